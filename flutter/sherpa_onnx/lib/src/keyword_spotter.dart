@@ -132,6 +132,8 @@ class KeywordSpotter {
         config.model.transducer.decoder.toNativeUtf8();
     c.ref.model.transducer.joiner =
         config.model.transducer.joiner.toNativeUtf8();
+    c.ref.model.transducer.nativeJoiner =
+        config.model.transducer.nativeJoiner ? 1 : 0;
 
     // paraformer
     c.ref.model.paraformer.encoder =
@@ -53,6 +53,7 @@ class OfflineTransducerModelConfig {
     this.encoder = '',
     this.decoder = '',
     this.joiner = '',
+    this.nativeJoiner = false,
   });
 
   factory OfflineTransducerModelConfig.fromJson(Map<String, dynamic> json) {
@@ -60,23 +61,26 @@ class OfflineTransducerModelConfig {
       encoder: json['encoder'] as String? ?? '',
       decoder: json['decoder'] as String? ?? '',
       joiner: json['joiner'] as String? ?? '',
+      nativeJoiner: json['nativeJoiner'] as bool? ?? false,
     );
   }
 
   @override
   String toString() {
-    return 'OfflineTransducerModelConfig(encoder: $encoder, decoder: $decoder, joiner: $joiner)';
+    return 'OfflineTransducerModelConfig(encoder: $encoder, decoder: $decoder, joiner: $joiner, nativeJoiner: $nativeJoiner)';
   }
 
   Map<String, dynamic> toJson() => {
     'encoder': encoder,
     'decoder': decoder,
     'joiner': joiner,
+    'nativeJoiner': nativeJoiner,
   };
 
   final String encoder;
   final String decoder;
   final String joiner;
+  final bool nativeJoiner;
 }
 
 /// Model files for an offline Paraformer recognizer.
@@ -1049,6 +1053,9 @@ class OfflineRecognizer {
         .toNativeUtf8();
     c.ref.model.transducer.joiner = config.model.transducer.joiner
         .toNativeUtf8();
+    c.ref.model.transducer.nativeJoiner = config.model.transducer.nativeJoiner
+        ? 1
+        : 0;
 
     // paraformer
     c.ref.model.paraformer.model = config.model.paraformer.model.toNativeUtf8();
@@ -44,6 +44,7 @@ class OnlineTransducerModelConfig {
     this.encoder = '',
     this.decoder = '',
     this.joiner = '',
+    this.nativeJoiner = false,
   });
 
   factory OnlineTransducerModelConfig.fromJson(Map<String, dynamic> json) {
@@ -51,23 +52,26 @@ class OnlineTransducerModelConfig {
       encoder: json['encoder'] as String? ?? '',
       decoder: json['decoder'] as String? ?? '',
       joiner: json['joiner'] as String? ?? '',
+      nativeJoiner: json['nativeJoiner'] as bool? ?? false,
     );
   }
 
   @override
   String toString() {
-    return 'OnlineTransducerModelConfig(encoder: $encoder, decoder: $decoder, joiner: $joiner)';
+    return 'OnlineTransducerModelConfig(encoder: $encoder, decoder: $decoder, joiner: $joiner, nativeJoiner: $nativeJoiner)';
   }
 
   Map<String, dynamic> toJson() => {
         'encoder': encoder,
         'decoder': decoder,
         'joiner': joiner,
+        'nativeJoiner': nativeJoiner,
       };
 
   final String encoder;
   final String decoder;
   final String joiner;
+  final bool nativeJoiner;
 }
 
 /// Model files for a streaming Paraformer recognizer.
@@ -427,6 +431,8 @@ class OnlineRecognizer {
         config.model.transducer.decoder.toNativeUtf8();
     c.ref.model.transducer.joiner =
         config.model.transducer.joiner.toNativeUtf8();
+    c.ref.model.transducer.nativeJoiner =
+        config.model.transducer.nativeJoiner ? 1 : 0;
 
     // paraformer
     c.ref.model.paraformer.encoder =
@@ -346,6 +346,9 @@ final class SherpaOnnxOfflineTransducerModelConfig extends Struct {
   external Pointer<Utf8> encoder;
   external Pointer<Utf8> decoder;
   external Pointer<Utf8> joiner;
+
+  @Int32()
+  external int nativeJoiner;
 }
 
 final class SherpaOnnxOfflineParaformerModelConfig extends Struct {
@@ -565,6 +568,9 @@ final class SherpaOnnxOnlineTransducerModelConfig extends Struct {
   external Pointer<Utf8> encoder;
   external Pointer<Utf8> decoder;
   external Pointer<Utf8> joiner;
+
+  @Int32()
+  external int nativeJoiner;
 }
 
 final class SherpaOnnxOnlineParaformerModelConfig extends Struct {
@@ -60,6 +60,7 @@ fn main() {
         encoder: Some(args.encoder.clone()),
         decoder: Some(args.decoder.clone()),
         joiner: Some(args.joiner.clone()),
+        ..Default::default()
     };
 
     recognizer_config.model_config.tokens = Some(args.tokens.clone());
@@ -12,6 +12,7 @@ namespace SherpaOnnx
             Encoder = "";
             Decoder = "";
             Joiner = "";
+            NativeJoiner = 0;
         }
         [MarshalAs(UnmanagedType.LPStr)]
         public string Encoder;
@@ -21,6 +22,8 @@ namespace SherpaOnnx
 
         [MarshalAs(UnmanagedType.LPStr)]
         public string Joiner;
+
+        public int NativeJoiner;
     }
 
 }
\ No newline at end of file
@@ -15,6 +15,7 @@ namespace SherpaOnnx
             Encoder = "";
             Decoder = "";
             Joiner = "";
+            NativeJoiner = 0;
         }
 
         [MarshalAs(UnmanagedType.LPStr)]
@@ -25,6 +26,8 @@ namespace SherpaOnnx
 
         [MarshalAs(UnmanagedType.LPStr)]
         public string Joiner;
+
+        public int NativeJoiner;
     }
 
 }
\ No newline at end of file
@@ -24,6 +24,7 @@
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/keyword-spotter.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-batch-transcriber.h"
 #include "sherpa-onnx/csrc/offline-punctuation.h"
 #include "sherpa-onnx/csrc/offline-recognizer.h"
 #include "sherpa-onnx/csrc/offline-source-separation.h"
@@ -32,6 +33,8 @@
 #include "sherpa-onnx/csrc/online-recognizer.h"
 #include "sherpa-onnx/csrc/online-speech-denoiser.h"
 #include "sherpa-onnx/csrc/resample.h"
+#include "sherpa-onnx/csrc/sample-format.h"
+#include "sherpa-onnx/csrc/session.h"
 #include "sherpa-onnx/csrc/speaker-embedding-extractor.h"
 #include "sherpa-onnx/csrc/speaker-embedding-manager.h"
 #include "sherpa-onnx/csrc/spoken-language-identification.h"
@@ -84,6 +87,8 @@ static sherpa_onnx::OnlineRecognizerConfig GetOnlineRecognizerConfig(
       SHERPA_ONNX_OR(config->model_config.transducer.decoder, "");
   recognizer_config.model_config.transducer.joiner =
       SHERPA_ONNX_OR(config->model_config.transducer.joiner, "");
+  recognizer_config.model_config.transducer.native_joiner =
+      config->model_config.transducer.native_joiner;
 
   recognizer_config.model_config.paraformer.encoder =
       SHERPA_ONNX_OR(config->model_config.paraformer.encoder, "");
@@ -238,6 +243,24 @@ void SherpaOnnxOnlineStreamAcceptWaveform(const SherpaOnnxOnlineStream *stream,
   stream->impl->AcceptWaveform(sample_rate, samples, n);
 }
 
+static bool GetSampleFormat(const char *name,
+                            sherpa_onnx::SampleFormat *format) {
+  if (!name || !sherpa_onnx::ParseSampleFormat(name, format)) {
+    SHERPA_ONNX_LOGE("Unsupported sample format: '%s'", name ? name : "");
+    return false;
+  }
+
+  return true;
+}
+
+void SherpaOnnxOnlineStreamAcceptWaveformWithFormat(
+    const SherpaOnnxOnlineStream *stream, int32_t sample_rate,
+    const void *samples, int32_t n, const char *format) {
+  sherpa_onnx::SampleFormat f;
+  if (!stream || !GetSampleFormat(format, &f)) return;
+  stream->impl->AcceptWaveform(sample_rate, samples, n, f);
+}
+
 int32_t SherpaOnnxIsOnlineStreamReady(
     const SherpaOnnxOnlineRecognizer *recognizer,
     const SherpaOnnxOnlineStream *stream) {
@@ -442,6 +465,9 @@ static sherpa_onnx::OfflineRecognizerConfig GetOfflineRecognizerConfig(
   recognizer_config.model_config.transducer.joiner_filename =
       SHERPA_ONNX_OR(config->model_config.transducer.joiner, "");
 
+  recognizer_config.model_config.transducer.native_joiner =
+      config->model_config.transducer.native_joiner;
+
   recognizer_config.model_config.paraformer.model =
       SHERPA_ONNX_OR(config->model_config.paraformer.model, "");
 
@@ -655,6 +681,11 @@ static sherpa_onnx::OfflineRecognizerConfig GetOfflineRecognizerConfig(
   recognizer_config.hr.lexicon = SHERPA_ONNX_OR(config->hr.lexicon, "");
   recognizer_config.hr.rule_fsts = SHERPA_ONNX_OR(config->hr.rule_fsts, "");
 
+  recognizer_config.max_padding_ratio =
+      SHERPA_ONNX_OR(config->max_padding_ratio, 1);
+  recognizer_config.num_bucket_threads =
+      SHERPA_ONNX_OR(config->num_bucket_threads, 1);
+
   if (config->model_config.debug) {
 #if __OHOS__
     auto str_vec = sherpa_onnx::SplitString(recognizer_config.ToString(), 128);
@@ -731,6 +762,14 @@ void SherpaOnnxAcceptWaveformOffline(const SherpaOnnxOfflineStream *stream,
   stream->impl->AcceptWaveform(sample_rate, samples, n);
 }
 
+void SherpaOnnxAcceptWaveformOfflineWithFormat(
+    const SherpaOnnxOfflineStream *stream, int32_t sample_rate,
+    const void *samples, int32_t n, const char *format) {
+  sherpa_onnx::SampleFormat f;
+  if (!stream || !GetSampleFormat(format, &f)) return;
+  stream->impl->AcceptWaveform(sample_rate, samples, n, f);
+}
+
 void SherpaOnnxOfflineStreamSetOption(const SherpaOnnxOfflineStream *stream,
                                       const char *key, const char *value) {
   if (!stream || !key || !value) return;
@@ -767,11 +806,8 @@ void SherpaOnnxDecodeMultipleOfflineStreams(
   recognizer->impl->DecodeStreams(ss.data(), n);
 }
 
-const SherpaOnnxOfflineRecognizerResult *SherpaOnnxGetOfflineStreamResult(
-    const SherpaOnnxOfflineStream *stream) {
-  if (!stream) return nullptr;
-  const sherpa_onnx::OfflineRecognitionResult &result =
-      stream->impl->GetResult();
+static const SherpaOnnxOfflineRecognizerResult *NewOfflineRecognizerResult(
+    const sherpa_onnx::OfflineRecognitionResult &result) {
   const auto &text = result.text;
 
   auto r = new SherpaOnnxOfflineRecognizerResult;
@@ -911,6 +947,12 @@ const SherpaOnnxOfflineRecognizerResult *SherpaOnnxGetOfflineStreamResult(
   return r;
 }
 
+const SherpaOnnxOfflineRecognizerResult *SherpaOnnxGetOfflineStreamResult(
+    const SherpaOnnxOfflineStream *stream) {
+  if (!stream) return nullptr;
+  return NewOfflineRecognizerResult(stream->impl->GetResult());
+}
+
 void SherpaOnnxDestroyOfflineRecognizerResult(
     const SherpaOnnxOfflineRecognizerResult *r) {
   if (r) {
@@ -948,6 +990,46 @@ void SherpaOnnxDestroyOfflineStreamResultJson(const char *s) {
   delete[] s;
 }
 
+void SherpaOnnxOfflineBatchTranscribe(
+    const SherpaOnnxOfflineRecognizer *recognizer,
+    const SherpaOnnxOfflineBatchTranscriberConfig *config,
+    const char *const *filenames, int32_t n,
+    SherpaOnnxOfflineBatchTranscriberCallback callback, void *arg) {
+  if (!recognizer || !filenames || n <= 0 || !callback) {
+    return;
+  }
+
+  sherpa_onnx::OfflineBatchTranscriberConfig c;
+  if (config) {
+    c.num_workers = SHERPA_ONNX_OR(config->num_workers, c.num_workers);
+    c.batch_size = SHERPA_ONNX_OR(config->batch_size, c.batch_size);
+    c.num_readers = SHERPA_ONNX_OR(config->num_readers, c.num_readers);
+    c.num_readers = std::max(c.num_readers, 0);
+  }
+
+  if (!c.Validate()) {
+    SHERPA_ONNX_LOGE("Errors in config");
+    return;
+  }
+
+  std::vector<std::string> files(filenames, filenames + n);
+
+  sherpa_onnx::OfflineBatchTranscriber transcriber(recognizer->impl.get(), c);
+  sherpa_onnx::OfflineBatchTranscriberCallback on_result =
+      [callback, arg](const sherpa_onnx::OfflineBatchTranscriberResult &r) {
+        if (!r.ok) {
+          callback(r.index, r.filename.c_str(), nullptr, arg);
+          return;
+        }
+
+        auto result = NewOfflineRecognizerResult(r.result);
+        callback(r.index, r.filename.c_str(), result, arg);
+        SherpaOnnxDestroyOfflineRecognizerResult(result);
+      };
+
+  transcriber.Run(files, on_result);
+}
+
 // ============================================================
 // For Keyword Spot
 // ============================================================
@@ -971,6 +1053,8 @@ static sherpa_onnx::KeywordSpotterConfig GetKeywordSpotterConfig(
       SHERPA_ONNX_OR(config->model_config.transducer.decoder, "");
   spotter_config.model_config.transducer.joiner =
       SHERPA_ONNX_OR(config->model_config.transducer.joiner, "");
+  spotter_config.model_config.transducer.native_joiner =
+      config->model_config.transducer.native_joiner;
 
   spotter_config.model_config.paraformer.encoder =
       SHERPA_ONNX_OR(config->model_config.paraformer.encoder, "");
@@ -1410,13 +1494,14 @@ const SherpaOnnxSpeechSegment *SherpaOnnxVoiceActivityDetectorFront(
     return nullptr;
   }
 
-  const sherpa_onnx::SpeechSegment &segment = p->impl->Front();
+  const sherpa_onnx::SpeechSegmentView &segment = p->impl->FrontView();
 
   SherpaOnnxSpeechSegment *ans = new SherpaOnnxSpeechSegment;
   ans->start = segment.start;
-  ans->samples = new float[segment.samples.size()];
-  std::copy(segment.samples.begin(), segment.samples.end(), ans->samples);
-  ans->n = segment.samples.size();
+  ans->samples = new float[segment.samples.Size()];
+  std::copy(segment.samples.Data(),
+            segment.samples.Data() + segment.samples.Size(), ans->samples);
+  ans->n = segment.samples.Size();
 
   return ans;
 }
@@ -2762,6 +2847,41 @@ int32_t SherpaOnnxFileExists(const char *filename) {
   return sherpa_onnx::FileExists(filename);
 }
 
+int32_t SherpaOnnxInitGlobalThreadPool(
+    const SherpaOnnxOrtThreadPoolConfig *config) {
+  if (!config) {
+    SHERPA_ONNX_LOGE("config is NULL");
+    return 0;
+  }
+
+  if (sherpa_onnx::HasGlobalThreadPool()) {
+    SHERPA_ONNX_LOGE("The global thread pool can be initialized only once");
+    return 0;
+  }
+
+  sherpa_onnx::OrtThreadPoolConfig c;
+  c.enabled = true;
+  c.intra_op_num_threads = config->intra_op_num_threads;
+  c.inter_op_num_threads = SHERPA_ONNX_OR(config->inter_op_num_threads, 1);
+  c.allow_spinning = !config->disable_spinning;
+  c.intra_op_thread_affinity =
+      SHERPA_ONNX_OR(config->intra_op_thread_affinity, "");
+
+  if (!c.Validate()) {
+    SHERPA_ONNX_LOGE("Errors in config");
+    return 0;
+  }
+
+  try {
+    sherpa_onnx::InitGlobalThreadPool(c);
+  } catch (const Ort::Exception &ex) {
+    SHERPA_ONNX_LOGE("Failed to create the global thread pool: %s", ex.what());
+    return 0;
+  }
+
+  return 1;
+}
+
 struct SherpaOnnxOfflineSpeechDenoiser {
   std::unique_ptr<sherpa_onnx::OfflineSpeechDenoiser> impl;
 };
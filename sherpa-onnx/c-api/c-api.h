@@ -164,6 +164,51 @@ SHERPA_ONNX_API const char *SherpaOnnxGetGitDate();
  */
 SHERPA_ONNX_API int32_t SherpaOnnxFileExists(const char *filename);
 
+/**
+ * @brief Thread pools of onnxruntime shared by all models of the process.
+ *
+ * Zero-initialize it and set only the fields you need.
+ */
+typedef struct SherpaOnnxOrtThreadPoolConfig {
+  /** Number of intra-op threads. 0 means the number of physical cores. */
+  int32_t intra_op_num_threads;
+  /** Number of inter-op threads. 0 means 1. */
+  int32_t inter_op_num_threads;
+  /**
+   * Non-zero to stop idle threads from spinning before they sleep. 0 keeps
+   * spinning enabled, which is also the default of the C++ API.
+   */
+  int32_t disable_spinning;
+  /**
+   * CPU affinity of the intra-op threads, e.g., "1,2;3,4". It has
+   * intra_op_num_threads - 1 groups. NULL or empty means no affinity.
+   */
+  const char *intra_op_thread_affinity;
+} SherpaOnnxOrtThreadPoolConfig;
+
+/**
+ * @brief Let all models of this process share one set of onnxruntime thread
+ * pools.
+ *
+ * Models created afterwards ignore their `num_threads` and use the shared
+ * pools instead, which avoids having more threads than CPU cores when
+ * several models are loaded. It has to be called once, before creating
+ * any model.
+ *
+ * @param config Thread pool configuration.
+ * @return 1 on success; 0 if the config is invalid, onnxruntime fails to
+ *         create the pools, or the pools have already been initialized.
+ *
+ * @code
+ * SherpaOnnxOrtThreadPoolConfig pool;
+ * memset(&pool, 0, sizeof(pool));
+ * pool.intra_op_num_threads = 4;
+ * SherpaOnnxInitGlobalThreadPool(&pool);
+ * @endcode
+ */
+SHERPA_ONNX_API int32_t
+SherpaOnnxInitGlobalThreadPool(const SherpaOnnxOrtThreadPoolConfig *config);
+
 /**
  * @brief Configuration for a streaming transducer model.
  *
@@ -178,6 +223,11 @@ typedef struct SherpaOnnxOnlineTransducerModelConfig {
   const char *decoder;
   /** Path to the joiner ONNX model. */
   const char *joiner;
+  /**
+   * Non-zero to run the joiner in C++ instead of onnxruntime when the
+   * joiner model is supported.
+   */
+  int32_t native_joiner;
 } SherpaOnnxOnlineTransducerModelConfig;
 
 /**
@@ -550,6 +600,32 @@ SHERPA_ONNX_API void SherpaOnnxOnlineStreamAcceptWaveform(
     const SherpaOnnxOnlineStream *stream, int32_t sample_rate,
     const float *samples, int32_t n);
 
+/**
+ * @brief Like SherpaOnnxOnlineStreamAcceptWaveform(), but the samples are
+ * not floats.
+ *
+ * Use it to feed audio from telephony or a sound card without converting
+ * it to float yourself.
+ *
+ * @param stream A pointer returned by SherpaOnnxCreateOnlineStream().
+ * @param sample_rate Sample rate of @p samples.
+ * @param samples Pointer to @p n mono samples in the given format.
+ * @param n Number of samples, not bytes.
+ * @param format One of "int16", "int24" or "int32" (signed PCM, little
+ *               endian), "uint8" (8-bit unsigned PCM), "mulaw" (G.711
+ *               mu-law), "alaw" (G.711 A-law) or "float32". An unknown
+ *               format is reported and the samples are ignored.
+ *
+ * @code
+ * // 20 ms of 8 kHz mu-law audio from an RTP packet
+ * SherpaOnnxOnlineStreamAcceptWaveformWithFormat(stream, 8000, payload, 160,
+ *                                                "mulaw");
+ * @endcode
+ */
+SHERPA_ONNX_API void SherpaOnnxOnlineStreamAcceptWaveformWithFormat(
+    const SherpaOnnxOnlineStream *stream, int32_t sample_rate,
+    const void *samples, int32_t n, const char *format);
+
 /**
  * @brief Check whether a streaming ASR stream is ready to decode.
  *
@@ -825,6 +901,11 @@ typedef struct SherpaOnnxOfflineTransducerModelConfig {
   const char *decoder;
   /** Path to the joiner ONNX model. */
   const char *joiner;
+  /**
+   * Non-zero to run the joiner in C++ instead of onnxruntime when the
+   * joiner model is supported.
+   */
+  int32_t native_joiner;
 } SherpaOnnxOfflineTransducerModelConfig;
 
 /** @brief Configuration for a non-streaming Paraformer model. */
@@ -1179,6 +1260,16 @@ typedef struct SherpaOnnxOfflineRecognizerConfig {
 
   /** Optional homophone replacement configuration. */
   SherpaOnnxHomophoneReplacerConfig hr;
+
+  /**
+   * Streams decoded together are split into groups of similar lengths, so
+   * that at most this fraction of the frames in a group is padding. Each
+   * group is a separate batch. 1 decodes all streams in a single batch.
+   * 0 means the default, 1.
+   */
+  float max_padding_ratio;
+  /** Number of threads decoding the groups above. 0 means 1. */
+  int32_t num_bucket_threads;
 } SherpaOnnxOfflineRecognizerConfig;
 
 /** @brief Non-streaming recognizer handle. */
@@ -1352,6 +1443,16 @@ SHERPA_ONNX_API void SherpaOnnxAcceptWaveformOffline(
     const SherpaOnnxOfflineStream *stream, int32_t sample_rate,
     const float *samples, int32_t n);
 
+/**
+ * @brief Like SherpaOnnxAcceptWaveformOffline(), but the samples are in the
+ * given format.
+ *
+ * @param format See SherpaOnnxOnlineStreamAcceptWaveformWithFormat().
+ */
+SHERPA_ONNX_API void SherpaOnnxAcceptWaveformOfflineWithFormat(
+    const SherpaOnnxOfflineStream *stream, int32_t sample_rate,
+    const void *samples, int32_t n, const char *format);
+
 /**
  * @brief Set a per-stream runtime option for offline ASR.
  *
@@ -1566,6 +1667,72 @@ SHERPA_ONNX_API const char *SherpaOnnxGetOfflineStreamResultAsJson(
  */
 SHERPA_ONNX_API void SherpaOnnxDestroyOfflineStreamResultJson(const char *s);
 
+/**
+ * @brief Configuration for SherpaOnnxOfflineBatchTranscribe().
+ *
+ * Zero-initialize it and set only the fields you need. 0 means the default
+ * value.
+ */
+typedef struct SherpaOnnxOfflineBatchTranscriberConfig {
+  /** Number of threads decoding files in parallel. Default 1. */
+  int32_t num_workers;
+  /** Maximum number of files decoded at once by a thread. Default 8. */
+  int32_t batch_size;
+  /** Number of threads reading files ahead of the decoding threads.
+   *  Default 1. Use a negative value to read files in the decoding
+   *  threads. */
+  int32_t num_readers;
+} SherpaOnnxOfflineBatchTranscriberConfig;
+
+/**
+ * @brief Callback of SherpaOnnxOfflineBatchTranscribe().
+ *
+ * @param index Index of the file in the input list.
+ * @param filename The file name.
+ * @param r The result, or NULL if the file cannot be read. It is owned by
+ *          the library and valid only during the call.
+ * @param arg The user pointer passed to SherpaOnnxOfflineBatchTranscribe().
+ */
+typedef void (*SherpaOnnxOfflineBatchTranscriberCallback)(
+    int32_t index, const char *filename,
+    const SherpaOnnxOfflineRecognizerResult *r, void *arg);
+
+/**
+ * @brief Transcribe a list of wave files using multiple threads.
+ *
+ * Files are grouped by duration into batches and distributed among the
+ * worker threads. The callback is invoked once per file in the order of
+ * @p filenames. Calls are not concurrent, but they may come from
+ * different threads. The function returns after all files are processed.
+ *
+ * @param recognizer A pointer returned by SherpaOnnxCreateOfflineRecognizer().
+ * @param config Configuration. NULL to use the default values.
+ * @param filenames Array of @p n wave file names.
+ * @param n Number of files.
+ * @param callback Invoked for each file.
+ * @param arg Passed to @p callback.
+ *
+ * @code
+ * static void OnResult(int32_t index, const char *filename,
+ *                      const SherpaOnnxOfflineRecognizerResult *r,
+ *                      void *arg) {
+ *   printf("%s: %s\n", filename, r ? r->text : "(failed)");
+ * }
+ *
+ * SherpaOnnxOfflineBatchTranscriberConfig config;
+ * memset(&config, 0, sizeof(config));
+ * config.num_workers = 4;
+ * const char *files[] = {"a.wav", "b.wav", "c.wav"};
+ * SherpaOnnxOfflineBatchTranscribe(recognizer, &config, files, 3, OnResult,
+ *                                  NULL);
+ * @endcode
+ */
+SHERPA_ONNX_API void SherpaOnnxOfflineBatchTranscribe(
+    const SherpaOnnxOfflineRecognizer *recognizer,
+    const SherpaOnnxOfflineBatchTranscriberConfig *config,
+    const char *const *filenames, int32_t n,
+    SherpaOnnxOfflineBatchTranscriberCallback callback, void *arg);
+
 // ============================================================
 // For keyword spotting
 // ============================================================
@@ -88,6 +88,8 @@ OnlineRecognizer OnlineRecognizer::Create(
       config.model_config.transducer.decoder.c_str();
   c.model_config.transducer.joiner =
       config.model_config.transducer.joiner.c_str();
+  c.model_config.transducer.native_joiner =
+      config.model_config.transducer.native_joiner;
 
   c.model_config.paraformer.encoder =
       config.model_config.paraformer.encoder.c_str();
@@ -252,6 +254,8 @@ static SherpaOnnxOfflineRecognizerConfig Convert(
       config.model_config.transducer.decoder.c_str();
   c.model_config.transducer.joiner =
       config.model_config.transducer.joiner.c_str();
+  c.model_config.transducer.native_joiner =
+      config.model_config.transducer.native_joiner;
 
   c.model_config.paraformer.model =
       config.model_config.paraformer.model.c_str();
@@ -393,6 +397,9 @@ static SherpaOnnxOfflineRecognizerConfig Convert(
   c.hr.lexicon = config.hr.lexicon.c_str();
   c.hr.rule_fsts = config.hr.rule_fsts.c_str();
 
+  c.max_padding_ratio = config.max_padding_ratio;
+  c.num_bucket_threads = config.num_bucket_threads;
+
   return c;
 }
 
@@ -681,6 +688,8 @@ KeywordSpotter KeywordSpotter::Create(const KeywordSpotterConfig &config) {
       config.model_config.transducer.decoder.c_str();
   c.model_config.transducer.joiner =
       config.model_config.transducer.joiner.c_str();
+  c.model_config.transducer.native_joiner =
+      config.model_config.transducer.native_joiner;
   c.feat_config.feature_dim = config.feat_config.feature_dim;
 
   c.model_config.paraformer.encoder =
@@ -1056,6 +1065,18 @@ bool FileExists(const std::string &filename) {
   return SherpaOnnxFileExists(filename.c_str());
 }
 
+bool InitGlobalThreadPool(const OrtThreadPoolConfig &config) {
+  SherpaOnnxOrtThreadPoolConfig c;
+  memset(&c, 0, sizeof(c));
+
+  c.intra_op_num_threads = config.intra_op_num_threads;
+  c.inter_op_num_threads = config.inter_op_num_threads;
+  c.disable_spinning = !config.allow_spinning;
+  c.intra_op_thread_affinity = config.intra_op_thread_affinity.c_str();
+
+  return SherpaOnnxInitGlobalThreadPool(&c);
+}
+
 // ============================================================
 // For Offline Punctuation
 // ============================================================
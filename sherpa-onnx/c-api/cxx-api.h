@@ -64,6 +64,8 @@ struct OnlineTransducerModelConfig {
   std::string decoder;
   /** Joiner ONNX model. */
   std::string joiner;
+  /** Run the joiner in C++ when the joiner model is supported. */
+  bool native_joiner = false;
 };
 
 /** @brief Streaming Paraformer model files. */
@@ -429,6 +431,8 @@ struct OfflineTransducerModelConfig {
   std::string decoder;
   /** Joiner ONNX model. */
   std::string joiner;
+  /** Run the joiner in C++ when the joiner model is supported. */
+  bool native_joiner = false;
 };
 
 /** @brief Offline Paraformer model file. */
@@ -746,6 +750,10 @@ struct OfflineRecognizerConfig {
   float blank_penalty = 0;
   /** Optional homophone replacement configuration. */
   HomophoneReplacerConfig hr;
+  /** Maximum fraction of padding frames in a batch. 1 disables splitting. */
+  float max_padding_ratio = 1;
+  /** Number of threads decoding the batches split by max_padding_ratio. */
+  int32_t num_bucket_threads = 1;
 };
 
 /** @brief Offline ASR result copied into C++ containers. */
@@ -1494,6 +1502,26 @@ SHERPA_ONNX_API std::string GetGitDate();
 /** @brief Return `true` if a file exists. */
 SHERPA_ONNX_API bool FileExists(const std::string &filename);
 
+/** @brief Thread pools of onnxruntime shared by all models. */
+struct OrtThreadPoolConfig {
+  /** Number of intra-op threads. 0 means the number of physical cores. */
+  int32_t intra_op_num_threads = 0;
+  /** Number of inter-op threads. */
+  int32_t inter_op_num_threads = 1;
+  /** Let idle threads spin before sleeping. */
+  bool allow_spinning = true;
+  /** CPU affinity of the intra-op threads, e.g., "1,2;3,4". */
+  std::string intra_op_thread_affinity;
+};
+
+/**
+ * @brief Let all models share one set of onnxruntime thread pools.
+ *
+ * Call it once, before creating any model. See
+ * SherpaOnnxInitGlobalThreadPool().
+ */
+SHERPA_ONNX_API bool InitGlobalThreadPool(const OrtThreadPoolConfig &config);
+
 // ============================================================================
 // Offline Punctuation
 // ============================================================================
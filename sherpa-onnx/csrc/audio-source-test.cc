@@ -0,0 +1,241 @@
+// sherpa-onnx/csrc/audio-source-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/audio-source.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/wave-writer.h"
+
+namespace sherpa_onnx {
+
+// Helpers to write wave files by hand, e.g., with chunks that WriteWave()
+// does not produce
+static void AppendUint16(uint16_t v, std::string *s) {
+  s->push_back(v & 0xff);
+  s->push_back(v >> 8);
+}
+
+static void AppendUint32(uint32_t v, std::string *s) {
+  AppendUint16(v & 0xffff, s);
+  AppendUint16(v >> 16, s);
+}
+
+// If size is -1, the actual size of body is written
+static void AppendChunk(const char *id, const std::string &body,
+                        std::string *s, int64_t size = -1) {
+  s->append(id, 4);
+  AppendUint32(size == -1 ? body.size() : size, s);
+  *s += body;
+  if (body.size() & 1) {
+    s->push_back(0);
+  }
+}
+
+static std::string FmtChunk(int32_t audio_format, int32_t num_channels,
+                            int32_t sample_rate, int32_t bits_per_sample) {
+  int32_t block_align = num_channels * bits_per_sample / 8;
+
+  std::string s;
+  AppendUint16(audio_format, &s);
+  AppendUint16(num_channels, &s);
+  AppendUint32(sample_rate, &s);
+  AppendUint32(sample_rate * block_align, &s);
+  AppendUint16(block_align, &s);
+  AppendUint16(bits_per_sample, &s);
+  return s;
+}
+
+static std::string ExtensibleFmtChunk(int32_t sub_format,
+                                      int32_t num_channels,
+                                      int32_t sample_rate,
+                                      int32_t bits_per_sample) {
+  std::string s =
+      FmtChunk(0xfffe, num_channels, sample_rate, bits_per_sample);
+  AppendUint16(22, &s);               // cbSize
+  AppendUint16(bits_per_sample, &s);  // valid bits per sample
+  AppendUint32(0, &s);                // channel mask
+  // The sub-format GUID starts with the format code
+  AppendUint16(sub_format, &s);
+  s += std::string(
+      "\x00\x00\x00\x00\x10\x00\x80\x00\x00\xaa\x00\x38\x9b\x71", 14);
+  return s;
+}
+
+static void WriteFile(const std::string &filename, const std::string &chunks) {
+  std::string s = "RIFF";
+  AppendUint32(4 + chunks.size(), &s);
+  s += "WAVE";
+  s += chunks;
+
+  std::ofstream os(filename, std::ios::binary);
+  os.write(s.data(), s.size());
+}
+
+TEST(AudioFileSource, Wave) {
+  std::vector<float> ch0 = {0.5, -0.25, 0.125, 0, -1, 0.75, 0.375};
+  std::vector<float> ch1 = {-0.5, 0.25, 0, 0.625, 1, -0.75, 0.25};
+  std::string filename = "audio-source-test.wav";
+  ASSERT_TRUE(WriteWave(filename, 8000, ch0.data(), ch1.data(), ch0.size()));
+
+  auto source = AudioFileSource::CreateFromWave(filename);
+  ASSERT_NE(source, nullptr);
+  EXPECT_EQ(source->SampleRate(), 8000);
+  EXPECT_EQ(source->NumChannels(), 2);
+  EXPECT_EQ(source->NumSamples(), ch0.size());
+  EXPECT_EQ(source->GetSampleFormat(), SampleFormat::kInt16);
+
+  std::vector<std::vector<float>> samples;
+  EXPECT_EQ(source->Read(4, &samples), 4);
+  ASSERT_EQ(samples.size(), 2);
+  for (int32_t i = 0; i != 4; ++i) {
+    EXPECT_NEAR(samples[0][i], ch0[i], 1e-4);
+    EXPECT_NEAR(samples[1][i], ch1[i], 1e-4);
+  }
+
+  std::vector<float> first;
+  EXPECT_EQ(source->Read(100, &first), 3);
+  for (int32_t i = 0; i != 3; ++i) {
+    EXPECT_NEAR(first[i], ch0[4 + i], 1e-4);
+  }
+
+  EXPECT_EQ(source->Read(100, &first), 0);
+
+  std::remove(filename.c_str());
+}
+
+TEST(AudioFileSource, Raw) {
+  // 24-bit little endian samples
+  const uint8_t bytes[] = {0x00, 0x00, 0x40, 0x00, 0x00,
+                           0xc0, 0x00, 0x00, 0x00};
+  std::string filename = "audio-source-test.raw";
+  {
+    std::ofstream os(filename, std::ios::binary);
+    os.write(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+  }
+
+  auto source =
+      AudioFileSource::CreateFromRaw(filename, 16000, 1, SampleFormat::kInt24);
+  ASSERT_NE(source, nullptr);
+  EXPECT_EQ(source->NumSamples(), 3);
+
+  std::vector<float> samples;
+  EXPECT_EQ(source->Read(10, &samples), 3);
+  EXPECT_FLOAT_EQ(samples[0], 0.5);
+  EXPECT_FLOAT_EQ(samples[1], -0.5);
+  EXPECT_FLOAT_EQ(samples[2], 0);
+
+  std::remove(filename.c_str());
+}
+
+TEST(AudioFileSource, ListChunkAndFloat32) {
+  std::vector<float> expected = {0.5, -0.25, 0.125};
+  std::string data(reinterpret_cast<const char *>(expected.data()),
+                   expected.size() * sizeof(float));
+
+  // A LIST chunk of odd size is padded to 6 bytes, so the samples start
+  // at an offset that is not a multiple of 4
+  std::string chunks;
+  AppendChunk("fmt ", FmtChunk(3, 1, 16000, 32), &chunks);
+  AppendChunk("LIST", "INFOx", &chunks);
+  AppendChunk("data", data, &chunks);
+
+  std::string filename = "audio-source-test-list.wav";
+  WriteFile(filename, chunks);
+
+  auto source = AudioFileSource::CreateFromWave(filename);
+  ASSERT_NE(source, nullptr);
+  EXPECT_EQ(source->GetSampleFormat(), SampleFormat::kFloat32);
+  EXPECT_EQ(source->NumSamples(), 3);
+
+  std::vector<float> samples;
+  EXPECT_EQ(source->Read(10, &samples), 3);
+  EXPECT_EQ(samples, expected);
+
+  std::remove(filename.c_str());
+}
+
+TEST(AudioFileSource, Extensible) {
+  std::vector<int16_t> s16 = {16384, -32768, 0, 8192};
+  std::string data(reinterpret_cast<const char *>(s16.data()),
+                   s16.size() * sizeof(int16_t));
+
+  std::string chunks;
+  AppendChunk("fmt ", ExtensibleFmtChunk(1, 2, 8000, 16), &chunks);
+  AppendChunk("data", data, &chunks);
+
+  std::string filename = "audio-source-test-extensible.wav";
+  WriteFile(filename, chunks);
+
+  auto source = AudioFileSource::CreateFromWave(filename);
+  ASSERT_NE(source, nullptr);
+  EXPECT_EQ(source->SampleRate(), 8000);
+  EXPECT_EQ(source->NumChannels(), 2);
+  EXPECT_EQ(source->GetSampleFormat(), SampleFormat::kInt16);
+  EXPECT_EQ(source->NumSamples(), 2);
+
+  std::vector<std::vector<float>> samples;
+  EXPECT_EQ(source->Read(10, &samples), 2);
+  EXPECT_EQ(samples[0], (std::vector<float>{0.5, 0}));
+  EXPECT_EQ(samples[1], (std::vector<float>{-1, 0.25}));
+
+  std::remove(filename.c_str());
+}
+
+TEST(AudioFileSource, DataSize) {
+  std::vector<int16_t> s16 = {16384, -32768, 0, 8192};
+  std::string data(reinterpret_cast<const char *>(s16.data()),
+                   s16.size() * sizeof(int16_t));
+
+  std::string filename = "audio-source-test-data-size.wav";
+
+  // The size is 0 or 0xffffffff in files written by a stream, and it is
+  // too large in a truncated file. All of them use the rest of the file.
+  for (int64_t size : {0LL, 0xffffffffLL, 1000LL}) {
+    std::string chunks;
+    AppendChunk("fmt ", FmtChunk(1, 1, 16000, 16), &chunks);
+    AppendChunk("data", data, &chunks, size);
+    WriteFile(filename, chunks);
+
+    auto source = AudioFileSource::CreateFromWave(filename);
+    ASSERT_NE(source, nullptr) << size;
+    EXPECT_EQ(source->NumSamples(), 4) << size;
+  }
+
+  // A data chunk with only part of the last sample
+  std::string chunks;
+  AppendChunk("fmt ", FmtChunk(1, 1, 16000, 16), &chunks);
+  AppendChunk("data", data.substr(0, 7), &chunks, 8);
+  chunks.pop_back();  // no padding byte
+  WriteFile(filename, chunks);
+
+  auto source = AudioFileSource::CreateFromWave(filename);
+  ASSERT_NE(source, nullptr);
+  EXPECT_EQ(source->NumSamples(), 3);
+
+  std::vector<float> samples;
+  EXPECT_EQ(source->Read(10, &samples), 3);
+  EXPECT_EQ(samples, (std::vector<float>{0.5, -1, 0}));
+
+  std::remove(filename.c_str());
+}
+
+TEST(AudioFileSource, NotWave) {
+  std::string filename = "audio-source-test.txt";
+  {
+    std::ofstream os(filename);
+    os << "this is not a wave file";
+  }
+
+  EXPECT_EQ(AudioFileSource::CreateFromWave(filename), nullptr);
+
+  std::remove(filename.c_str());
+}
+
+}  // namespace sherpa_onnx
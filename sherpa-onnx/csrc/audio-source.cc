@@ -0,0 +1,293 @@
+// sherpa-onnx/csrc/audio-source.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/audio-source.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+int32_t MemoryAudioSource::Read(int32_t n,
+                                std::vector<std::vector<float>> *samples) {
+  samples->resize(1);
+  return Read(n, &(*samples)[0]);
+}
+
+int32_t MemoryAudioSource::Read(int32_t n, std::vector<float> *samples) {
+  int32_t k = std::min<int64_t>(n, n_ - pos_);
+  samples->assign(samples_ + pos_, samples_ + pos_ + k);
+  pos_ += k;
+  return k;
+}
+
+namespace {
+
+uint16_t ReadUint16(const char *p) {
+  uint16_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+uint32_t ReadUint32(const char *p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+// See http://soundfile.sapp.org/doc/WaveFormat/
+// and https://www.mmsp.ece.mcgill.ca/Documents/AudioFormats/WAVE/WAVE.html
+//
+// Note: We assume little endian here
+struct WaveInfo {
+  int32_t sample_rate = 0;
+  int32_t num_channels = 0;
+  SampleFormat format = SampleFormat::kInt16;
+  int64_t data_offset = 0;
+  int64_t data_size = 0;
+};
+
+bool GetSampleFormat(int32_t audio_format, int32_t bits_per_sample,
+                     SampleFormat *format) {
+  if (audio_format == 1) {  // integer PCM
+    switch (bits_per_sample) {
+      case 8:
+        *format = SampleFormat::kUint8;
+        return true;
+      case 16:
+        *format = SampleFormat::kInt16;
+        return true;
+      case 24:
+        *format = SampleFormat::kInt24;
+        return true;
+      case 32:
+        *format = SampleFormat::kInt32;
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  if (audio_format == 3 && bits_per_sample == 32) {
+    *format = SampleFormat::kFloat32;
+    return true;
+  }
+
+  if (audio_format == 6 && bits_per_sample == 8) {
+    *format = SampleFormat::kALaw;
+    return true;
+  }
+
+  if (audio_format == 7 && bits_per_sample == 8) {
+    *format = SampleFormat::kMuLaw;
+    return true;
+  }
+
+  return false;
+}
+
+bool ParseWaveHeader(const char *data, int64_t size, WaveInfo *info) {
+  if (size < 12 || std::memcmp(data, "RIFF", 4) != 0 ||
+      std::memcmp(data + 8, "WAVE", 4) != 0) {
+    SHERPA_ONNX_LOGE("Not a RIFF/WAVE file");
+    return false;
+  }
+
+  bool has_fmt = false;
+  int64_t offset = 12;
+
+  // Walk over the chunks until the data chunk is found
+  while (offset + 8 <= size) {
+    const char *id = data + offset;
+    int64_t chunk_size = ReadUint32(data + offset + 4);
+    const char *p = data + offset + 8;
+    int64_t remaining = size - offset - 8;
+
+    if (std::memcmp(id, "fmt ", 4) == 0) {
+      if (chunk_size < 16 || remaining < 16) {
+        SHERPA_ONNX_LOGE("Invalid fmt chunk of size %d",
+                         static_cast<int32_t>(chunk_size));
+        return false;
+      }
+
+      int32_t audio_format = ReadUint16(p);
+      info->num_channels = ReadUint16(p + 2);
+      info->sample_rate = ReadUint32(p + 4);
+      int32_t block_align = ReadUint16(p + 12);
+      int32_t bits_per_sample = ReadUint16(p + 14);
+
+      if (audio_format == 0xfffe) {
+        // WAVE_FORMAT_EXTENSIBLE. The format is given by the first two
+        // bytes of the sub-format GUID.
+        if (chunk_size < 40 || remaining < 40) {
+          SHERPA_ONNX_LOGE("Invalid WAVE_FORMAT_EXTENSIBLE fmt chunk");
+          return false;
+        }
+        audio_format = ReadUint16(p + 24);
+      }
+
+      if (!GetSampleFormat(audio_format, bits_per_sample, &info->format)) {
+        SHERPA_ONNX_LOGE(
+            "Unsupported audio format %d with %d bits per sample. Supported "
+            "formats are integer PCM (8, 16, 24, 32 bits), float32, mu-law "
+            "and A-law",
+            audio_format, bits_per_sample);
+        return false;
+      }
+
+      if (info->num_channels <= 0 ||
+          block_align != info->num_channels * BytesPerSample(info->format)) {
+        SHERPA_ONNX_LOGE("Invalid num_channels %d or block_align %d",
+                         info->num_channels, block_align);
+        return false;
+      }
+
+      has_fmt = true;
+    } else if (std::memcmp(id, "data", 4) == 0) {
+      if (!has_fmt) {
+        SHERPA_ONNX_LOGE("The data chunk comes before the fmt chunk");
+        return false;
+      }
+
+      // Chunks are only aligned to 2 bytes, so the samples may not be
+      // aligned for float32. They are read with ConvertToFloat(), which
+      // does not assume any alignment.
+      info->data_offset = offset + 8;
+      // The size may be missing or wrong in files written by a stream,
+      // so it is limited by the actual file size
+      info->data_size = std::min(chunk_size, remaining);
+      if (chunk_size == 0 || chunk_size == 0xffffffff) {
+        info->data_size = remaining;
+      }
+      return true;
+    }
+
+    // Chunks are padded to an even number of bytes
+    offset += 8 + chunk_size + (chunk_size & 1);
+  }
+
+  SHERPA_ONNX_LOGE("No data chunk is found");
+  return false;
+}
+
+}  // namespace
+
+AudioFileSource::AudioFileSource(std::unique_ptr<MappedFile> file,
+                                 const char *data, int64_t num_bytes,
+                                 int32_t sample_rate, int32_t num_channels,
+                                 SampleFormat format)
+    : file_(std::move(file)),
+      data_(data),
+      sample_rate_(sample_rate),
+      num_channels_(num_channels),
+      format_(format),
+      bytes_per_frame_(num_channels * BytesPerSample(format)),
+      num_samples_(num_bytes / bytes_per_frame_) {}
+
+std::unique_ptr<AudioFileSource> AudioFileSource::CreateFromWave(
+    const std::string &filename) {
+  if (!FileExists(filename)) {
+    SHERPA_ONNX_LOGE("Filename '%s' does not exist", filename.c_str());
+    return nullptr;
+  }
+
+  auto file = std::make_unique<MappedFile>(filename);
+
+  WaveInfo info;
+  if (!ParseWaveHeader(file->Data(), file->Size(), &info)) {
+    SHERPA_ONNX_LOGE("Failed to read '%s'", filename.c_str());
+    return nullptr;
+  }
+
+  const char *data = file->Data() + info.data_offset;
+
+  return std::unique_ptr<AudioFileSource>(
+      new AudioFileSource(std::move(file), data, info.data_size,
+                          info.sample_rate, info.num_channels, info.format));
+}
+
+std::unique_ptr<AudioFileSource> AudioFileSource::CreateFromRaw(
+    const std::string &filename, int32_t sample_rate, int32_t num_channels,
+    SampleFormat format) {
+  if (!FileExists(filename)) {
+    SHERPA_ONNX_LOGE("Filename '%s' does not exist", filename.c_str());
+    return nullptr;
+  }
+
+  if (sample_rate <= 0 || num_channels <= 0) {
+    SHERPA_ONNX_LOGE("Invalid sample_rate %d or num_channels %d", sample_rate,
+                     num_channels);
+    return nullptr;
+  }
+
+  auto file = std::make_unique<MappedFile>(filename);
+  const char *data = file->Data();
+  int64_t size = file->Size();
+
+  return std::unique_ptr<AudioFileSource>(new AudioFileSource(
+      std::move(file), data, size, sample_rate, num_channels, format));
+}
+
+void AudioFileSource::ReadInterleaved(int32_t k) {
+  buffer_.resize(static_cast<int64_t>(k) * num_channels_);
+  ConvertToFloat(data_ + pos_ * bytes_per_frame_, k * num_channels_, format_,
+                 1, buffer_.data());
+  pos_ += k;
+}
+
+int32_t AudioFileSource::Read(int32_t n,
+                              std::vector<std::vector<float>> *samples) {
+  int32_t k = std::min<int64_t>(n, num_samples_ - pos_);
+  samples->resize(num_channels_);
+
+  if (num_channels_ == 1) {
+    auto &s = (*samples)[0];
+    s.resize(k);
+    ConvertToFloat(data_ + pos_ * bytes_per_frame_, k, format_, 1, s.data());
+    pos_ += k;
+    return k;
+  }
+
+  ReadInterleaved(k);
+
+  for (int32_t c = 0; c != num_channels_; ++c) {
+    auto &s = (*samples)[c];
+    s.resize(k);
+    for (int32_t i = 0; i != k; ++i) {
+      s[i] = buffer_[i * num_channels_ + c];
+    }
+  }
+
+  return k;
+}
+
+int32_t AudioFileSource::Read(int32_t n, std::vector<float> *samples) {
+  int32_t k = std::min<int64_t>(n, num_samples_ - pos_);
+
+  if (num_channels_ == 1) {
+    samples->resize(k);
+    ConvertToFloat(data_ + pos_ * bytes_per_frame_, k, format_, 1,
+                   samples->data());
+    pos_ += k;
+    return k;
+  }
+
+  ReadInterleaved(k);
+
+  samples->resize(k);
+  for (int32_t i = 0; i != k; ++i) {
+    (*samples)[i] = buffer_[i * num_channels_];
+  }
+
+  return k;
+}
+
+}  // namespace sherpa_onnx
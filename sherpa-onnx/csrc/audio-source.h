@@ -0,0 +1,122 @@
+// sherpa-onnx/csrc/audio-source.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_AUDIO_SOURCE_H_
+#define SHERPA_ONNX_CSRC_AUDIO_SOURCE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/mapped-file.h"
+#include "sherpa-onnx/csrc/sample-format.h"
+
+namespace sherpa_onnx {
+
+// Audio that is read block by block, so that a long recording needs not
+// to be converted and kept in memory as a whole.
+class AudioSource {
+ public:
+  virtual ~AudioSource() = default;
+
+  virtual int32_t SampleRate() const = 0;
+
+  virtual int32_t NumChannels() const = 0;
+
+  // Total number of samples per channel
+  virtual int64_t NumSamples() const = 0;
+
+  // Read the next block of at most n samples per channel.
+  //
+  // @param samples On return, (*samples)[c] contains the samples of
+  //                channel c, normalized to the range [-1, 1].
+  // @return Return the number of samples per channel that are read. It
+  //         is 0 at the end of the audio.
+  virtual int32_t Read(int32_t n, std::vector<std::vector<float>> *samples) = 0;
+
+  // Like the above one, but only the first channel is returned.
+  virtual int32_t Read(int32_t n, std::vector<float> *samples) = 0;
+};
+
+// Single channel samples that are already in memory. They are not copied,
+// so they must outlive this object.
+class MemoryAudioSource : public AudioSource {
+ public:
+  MemoryAudioSource(const float *samples, int64_t n, int32_t sample_rate)
+      : samples_(samples), n_(n), sample_rate_(sample_rate) {}
+
+  int32_t SampleRate() const override { return sample_rate_; }
+
+  int32_t NumChannels() const override { return 1; }
+
+  int64_t NumSamples() const override { return n_; }
+
+  int32_t Read(int32_t n, std::vector<std::vector<float>> *samples) override;
+
+  int32_t Read(int32_t n, std::vector<float> *samples) override;
+
+ private:
+  const float *samples_;
+  int64_t n_;
+  int32_t sample_rate_;
+  int64_t pos_ = 0;
+};
+
+// A wave file or a headerless raw file. The file is memory mapped and
+// the samples are converted to float only when they are read.
+//
+// Supported wave files are integer PCM with 8, 16, 24 or 32 bits per
+// sample, 32-bit float, and G.711 mu-law or A-law, including files using
+// WAVE_FORMAT_EXTENSIBLE.
+class AudioFileSource : public AudioSource {
+ public:
+  // @return Return nullptr if the file does not exist or is not a
+  //         supported wave file.
+  static std::unique_ptr<AudioFileSource> CreateFromWave(
+      const std::string &filename);
+
+  // For a file containing only interleaved samples of the given format.
+  //
+  // @return Return nullptr if the file does not exist.
+  static std::unique_ptr<AudioFileSource> CreateFromRaw(
+      const std::string &filename, int32_t sample_rate, int32_t num_channels,
+      SampleFormat format);
+
+  int32_t SampleRate() const override { return sample_rate_; }
+
+  int32_t NumChannels() const override { return num_channels_; }
+
+  int64_t NumSamples() const override { return num_samples_; }
+
+  SampleFormat GetSampleFormat() const { return format_; }
+
+  int32_t Read(int32_t n, std::vector<std::vector<float>> *samples) override;
+
+  int32_t Read(int32_t n, std::vector<float> *samples) override;
+
+ private:
+  AudioFileSource(std::unique_ptr<MappedFile> file, const char *data,
+                  int64_t num_bytes, int32_t sample_rate, int32_t num_channels,
+                  SampleFormat format);
+
+  // Convert the next k samples of all channels, interleaved, into buffer_
+  void ReadInterleaved(int32_t k);
+
+ private:
+  std::unique_ptr<MappedFile> file_;
+  const char *data_;  // start of the samples in file_
+  int32_t sample_rate_;
+  int32_t num_channels_;
+  SampleFormat format_;
+  int32_t bytes_per_frame_;
+
+  int64_t num_samples_;  // per channel
+  int64_t pos_ = 0;      // per channel
+
+  std::vector<float> buffer_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_AUDIO_SOURCE_H_
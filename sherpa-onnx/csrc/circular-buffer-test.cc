@@ -147,4 +147,35 @@ TEST(CircularBuffer, PushAndPop) {
   EXPECT_EQ(c[1], 4000);
 }
 
+TEST(CircularBuffer, View) {
+  CircularBuffer buffer(5);
+  std::vector<float> a = {0, 1, 2, 3};
+  buffer.Push(a.data(), a.size());
+
+  CircularBufferView v = buffer.GetView(1, 3);
+  EXPECT_EQ(v.Size(), 3);
+  EXPECT_EQ(v.Data()[0], 1);
+  EXPECT_EQ(v.Data()[2], 3);
+
+  buffer.Pop(4);
+
+  // It would overwrite the popped elements referred to by v
+  a = {10, 11, 12, 13};
+  buffer.Push(a.data(), a.size());
+  EXPECT_EQ(v.ToVector(), (std::vector<float>{1, 2, 3}));
+  EXPECT_EQ(buffer.Get(4, 4), a);
+
+  // It wraps around, so the elements are copied
+  CircularBufferView w = buffer.GetView(4, 4);
+  EXPECT_EQ(w.ToVector(), a);
+
+  buffer.Reset();
+  a = {20, 21, 22};
+  buffer.Push(a.data(), a.size());
+  EXPECT_EQ(v.ToVector(), (std::vector<float>{1, 2, 3}));
+  EXPECT_EQ(buffer.Get(0, 3), a);
+
+  EXPECT_TRUE(buffer.GetView(0, 0).Empty());
+}
+
 }  // namespace sherpa_onnx
@@ -5,23 +5,78 @@
 #include "sherpa-onnx/csrc/circular-buffer.h"
 
 #include <algorithm>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <set>
+#include <utility>
 #include <vector>
 
 #include "sherpa-onnx/csrc/macros.h"
 
 namespace sherpa_onnx {
 
-CircularBuffer::CircularBuffer(int32_t capacity) {
+struct CircularBuffer::Storage {
+  std::vector<float> buffer;
+
+  // Protects pins. Views may be released from other threads.
+  std::mutex mutex;
+
+  // Linear start indexes of the views referring to this storage
+  std::multiset<int32_t> pins;
+};
+
+// Pin the elements starting at a linear index of a storage while
+// it is alive.
+class CircularBuffer::Pin {
+ public:
+  Pin(std::shared_ptr<Storage> storage, int32_t index)
+      : storage_(std::move(storage)), index_(index) {
+    std::lock_guard<std::mutex> lock(storage_->mutex);
+    storage_->pins.insert(index_);
+  }
+
+  ~Pin() {
+    std::lock_guard<std::mutex> lock(storage_->mutex);
+    storage_->pins.erase(storage_->pins.find(index_));
+  }
+
+  Pin(const Pin &) = delete;
+  Pin &operator=(const Pin &) = delete;
+
+ private:
+  std::shared_ptr<Storage> storage_;
+  int32_t index_;
+};
+
+CircularBuffer::CircularBuffer(int32_t capacity)
+    : storage_(std::make_shared<Storage>()) {
   if (capacity <= 0) {
     SHERPA_ONNX_LOGE("Please specify a positive capacity. Given: %d\n",
                      capacity);
     SHERPA_ONNX_EXIT(-1);
   }
-  buffer_.resize(capacity);
+  storage_->buffer.resize(capacity);
+}
+
+int32_t CircularBuffer::MinPinnedIndex() const {
+  std::lock_guard<std::mutex> lock(storage_->mutex);
+  return storage_->pins.empty() ? tail_ : *storage_->pins.begin();
+}
+
+void CircularBuffer::Reset() {
+  if (MinPinnedIndex() < tail_) {
+    // Positions are reused from 0, so don't touch the pinned elements
+    auto storage = std::make_shared<Storage>();
+    storage->buffer.resize(storage_->buffer.size());
+    storage_ = std::move(storage);
+  }
+
+  head_ = 0;
+  tail_ = 0;
 }
 
 void CircularBuffer::Resize(int32_t new_capacity) {
-  int32_t capacity = static_cast<int32_t>(buffer_.size());
+  int32_t capacity = static_cast<int32_t>(storage_->buffer.size());
   if (new_capacity <= capacity) {
 #if __OHOS__
     SHERPA_ONNX_LOGE(
@@ -34,30 +89,42 @@ void CircularBuffer::Resize(int32_t new_capacity) {
     return;
   }
 
+  Reallocate(new_capacity);
+}
+
+void CircularBuffer::Reallocate(int32_t new_capacity) {
+  // Views may still point into the current storage, so it is never
+  // modified in place.
+  const std::vector<float> &buffer = storage_->buffer;
+  int32_t capacity = static_cast<int32_t>(buffer.size());
   int32_t size = Size();
+
+  auto storage = std::make_shared<Storage>();
+  std::vector<float> &new_buffer = storage->buffer;
+  new_buffer.resize(new_capacity);
+
   if (size == 0) {
-    buffer_.resize(new_capacity);
+    storage_ = std::move(storage);
     return;
   }
 
-  std::vector<float> new_buffer(new_capacity);
   int32_t start = head_ % capacity;
   int32_t dest = head_ % new_capacity;
 
   if (start + size <= capacity) {
     if (dest + size <= new_capacity) {
-      std::copy(buffer_.begin() + start, buffer_.begin() + start + size,
+      std::copy(buffer.begin() + start, buffer.begin() + start + size,
                 new_buffer.begin() + dest);
     } else {
       int32_t part1_size = new_capacity - dest;
 
       // copy [start, start+part1_size] to new_buffer
-      std::copy(buffer_.begin() + start, buffer_.begin() + start + part1_size,
+      std::copy(buffer.begin() + start, buffer.begin() + start + part1_size,
                 new_buffer.begin() + dest);
 
       // copy [start+part1_size, start+size] to new_buffer
-      std::copy(buffer_.begin() + start + part1_size,
-                buffer_.begin() + start + size, new_buffer.begin());
+      std::copy(buffer.begin() + start + part1_size,
+                buffer.begin() + start + size, new_buffer.begin());
     }
   } else {
     int32_t part1_size = capacity - start;
@@ -65,35 +132,35 @@ void CircularBuffer::Resize(int32_t new_capacity) {
 
     // copy [start, start+part1_size] to new_buffer
     if (dest + part1_size <= new_capacity) {
-      std::copy(buffer_.begin() + start, buffer_.begin() + start + part1_size,
+      std::copy(buffer.begin() + start, buffer.begin() + start + part1_size,
                 new_buffer.begin() + dest);
     } else {
       int32_t first_part = new_capacity - dest;
-      std::copy(buffer_.begin() + start, buffer_.begin() + start + first_part,
+      std::copy(buffer.begin() + start, buffer.begin() + start + first_part,
                 new_buffer.begin() + dest);
 
-      std::copy(buffer_.begin() + start + first_part,
-                buffer_.begin() + start + part1_size, new_buffer.begin());
+      std::copy(buffer.begin() + start + first_part,
+                buffer.begin() + start + part1_size, new_buffer.begin());
     }
 
     int32_t new_dest = (dest + part1_size) % new_capacity;
 
     if (new_dest + part2_size <= new_capacity) {
-      std::copy(buffer_.begin(), buffer_.begin() + part2_size,
+      std::copy(buffer.begin(), buffer.begin() + part2_size,
                 new_buffer.begin() + new_dest);
     } else {
       int32_t first_part = new_capacity - new_dest;
-      std::copy(buffer_.begin(), buffer_.begin() + first_part,
+      std::copy(buffer.begin(), buffer.begin() + first_part,
                 new_buffer.begin() + new_dest);
-      std::copy(buffer_.begin() + first_part, buffer_.begin() + part2_size,
+      std::copy(buffer.begin() + first_part, buffer.begin() + part2_size,
                 new_buffer.begin());
     }
   }
-  buffer_.swap(new_buffer);
+  storage_ = std::move(storage);
 }
 
 void CircularBuffer::Push(const float *p, int32_t n) {
-  int32_t capacity = static_cast<int32_t>(buffer_.size());
+  int32_t capacity = static_cast<int32_t>(storage_->buffer.size());
   int32_t size = Size();
   if (n + size > capacity) {
     int32_t new_capacity = std::max(capacity * 2, n + size);
@@ -112,63 +179,100 @@ void CircularBuffer::Push(const float *p, int32_t n) {
     Resize(new_capacity);
 
     capacity = new_capacity;
+  } else if (MinPinnedIndex() < tail_ + n - capacity) {
+    // The new elements would overwrite popped elements that are still
+    // referred to by a view
+    Reallocate(capacity);
   }
 
+  std::vector<float> &buffer = storage_->buffer;
   int32_t start = tail_ % capacity;
 
   tail_ += n;
 
   if (start + n < capacity) {
-    std::copy(p, p + n, buffer_.begin() + start);
+    std::copy(p, p + n, buffer.begin() + start);
     return;
   }
 
   int32_t part1_size = capacity - start;
 
-  std::copy(p, p + part1_size, buffer_.begin() + start);
+  std::copy(p, p + part1_size, buffer.begin() + start);
 
-  std::copy(p + part1_size, p + n, buffer_.begin());
+  std::copy(p + part1_size, p + n, buffer.begin());
 }
 
-std::vector<float> CircularBuffer::Get(int32_t start_index, int32_t n) const {
+bool CircularBuffer::Validate(int32_t start_index, int32_t n) const {
   if (start_index < head_ || start_index >= tail_) {
     SHERPA_ONNX_LOGE("Invalid start_index: %d. head_: %d, tail_: %d",
                      start_index, head_, tail_);
-    return {};
+    return false;
   }
 
   int32_t size = Size();
   if (n < 0 || n > size) {
     SHERPA_ONNX_LOGE("Invalid n: %d. size: %d", n, size);
-    return {};
+    return false;
   }
 
-  int32_t capacity = static_cast<int32_t>(buffer_.size());
-
   if (start_index - head_ + n > size) {
     SHERPA_ONNX_LOGE("Invalid start_index: %d and n: %d. head_: %d, size: %d",
                      start_index, n, head_, size);
+    return false;
+  }
+
+  return true;
+}
+
+std::vector<float> CircularBuffer::Get(int32_t start_index, int32_t n) const {
+  if (!Validate(start_index, n)) {
     return {};
   }
 
+  const std::vector<float> &buffer = storage_->buffer;
+  int32_t capacity = static_cast<int32_t>(buffer.size());
+
   int32_t start = start_index % capacity;
 
   if (start + n < capacity) {
-    return {buffer_.begin() + start, buffer_.begin() + start + n};
+    return {buffer.begin() + start, buffer.begin() + start + n};
   }
 
   std::vector<float> ans(n);
 
-  std::copy(buffer_.begin() + start, buffer_.end(), ans.begin());
+  std::copy(buffer.begin() + start, buffer.end(), ans.begin());
 
   int32_t part1_size = capacity - start;
   int32_t part2_size = n - part1_size;
-  std::copy(buffer_.begin(), buffer_.begin() + part2_size,
+  std::copy(buffer.begin(), buffer.begin() + part2_size,
             ans.begin() + part1_size);
 
   return ans;
 }
 
+CircularBufferView CircularBuffer::GetView(int32_t start_index,
+                                           int32_t n) const {
+  CircularBufferView ans;
+  if (n == 0 || !Validate(start_index, n)) {
+    return ans;
+  }
+
+  int32_t capacity = static_cast<int32_t>(storage_->buffer.size());
+  int32_t start = start_index % capacity;
+
+  if (start + n <= capacity) {
+    ans.data_ = storage_->buffer.data() + start;
+    ans.holder_ = std::make_shared<Pin>(storage_, start_index);
+  } else {
+    auto v = std::make_shared<std::vector<float>>(Get(start_index, n));
+    ans.data_ = v->data();
+    ans.holder_ = std::move(v);
+  }
+  ans.size_ = n;
+
+  return ans;
+}
+
 void CircularBuffer::Pop(int32_t n) {
   int32_t size = Size();
   if (n < 0 || n > size) {
@@ -5,10 +5,39 @@
 #define SHERPA_ONNX_CSRC_CIRCULAR_BUFFER_H_
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace sherpa_onnx {
 
+// A read-only view of consecutive elements of a CircularBuffer.
+//
+// While a view (or any copy of it) is alive, the elements it refers to
+// are pinned: the buffer never overwrites them, even after they are
+// popped. If the buffer needs the space, it moves its content to new
+// storage and the old storage is kept alive by the views.
+class CircularBufferView {
+ public:
+  CircularBufferView() = default;
+
+  const float *Data() const { return data_; }
+
+  int32_t Size() const { return size_; }
+
+  bool Empty() const { return size_ == 0; }
+
+  std::vector<float> ToVector() const { return {data_, data_ + size_}; }
+
+ private:
+  friend class CircularBuffer;
+
+  const float *data_ = nullptr;
+  int32_t size_ = 0;
+
+  // Keeps the pinned storage, or a copy of the elements, alive
+  std::shared_ptr<const void> holder_;
+};
+
 class CircularBuffer {
  public:
   // Capacity of this buffer. Should be large enough.
@@ -28,6 +57,12 @@ class CircularBuffer {
   // @return Return a vector of size n containing the requested elements
   std::vector<float> Get(int32_t start_index, int32_t n) const;
 
+  // Like Get(), but no elements are copied unless the requested range
+  // wraps around the end of the underlying storage.
+  //
+  // The view stays valid after the elements are popped.
+  CircularBufferView GetView(int32_t start_index, int32_t n) const;
+
   // Remove n elements from the buffer
   //
   // @param n Should be in the range [0, size_]
@@ -42,15 +77,26 @@ class CircularBuffer {
   // Current position of the tail
   int32_t Tail() const { return tail_; }
 
-  void Reset() {
-    head_ = 0;
-    tail_ = 0;
-  }
+  void Reset();
 
   void Resize(int32_t new_capacity);
 
  private:
-  std::vector<float> buffer_;
+  struct Storage;
+  class Pin;
+
+  // Move the elements to a new storage of the given capacity. The old
+  // storage is released once no views refer to it.
+  void Reallocate(int32_t new_capacity);
+
+  // Smallest linear index pinned by a view of the current storage;
+  // tail_ if there is none.
+  int32_t MinPinnedIndex() const;
+
+  bool Validate(int32_t start_index, int32_t n) const;
+
+ private:
+  std::shared_ptr<Storage> storage_;
 
   int32_t head_ = 0;  // linear index; always increasing; never wraps around
   int32_t tail_ = 0;  // linear index, always increasing; never wraps around.
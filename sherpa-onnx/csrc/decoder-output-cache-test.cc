@@ -0,0 +1,238 @@
+// sherpa-onnx/csrc/decoder-output-cache-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/decoder-output-cache.h"
+
+#include <array>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+// It returns a (N, 3) tensor whose row i is {c, c + 1, c + 2}, where
+// c = 10 * contexts[i][0] + contexts[i][1], and records its inputs
+class FakeDecoder {
+ public:
+  explicit FakeDecoder(OrtAllocator *allocator) : allocator_(allocator) {}
+
+  Ort::Value operator()(Ort::Value decoder_input) {
+    auto shape = decoder_input.GetTensorTypeAndShapeInfo().GetShape();
+    EXPECT_EQ(shape.size(), 2);
+    EXPECT_EQ(shape[1], 2);
+
+    const int64_t *p = decoder_input.GetTensorData<int64_t>();
+    num_calls += 1;
+    inputs.emplace_back(p, p + shape[0] * shape[1]);
+
+    std::array<int64_t, 2> out_shape{shape[0], 3};
+    Ort::Value ans = Ort::Value::CreateTensor<float>(
+        allocator_, out_shape.data(), out_shape.size());
+    float *out = ans.GetTensorMutableData<float>();
+    for (int64_t i = 0; i != shape[0]; ++i) {
+      float c = 10 * p[2 * i] + p[2 * i + 1];
+      for (int32_t k = 0; k != 3; ++k) {
+        out[i * 3 + k] = c + k;
+      }
+    }
+
+    last_output = out;
+    return ans;
+  }
+
+  int32_t num_calls = 0;
+  std::vector<std::vector<int64_t>> inputs;
+  const float *last_output = nullptr;
+
+ private:
+  OrtAllocator *allocator_;
+};
+
+static Ort::Value RunCache(DecoderOutputCache *cache,
+                           const std::vector<int64_t> &contexts,
+                           OrtAllocator *allocator, FakeDecoder *decoder) {
+  return cache->Run(contexts.data(), contexts.size() / 2, 2, allocator,
+                    [decoder](Ort::Value decoder_input) {
+                      return (*decoder)(std::move(decoder_input));
+                    });
+}
+
+// Check that row i of out is the decoder output of contexts[i]
+static void CheckOutput(const Ort::Value &out,
+                        const std::vector<int64_t> &contexts) {
+  int32_t n = contexts.size() / 2;
+  auto shape = out.GetTensorTypeAndShapeInfo().GetShape();
+  ASSERT_EQ(shape.size(), 2);
+  ASSERT_EQ(shape[0], n);
+  ASSERT_EQ(shape[1], 3);
+
+  const float *p = out.GetTensorData<float>();
+  for (int32_t i = 0; i != n; ++i) {
+    float c = 10 * contexts[2 * i] + contexts[2 * i + 1];
+    for (int32_t k = 0; k != 3; ++k) {
+      EXPECT_EQ(p[i * 3 + k], c + k) << "row " << i;
+    }
+  }
+}
+
+TEST(DecoderOutputCache, LookupAndInsert) {
+  DecoderOutputCache cache;
+
+  std::vector<int64_t> context = {0, 5};
+  std::vector<float> output = {1, 2, 3};
+  std::vector<float> out(3);
+
+  EXPECT_FALSE(cache.Lookup(context.data(), 2, 3, out.data()));
+
+  cache.Insert(context.data(), 2, 3, output.data());
+  EXPECT_EQ(cache.Size(), 1);
+
+  EXPECT_TRUE(cache.Lookup(context.data(), 2, 3, out.data()));
+  EXPECT_EQ(out, output);
+
+  // A different dim is treated as a miss
+  EXPECT_FALSE(cache.Lookup(context.data(), 2, 4, out.data()));
+
+  std::vector<int64_t> other = {5, 0};
+  EXPECT_FALSE(cache.Lookup(other.data(), 2, 3, out.data()));
+
+  cache.Clear();
+  EXPECT_EQ(cache.Size(), 0);
+  EXPECT_FALSE(cache.Lookup(context.data(), 2, 3, out.data()));
+}
+
+TEST(DecoderOutputCache, LongContext) {
+  DecoderOutputCache cache;
+
+  std::vector<int64_t> context(DecoderOutputCache::kMaxContextSize + 1, 1);
+  float output = 1;
+
+  cache.Insert(context.data(), context.size(), 1, &output);
+  EXPECT_EQ(cache.Size(), 0);
+  EXPECT_FALSE(cache.Lookup(context.data(), context.size(), 1, &output));
+}
+
+TEST(DecoderOutputCache, Capacity) {
+  DecoderOutputCache disabled(0);
+  int64_t context = 1;
+  float output = 1;
+  disabled.Insert(&context, 1, 1, &output);
+  EXPECT_EQ(disabled.Size(), 0);
+
+  DecoderOutputCache cache(64);
+  for (int64_t i = 0; i != 1000; ++i) {
+    float f = i;
+    cache.Insert(&i, 1, 1, &f);
+    EXPECT_LE(cache.Size(), 64);
+  }
+
+  // Entries that are kept have the right values
+  for (int64_t i = 0; i != 1000; ++i) {
+    float f = -1;
+    if (cache.Lookup(&i, 1, 1, &f)) {
+      EXPECT_EQ(f, i);
+    }
+  }
+}
+
+TEST(DecoderOutputCache, SetCapacity) {
+  DecoderOutputCache cache;
+  int64_t context = 1;
+  float output = 1;
+  cache.Insert(&context, 1, 1, &output);
+  EXPECT_EQ(cache.Size(), 1);
+
+  cache.SetCapacity(0);
+  EXPECT_EQ(cache.Size(), 0);
+  cache.Insert(&context, 1, 1, &output);
+  EXPECT_EQ(cache.Size(), 0);
+  EXPECT_FALSE(cache.Lookup(&context, 1, 1, &output));
+
+  cache.SetCapacity(16);
+  cache.Insert(&context, 1, 1, &output);
+  EXPECT_EQ(cache.Size(), 1);
+}
+
+TEST(DecoderOutputCache, RunAllMissed) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  DecoderOutputCache cache;
+  FakeDecoder decoder(allocator);
+
+  std::vector<int64_t> contexts = {0, 1, 2, 3, 4, 5};
+  Ort::Value out = RunCache(&cache, contexts, allocator, &decoder);
+
+  EXPECT_EQ(decoder.num_calls, 1);
+  EXPECT_EQ(decoder.inputs[0], contexts);
+
+  // The output of the decoder is returned without a copy
+  EXPECT_EQ(out.GetTensorData<float>(), decoder.last_output);
+  CheckOutput(out, contexts);
+
+  EXPECT_EQ(cache.Size(), 3);
+  EXPECT_EQ(cache.NumHits(), 0);
+  EXPECT_EQ(cache.NumMisses(), 3);
+}
+
+TEST(DecoderOutputCache, RunDuplicates) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  DecoderOutputCache cache;
+  FakeDecoder decoder(allocator);
+
+  // The same context appears several times in a batch, e.g., the initial
+  // context of all streams
+  std::vector<int64_t> contexts = {0, 0, 1, 2, 0, 0, 1, 2, 0, 0};
+  Ort::Value out = RunCache(&cache, contexts, allocator, &decoder);
+
+  // Each distinct context is computed only once
+  EXPECT_EQ(decoder.num_calls, 1);
+  EXPECT_EQ(decoder.inputs[0], (std::vector<int64_t>{0, 0, 1, 2}));
+  CheckOutput(out, contexts);
+
+  EXPECT_EQ(cache.NumHits(), 3);
+  EXPECT_EQ(cache.NumMisses(), 2);
+}
+
+TEST(DecoderOutputCache, RunHitsAndMisses) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  DecoderOutputCache cache;
+  FakeDecoder decoder(allocator);
+
+  std::vector<int64_t> contexts = {1, 2, 3, 4};
+  RunCache(&cache, contexts, allocator, &decoder);
+
+  // Hits and misses are interleaved, and they are reassembled in the
+  // input order
+  contexts = {5, 6, 3, 4, 7, 8, 1, 2, 5, 6};
+  Ort::Value out = RunCache(&cache, contexts, allocator, &decoder);
+
+  EXPECT_EQ(decoder.num_calls, 2);
+  EXPECT_EQ(decoder.inputs[1], (std::vector<int64_t>{5, 6, 7, 8}));
+  CheckOutput(out, contexts);
+
+  // All of them are cached now
+  Ort::Value again = RunCache(&cache, contexts, allocator, &decoder);
+  EXPECT_EQ(decoder.num_calls, 2);
+  CheckOutput(again, contexts);
+
+  EXPECT_EQ(cache.Size(), 4);
+}
+
+TEST(DecoderOutputCache, RunDisabled) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  DecoderOutputCache cache(0);
+  FakeDecoder decoder(allocator);
+
+  std::vector<int64_t> contexts = {1, 2, 1, 2};
+  RunCache(&cache, contexts, allocator, &decoder);
+  Ort::Value out = RunCache(&cache, contexts, allocator, &decoder);
+
+  // Every call runs the decoder on the whole batch
+  EXPECT_EQ(decoder.num_calls, 2);
+  EXPECT_EQ(decoder.inputs[1], contexts);
+  CheckOutput(out, contexts);
+  EXPECT_EQ(cache.Size(), 0);
+}
+
+}  // namespace sherpa_onnx
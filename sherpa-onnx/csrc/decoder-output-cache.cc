@@ -0,0 +1,204 @@
+// sherpa-onnx/csrc/decoder-output-cache.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/decoder-output-cache.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sherpa_onnx {
+
+static Ort::Value BuildDecoderInput(const int64_t *contexts,
+                                    int32_t batch_size, int32_t context_size,
+                                    OrtAllocator *allocator) {
+  std::array<int64_t, 2> shape{batch_size, context_size};
+  Ort::Value ans = Ort::Value::CreateTensor<int64_t>(allocator, shape.data(),
+                                                     shape.size());
+  std::copy(contexts, contexts + batch_size * context_size,
+            ans.GetTensorMutableData<int64_t>());
+  return ans;
+}
+
+DecoderOutputCache::DecoderOutputCache(int32_t capacity)
+    : shard_capacity_(ShardCapacity(capacity)) {}
+
+DecoderOutputCache::Key DecoderOutputCache::MakeKey(const int64_t *context,
+                                                    int32_t context_size) {
+  Key ans;
+  std::copy(context, context + context_size, ans.tokens.begin());
+  return ans;
+}
+
+bool DecoderOutputCache::Lookup(const int64_t *context, int32_t context_size,
+                                int32_t dim, float *out) {
+  if (shard_capacity_ == 0 || context_size > kMaxContextSize) {
+    return false;
+  }
+
+  Key key = MakeKey(context, context_size);
+  Shard &shard = GetShard(key);
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.outputs.find(key);
+  if (it == shard.outputs.end() ||
+      static_cast<int32_t>(it->second.size()) != dim) {
+    return false;
+  }
+
+  std::copy(it->second.begin(), it->second.end(), out);
+  return true;
+}
+
+void DecoderOutputCache::Insert(const int64_t *context, int32_t context_size,
+                                int32_t dim, const float *output) {
+  if (shard_capacity_ == 0 || context_size > kMaxContextSize) {
+    return;
+  }
+
+  Key key = MakeKey(context, context_size);
+  Shard &shard = GetShard(key);
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  if (static_cast<int32_t>(shard.outputs.size()) >= shard_capacity_ &&
+      !shard.outputs.count(key)) {
+    shard.outputs.clear();
+  }
+
+  shard.outputs[key].assign(output, output + dim);
+}
+
+void DecoderOutputCache::Clear() {
+  for (auto &shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.outputs.clear();
+  }
+}
+
+void DecoderOutputCache::SetCapacity(int32_t capacity) {
+  shard_capacity_ = ShardCapacity(capacity);
+  Clear();
+}
+
+int32_t DecoderOutputCache::Size() const {
+  int32_t ans = 0;
+  for (const auto &shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    ans += shard.outputs.size();
+  }
+  return ans;
+}
+
+std::string DecoderOutputCache::ToString() const {
+  std::ostringstream os;
+
+  os << "DecoderOutputCache(";
+  os << "capacity=" << shard_capacity_ * kNumShards << ", ";
+  os << "size=" << Size() << ", ";
+  os << "num_hits=" << NumHits() << ", ";
+  os << "num_misses=" << NumMisses() << ", ";
+  os << "hit_rate=" << HitRate() << ")";
+
+  return os.str();
+}
+
+std::vector<int64_t> DecoderOutputCache::OutputShape() const {
+  std::lock_guard<std::mutex> lock(shape_mutex_);
+  return shape_;
+}
+
+Ort::Value DecoderOutputCache::Run(
+    const int64_t *contexts, int32_t batch_size, int32_t context_size,
+    OrtAllocator *allocator,
+    const std::function<Ort::Value(Ort::Value)> &run_decoder) {
+  if (shard_capacity_ == 0 || context_size > kMaxContextSize) {
+    return run_decoder(
+        BuildDecoderInput(contexts, batch_size, context_size, allocator));
+  }
+
+  std::vector<int64_t> shape = OutputShape();
+  int32_t dim = 0;
+  if (!shape.empty()) {
+    dim = 1;
+    for (size_t i = 1; i < shape.size(); ++i) {
+      dim *= shape[i];
+    }
+  }
+
+  std::vector<float> cached(static_cast<int64_t>(batch_size) * dim);
+
+  // row[i] is -1 if the output of contexts[i] is in cached. Otherwise, it
+  // is the row of contexts[i] in the output of run_decoder()
+  std::vector<int32_t> row(batch_size, -1);
+  std::vector<int64_t> missed;
+  std::unordered_map<Key, int32_t, KeyHash> missed_rows;
+  int32_t num_missed = 0;
+
+  for (int32_t i = 0; i != batch_size; ++i) {
+    const int64_t *c = contexts + i * context_size;
+    if (dim > 0 && Lookup(c, context_size, dim, cached.data() + i * dim)) {
+      continue;
+    }
+
+    auto p = missed_rows.emplace(MakeKey(c, context_size), num_missed);
+    row[i] = p.first->second;
+    if (p.second) {
+      missed.insert(missed.end(), c, c + context_size);
+      ++num_missed;
+    }
+  }
+
+  num_hits_ += batch_size - num_missed;
+  num_misses_ += num_missed;
+
+  Ort::Value computed{nullptr};
+  const float *p_computed = nullptr;
+
+  if (num_missed > 0) {
+    computed = run_decoder(BuildDecoderInput(missed.data(), num_missed,
+                                             context_size, allocator));
+
+    shape = computed.GetTensorTypeAndShapeInfo().GetShape();
+    dim = 1;
+    for (size_t i = 1; i < shape.size(); ++i) {
+      dim *= shape[i];
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(shape_mutex_);
+      if (shape_.empty()) {
+        shape_ = shape;
+        shape_[0] = 1;
+      }
+    }
+
+    p_computed = computed.GetTensorData<float>();
+    for (int32_t i = 0; i != num_missed; ++i) {
+      Insert(missed.data() + i * context_size, context_size, dim,
+             p_computed + i * dim);
+    }
+
+    if (num_missed == batch_size) {
+      // Nothing is cached and all contexts are different
+      return computed;
+    }
+  }
+
+  shape[0] = batch_size;
+  Ort::Value ans =
+      Ort::Value::CreateTensor<float>(allocator, shape.data(), shape.size());
+  float *p = ans.GetTensorMutableData<float>();
+
+  for (int32_t i = 0; i != batch_size; ++i, p += dim) {
+    const float *src =
+        row[i] == -1 ? cached.data() + i * dim : p_computed + row[i] * dim;
+    std::copy(src, src + dim, p);
+  }
+
+  return ans;
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,136 @@
+// sherpa-onnx/csrc/decoder-output-cache.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_DECODER_OUTPUT_CACHE_H_
+#define SHERPA_ONNX_CSRC_DECODER_OUTPUT_CACHE_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "onnxruntime_cxx_api.h"  // NOLINT
+
+namespace sherpa_onnx {
+
+// The decoder (prediction network) of a stateless transducer sees only the
+// last context_size tokens, so its output is a function of them. This class
+// caches the output for each context, so the decoder model runs only on
+// contexts it has not seen before.
+//
+// It is thread-safe. A model owns one cache, which is shared by all streams
+// and threads using the model.
+class DecoderOutputCache {
+ public:
+  // Contexts longer than this are not cached
+  static constexpr int32_t kMaxContextSize = 4;
+
+  // @param capacity Maximum number of cached contexts. 0 disables the cache.
+  //                 Entries are spread over a few shards; when a shard is
+  //                 full, it is emptied.
+  explicit DecoderOutputCache(int32_t capacity = 8192);
+
+  DecoderOutputCache(const DecoderOutputCache &) = delete;
+  DecoderOutputCache &operator=(const DecoderOutputCache &) = delete;
+
+  /* Run the decoder on a batch of contexts, skipping the cached ones.
+   *
+   * @param contexts A row-major array of shape (batch_size, context_size).
+   * @param run_decoder Run the decoder model on an int64 tensor of shape
+   *                    (N, context_size) and return a tensor whose first
+   *                    dimension is N.
+   * @return Return the same as run_decoder() would return for all contexts.
+   */
+  Ort::Value Run(const int64_t *contexts, int32_t batch_size,
+                 int32_t context_size, OrtAllocator *allocator,
+                 const std::function<Ort::Value(Ort::Value)> &run_decoder);
+
+  // If the output of the context is cached, copy its dim floats to out
+  // and return true. Otherwise, return false.
+  bool Lookup(const int64_t *context, int32_t context_size, int32_t dim,
+              float *out);
+
+  void Insert(const int64_t *context, int32_t context_size, int32_t dim,
+              const float *output);
+
+  void Clear();
+
+  // Change the capacity and clear the cache. 0 disables the cache. It must
+  // not be called while other threads are using the cache.
+  void SetCapacity(int32_t capacity);
+
+  int32_t Size() const;
+
+  // Number of decoder outputs taken from the cache, including repeated
+  // contexts inside a batch
+  int64_t NumHits() const { return num_hits_; }
+
+  // Number of decoder outputs computed by the model
+  int64_t NumMisses() const { return num_misses_; }
+
+  float HitRate() const {
+    int64_t total = NumHits() + NumMisses();
+    return total ? static_cast<float>(NumHits()) / total : 0;
+  }
+
+  // Size and hit statistics, for debug logs
+  std::string ToString() const;
+
+ private:
+  struct Key {
+    std::array<int64_t, kMaxContextSize> tokens{};
+
+    bool operator==(const Key &other) const { return tokens == other.tokens; }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key &k) const {
+      uint64_t h = 14695981039346656037ull;
+      for (auto t : k.tokens) {
+        h = (h ^ static_cast<uint64_t>(t)) * 1099511628211ull;
+      }
+      return h;
+    }
+  };
+
+  struct Shard {
+    mutable std::mutex mutex;
+    std::unordered_map<Key, std::vector<float>, KeyHash> outputs;
+  };
+
+  static constexpr int32_t kNumShards = 16;
+
+  static Key MakeKey(const int64_t *context, int32_t context_size);
+
+  static int32_t ShardCapacity(int32_t capacity) {
+    return capacity > 0 ? std::max(capacity / kNumShards, 1) : 0;
+  }
+
+  Shard &GetShard(const Key &key) {
+    return shards_[KeyHash()(key) % kNumShards];
+  }
+
+  // Return an empty vector if no output has been cached yet
+  std::vector<int64_t> OutputShape() const;
+
+ private:
+  int32_t shard_capacity_;
+  std::array<Shard, kNumShards> shards_;
+
+  // Shape of the decoder output of a single context, with the batch
+  // dimension set to 1
+  mutable std::mutex shape_mutex_;
+  std::vector<int64_t> shape_;
+
+  std::atomic<int64_t> num_hits_{0};
+  std::atomic<int64_t> num_misses_{0};
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_DECODER_OUTPUT_CACHE_H_
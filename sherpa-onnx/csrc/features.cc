@@ -82,6 +82,29 @@ class FeatureExtractor::Impl {
     }
   }
 
+  void AcceptWaveform(int32_t sampling_rate, const void *waveform, int32_t n,
+                      SampleFormat format) {
+    if (CanReadAsFloat(waveform, format)) {
+      AcceptWaveform(sampling_rate, static_cast<const float *>(waveform), n);
+      return;
+    }
+
+    // Scaling for normalize_samples == false is done during the conversion
+    float scale = config_.normalize_samples ? 1 : 32768;
+
+    const uint8_t *p = static_cast<const uint8_t *>(waveform);
+    int32_t bytes_per_sample = BytesPerSample(format);
+
+    constexpr int32_t kBlockSize = 4096;
+    std::vector<float> buf(std::min(n, kBlockSize));
+
+    for (int32_t i = 0; i < n; i += kBlockSize) {
+      int32_t k = std::min(n - i, kBlockSize);
+      ConvertToFloat(p + i * bytes_per_sample, k, format, scale, buf.data());
+      AcceptWaveformImpl(sampling_rate, buf.data(), k);
+    }
+  }
+
   void AcceptWaveformImpl(int32_t sampling_rate, const float *waveform,
                           int32_t n) {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -130,6 +153,29 @@ class FeatureExtractor::Impl {
     AcceptWaveformWrapper(sampling_rate, waveform, n);
   }
 
+  void Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // The options are kept, so we don't need to compute them again
+    if (fbank_) {
+      fbank_ = std::make_unique<knf::OnlineFbank>(opts_);
+    } else if (mfcc_) {
+      mfcc_ = std::make_unique<knf::OnlineMfcc>(mfcc_opts_);
+    } else if (whisper_fbank_) {
+      knf::WhisperFeatureOptions whisper_opts;
+      whisper_opts.frame_opts = opts_.frame_opts;
+      whisper_opts.dim = config_.feature_dim;
+      whisper_fbank_ = std::make_unique<knf::OnlineWhisperFbank>(whisper_opts);
+    } else if (raw_audio_) {
+      raw_audio_ =
+          std::make_unique<knf::OnlineRawAudioSamples>(opts_raw_audio_);
+    }
+
+    // The next input may have a different sample rate
+    resampler_.reset();
+    last_frame_index_ = 0;
+  }
+
   void InputFinished() const {
     std::lock_guard<std::mutex> lock(mutex_);
     if (fbank_) {
@@ -182,7 +228,7 @@ class FeatureExtractor::Impl {
     return false;
   }
 
-  std::vector<float> GetFrames(int32_t frame_index, int32_t n) {
+  void GetFrames(int32_t frame_index, int32_t n, float *features) {
     std::lock_guard<std::mutex> lock(mutex_);
     if (frame_index + n > NumFramesReady()) {
       SHERPA_ONNX_LOGE("%d + %d > %d\n", frame_index, n, NumFramesReady());
@@ -199,9 +245,7 @@ class FeatureExtractor::Impl {
     PopWrapper(discard_num);
 
     int32_t feature_dim = FeatureDim();
-    std::vector<float> features(feature_dim * n);
-
-    float *p = features.data();
+    float *p = features;
 
     for (int32_t i = 0; i != n; ++i) {
       const float *f = GetFrameWrapper(i + frame_index);
@@ -210,8 +254,6 @@ class FeatureExtractor::Impl {
     }
 
     last_frame_index_ = frame_index;
-
-    return features;
   }
 
   int32_t FeatureDim() const {
@@ -374,6 +416,12 @@ void FeatureExtractor::AcceptWaveform(int32_t sampling_rate,
   impl_->AcceptWaveform(sampling_rate, waveform, n);
 }
 
+void FeatureExtractor::AcceptWaveform(int32_t sampling_rate,
+                                      const void *waveform, int32_t n,
+                                      SampleFormat format) const {
+  impl_->AcceptWaveform(sampling_rate, waveform, n, format);
+}
+
 void FeatureExtractor::InputFinished() const { impl_->InputFinished(); }
 
 int32_t FeatureExtractor::NumFramesReady() const {
@@ -386,9 +434,18 @@ bool FeatureExtractor::IsLastFrame(int32_t frame) const {
 
 std::vector<float> FeatureExtractor::GetFrames(int32_t frame_index,
                                                int32_t n) const {
-  return impl_->GetFrames(frame_index, n);
+  std::vector<float> features(n * FeatureDim());
+  impl_->GetFrames(frame_index, n, features.data());
+  return features;
+}
+
+void FeatureExtractor::GetFrames(int32_t frame_index, int32_t n,
+                                 float *features) const {
+  impl_->GetFrames(frame_index, n, features);
 }
 
 int32_t FeatureExtractor::FeatureDim() const { return impl_->FeatureDim(); }
 
+void FeatureExtractor::Reset() { impl_->Reset(); }
+
 }  // namespace sherpa_onnx
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/sample-format.h"
 
 namespace sherpa_onnx {
 
@@ -106,6 +107,17 @@ class FeatureExtractor {
   void AcceptWaveform(int32_t sampling_rate, const float *waveform,
                       int32_t n) const;
 
+  /**
+     Like the above one, but the samples are in the given format, e.g.,
+     16-bit PCM or G.711 mu-law from telephony. They are converted to float
+     block by block, so the caller needs not to allocate a float copy.
+
+     @param waveform Pointer to n samples, i.e., n * BytesPerSample(format)
+                     bytes.
+   */
+  void AcceptWaveform(int32_t sampling_rate, const void *waveform, int32_t n,
+                      SampleFormat format) const;
+
   /**
    * InputFinished() tells the class you won't be providing any
    * more waveform.  This will help flush out the last frame or two
@@ -130,9 +142,20 @@ class FeatureExtractor {
    */
   std::vector<float> GetFrames(int32_t frame_index, int32_t n) const;
 
+  /** Like the above one, but write the frames to the given buffer, e.g.,
+   * a row of a batched input tensor, instead of allocating a new vector.
+   *
+   * @param features  Output array of n * FeatureDim() floats.
+   */
+  void GetFrames(int32_t frame_index, int32_t n, float *features) const;
+
   /// Return feature dim of this extractor
   int32_t FeatureDim() const;
 
+  /// Discard all samples and frames so that it can be used for new audio.
+  /// It is cheaper than creating a new extractor.
+  void Reset();
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
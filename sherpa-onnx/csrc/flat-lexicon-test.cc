@@ -0,0 +1,76 @@
+// sherpa-onnx/csrc/flat-lexicon-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/flat-lexicon.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(FlatLexicon, WriteAndRead) {
+  FlatLexiconBuilder builder;
+  EXPECT_TRUE(builder.Add("hello", {1, 2, 3}));
+  EXPECT_TRUE(builder.Add("你好", {4, 5}));
+  EXPECT_TRUE(builder.Add("a", {6}));
+  EXPECT_TRUE(builder.Add("empty", {}));
+  EXPECT_FALSE(builder.Add("hello", {7}));
+
+  // An entry without IDs is replaced by a later one with IDs
+  EXPECT_TRUE(builder.Add("replaced", {}));
+  EXPECT_TRUE(builder.Add("replaced", {8, 9}));
+  EXPECT_FALSE(builder.Add("replaced", {}));
+
+  std::string filename = "flat-lexicon-test.bin";
+  ASSERT_TRUE(builder.Write(filename));
+  EXPECT_TRUE(FlatLexicon::IsFlatLexicon(filename));
+
+  {
+    FlatLexicon lexicon(filename);
+    EXPECT_EQ(lexicon.NumWords(), 5);
+
+    std::vector<int32_t> ids;
+    EXPECT_TRUE(lexicon.GetIds("hello", &ids));
+    EXPECT_EQ(ids, (std::vector<int32_t>{1, 2, 3}));
+
+    EXPECT_TRUE(lexicon.GetIds("你好", &ids));
+    EXPECT_EQ(ids, (std::vector<int32_t>{4, 5}));
+
+    EXPECT_TRUE(lexicon.GetIds("a", &ids));
+    EXPECT_EQ(ids, (std::vector<int32_t>{6}));
+
+    EXPECT_TRUE(lexicon.GetIds("empty", &ids));
+    EXPECT_TRUE(ids.empty());
+
+    EXPECT_TRUE(lexicon.GetIds("replaced", &ids));
+    EXPECT_EQ(ids, (std::vector<int32_t>{8, 9}));
+
+    EXPECT_FALSE(lexicon.Contains(""));
+    EXPECT_FALSE(lexicon.Contains("hell"));
+    EXPECT_FALSE(lexicon.Contains("hello!"));
+    EXPECT_FALSE(lexicon.Contains("b"));
+  }
+
+  std::remove(filename.c_str());
+}
+
+TEST(FlatLexicon, Empty) {
+  FlatLexiconBuilder builder;
+
+  std::string filename = "flat-lexicon-test-empty.bin";
+  ASSERT_TRUE(builder.Write(filename));
+
+  {
+    FlatLexicon lexicon(filename);
+    EXPECT_EQ(lexicon.NumWords(), 0);
+    EXPECT_FALSE(lexicon.Contains("a"));
+  }
+
+  std::remove(filename.c_str());
+}
+
+}  // namespace sherpa_onnx
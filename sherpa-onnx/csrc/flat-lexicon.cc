@@ -0,0 +1,194 @@
+// sherpa-onnx/csrc/flat-lexicon.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/flat-lexicon.h"
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+static_assert(sizeof(FlatLexiconHeader) == 32, "");
+
+static constexpr char kFlatLexiconMagic[8] = {'S', 'O', 'L', 'E',
+                                              'X', 'I', 'C', '1'};
+static constexpr int32_t kFlatLexiconVersion = 1;
+
+static size_t RoundUpTo4(size_t n) { return (n + 3) / 4 * 4; }
+
+bool FlatLexicon::IsFlatLexicon(const std::string &filename) {
+  std::ifstream is(filename, std::ios::binary);
+  char magic[sizeof(kFlatLexiconMagic)];
+  if (!is.read(magic, sizeof(magic))) {
+    return false;
+  }
+
+  return IsFlatLexicon(magic, sizeof(magic));
+}
+
+bool FlatLexicon::IsFlatLexicon(const char *data, size_t size) {
+  return size >= sizeof(kFlatLexiconMagic) &&
+         std::memcmp(data, kFlatLexiconMagic, sizeof(kFlatLexiconMagic)) == 0;
+}
+
+FlatLexicon::FlatLexicon(const std::string &filename)
+    : file_(std::make_unique<MappedFile>(filename)) {
+  Init(file_->Data(), file_->Size());
+}
+
+FlatLexicon::FlatLexicon(std::vector<char> buffer)
+    : buffer_(std::move(buffer)) {
+  Init(buffer_.data(), buffer_.size());
+}
+
+void FlatLexicon::Init(const char *p, size_t size) {
+  if (size < sizeof(FlatLexiconHeader) || !IsFlatLexicon(p, size)) {
+    SHERPA_ONNX_LOGE("Not a flat lexicon");
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  header_ = reinterpret_cast<const FlatLexiconHeader *>(p);
+  if (header_->version != kFlatLexiconVersion) {
+    SHERPA_ONNX_LOGE("Unsupported version %d of flat lexicon",
+                     header_->version);
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  if (header_->num_words < 0) {
+    SHERPA_ONNX_LOGE("Invalid number of words %d in flat lexicon",
+                     header_->num_words);
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  size_t num_offsets = static_cast<size_t>(header_->num_words) + 1;
+  size_t expected_size = sizeof(FlatLexiconHeader) +
+                         2 * num_offsets * sizeof(uint32_t) +
+                         RoundUpTo4(header_->pool_size) +
+                         static_cast<size_t>(header_->num_ids) * sizeof(int32_t);
+
+  if (size < expected_size) {
+    SHERPA_ONNX_LOGE("Truncated flat lexicon. Size: %zu, expected: %zu", size,
+                     expected_size);
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  p += sizeof(FlatLexiconHeader);
+  word_offsets_ = reinterpret_cast<const uint32_t *>(p);
+
+  p += num_offsets * sizeof(uint32_t);
+  id_offsets_ = reinterpret_cast<const uint32_t *>(p);
+
+  p += num_offsets * sizeof(uint32_t);
+  pool_ = p;
+
+  p += RoundUpTo4(header_->pool_size);
+  ids_ = reinterpret_cast<const int32_t *>(p);
+}
+
+int32_t FlatLexicon::Find(const std::string &word) const {
+  int32_t lo = 0;
+  int32_t hi = header_->num_words;
+
+  while (lo < hi) {
+    int32_t mid = lo + (hi - lo) / 2;
+    const char *s = pool_ + word_offsets_[mid];
+    size_t len = word_offsets_[mid + 1] - word_offsets_[mid];
+
+    int32_t c = word.compare(0, word.size(), s, len);
+    if (c == 0) {
+      return mid;
+    } else if (c < 0) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+
+  return -1;
+}
+
+bool FlatLexicon::GetIds(const std::string &word,
+                         std::vector<int32_t> *ids) const {
+  int32_t i = Find(word);
+  if (i == -1) {
+    return false;
+  }
+
+  ids->assign(ids_ + id_offsets_[i], ids_ + id_offsets_[i + 1]);
+  return true;
+}
+
+bool FlatLexiconBuilder::Add(const std::string &word,
+                             const std::vector<int32_t> &ids) {
+  auto p = word2ids_.emplace(word, ids);
+  if (p.second) {
+    return true;
+  }
+
+  if (p.first->second.empty() && !ids.empty()) {
+    p.first->second = ids;
+    return true;
+  }
+
+  return false;
+}
+
+bool FlatLexiconBuilder::Write(const std::string &filename) const {
+  std::vector<uint32_t> word_offsets;
+  std::vector<uint32_t> id_offsets;
+  word_offsets.reserve(word2ids_.size() + 1);
+  id_offsets.reserve(word2ids_.size() + 1);
+
+  std::string pool;
+  std::vector<int32_t> ids;
+
+  for (const auto &p : word2ids_) {
+    word_offsets.push_back(pool.size());
+    id_offsets.push_back(ids.size());
+
+    pool += p.first;
+    ids.insert(ids.end(), p.second.begin(), p.second.end());
+  }
+  word_offsets.push_back(pool.size());
+  id_offsets.push_back(ids.size());
+
+  FlatLexiconHeader header{};
+  std::memcpy(header.magic, kFlatLexiconMagic, sizeof(header.magic));
+  header.version = kFlatLexiconVersion;
+  header.num_words = static_cast<int32_t>(word2ids_.size());
+  header.pool_size = static_cast<uint32_t>(pool.size());
+  header.num_ids = static_cast<uint32_t>(ids.size());
+
+  pool.resize(RoundUpTo4(pool.size()), '\0');
+
+  std::ofstream os(filename, std::ios::binary);
+  if (!os) {
+    SHERPA_ONNX_LOGE("Failed to create '%s'", filename.c_str());
+    return false;
+  }
+
+  os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  os.write(reinterpret_cast<const char *>(word_offsets.data()),
+           word_offsets.size() * sizeof(uint32_t));
+  os.write(reinterpret_cast<const char *>(id_offsets.data()),
+           id_offsets.size() * sizeof(uint32_t));
+  os.write(pool.data(), pool.size());
+  os.write(reinterpret_cast<const char *>(ids.data()),
+           ids.size() * sizeof(int32_t));
+
+  if (!os) {
+    SHERPA_ONNX_LOGE("Write '%s' failed", filename.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+}  // namespace sherpa_onnx
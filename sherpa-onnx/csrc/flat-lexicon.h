@@ -0,0 +1,102 @@
+// sherpa-onnx/csrc/flat-lexicon.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_FLAT_LEXICON_H_
+#define SHERPA_ONNX_CSRC_FLAT_LEXICON_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/mapped-file.h"
+
+namespace sherpa_onnx {
+
+// A lexicon, i.e., a map from words to token IDs, stored in a flat binary
+// format that can be memory-mapped and used without any parsing.
+//
+// Layout of the file (little endian):
+//
+//   - Header (32 bytes), see FlatLexiconHeader
+//   - Word offsets, num_words + 1 entries of uint32_t. Word i is
+//     pool[word_offsets[i], word_offsets[i+1])
+//   - ID offsets, num_words + 1 entries of uint32_t. The token IDs of
+//     word i are ids[id_offsets[i], id_offsets[i+1])
+//   - String pool, pool_size bytes, padded with zeros to a multiple of 4
+//   - Token IDs, num_ids entries of int32_t
+//
+// Words are sorted in byte order, so a word is looked up with a binary
+// search.
+struct FlatLexiconHeader {
+  char magic[8];
+  int32_t version;
+  int32_t num_words;
+  uint32_t pool_size;
+  uint32_t num_ids;
+  int32_t reserved[2];
+};
+
+class FlatLexicon {
+ public:
+  // It exits the program if the file is not a valid flat lexicon.
+  explicit FlatLexicon(const std::string &filename);
+
+  // For files that cannot be memory-mapped, e.g., files from the asset
+  // manager on Android.
+  explicit FlatLexicon(std::vector<char> buffer);
+
+  // Return true if the given file starts with the magic of this format.
+  static bool IsFlatLexicon(const std::string &filename);
+
+  static bool IsFlatLexicon(const char *data, size_t size);
+
+  int32_t NumWords() const { return header_->num_words; }
+
+  bool Contains(const std::string &word) const { return Find(word) != -1; }
+
+  // @return Return true if the word is found; in that case, ids is set
+  //         to the token IDs of the word.
+  bool GetIds(const std::string &word, std::vector<int32_t> *ids) const;
+
+ private:
+  void Init(const char *data, size_t size);
+
+  // Return the index of the word or -1 if it is not found
+  int32_t Find(const std::string &word) const;
+
+ private:
+  std::unique_ptr<MappedFile> file_;
+
+  // used only when it is constructed from a buffer
+  std::vector<char> buffer_;
+
+  const FlatLexiconHeader *header_ = nullptr;
+  const uint32_t *word_offsets_ = nullptr;
+  const uint32_t *id_offsets_ = nullptr;
+  const char *pool_ = nullptr;
+  const int32_t *ids_ = nullptr;
+};
+
+// Collect words and their token IDs and save them in the format of
+// FlatLexicon.
+class FlatLexiconBuilder {
+ public:
+  // If the word already exists, it is ignored and false is returned. An
+  // existing word without any IDs is replaced, since the text lexicons
+  // skip such entries when looking for duplicates.
+  bool Add(const std::string &word, const std::vector<int32_t> &ids);
+
+  int32_t NumWords() const { return word2ids_.size(); }
+
+  // @return Return true on success.
+  bool Write(const std::string &filename) const;
+
+ private:
+  std::map<std::string, std::vector<int32_t>> word2ids_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_FLAT_LEXICON_H_
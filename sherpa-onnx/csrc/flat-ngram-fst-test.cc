@@ -0,0 +1,81 @@
+// sherpa-onnx/csrc/flat-ngram-fst-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/flat-ngram-fst.h"
+
+#include <cstdio>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(FlatNgramFst, WriteAndRead) {
+  // A bigram LM over tokens 1 and 2.
+  // State 0 is the unigram state; states 1 and 2 are the history of
+  // token 1 and token 2.
+  FlatNgramFstBuilder builder;
+  builder.SetStart(0);
+  builder.AddArc(0, 2, 2, 1.5);
+  builder.AddArc(0, 1, 1, 0.5);
+  builder.AddArc(1, 2, 2, 0.25);
+  builder.SetBackoff(1, 0, 0.75);
+  builder.SetBackoff(2, 0, 1.25);
+  builder.SetFinal(2, 2.0);
+
+  std::string filename = "flat-ngram-fst-test.bin";
+  ASSERT_TRUE(builder.Write(filename));
+  EXPECT_TRUE(FlatNgramFst::IsFlatNgramFst(filename));
+
+  {
+    FlatNgramFst fst(filename);
+    EXPECT_EQ(fst.Start(), 0);
+    EXPECT_EQ(fst.NumStates(), 3);
+    EXPECT_EQ(fst.NumArcs(), 3);
+
+    int32_t next = -1;
+    float cost = 0;
+    float eps = 1e-3;
+
+    EXPECT_TRUE(fst.FindArc(0, 1, &next, &cost));
+    EXPECT_EQ(next, 1);
+    EXPECT_NEAR(cost, 0.5, eps);
+
+    EXPECT_TRUE(fst.FindArc(0, 2, &next, &cost));
+    EXPECT_EQ(next, 2);
+    EXPECT_NEAR(cost, 1.5, eps);
+
+    EXPECT_TRUE(fst.FindArc(1, 2, &next, &cost));
+    EXPECT_EQ(next, 2);
+    EXPECT_NEAR(cost, 0.25, eps);
+
+    EXPECT_FALSE(fst.FindArc(1, 1, &next, &cost));
+    EXPECT_FALSE(fst.FindArc(2, 1, &next, &cost));
+    EXPECT_FALSE(fst.FindArc(0, 3, &next, &cost));
+
+    EXPECT_FALSE(fst.Backoff(0, &next, &cost));
+    EXPECT_TRUE(fst.Backoff(1, &next, &cost));
+    EXPECT_EQ(next, 0);
+    EXPECT_NEAR(cost, 0.75, eps);
+
+    EXPECT_FALSE(fst.Final(0, &cost));
+    EXPECT_TRUE(fst.Final(2, &cost));
+    EXPECT_NEAR(cost, 2.0, eps);
+  }
+
+  std::remove(filename.c_str());
+}
+
+TEST(FlatNgramFst, NotFlat) {
+  std::string filename = "flat-ngram-fst-test-not-flat.bin";
+  {
+    FILE *fp = fopen(filename.c_str(), "wb");
+    fputs("not a flat n-gram fst", fp);
+    fclose(fp);
+  }
+  EXPECT_FALSE(FlatNgramFst::IsFlatNgramFst(filename));
+  std::remove(filename.c_str());
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,256 @@
+// sherpa-onnx/csrc/flat-ngram-fst.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/flat-ngram-fst.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+static_assert(sizeof(FlatNgramFstHeader) == 64, "");
+static_assert(sizeof(FlatNgramFstState) == 16, "");
+static_assert(sizeof(FlatNgramFstArc) == 8, "");
+
+static constexpr char kFlatNgramFstMagic[8] = {'S', 'O', 'N', 'G',
+                                               'R', 'A', 'M', '1'};
+static constexpr int32_t kFlatNgramFstVersion = 1;
+static constexpr uint16_t kInfinity = 65535;
+
+bool FlatNgramFst::IsFlatNgramFst(const std::string &filename) {
+  std::ifstream is(filename, std::ios::binary);
+  char magic[sizeof(kFlatNgramFstMagic)];
+  if (!is.read(magic, sizeof(magic))) {
+    return false;
+  }
+
+  return std::memcmp(magic, kFlatNgramFstMagic, sizeof(magic)) == 0;
+}
+
+FlatNgramFst::FlatNgramFst(const std::string &filename)
+    : file_(std::make_unique<MappedFile>(filename)) {
+  const char *p = file_->Data();
+  size_t size = file_->Size();
+
+  if (size < sizeof(FlatNgramFstHeader) ||
+      std::memcmp(p, kFlatNgramFstMagic, sizeof(kFlatNgramFstMagic)) != 0) {
+    SHERPA_ONNX_LOGE("'%s' is not a flat n-gram FST", filename.c_str());
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  header_ = reinterpret_cast<const FlatNgramFstHeader *>(p);
+  if (header_->version != kFlatNgramFstVersion) {
+    SHERPA_ONNX_LOGE("Unsupported version %d of flat n-gram FST '%s'",
+                     header_->version, filename.c_str());
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  size_t expected_size =
+      sizeof(FlatNgramFstHeader) +
+      (header_->num_states + 1) * sizeof(FlatNgramFstState) +
+      header_->num_arcs * (sizeof(FlatNgramFstArc) + sizeof(uint16_t));
+
+  if (header_->num_states < 0 || header_->num_arcs < 0 ||
+      size < expected_size) {
+    SHERPA_ONNX_LOGE("Truncated flat n-gram FST '%s'. Size: %zu, expected: %zu",
+                     filename.c_str(), size, expected_size);
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  p += sizeof(FlatNgramFstHeader);
+  states_ = reinterpret_cast<const FlatNgramFstState *>(p);
+
+  p += (header_->num_states + 1) * sizeof(FlatNgramFstState);
+  arcs_ = reinterpret_cast<const FlatNgramFstArc *>(p);
+
+  p += header_->num_arcs * sizeof(FlatNgramFstArc);
+  weights_ = reinterpret_cast<const uint16_t *>(p);
+}
+
+bool FlatNgramFst::FindArc(int32_t state, int32_t label, int32_t *next_state,
+                           float *cost) const {
+  if (state < 0 || state >= header_->num_states) {
+    return false;
+  }
+
+  const FlatNgramFstArc *begin = arcs_ + states_[state].arc_begin;
+  const FlatNgramFstArc *end = arcs_ + states_[state + 1].arc_begin;
+
+  auto it = std::lower_bound(
+      begin, end, label,
+      [](const FlatNgramFstArc &arc, int32_t l) { return arc.label < l; });
+
+  if (it == end || it->label != label) {
+    return false;
+  }
+
+  *next_state = it->next_state;
+  *cost = Dequantize(weights_[it - arcs_]);
+
+  return true;
+}
+
+bool FlatNgramFst::Backoff(int32_t state, int32_t *backoff_state,
+                           float *cost) const {
+  if (state < 0 || state >= header_->num_states) {
+    return false;
+  }
+
+  const auto &s = states_[state];
+  if (s.backoff_state < 0) {
+    return false;
+  }
+
+  *backoff_state = s.backoff_state;
+  *cost = Dequantize(s.backoff_weight);
+
+  return true;
+}
+
+bool FlatNgramFst::Final(int32_t state, float *cost) const {
+  if (state < 0 || state >= header_->num_states) {
+    return false;
+  }
+
+  uint16_t q = states_[state].final_weight;
+  if (q == kInfinity) {
+    return false;
+  }
+
+  *cost = Dequantize(q);
+
+  return true;
+}
+
+FlatNgramFstBuilder::State *FlatNgramFstBuilder::GetState(int32_t state) {
+  if (state >= static_cast<int32_t>(states_.size())) {
+    states_.resize(state + 1);
+  }
+
+  return &states_[state];
+}
+
+void FlatNgramFstBuilder::AddArc(int32_t state, int32_t label,
+                                 int32_t next_state, float cost) {
+  GetState(next_state);
+  GetState(state)->arcs[label] = {next_state, cost};
+}
+
+void FlatNgramFstBuilder::SetBackoff(int32_t state, int32_t backoff_state,
+                                     float cost) {
+  GetState(backoff_state);
+
+  auto s = GetState(state);
+  s->backoff_state = backoff_state;
+  s->backoff_cost = cost;
+}
+
+void FlatNgramFstBuilder::SetFinal(int32_t state, float cost) {
+  auto s = GetState(state);
+  s->is_final = true;
+  s->final_cost = cost;
+}
+
+bool FlatNgramFstBuilder::Write(const std::string &filename) const {
+  float min_cost = std::numeric_limits<float>::infinity();
+  float max_cost = -std::numeric_limits<float>::infinity();
+  int64_t num_arcs = 0;
+
+  auto update = [&min_cost, &max_cost](float c) {
+    min_cost = std::min(min_cost, c);
+    max_cost = std::max(max_cost, c);
+  };
+
+  for (const auto &s : states_) {
+    for (const auto &a : s.arcs) {
+      update(a.second.second);
+    }
+    num_arcs += s.arcs.size();
+
+    if (s.backoff_state >= 0) {
+      update(s.backoff_cost);
+    }
+
+    if (s.is_final) {
+      update(s.final_cost);
+    }
+  }
+
+  if (min_cost > max_cost) {
+    // there are no weights at all
+    min_cost = max_cost = 0;
+  }
+
+  FlatNgramFstHeader header{};
+  std::memcpy(header.magic, kFlatNgramFstMagic, sizeof(header.magic));
+  header.version = kFlatNgramFstVersion;
+  header.num_states = static_cast<int32_t>(states_.size());
+  header.num_arcs = num_arcs;
+  header.start = start_;
+  header.weight_min = min_cost;
+  header.weight_step =
+      max_cost > min_cost ? (max_cost - min_cost) / (kInfinity - 1) : 1;
+
+  auto quantize = [&header](float c) -> uint16_t {
+    float q = std::round((c - header.weight_min) / header.weight_step);
+    q = std::min<float>(std::max<float>(q, 0), kInfinity - 1);
+    return static_cast<uint16_t>(q);
+  };
+
+  std::ofstream os(filename, std::ios::binary);
+  if (!os) {
+    SHERPA_ONNX_LOGE("Failed to open '%s' for writing", filename.c_str());
+    return false;
+  }
+
+  os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  int64_t arc_begin = 0;
+  for (const auto &s : states_) {
+    FlatNgramFstState fs{};
+    fs.arc_begin = arc_begin;
+    fs.backoff_state = s.backoff_state;
+    fs.backoff_weight = s.backoff_state >= 0 ? quantize(s.backoff_cost)
+                                             : kInfinity;
+    fs.final_weight = s.is_final ? quantize(s.final_cost) : kInfinity;
+
+    os.write(reinterpret_cast<const char *>(&fs), sizeof(fs));
+
+    arc_begin += s.arcs.size();
+  }
+
+  FlatNgramFstState sentinel{};
+  sentinel.arc_begin = arc_begin;
+  sentinel.backoff_state = -1;
+  sentinel.backoff_weight = kInfinity;
+  sentinel.final_weight = kInfinity;
+  os.write(reinterpret_cast<const char *>(&sentinel), sizeof(sentinel));
+
+  // std::map keeps the arcs sorted by label
+  for (const auto &s : states_) {
+    for (const auto &a : s.arcs) {
+      FlatNgramFstArc arc{a.first, a.second.first};
+      os.write(reinterpret_cast<const char *>(&arc), sizeof(arc));
+    }
+  }
+
+  for (const auto &s : states_) {
+    for (const auto &a : s.arcs) {
+      uint16_t w = quantize(a.second.second);
+      os.write(reinterpret_cast<const char *>(&w), sizeof(w));
+    }
+  }
+
+  return static_cast<bool>(os);
+}
+
+}  // namespace sherpa_onnx
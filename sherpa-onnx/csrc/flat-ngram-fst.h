@@ -0,0 +1,133 @@
+// sherpa-onnx/csrc/flat-ngram-fst.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_FLAT_NGRAM_FST_H_
+#define SHERPA_ONNX_CSRC_FLAT_NGRAM_FST_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/mapped-file.h"
+
+namespace sherpa_onnx {
+
+// A backoff n-gram LM stored in a flat binary format that can be
+// memory-mapped and used without any parsing.
+//
+// Layout of the file (little endian):
+//
+//   - Header (64 bytes), see FlatNgramFstHeader
+//   - States, num_states + 1 entries of FlatNgramFstState. The last one
+//     is a sentinel so that the arcs of state s are in
+//     [states[s].arc_begin, states[s+1].arc_begin)
+//   - Arcs, num_arcs entries of FlatNgramFstArc, sorted by label
+//     within each state. Backoff arcs are not included; they are
+//     stored in FlatNgramFstState::backoff_state
+//   - Weights of the arcs, num_arcs entries of uint16_t
+//
+// Weights (i.e., costs, -log prob) are quantized to 16 bits
+// linearly between weight_min and weight_min + 65534 * weight_step.
+// The value 65535 means infinity, i.e., no final weight or no backoff.
+struct FlatNgramFstHeader {
+  char magic[8];
+  int32_t version;
+  int32_t num_states;
+  int64_t num_arcs;
+  int32_t start;
+  float weight_min;
+  float weight_step;
+  int32_t reserved[7];
+};
+
+struct FlatNgramFstState {
+  int64_t arc_begin;
+  int32_t backoff_state;  // -1 if there is no backoff arc
+  uint16_t backoff_weight;
+  uint16_t final_weight;
+};
+
+struct FlatNgramFstArc {
+  int32_t label;
+  int32_t next_state;
+};
+
+class FlatNgramFst {
+ public:
+  // It exits the program if the file is not a valid flat n-gram FST.
+  explicit FlatNgramFst(const std::string &filename);
+
+  // Return true if the given file starts with the magic of this format.
+  static bool IsFlatNgramFst(const std::string &filename);
+
+  int32_t Start() const { return header_->start; }
+
+  int32_t NumStates() const { return header_->num_states; }
+
+  int64_t NumArcs() const { return header_->num_arcs; }
+
+  // Find the non-backoff arc leaving the given state with the given label.
+  //
+  // @return Return true if it is found; in that case, next_state and cost
+  //         are set.
+  bool FindArc(int32_t state, int32_t label, int32_t *next_state,
+               float *cost) const;
+
+  // @return Return true if the state has a backoff arc; in that case,
+  //         backoff_state and cost are set.
+  bool Backoff(int32_t state, int32_t *backoff_state, float *cost) const;
+
+  // @return Return true if the state is final; in that case, cost is set.
+  bool Final(int32_t state, float *cost) const;
+
+ private:
+  float Dequantize(uint16_t q) const {
+    return header_->weight_min + q * header_->weight_step;
+  }
+
+ private:
+  std::unique_ptr<MappedFile> file_;
+
+  const FlatNgramFstHeader *header_ = nullptr;
+  const FlatNgramFstState *states_ = nullptr;
+  const FlatNgramFstArc *arcs_ = nullptr;
+  const uint16_t *weights_ = nullptr;
+};
+
+// Collect the states and arcs of a backoff n-gram LM and save it
+// in the format of FlatNgramFst.
+class FlatNgramFstBuilder {
+ public:
+  void SetStart(int32_t state) { start_ = state; }
+
+  void AddArc(int32_t state, int32_t label, int32_t next_state, float cost);
+
+  void SetBackoff(int32_t state, int32_t backoff_state, float cost);
+
+  void SetFinal(int32_t state, float cost);
+
+  // @return Return true on success.
+  bool Write(const std::string &filename) const;
+
+ private:
+  struct State {
+    std::map<int32_t, std::pair<int32_t, float>> arcs;  // label -> (next, w)
+    int32_t backoff_state = -1;
+    float backoff_cost = 0;
+    bool is_final = false;
+    float final_cost = 0;
+  };
+
+  State *GetState(int32_t state);
+
+ private:
+  int32_t start_ = 0;
+  std::vector<State> states_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_FLAT_NGRAM_FST_H_
@@ -0,0 +1,66 @@
+// sherpa-onnx/csrc/histogram-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/histogram.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(Histogram, Empty) {
+  Histogram h({1, 2, 4});
+  EXPECT_EQ(h.Count(), 0);
+  EXPECT_EQ(h.Mean(), 0);
+  EXPECT_EQ(h.Percentile(50), 0);
+}
+
+TEST(Histogram, Percentile) {
+  Histogram h(ExponentialBuckets(1, 2, 4));  // 1, 2, 4, 8
+
+  for (int32_t i = 0; i != 90; ++i) {
+    h.Record(1.5);
+  }
+
+  for (int32_t i = 0; i != 9; ++i) {
+    h.Record(3);
+  }
+
+  h.Record(20);
+
+  EXPECT_EQ(h.Count(), 100);
+  EXPECT_NEAR(h.Mean(), (90 * 1.5 + 9 * 3 + 20) / 100, 1e-6);
+  EXPECT_EQ(h.Max(), 20);
+
+  EXPECT_EQ(h.Percentile(50), 2);
+  EXPECT_EQ(h.Percentile(90), 2);
+  EXPECT_EQ(h.Percentile(99), 4);
+  EXPECT_EQ(h.Percentile(100), 20);  // overflow bucket
+}
+
+TEST(Histogram, PercentileNotLargerThanMax) {
+  Histogram h({10, 100});
+  h.Record(3);
+  EXPECT_EQ(h.Percentile(50), 3);
+}
+
+TEST(Histogram, ToJson) {
+  Histogram h({1, 2});
+  h.Record(0.5);
+  h.Record(5);
+
+  std::string s = h.ToJson();
+  EXPECT_NE(s.find("\"count\": 2"), std::string::npos) << s;
+  EXPECT_NE(s.find("{\"le\": 1.000, \"count\": 1}"), std::string::npos) << s;
+  EXPECT_NE(s.find("{\"le\": \"inf\", \"count\": 1}"), std::string::npos)
+      << s;
+  EXPECT_EQ(s.find("\"le\": 2.000"), std::string::npos) << s;
+
+  h.Reset();
+  EXPECT_EQ(h.Count(), 0);
+}
+
+}  // namespace sherpa_onnx
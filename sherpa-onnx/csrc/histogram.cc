@@ -0,0 +1,126 @@
+// sherpa-onnx/csrc/histogram.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sherpa_onnx {
+
+Histogram::Histogram(std::vector<double> bounds)
+    : bounds_(std::move(bounds)), counts_(bounds_.size() + 1) {}
+
+void Histogram::Record(double v) {
+  int32_t i = std::lower_bound(bounds_.begin(), bounds_.end(), v) -
+              bounds_.begin();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  counts_[i] += 1;
+  count_ += 1;
+  sum_ += v;
+  max_ = count_ == 1 ? v : std::max(max_, v);
+}
+
+int64_t Histogram::Count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return count_;
+}
+
+double Histogram::Mean() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return count_ ? sum_ / count_ : 0;
+}
+
+double Histogram::Max() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return max_;
+}
+
+double Histogram::Percentile(double p) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return PercentileUnlocked(p);
+}
+
+double Histogram::PercentileUnlocked(double p) const {
+  if (count_ == 0) {
+    return 0;
+  }
+
+  // rank of the percentile, starting from 1
+  int64_t rank = std::max<int64_t>(1, std::ceil(p / 100 * count_));
+
+  int64_t n = 0;
+  for (size_t i = 0; i != bounds_.size(); ++i) {
+    n += counts_[i];
+    if (n >= rank) {
+      return std::min(bounds_[i], max_);
+    }
+  }
+
+  return max_;
+}
+
+void Histogram::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::fill(counts_.begin(), counts_.end(), 0);
+  count_ = 0;
+  sum_ = 0;
+  max_ = 0;
+}
+
+std::string Histogram::ToJson() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(3);
+  os << "{ ";
+  os << "\"count\": " << count_ << ", ";
+  os << "\"mean\": " << (count_ ? sum_ / count_ : 0) << ", ";
+  os << "\"max\": " << max_ << ", ";
+  os << "\"p50\": " << PercentileUnlocked(50) << ", ";
+  os << "\"p90\": " << PercentileUnlocked(90) << ", ";
+  os << "\"p99\": " << PercentileUnlocked(99) << ", ";
+  os << "\"buckets\": [";
+
+  std::string sep;
+  for (size_t i = 0; i != counts_.size(); ++i) {
+    if (counts_[i] == 0) {
+      continue;
+    }
+
+    os << sep << "{\"le\": ";
+    if (i < bounds_.size()) {
+      os << bounds_[i];
+    } else {
+      os << "\"inf\"";
+    }
+    os << ", \"count\": " << counts_[i] << "}";
+    sep = ", ";
+  }
+  os << "] }";
+
+  return os.str();
+}
+
+std::vector<double> ExponentialBuckets(double start, double factor,
+                                       int32_t n) {
+  std::vector<double> ans;
+  ans.reserve(n);
+
+  double b = start;
+  for (int32_t i = 0; i != n; ++i) {
+    ans.push_back(b);
+    b *= factor;
+  }
+
+  return ans;
+}
+
+}  // namespace sherpa_onnx
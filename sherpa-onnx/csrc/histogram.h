@@ -0,0 +1,64 @@
+// sherpa-onnx/csrc/histogram.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_HISTOGRAM_H_
+#define SHERPA_ONNX_CSRC_HISTOGRAM_H_
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+namespace sherpa_onnx {
+
+/* A thread-safe histogram with fixed buckets, e.g., for latencies.
+ *
+ * Bucket i counts values v with bounds[i-1] < v <= bounds[i]. There is an
+ * extra bucket for values larger than the last bound.
+ */
+class Histogram {
+ public:
+  /*
+   * @param bounds Upper bounds of the buckets in ascending order.
+   */
+  explicit Histogram(std::vector<double> bounds);
+
+  void Record(double v);
+
+  int64_t Count() const;
+
+  double Mean() const;
+
+  double Max() const;
+
+  /* Return the upper bound of the bucket containing the p-th percentile.
+   * If it is the last bucket, the max value is returned.
+   *
+   * @param p A value in [0, 100].
+   */
+  double Percentile(double p) const;
+
+  void Reset();
+
+  // Return count, mean, max, p50, p90, p99 and non-empty buckets as
+  // a JSON object.
+  std::string ToJson() const;
+
+ private:
+  double PercentileUnlocked(double p) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<double> bounds_;
+  std::vector<int64_t> counts_;  // bounds_.size() + 1 entries
+  int64_t count_ = 0;
+  double sum_ = 0;
+  double max_ = 0;
+};
+
+// Return {start, start * factor, start * factor^2, ...} with n entries
+std::vector<double> ExponentialBuckets(double start, double factor, int32_t n);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_HISTOGRAM_H_
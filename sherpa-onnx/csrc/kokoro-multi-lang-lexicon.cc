@@ -6,11 +6,10 @@
 #include "sherpa-onnx/csrc/macros.h"
 
 #include <fstream>
-#include <regex>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <unordered_map>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -27,9 +26,11 @@
 #include "phoneme_ids.hpp"  // NOLINT
 #include "phonemize.hpp"    // NOLINT
 #include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/flat-lexicon.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/phrase-matcher.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/text-replacer.h"
 #include "sherpa-onnx/csrc/text-utils.h"
 
 namespace sherpa_onnx {
@@ -69,50 +70,31 @@ class KokoroMultiLangLexicon::Impl {
                                               const std::string &voice) const {
     // we cannot convert text to lowercase here since it will affect
     // how piper_phonemize handles punctuations inside the text
-    std::string text = _text;
-
-    std::vector<std::pair<std::string, std::string>> replace_str_pairs = {
-        {"，", ","}, {":", ","},  {"、", ","}, {"；", ";"},   {"：", ":"},
-        {"。", "."}, {"？", "?"}, {"！", "!"}, {"\\s+", " "},
-    };
-    for (const auto &p : replace_str_pairs) {
-      std::regex re(p.first);
-      text = std::regex_replace(text, re, p.second);
-    }
+    std::string text = punct_replacer_.Apply(_text);
 
     if (debug_) {
       SHERPA_ONNX_LOGE("After replacing punctuations and merging spaces:\n%s",
                        text.c_str());
     }
 
-    // https://en.cppreference.com/w/cpp/regex
-    // https://stackoverflow.com/questions/37989081/how-to-use-unicode-range-in-c-regex
-    std::string expr_chinese = "([\\u4e00-\\u9fff]+)";
-    std::string expr_not_chinese = "([^\\u4e00-\\u9fff]+)";
-
-    std::string expr_both = expr_chinese + "|" + expr_not_chinese;
-
+    // Split the text into runs of Chinese characters, i.e., [\u4e00-\u9fff],
+    // and runs of other characters
     auto ws = ToWideString(text);
-    std::wstring wexpr_both = ToWideString(expr_both);
-    std::wregex we_both(wexpr_both);
-
-    std::wstring wexpr_zh = ToWideString(expr_chinese);
-    std::wregex we_zh(wexpr_zh);
-
-    auto begin = std::wsregex_iterator(ws.begin(), ws.end(), we_both);
-    auto end = std::wsregex_iterator();
 
     std::vector<TokenIDs> ans;
 
-    for (std::wsregex_iterator i = begin; i != end; ++i) {
-      std::wsmatch match = *i;
-      std::wstring match_str = match.str();
+    for (size_t start = 0; start < ws.size();) {
+      bool is_chinese = IsChineseChar(ws[start]);
+      size_t end = start + 1;
+      while (end < ws.size() && IsChineseChar(ws[end]) == is_chinese) {
+        ++end;
+      }
 
-      auto ms = ToString(match_str);
-      uint8_t c = reinterpret_cast<const uint8_t *>(ms.data())[0];
+      auto ms = ToString(ws.substr(start, end - start));
+      start = end;
 
       std::vector<std::vector<int32_t>> ids_vec;
-      if (std::regex_match(match_str, we_zh)) {
+      if (is_chinese) {
         if (debug_) {
           SHERPA_ONNX_LOGE("Chinese: %s", ms.c_str());
         }
@@ -163,6 +145,8 @@ class KokoroMultiLangLexicon::Impl {
   }
 
  private:
+  static bool IsChineseChar(wchar_t c) { return c >= 0x4e00 && c <= 0x9fff; }
+
   bool IsPunctuation(const std::string &text) const {
     if (text == ";" || text == ":" || text == "," || text == "." ||
         text == "!" || text == "?" || text == "—" || text == "…" ||
@@ -174,14 +158,36 @@ class KokoroMultiLangLexicon::Impl {
     return false;
   }
 
+  bool HasWord(const std::string &w) const {
+    if (flat_lexicon_) {
+      // Like InitLexicon(), words without any token IDs are ignored,
+      // except 呣
+      std::vector<int32_t> ids;
+      return flat_lexicon_->GetIds(w, &ids) && (!ids.empty() || w == "呣");
+    }
+
+    return word2ids_.count(w) > 0;
+  }
+
+  // Call it only if HasWord(w) is true
+  std::vector<int32_t> GetWordIds(const std::string &w) const {
+    if (flat_lexicon_) {
+      std::vector<int32_t> ans;
+      flat_lexicon_->GetIds(w, &ans);
+      return ans;
+    }
+
+    return word2ids_.at(w);
+  }
+
   std::vector<int32_t> ConvertWordToIds(const std::string &w) const {
     std::vector<int32_t> ans;
-    if (word2ids_.count(w)) {
-      ans = word2ids_.at(w);
+    if (HasWord(w)) {
+      ans = GetWordIds(w);
     } else {
       std::vector<std::string> words = SplitUtf8(w);
       for (const auto &word : words) {
-        if (word2ids_.count(word)) {
+        if (HasWord(word)) {
           auto ids = ConvertWordToIds(word);
           ans.insert(ans.end(), ids.begin(), ids.end());
         } else {
@@ -235,7 +241,8 @@ class KokoroMultiLangLexicon::Impl {
 
     this_sentence.push_back(0);
 
-    PhraseMatcher matcher(&all_words_, words, debug_);
+    PhraseMatcher matcher(
+        [this](const std::string &w) { return HasWord(w); }, words, debug_);
 
     for (const std::string &w : matcher) {
       auto ids = ConvertWordToIds(w);
@@ -350,8 +357,8 @@ class KokoroMultiLangLexicon::Impl {
 
           this_sentence.push_back(0);
         }
-      } else if (word2ids_.count(word)) {
-        const auto &ids = word2ids_.at(word);
+      } else if (HasWord(word)) {
+        const auto &ids = GetWordIds(word);
         if (this_sentence.size() + ids.size() + 3 > max_len - 2) {
           this_sentence.push_back(0);
           ans.push_back(std::move(this_sentence));
@@ -470,6 +477,14 @@ class KokoroMultiLangLexicon::Impl {
 
     std::vector<std::string> files;
     SplitStringToVector(lexicon, ",", false, &files);
+
+    // A flat lexicon from sherpa-onnx-compile-lexicon already contains
+    // the words of all the text lexicons it was built from
+    if (files.size() == 1 && FlatLexicon::IsFlatLexicon(files[0])) {
+      flat_lexicon_ = std::make_unique<FlatLexicon>(files[0]);
+      return;
+    }
+
     for (const auto &f : files) {
       std::ifstream is(f);
       InitLexicon(is);
@@ -487,6 +502,12 @@ class KokoroMultiLangLexicon::Impl {
     for (const auto &f : files) {
       auto buf = ReadFile(mgr, f);
 
+      if (files.size() == 1 &&
+          FlatLexicon::IsFlatLexicon(buf.data(), buf.size())) {
+        flat_lexicon_ = std::make_unique<FlatLexicon>(std::move(buf));
+        break;
+      }
+
       std::istringstream is(std::string(buf.data(), buf.size()));
       InitLexicon(is);
     }
@@ -532,10 +553,6 @@ class KokoroMultiLangLexicon::Impl {
 
       word2ids_.insert({std::move(word), std::move(ids)});
     }
-
-    for (const auto &[key, _] : word2ids_) {
-      all_words_.insert(key);
-    }
   }
 
  private:
@@ -543,7 +560,9 @@ class KokoroMultiLangLexicon::Impl {
 
   // word to token IDs
   std::unordered_map<std::string, std::vector<int32_t>> word2ids_;
-  std::unordered_set<std::string> all_words_;
+
+  // If not null, lexicon words are looked up in it and word2ids_ is empty
+  std::unique_ptr<FlatLexicon> flat_lexicon_;
 
   // tokens.txt is saved in token2id_
   std::unordered_map<std::string, int32_t> token2id_;
@@ -551,6 +570,18 @@ class KokoroMultiLangLexicon::Impl {
 
   std::unordered_map<char32_t, int32_t> phoneme2id_;
 
+  // Replace Chinese punctuations and merge spaces. It is built once and
+  // shared by all calls of ConvertTextToTokenIds()
+  TextReplacer punct_replacer_{{{"，", ","},
+                                {":", ","},
+                                {"、", ","},
+                                {"；", ";"},
+                                {"：", ":"},
+                                {"。", "."},
+                                {"？", "?"},
+                                {"！", "!"}},
+                               true};
+
   bool debug_ = false;
 };
 
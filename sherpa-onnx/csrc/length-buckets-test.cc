@@ -0,0 +1,43 @@
+// sherpa-onnx/csrc/length-buckets-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/length-buckets.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(SplitByLength, Empty) { EXPECT_TRUE(SplitByLength({}, 0.2).empty()); }
+
+TEST(SplitByLength, SingleBucket) {
+  std::vector<int32_t> lengths = {200, 3000, 150};
+  auto buckets = SplitByLength(lengths, 1);
+  ASSERT_EQ(buckets.size(), 1);
+  EXPECT_EQ(buckets[0], (std::vector<int32_t>{1, 0, 2}));
+}
+
+TEST(SplitByLength, LongOutlier) {
+  // One 30 s utterance among 2 s ones
+  std::vector<int32_t> lengths = {200, 3000, 190, 210, 200};
+  auto buckets = SplitByLength(lengths, 0.2);
+  ASSERT_EQ(buckets.size(), 2);
+  EXPECT_EQ(buckets[0], (std::vector<int32_t>{1}));
+  EXPECT_EQ(buckets[1], (std::vector<int32_t>{3, 0, 4, 2}));
+}
+
+TEST(SplitByLength, Ratio) {
+  std::vector<int32_t> lengths = {100, 90, 60, 55};
+  // Padding of {100, 90, 60} is 50 / 300 = 0.17
+  auto buckets = SplitByLength(lengths, 0.2);
+  ASSERT_EQ(buckets.size(), 2);
+  EXPECT_EQ(buckets[0], (std::vector<int32_t>{0, 1, 2}));
+  EXPECT_EQ(buckets[1], (std::vector<int32_t>{3}));
+
+  buckets = SplitByLength(lengths, 0);
+  EXPECT_EQ(buckets.size(), 4);
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,48 @@
+// sherpa-onnx/csrc/length-buckets.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/length-buckets.h"
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace sherpa_onnx {
+
+std::vector<std::vector<int32_t>> SplitByLength(
+    const std::vector<int32_t> &lengths, float max_padding_ratio) {
+  int32_t n = lengths.size();
+
+  std::vector<int32_t> indexes(n);
+  std::iota(indexes.begin(), indexes.end(), 0);
+  std::stable_sort(indexes.begin(), indexes.end(), [&](int32_t a, int32_t b) {
+    return lengths[a] > lengths[b];
+  });
+
+  std::vector<std::vector<int32_t>> ans;
+  int64_t max_len = 0;
+  int64_t sum = 0;
+
+  for (auto i : indexes) {
+    if (!ans.empty()) {
+      // Sorted in descending order, so max_len is the first one in the
+      // bucket
+      int64_t total = max_len * (ans.back().size() + 1);
+      int64_t padding = total - sum - lengths[i];
+      if (total == 0 || padding <= max_padding_ratio * total) {
+        ans.back().push_back(i);
+        sum += lengths[i];
+        continue;
+      }
+    }
+
+    ans.push_back({i});
+    max_len = lengths[i];
+    sum = lengths[i];
+  }
+
+  return ans;
+}
+
+}  // namespace sherpa_onnx
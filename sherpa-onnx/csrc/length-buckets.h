@@ -0,0 +1,32 @@
+// sherpa-onnx/csrc/length-buckets.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_LENGTH_BUCKETS_H_
+#define SHERPA_ONNX_CSRC_LENGTH_BUCKETS_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace sherpa_onnx {
+
+/* Split a batch of sequences into buckets of similar lengths.
+ *
+ * Sequences are sorted by length in descending order and assigned
+ * greedily, so that in each bucket the fraction of padding, i.e.,
+ *
+ *   1 - sum(lengths) / (max(lengths) * num_sequences),
+ *
+ * does not exceed max_padding_ratio.
+ *
+ * @param lengths lengths[i] is the length of the i-th sequence.
+ * @param max_padding_ratio A value in [0, 1]. 1 puts all sequences into a
+ *                          single bucket.
+ * @return Return indexes into lengths for each bucket. Longer buckets come
+ *         first.
+ */
+std::vector<std::vector<int32_t>> SplitByLength(
+    const std::vector<int32_t> &lengths, float max_padding_ratio);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_LENGTH_BUCKETS_H_
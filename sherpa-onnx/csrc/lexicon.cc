@@ -25,6 +25,7 @@
 #endif
 
 #include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/flat-lexicon.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
 #include "sherpa-onnx/csrc/text-utils.h"
@@ -112,7 +113,9 @@ Lexicon::Lexicon(const std::string &lexicon, const std::string &tokens,
     InitTokens(is);
   }
 
-  {
+  if (FlatLexicon::IsFlatLexicon(lexicon)) {
+    flat_lexicon_ = std::make_unique<FlatLexicon>(lexicon);
+  } else {
     std::ifstream is(lexicon);
     InitLexicon(is);
   }
@@ -136,8 +139,12 @@ Lexicon::Lexicon(Manager *mgr, const std::string &lexicon,
 
   {
     auto buf = ReadFile(mgr, lexicon);
-    std::istringstream is(std::string(buf.data(), buf.size()));
-    InitLexicon(is);
+    if (FlatLexicon::IsFlatLexicon(buf.data(), buf.size())) {
+      flat_lexicon_ = std::make_unique<FlatLexicon>(std::move(buf));
+    } else {
+      std::istringstream is(std::string(buf.data(), buf.size()));
+      InitLexicon(is);
+    }
   }
 
   InitPunctuations(punctuations);
@@ -208,6 +215,7 @@ std::vector<TokenIDs> Lexicon::ConvertTextToTokenIdsChinese(
     this_sentence.push_back(sil);
   }
 
+  std::vector<int32_t> token_ids;
   for (const auto &w : words) {
     if (w == "." || w == ";" || w == "!" || w == "?" || w == "-" || w == ":" ||
         w == "。" || w == "；" || w == "！" || w == "？" || w == "：" ||
@@ -238,12 +246,11 @@ std::vector<TokenIDs> Lexicon::ConvertTextToTokenIdsChinese(
       continue;
     }
 
-    if (!word2ids_.count(w)) {
+    if (!GetWordIds(w, &token_ids)) {
       SHERPA_ONNX_LOGE("OOV %s. Ignore it!", w.c_str());
       continue;
     }
 
-    const auto &token_ids = word2ids_.at(w);
     this_sentence.insert(this_sentence.end(), token_ids.begin(),
                          token_ids.end());
   }
@@ -298,6 +305,7 @@ std::vector<TokenIDs> Lexicon::ConvertTextToTokenIdsNotChinese(
   std::vector<TokenIDs> ans;
   std::vector<int64_t> this_sentence;
 
+  std::vector<int32_t> token_ids;
   for (const auto &w : words) {
     if (w == "." || w == ";" || w == "!" || w == "?" || w == "-" || w == ":" ||
         // not sentence break
@@ -315,12 +323,11 @@ std::vector<TokenIDs> Lexicon::ConvertTextToTokenIdsNotChinese(
       continue;
     }
 
-    if (!word2ids_.count(w)) {
+    if (!GetWordIds(w, &token_ids)) {
       SHERPA_ONNX_LOGE("OOV %s. Ignore it!", w.c_str());
       continue;
     }
 
-    const auto &token_ids = word2ids_.at(w);
     this_sentence.insert(this_sentence.end(), token_ids.begin(),
                          token_ids.end());
     this_sentence.push_back(blank);
@@ -338,6 +345,22 @@ std::vector<TokenIDs> Lexicon::ConvertTextToTokenIdsNotChinese(
   return ans;
 }
 
+bool Lexicon::GetWordIds(const std::string &w,
+                         std::vector<int32_t> *ids) const {
+  if (flat_lexicon_) {
+    // Like InitLexicon(), words without any token IDs are ignored
+    return flat_lexicon_->GetIds(w, ids) && !ids->empty();
+  }
+
+  auto it = word2ids_.find(w);
+  if (it == word2ids_.end()) {
+    return false;
+  }
+
+  *ids = it->second;
+  return true;
+}
+
 void Lexicon::InitTokens(std::istream &is) { token2id_ = ReadTokens(is); }
 
 void Lexicon::InitLanguage(const std::string &_lang) {
@@ -13,6 +13,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "sherpa-onnx/csrc/flat-lexicon.h"
 #include "sherpa-onnx/csrc/offline-tts-frontend.h"
 
 namespace sherpa_onnx {
@@ -22,6 +23,9 @@ class Lexicon : public OfflineTtsFrontend {
   Lexicon() = default;  // for subclasses
                         //
   // Note: for models from piper, we won't use this class.
+  //
+  // lexicon can be either a text file or a binary file created by
+  // sherpa-onnx-compile-lexicon
   Lexicon(const std::string &lexicon, const std::string &tokens,
           const std::string &punctuations, const std::string &language,
           bool debug = false);
@@ -41,6 +45,9 @@ class Lexicon : public OfflineTtsFrontend {
   std::vector<TokenIDs> ConvertTextToTokenIdsChinese(
       const std::string &text) const;
 
+  // @return Return false if w is an OOV
+  bool GetWordIds(const std::string &w, std::vector<int32_t> *ids) const;
+
   void InitLanguage(const std::string &lang);
   void InitTokens(std::istream &is);
   void InitLexicon(std::istream &is);
@@ -55,6 +62,10 @@ class Lexicon : public OfflineTtsFrontend {
 
  private:
   std::unordered_map<std::string, std::vector<int32_t>> word2ids_;
+
+  // If not null, the lexicon is a flat lexicon and word2ids_ is empty
+  std::unique_ptr<FlatLexicon> flat_lexicon_;
+
   std::unordered_set<std::string> punctuations_;
   std::unordered_map<std::string, int32_t> token2id_;
   Language language_ = Language::kUnknown;
@@ -39,6 +39,11 @@ int32_t LodrFst::FindBackoffId() {
 
 LodrFst::LodrFst(const std::string &fst_path, int32_t backoff_id)
     : backoff_id_(backoff_id) {
+  if (FlatNgramFst::IsFlatNgramFst(fst_path)) {
+    flat_fst_ = std::make_unique<FlatNgramFst>(fst_path);
+    return;
+  }
+
   fst_ = std::unique_ptr<fst::StdConstFst>(
       CastOrConvertToConstFst(fst::StdVectorFst::Read(fst_path)));
 
@@ -53,9 +58,49 @@ LodrFst::LodrFst(const std::string &fst_path, int32_t backoff_id)
   }
 }
 
+bool LodrFst::SaveFlat(const std::string &filename) const {
+  if (!fst_) {
+    SHERPA_ONNX_LOGE("The LODR FST is already in the flat format");
+    return false;
+  }
+
+  FlatNgramFstBuilder builder;
+  builder.SetStart(fst_->Start());
+
+  for (int32_t state = 0; state < fst_->NumStates(); ++state) {
+    fst::ArcIterator<fst::StdConstFst> arc_iter(*fst_, state);
+    for (; !arc_iter.Done(); arc_iter.Next()) {
+      const auto &arc = arc_iter.Value();
+      if (arc.ilabel == backoff_id_) {
+        builder.SetBackoff(state, arc.nextstate, arc.weight.Value());
+      } else {
+        builder.AddArc(state, arc.ilabel, arc.nextstate, arc.weight.Value());
+      }
+    }
+
+    auto final_weight = fst_->Final(state);
+    if (final_weight != fst::StdArc::Weight::Zero()) {
+      builder.SetFinal(state, final_weight.Value());
+    }
+  }
+
+  return builder.Write(filename);
+}
+
 std::vector<std::tuple<int32_t, float>> LodrFst::ProcessBackoffArcs(
     int32_t state, float cost) {
   std::vector<std::tuple<int32_t, float>> ans;
+  if (flat_fst_) {
+    int32_t next_state;
+    float next_cost;
+    while (flat_fst_->Backoff(state, &next_state, &next_cost)) {
+      cost += next_cost;
+      ans.emplace_back(next_state, cost);
+      state = next_state;
+    }
+    return ans;
+  }
+
   auto next = GetNextStatesCostsNoBackoff(state, backoff_id_);
   if (!next.has_value()) {
     return ans;
@@ -69,6 +114,15 @@ std::vector<std::tuple<int32_t, float>> LodrFst::ProcessBackoffArcs(
 
 std::optional<std::tuple<int32_t, float>> LodrFst::GetNextStatesCostsNoBackoff(
     int32_t state, int32_t label) {
+  if (flat_fst_) {
+    int32_t next_state;
+    float cost;
+    if (flat_fst_->FindArc(state, label, &next_state, &cost)) {
+      return std::make_tuple(next_state, cost);
+    }
+    return std::nullopt;
+  }
+
   fst::ArcIterator<fst::StdConstFst> arc_iter(*fst_, state);
   int32_t num_arcs = fst_->NumArcs(state);
 
@@ -137,6 +191,11 @@ void LodrFst::ComputeScore(float scale, Hypothesis *hyp, int32_t offset) {
 }
 
 float LodrFst::GetFinalCost(int32_t state) {
+  if (flat_fst_) {
+    float cost;
+    return flat_fst_->Final(state, &cost) ? cost : 0.0;
+  }
+
   auto final_weight = fst_->Final(state);
   if (final_weight == fst::StdArc::Weight::Zero()) {
     return 0.0;
@@ -21,6 +21,7 @@
 
 #include "fst/const-fst.h"
 #include "kaldifst/csrc/kaldi-fst-io.h"
+#include "sherpa-onnx/csrc/flat-ngram-fst.h"
 
 namespace sherpa_onnx {
 
@@ -28,8 +29,15 @@ struct Hypothesis;
 
 class LodrFst {
  public:
+  // fst_path is either an OpenFst n-gram FST or a file saved by SaveFlat().
+  // The latter is memory-mapped and its backoff arcs are already resolved,
+  // so backoff_id is ignored for it.
   explicit LodrFst(const std::string &fst_path, int32_t backoff_id = -1);
 
+  // Save the n-gram FST in the format of FlatNgramFst.
+  // Return true on success.
+  bool SaveFlat(const std::string &filename) const;
+
   std::pair<std::vector<int32_t>, std::vector<float>> GetNextStateCosts(
     int32_t state, int32_t label);
 
@@ -51,6 +59,9 @@ class LodrFst {
 
   int32_t backoff_id_ = -1;
   std::unique_ptr<fst::StdConstFst> fst_;  // owned by this class
+
+  // Only one of fst_ and flat_fst_ is not null
+  std::unique_ptr<FlatNgramFst> flat_fst_;
 };
 
 class LodrStateCost {
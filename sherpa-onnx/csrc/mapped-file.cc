@@ -0,0 +1,61 @@
+// sherpa-onnx/csrc/mapped-file.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/mapped-file.h"
+
+#include <string>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+MappedFile::MappedFile(const std::string &filename) {
+#if !defined(_WIN32)
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+      if (p != MAP_FAILED) {
+        data_ = static_cast<const char *>(p);
+        size_ = st.st_size;
+        is_mapped_ = true;
+      }
+    }
+    // The mapping stays valid after the file descriptor is closed
+    close(fd);
+  }
+
+  if (is_mapped_) {
+    return;
+  }
+#endif
+
+  if (!FileExists(filename)) {
+    SHERPA_ONNX_LOGE("Failed to open '%s'", filename.c_str());
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  buffer_ = ReadFile(filename);
+  data_ = buffer_.data();
+  size_ = buffer_.size();
+}
+
+MappedFile::~MappedFile() {
+#if !defined(_WIN32)
+  if (is_mapped_) {
+    munmap(const_cast<char *>(data_), size_);
+  }
+#endif
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,45 @@
+// sherpa-onnx/csrc/mapped-file.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_MAPPED_FILE_H_
+#define SHERPA_ONNX_CSRC_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace sherpa_onnx {
+
+// A read-only view of the whole content of a file.
+//
+// On POSIX systems, the file is mapped into memory with mmap(), so
+// loading is nearly free and the pages are shared by all processes
+// that map the same file. On other systems, the file is read into
+// a buffer.
+class MappedFile {
+ public:
+  // It exits the program if the file cannot be opened.
+  explicit MappedFile(const std::string &filename);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const char *Data() const { return data_; }
+  size_t Size() const { return size_; }
+
+  // True if the file is memory mapped; false if it is read into a buffer.
+  bool IsMapped() const { return is_mapped_; }
+
+ private:
+  const char *data_ = nullptr;
+  size_t size_ = 0;
+  bool is_mapped_ = false;
+
+  // used only when the file is not memory mapped
+  std::vector<char> buffer_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_MAPPED_FILE_H_
@@ -9,11 +9,9 @@
 #include <algorithm>
 #include <fstream>
 #include <memory>
-#include <regex>  // NOLINT
 #include <sstream>
 #include <string>
 #include <unordered_map>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -30,10 +28,12 @@
 #include "phoneme_ids.hpp"  // NOLINT
 #include "phonemize.hpp"    // NOLINT
 #include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/flat-lexicon.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/phrase-matcher.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/text-replacer.h"
 #include "sherpa-onnx/csrc/text-utils.h"
 
 namespace sherpa_onnx {
@@ -161,6 +161,12 @@ class MatchaTtsLexicon::Impl {
     for (const auto &f : files) {
       auto buf = ReadFile(mgr, f);
 
+      if (files.size() == 1 &&
+          FlatLexicon::IsFlatLexicon(buf.data(), buf.size())) {
+        flat_lexicon_ = std::make_unique<FlatLexicon>(std::move(buf));
+        break;
+      }
+
       std::istringstream is(std::string(buf.data(), buf.size()));
       InitLexicon(is);
     }
@@ -174,15 +180,7 @@ class MatchaTtsLexicon::Impl {
   }
 
   std::vector<TokenIDs> ConvertTextToTokenIds(const std::string &_text) const {
-    std::string text = _text;
-    std::vector<std::pair<std::string, std::string>> replace_str_pairs = {
-        {"，", ","}, {"、", ","}, {"；", ";"}, {"：", ","},   {":", ","},
-        {"。", "."}, {"？", "?"}, {"！", "!"}, {"\\s+", " "},
-    };
-    for (const auto &p : replace_str_pairs) {
-      std::regex re(p.first);
-      text = std::regex_replace(text, re, p.second);
-    }
+    std::string text = punct_replacer_.Apply(_text);
 
     if (debug_) {
       SHERPA_ONNX_LOGE("After replacing punctuations and merging spaces:\n%s",
@@ -260,7 +258,8 @@ class MatchaTtsLexicon::Impl {
     std::vector<TokenIDs> ans;
     std::vector<int64_t> this_sentence;
 
-    PhraseMatcher matcher(&all_words_, words, debug_);
+    PhraseMatcher matcher(
+        [this](const std::string &w) { return HasWord(w); }, words, debug_);
 
     int32_t blank = token2id_.at(" ");
 
@@ -314,17 +313,38 @@ class MatchaTtsLexicon::Impl {
   }
 
  private:
+  bool HasWord(const std::string &w) const {
+    if (flat_lexicon_) {
+      // Like InitLexicon(), words without any token IDs are ignored
+      std::vector<int32_t> ids;
+      return flat_lexicon_->GetIds(w, &ids) && !ids.empty();
+    }
+
+    return word2ids_.count(w) > 0;
+  }
+
+  // Call it only if HasWord(w) is true
+  std::vector<int32_t> GetWordIds(const std::string &w) const {
+    if (flat_lexicon_) {
+      std::vector<int32_t> ans;
+      flat_lexicon_->GetIds(w, &ans);
+      return ans;
+    }
+
+    return word2ids_.at(w);
+  }
+
   std::vector<int32_t> ConvertWordToIds(const std::string &w) const {
     std::vector<int32_t> ans;
-    if (word2ids_.count(w)) {
-      ans = word2ids_.at(w);
+    if (HasWord(w)) {
+      ans = GetWordIds(w);
     } else if (token2id_.count(w)) {
       ans = {token2id_.at(w)};
     } else {
       if (ContainsCJK(w)) {
         std::vector<std::string> words = SplitUtf8(w);
         for (const auto &word : words) {
-          if (word2ids_.count(word)) {
+          if (HasWord(word)) {
             auto ids = ConvertWordToIds(word);
             ans.insert(ans.end(), ids.begin(), ids.end());
           }
@@ -385,6 +405,14 @@ class MatchaTtsLexicon::Impl {
 
     std::vector<std::string> files;
     SplitStringToVector(lexicon, ",", false, &files);
+
+    // A flat lexicon from sherpa-onnx-compile-lexicon already contains
+    // the words of all the text lexicons it was built from
+    if (files.size() == 1 && FlatLexicon::IsFlatLexicon(files[0])) {
+      flat_lexicon_ = std::make_unique<FlatLexicon>(files[0]);
+      return;
+    }
+
     for (const auto &f : files) {
       std::ifstream is(f);
       InitLexicon(is);
@@ -439,22 +467,32 @@ class MatchaTtsLexicon::Impl {
 
       word2ids_.insert({std::move(word), std::move(ids)});
     }
-
-    for (const auto &[key, _] : word2ids_) {
-      all_words_.insert(key);
-    }
   }
 
  private:
   // lexicon.txt is saved in word2ids_
   std::unordered_map<std::string, std::vector<int32_t>> word2ids_;
-  std::unordered_set<std::string> all_words_;
+
+  // If not null, lexicon words are looked up in it and word2ids_ is empty
+  std::unique_ptr<FlatLexicon> flat_lexicon_;
 
   // tokens.txt is saved in token2id_
   std::unordered_map<std::string, int32_t> token2id_;
 
   std::unordered_map<int32_t, std::string> id2token_;
 
+  // Replace Chinese punctuations and merge spaces. It is built once and
+  // shared by all calls of ConvertTextToTokenIds()
+  TextReplacer punct_replacer_{{{"，", ","},
+                                {"、", ","},
+                                {"；", ";"},
+                                {"：", ","},
+                                {":", ","},
+                                {"。", "."},
+                                {"？", "?"},
+                                {"！", "!"}},
+                               true};
+
   bool debug_ = false;
   bool skip_replacement_ = false;
 };  // namespace sherpa_onnx
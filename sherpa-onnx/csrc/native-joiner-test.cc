@@ -0,0 +1,169 @@
+// sherpa-onnx/csrc/native-joiner-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/native-joiner.h"
+
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+namespace {
+
+// Write messages in the protobuf wire format
+class ProtoWriter {
+ public:
+  void Varint(int32_t field, uint64_t v) {
+    Key(field, 0);
+    Raw(v);
+  }
+
+  void Float(int32_t field, float f) {
+    Key(field, 5);
+    char buf[4];
+    std::memcpy(buf, &f, 4);
+    s_.append(buf, 4);
+  }
+
+  void Bytes(int32_t field, const std::string &b) {
+    Key(field, 2);
+    Raw(b.size());
+    s_ += b;
+  }
+
+  const std::string &Str() const { return s_; }
+
+ private:
+  void Key(int32_t field, int32_t wire_type) { Raw((field << 3) | wire_type); }
+
+  void Raw(uint64_t v) {
+    while (v >= 0x80) {
+      s_.push_back(static_cast<char>((v & 0x7f) | 0x80));
+      v >>= 7;
+    }
+    s_.push_back(static_cast<char>(v));
+  }
+
+ private:
+  std::string s_;
+};
+
+std::string Tensor(const std::string &name, const std::vector<int64_t> &dims,
+                   const std::vector<float> &data) {
+  ProtoWriter w;
+  for (auto d : dims) {
+    w.Varint(1, d);
+  }
+  w.Varint(2, 1);  // float
+  w.Bytes(8, name);
+  w.Bytes(9, std::string(reinterpret_cast<const char *>(data.data()),
+                         data.size() * sizeof(float)));
+  return w.Str();
+}
+
+std::string Node(const std::string &op_type,
+                 const std::vector<std::string> &inputs,
+                 const std::string &output, const std::string &attrs = "") {
+  ProtoWriter w;
+  for (const auto &i : inputs) {
+    w.Bytes(1, i);
+  }
+  w.Bytes(2, output);
+  w.Bytes(4, op_type);
+  return w.Str() + attrs;
+}
+
+std::string Model(const std::vector<std::string> &nodes,
+                  const std::vector<std::string> &initializers) {
+  ProtoWriter g;
+  for (const auto &n : nodes) {
+    g.Bytes(1, n);
+  }
+  for (const auto &t : initializers) {
+    g.Bytes(5, t);
+  }
+
+  ProtoWriter m;
+  m.Varint(1, 8);  // ir_version
+  m.Bytes(7, g.Str());
+  return m.Str();
+}
+
+// joiner_dim 2, vocab_size 3
+const std::vector<float> kWeight = {1, 2, 3, 4, 5, 6};  // (3, 2)
+const std::vector<float> kBias = {0.5, -0.5, 1};
+
+void Check(const NativeJoiner &joiner) {
+  ASSERT_EQ(joiner.JoinerDim(), 2);
+  ASSERT_EQ(joiner.VocabSize(), 3);
+
+  std::vector<float> e = {0.1, 0.2, -0.3, 0.4};
+  std::vector<float> d = {0.5, -0.6, 0.7, 0.8};
+  const float *rows[2] = {e.data() + 2, e.data()};
+
+  std::vector<float> logits(6);
+  joiner.Run(rows, d.data(), 2, logits.data());
+
+  for (int32_t i = 0; i != 2; ++i) {
+    float h0 = std::tanh(rows[i][0] + d[2 * i]);
+    float h1 = std::tanh(rows[i][1] + d[2 * i + 1]);
+    for (int32_t v = 0; v != 3; ++v) {
+      float expected = kWeight[2 * v] * h0 + kWeight[2 * v + 1] * h1 + kBias[v];
+      EXPECT_NEAR(logits[3 * i + v], expected, 1e-5);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(NativeJoiner, Gemm) {
+  ProtoWriter trans_b;
+  trans_b.Bytes(1, "transB");
+  trans_b.Varint(3, 1);
+  ProtoWriter attr;
+  attr.Bytes(5, trans_b.Str());
+
+  std::string model = Model(
+      {Node("Add", {"encoder_out", "decoder_out"}, "sum"),
+       Node("Tanh", {"sum"}, "h"),
+       Node("Gemm", {"h", "weight", "bias"}, "logit", attr.Str())},
+      {Tensor("weight", {3, 2}, kWeight), Tensor("bias", {3}, kBias)});
+
+  auto joiner = NativeJoiner::Create(model.data(), model.size(), false);
+  ASSERT_NE(joiner, nullptr);
+  Check(*joiner);
+}
+
+TEST(NativeJoiner, MatMul) {
+  std::vector<float> weight = {1, 3, 5, 2, 4, 6};  // (2, 3)
+
+  std::string model = Model(
+      {Node("Add", {"encoder_out", "decoder_out"}, "sum"),
+       Node("Tanh", {"sum"}, "h"), Node("MatMul", {"h", "weight"}, "proj"),
+       Node("Add", {"bias", "proj"}, "logit")},
+      {Tensor("weight", {2, 3}, weight), Tensor("bias", {3}, kBias)});
+
+  auto joiner = NativeJoiner::Create(model.data(), model.size(), false);
+  ASSERT_NE(joiner, nullptr);
+  Check(*joiner);
+}
+
+TEST(NativeJoiner, Unsupported) {
+  std::string model = Model(
+      {Node("Add", {"encoder_out", "decoder_out"}, "sum"),
+       Node("Relu", {"sum"}, "h"), Node("MatMul", {"h", "weight"}, "logit")},
+      {Tensor("weight", {2, 3}, kWeight)});
+
+  EXPECT_EQ(NativeJoiner::Create(model.data(), model.size(), false), nullptr);
+
+  std::string garbage = "not a model";
+  EXPECT_EQ(NativeJoiner::Create(garbage.data(), garbage.size(), false),
+            nullptr);
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,507 @@
+// sherpa-onnx/csrc/native-joiner.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/native-joiner.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Eigen/Dense"
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+namespace {
+
+// A reader of the protobuf wire format. It knows just enough to walk
+// through the nodes and initializers of an ONNX model.
+class ProtoReader {
+ public:
+  ProtoReader(const char *p, size_t n) : p_(p), end_(p + n) {}
+
+  bool Ok() const { return ok_; }
+
+  // Return false at the end of the message or on malformed input
+  bool Next(int32_t *field, int32_t *wire_type) {
+    if (!ok_ || p_ >= end_) {
+      return false;
+    }
+
+    uint64_t key = ReadVarint();
+    *field = static_cast<int32_t>(key >> 3);
+    *wire_type = static_cast<int32_t>(key & 7);
+    return ok_;
+  }
+
+  uint64_t ReadVarint() {
+    uint64_t ans = 0;
+    for (int32_t shift = 0; shift < 64; shift += 7) {
+      if (p_ >= end_) {
+        break;
+      }
+      uint8_t b = static_cast<uint8_t>(*p_++);
+      ans |= static_cast<uint64_t>(b & 0x7f) << shift;
+      if (!(b & 0x80)) {
+        return ans;
+      }
+    }
+    ok_ = false;
+    return 0;
+  }
+
+  float ReadFloat() {
+    float ans = 0;
+    if (end_ - p_ < 4) {
+      ok_ = false;
+      return ans;
+    }
+    std::memcpy(&ans, p_, 4);
+    p_ += 4;
+    return ans;
+  }
+
+  // For wire type 2
+  ProtoReader ReadBytes() {
+    uint64_t n = ReadVarint();
+    if (!ok_ || n > static_cast<uint64_t>(end_ - p_)) {
+      ok_ = false;
+      return ProtoReader(p_, 0);
+    }
+    ProtoReader ans(p_, n);
+    p_ += n;
+    return ans;
+  }
+
+  std::string ReadString() {
+    ProtoReader r = ReadBytes();
+    return std::string(r.p_, r.end_);
+  }
+
+  void Skip(int32_t wire_type) {
+    switch (wire_type) {
+      case 0:
+        ReadVarint();
+        break;
+      case 1:
+        Advance(8);
+        break;
+      case 2:
+        ReadBytes();
+        break;
+      case 5:
+        Advance(4);
+        break;
+      default:
+        ok_ = false;
+        break;
+    }
+  }
+
+  const char *Data() const { return p_; }
+  size_t Size() const { return end_ - p_; }
+
+ private:
+  void Advance(size_t n) {
+    if (static_cast<size_t>(end_ - p_) < n) {
+      ok_ = false;
+      return;
+    }
+    p_ += n;
+  }
+
+ private:
+  const char *p_;
+  const char *end_;
+  bool ok_ = true;
+};
+
+// Only float tensors with data inside the model are supported
+struct Tensor {
+  std::vector<int64_t> dims;
+  std::vector<float> data;
+  bool ok = false;
+
+  int64_t NumElements() const {
+    int64_t ans = 1;
+    for (auto d : dims) {
+      ans *= d;
+    }
+    return ans;
+  }
+};
+
+struct Node {
+  std::string op_type;
+  std::vector<std::string> inputs;
+  std::vector<std::string> outputs;
+
+  std::unordered_map<std::string, int64_t> ints;
+  std::unordered_map<std::string, float> floats;
+  std::unordered_map<std::string, Tensor> tensors;
+};
+
+// See TensorProto in onnx.proto
+Tensor ParseTensor(ProtoReader r, std::string *name) {
+  constexpr int32_t kFloat = 1;
+
+  Tensor ans;
+  int32_t data_type = 0;
+  bool external = false;
+
+  int32_t field, wire_type;
+  while (r.Next(&field, &wire_type)) {
+    if (field == 1 && wire_type == 0) {
+      ans.dims.push_back(r.ReadVarint());
+    } else if (field == 1 && wire_type == 2) {
+      ProtoReader packed = r.ReadBytes();
+      while (packed.Size() > 0 && packed.Ok()) {
+        ans.dims.push_back(packed.ReadVarint());
+      }
+    } else if (field == 2 && wire_type == 0) {
+      data_type = r.ReadVarint();
+    } else if (field == 4 && wire_type == 5) {
+      ans.data.push_back(r.ReadFloat());
+    } else if (field == 4 && wire_type == 2) {
+      ProtoReader packed = r.ReadBytes();
+      while (packed.Size() > 0 && packed.Ok()) {
+        ans.data.push_back(packed.ReadFloat());
+      }
+    } else if (field == 8 && wire_type == 2) {
+      std::string s = r.ReadString();
+      if (name) {
+        *name = std::move(s);
+      }
+    } else if (field == 9 && wire_type == 2) {
+      ProtoReader raw = r.ReadBytes();
+      ans.data.resize(raw.Size() / sizeof(float));
+      std::memcpy(ans.data.data(), raw.Data(),
+                  ans.data.size() * sizeof(float));
+    } else if (field == 14 && wire_type == 0) {
+      external = r.ReadVarint() == 1;
+    } else {
+      r.Skip(wire_type);
+    }
+  }
+
+  ans.ok = r.Ok() && data_type == kFloat && !external &&
+           static_cast<int64_t>(ans.data.size()) == ans.NumElements();
+  return ans;
+}
+
+// See NodeProto and AttributeProto in onnx.proto
+Node ParseNode(ProtoReader r) {
+  Node ans;
+
+  int32_t field, wire_type;
+  while (r.Next(&field, &wire_type)) {
+    if (field == 1 && wire_type == 2) {
+      ans.inputs.push_back(r.ReadString());
+    } else if (field == 2 && wire_type == 2) {
+      ans.outputs.push_back(r.ReadString());
+    } else if (field == 4 && wire_type == 2) {
+      ans.op_type = r.ReadString();
+    } else if (field == 5 && wire_type == 2) {
+      ProtoReader a = r.ReadBytes();
+      std::string name;
+      int32_t f, w;
+      while (a.Next(&f, &w)) {
+        if (f == 1 && w == 2) {
+          name = a.ReadString();
+        } else if (f == 2 && w == 5) {
+          ans.floats[name] = a.ReadFloat();
+        } else if (f == 3 && w == 0) {
+          ans.ints[name] = static_cast<int64_t>(a.ReadVarint());
+        } else if (f == 5 && w == 2) {
+          ans.tensors[name] = ParseTensor(a.ReadBytes(), nullptr);
+        } else {
+          a.Skip(w);
+        }
+      }
+    } else {
+      r.Skip(wire_type);
+    }
+  }
+
+  return ans;
+}
+
+bool ParseGraph(const char *model_data, size_t model_data_length,
+                std::vector<Node> *nodes,
+                std::unordered_map<std::string, Tensor> *tensors) {
+  ProtoReader model(model_data, model_data_length);
+
+  int32_t field, wire_type;
+  while (model.Next(&field, &wire_type)) {
+    if (field != 7 || wire_type != 2) {
+      model.Skip(wire_type);
+      continue;
+    }
+
+    ProtoReader graph = model.ReadBytes();
+    int32_t f, w;
+    while (graph.Next(&f, &w)) {
+      if (f == 1 && w == 2) {
+        nodes->push_back(ParseNode(graph.ReadBytes()));
+      } else if (f == 5 && w == 2) {
+        std::string name;
+        Tensor t = ParseTensor(graph.ReadBytes(), &name);
+        (*tensors)[name] = std::move(t);
+      } else {
+        graph.Skip(w);
+      }
+    }
+
+    if (!graph.Ok()) {
+      return false;
+    }
+  }
+
+  return model.Ok();
+}
+
+// Return a matrix of shape (cols, rows)
+std::vector<float> Transpose(const std::vector<float> &m, int32_t rows,
+                             int32_t cols) {
+  std::vector<float> ans(m.size());
+  for (int32_t r = 0; r != rows; ++r) {
+    for (int32_t c = 0; c != cols; ++c) {
+      ans[c * rows + r] = m[r * cols + c];
+    }
+  }
+  return ans;
+}
+
+using RowMajorMatrix =
+    Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+}  // namespace
+
+std::unique_ptr<NativeJoiner> NativeJoiner::Create(const char *model_data,
+                                                   size_t model_data_length,
+                                                   bool debug) {
+  std::vector<Node> nodes;
+  std::unordered_map<std::string, Tensor> tensors;
+  if (!ParseGraph(model_data, model_data_length, &nodes, &tensors)) {
+    SHERPA_ONNX_LOGE("Failed to parse the joiner model");
+    return nullptr;
+  }
+
+  // Expected graph:
+  //   sum = Add(encoder_out, decoder_out)
+  //   h = Tanh(sum)
+  //   logit = Gemm(h, weight, bias), or Add(MatMul(h, weight), bias)
+  const Node *add = nullptr;
+  const Node *act = nullptr;
+  const Node *proj = nullptr;
+  const Node *bias_add = nullptr;
+
+  int32_t num_nodes = 0;
+  for (const auto &n : nodes) {
+    if (n.op_type == "Constant") {
+      auto it = n.tensors.find("value");
+      if (it != n.tensors.end() && !n.outputs.empty()) {
+        tensors[n.outputs[0]] = it->second;
+      }
+      continue;
+    }
+    ++num_nodes;
+
+    if (n.outputs.empty()) {
+      return nullptr;
+    }
+
+    if (n.op_type == "Tanh") {
+      act = &n;
+    } else if (n.op_type == "Gemm" || n.op_type == "MatMul") {
+      proj = &n;
+    } else if (n.op_type == "Add" && n.inputs.size() == 2) {
+      if (tensors.count(n.inputs[0]) || tensors.count(n.inputs[1])) {
+        bias_add = &n;
+      } else {
+        add = &n;
+      }
+    }
+  }
+
+  auto unsupported = [debug](const char *reason) {
+    if (debug) {
+      SHERPA_ONNX_LOGE("Native joiner is not used: %s", reason);
+    }
+    return nullptr;
+  };
+
+  if (!add || !act || !proj || num_nodes != (bias_add ? 4 : 3)) {
+    return unsupported("unexpected graph");
+  }
+
+  if (act->inputs.empty() || act->inputs[0] != add->outputs[0] ||
+      proj->inputs.size() < 2 || proj->inputs[0] != act->outputs[0]) {
+    return unsupported("unexpected graph");
+  }
+
+  auto w_it = tensors.find(proj->inputs[1]);
+  if (w_it == tensors.end() || !w_it->second.ok ||
+      w_it->second.dims.size() != 2) {
+    return unsupported("unsupported weight");
+  }
+  const Tensor &w = w_it->second;
+
+  // The weight is stored as (vocab_size, joiner_dim)
+  bool transposed = false;
+  const Tensor *b = nullptr;
+
+  if (proj->op_type == "Gemm") {
+    auto get_int = [proj](const char *name, int64_t v) {
+      auto it = proj->ints.find(name);
+      return it == proj->ints.end() ? v : it->second;
+    };
+    auto get_float = [proj](const char *name, float v) {
+      auto it = proj->floats.find(name);
+      return it == proj->floats.end() ? v : it->second;
+    };
+
+    if (bias_add || get_int("transA", 0) != 0 ||
+        get_float("alpha", 1) != 1 || get_float("beta", 1) != 1) {
+      return unsupported("unsupported Gemm");
+    }
+    transposed = get_int("transB", 0) != 0;
+
+    if (proj->inputs.size() > 2 && !proj->inputs[2].empty()) {
+      auto it = tensors.find(proj->inputs[2]);
+      if (it == tensors.end()) {
+        return unsupported("unsupported bias");
+      }
+      b = &it->second;
+    }
+  } else {
+    if (bias_add) {
+      const auto &in = bias_add->inputs;
+      if (in[0] != proj->outputs[0] && in[1] != proj->outputs[0]) {
+        return unsupported("unexpected graph");
+      }
+      b = &tensors.at(in[0] == proj->outputs[0] ? in[1] : in[0]);
+    }
+  }
+
+  auto ans = std::unique_ptr<NativeJoiner>(new NativeJoiner);
+  if (transposed) {
+    ans->vocab_size_ = w.dims[0];
+    ans->joiner_dim_ = w.dims[1];
+    ans->weight_ = w.data;
+  } else {
+    ans->joiner_dim_ = w.dims[0];
+    ans->vocab_size_ = w.dims[1];
+    ans->weight_ = Transpose(w.data, w.dims[0], w.dims[1]);
+  }
+
+  if (b) {
+    if (!b->ok || b->data.size() != static_cast<size_t>(ans->vocab_size_)) {
+      return unsupported("unsupported bias");
+    }
+    ans->bias_ = b->data;
+  } else {
+    ans->bias_.resize(ans->vocab_size_);
+  }
+
+  if (debug) {
+    SHERPA_ONNX_LOGE("Native joiner: joiner_dim %d, vocab_size %d",
+                     ans->joiner_dim_, ans->vocab_size_);
+  }
+
+  return ans;
+}
+
+void NativeJoiner::Run(const float *const *encoder_out,
+                       const float *decoder_out, int32_t n,
+                       float *logits) const {
+  int32_t dim = joiner_dim_;
+
+  RowMajorMatrix h(n, dim);
+  for (int32_t i = 0; i != n; ++i) {
+    Eigen::Map<const Eigen::RowVectorXf> e(encoder_out[i], dim);
+    Eigen::Map<const Eigen::RowVectorXf> d(decoder_out + i * dim, dim);
+    h.row(i) = (e + d).array().tanh();
+  }
+
+  Eigen::Map<const RowMajorMatrix> w(weight_.data(), vocab_size_, dim);
+  Eigen::Map<const Eigen::RowVectorXf> b(bias_.data(), vocab_size_);
+  Eigen::Map<RowMajorMatrix> out(logits, n, vocab_size_);
+
+  out.noalias() = h * w.transpose();
+  out.rowwise() += b;
+}
+
+Ort::Value NativeJoiner::Run(const Ort::Value &encoder_out,
+                             const Ort::Value &decoder_out,
+                             OrtAllocator *allocator) const {
+  int32_t n = encoder_out.GetTensorTypeAndShapeInfo().GetShape()[0];
+
+  const float *p = encoder_out.GetTensorData<float>();
+  std::vector<const float *> rows(n);
+  for (int32_t i = 0; i != n; ++i) {
+    rows[i] = p + i * joiner_dim_;
+  }
+
+  std::array<int64_t, 2> shape{n, vocab_size_};
+  Ort::Value ans =
+      Ort::Value::CreateTensor<float>(allocator, shape.data(), shape.size());
+
+  Run(rows.data(), decoder_out.GetTensorData<float>(), n,
+      ans.GetTensorMutableData<float>());
+
+  return ans;
+}
+
+bool NativeJoiner::Verify(
+    const std::function<Ort::Value(Ort::Value, Ort::Value)> &run_joiner,
+    OrtAllocator *allocator) const {
+  constexpr int32_t kNumRows = 3;
+
+  std::array<int64_t, 2> shape{kNumRows, joiner_dim_};
+  Ort::Value encoder_out =
+      Ort::Value::CreateTensor<float>(allocator, shape.data(), shape.size());
+  Ort::Value decoder_out =
+      Ort::Value::CreateTensor<float>(allocator, shape.data(), shape.size());
+
+  std::mt19937 gen(20250101);
+  std::uniform_real_distribution<float> dist(-1, 1);
+
+  int32_t n = kNumRows * joiner_dim_;
+  float *e = encoder_out.GetTensorMutableData<float>();
+  float *d = decoder_out.GetTensorMutableData<float>();
+  for (int32_t i = 0; i != n; ++i) {
+    e[i] = dist(gen);
+    d[i] = dist(gen);
+  }
+
+  Ort::Value actual = Run(encoder_out, decoder_out, allocator);
+
+  Ort::Value expected =
+      run_joiner(std::move(encoder_out), std::move(decoder_out));
+
+  auto expected_shape = expected.GetTensorTypeAndShapeInfo().GetShape();
+  if (expected_shape.size() != 2 || expected_shape[0] != kNumRows ||
+      expected_shape[1] != vocab_size_) {
+    return false;
+  }
+
+  const float *p = actual.GetTensorData<float>();
+  const float *q = expected.GetTensorData<float>();
+  for (int32_t i = 0; i != kNumRows * vocab_size_; ++i) {
+    if (!(std::abs(p[i] - q[i]) <= 1e-3f * (1 + std::abs(q[i])))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+}  // namespace sherpa_onnx
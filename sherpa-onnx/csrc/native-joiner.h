@@ -0,0 +1,86 @@
+// sherpa-onnx/csrc/native-joiner.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_NATIVE_JOINER_H_
+#define SHERPA_ONNX_CSRC_NATIVE_JOINER_H_
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "onnxruntime_cxx_api.h"  // NOLINT
+
+namespace sherpa_onnx {
+
+/* A C++ implementation of the joiner of icefall transducer models.
+ *
+ * The exported joiner.onnx computes
+ *
+ *   logit = output_linear(tanh(encoder_out + decoder_out))
+ *
+ * since the encoder and decoder projections are already folded into
+ * encoder.onnx and decoder.onnx. For small joiners, the overhead of a
+ * session Run() per frame outweighs the computation, so this class extracts
+ * the weights of output_linear from joiner.onnx and computes the logits of
+ * all rows with a single matrix multiplication. It also reads encoder frames
+ * in place, so the frames do not have to be gathered into a new tensor first.
+ */
+class NativeJoiner {
+ public:
+  /* Return nullptr if the model does not have the structure above, e.g.,
+   * it is quantized.
+   *
+   * @param model_data Content of joiner.onnx
+   */
+  static std::unique_ptr<NativeJoiner> Create(const char *model_data,
+                                              size_t model_data_length,
+                                              bool debug);
+
+  int32_t JoinerDim() const { return joiner_dim_; }
+
+  int32_t VocabSize() const { return vocab_size_; }
+
+  /*
+   * @param encoder_out encoder_out[i] points to joiner_dim floats.
+   * @param decoder_out Array of shape (n, joiner_dim).
+   * @param n Number of rows.
+   * @param logits Output array of shape (n, vocab_size).
+   */
+  void Run(const float *const *encoder_out, const float *decoder_out,
+           int32_t n, float *logits) const;
+
+  /* Same as the joiner model.
+   *
+   * @param encoder_out A tensor of shape (N, joiner_dim).
+   * @param decoder_out A tensor of shape (N, joiner_dim).
+   * @return Return a tensor of shape (N, vocab_size).
+   */
+  Ort::Value Run(const Ort::Value &encoder_out, const Ort::Value &decoder_out,
+                 OrtAllocator *allocator) const;
+
+  /* Compare the output with that of run_joiner(), which runs joiner.onnx,
+   * on random inputs.
+   *
+   * @return Return true if they match.
+   */
+  bool Verify(
+      const std::function<Ort::Value(Ort::Value, Ort::Value)> &run_joiner,
+      OrtAllocator *allocator) const;
+
+ private:
+  NativeJoiner() = default;
+
+ private:
+  int32_t joiner_dim_ = 0;
+  int32_t vocab_size_ = 0;
+
+  // (vocab_size, joiner_dim), row major
+  std::vector<float> weight_;
+
+  // (vocab_size,)
+  std::vector<float> bias_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_NATIVE_JOINER_H_
@@ -0,0 +1,55 @@
+// sherpa-onnx/csrc/numa-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/numa.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(ParseCpuList, Basic) {
+  std::vector<int32_t> cpus;
+  EXPECT_TRUE(ParseCpuList("0-3,8,10-11\n", &cpus));
+  EXPECT_EQ(cpus, (std::vector<int32_t>{0, 1, 2, 3, 8, 10, 11}));
+
+  cpus.clear();
+  EXPECT_TRUE(ParseCpuList("", &cpus));
+  EXPECT_TRUE(cpus.empty());
+}
+
+TEST(ParseCpuList, Invalid) {
+  std::vector<int32_t> cpus;
+  EXPECT_FALSE(ParseCpuList("3-1", &cpus));
+  EXPECT_FALSE(ParseCpuList("a", &cpus));
+  EXPECT_FALSE(ParseCpuList("1-", &cpus));
+}
+
+TEST(CpuListToString, Basic) {
+  EXPECT_EQ(CpuListToString({0, 1, 2, 3, 8, 10, 11}), "0-3,8,10-11");
+  EXPECT_EQ(CpuListToString({5}), "5");
+  EXPECT_EQ(CpuListToString({}), "");
+
+  std::vector<int32_t> cpus;
+  EXPECT_TRUE(ParseCpuList(CpuListToString({1, 2, 4, 6, 7}), &cpus));
+  EXPECT_EQ(cpus, (std::vector<int32_t>{1, 2, 4, 6, 7}));
+}
+
+TEST(GetNumaNodes, Basic) {
+  // Every CPU belongs to at most one node
+  std::vector<bool> seen;
+  for (const auto &node : GetNumaNodes()) {
+    EXPECT_FALSE(node.cpus.empty());
+    for (auto c : node.cpus) {
+      if (c >= static_cast<int32_t>(seen.size())) {
+        seen.resize(c + 1);
+      }
+      EXPECT_FALSE(seen[c]);
+      seen[c] = true;
+    }
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,129 @@
+// sherpa-onnx/csrc/numa.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/numa.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/text-utils.h"
+
+namespace sherpa_onnx {
+
+bool ParseCpuList(const std::string &s, std::vector<int32_t> *cpus) {
+  std::vector<std::string> ranges;
+  SplitStringToVector(Trim(s), ",", true, &ranges);
+
+  for (const auto &r : ranges) {
+    auto pos = r.find('-');
+
+    int32_t first = 0;
+    int32_t last = 0;
+    if (pos == std::string::npos) {
+      if (!ConvertStringToInteger(r, &first)) {
+        return false;
+      }
+      last = first;
+    } else if (!ConvertStringToInteger(r.substr(0, pos), &first) ||
+               !ConvertStringToInteger(r.substr(pos + 1), &last)) {
+      return false;
+    }
+
+    if (first < 0 || last < first) {
+      return false;
+    }
+
+    for (int32_t i = first; i <= last; ++i) {
+      cpus->push_back(i);
+    }
+  }
+
+  return true;
+}
+
+std::string CpuListToString(const std::vector<int32_t> &cpus) {
+  std::ostringstream os;
+  std::string sep;
+
+  int32_t n = cpus.size();
+  for (int32_t i = 0; i < n;) {
+    int32_t j = i;
+    while (j + 1 < n && cpus[j + 1] == cpus[j] + 1) {
+      ++j;
+    }
+
+    os << sep << cpus[i];
+    if (j > i) {
+      os << "-" << cpus[j];
+    }
+    sep = ",";
+
+    i = j + 1;
+  }
+
+  return os.str();
+}
+
+std::vector<NumaNode> GetNumaNodes() {
+  std::vector<NumaNode> ans;
+
+#if defined(__linux__)
+  const std::string dir = "/sys/devices/system/node/";
+
+  std::ifstream is(dir + "online");
+  std::string line;
+  std::vector<int32_t> ids;
+  if (!std::getline(is, line) || !ParseCpuList(line, &ids)) {
+    return ans;
+  }
+
+  for (auto id : ids) {
+    std::ifstream cpulist(dir + "node" + std::to_string(id) + "/cpulist");
+
+    NumaNode node;
+    node.id = id;
+    if (!std::getline(cpulist, line) || !ParseCpuList(line, &node.cpus)) {
+      return {};
+    }
+
+    // Skip nodes with only memory
+    if (!node.cpus.empty()) {
+      ans.push_back(std::move(node));
+    }
+  }
+#endif
+
+  return ans;
+}
+
+bool SetThreadAffinity(const std::vector<int32_t> &cpus) {
+#if defined(__linux__)
+  if (cpus.empty()) {
+    return false;
+  }
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (auto c : cpus) {
+    if (c >= CPU_SETSIZE) {
+      return false;
+    }
+    CPU_SET(c, &set);
+  }
+
+  // 0 means the calling thread
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,43 @@
+// sherpa-onnx/csrc/numa.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_NUMA_H_
+#define SHERPA_ONNX_CSRC_NUMA_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sherpa_onnx {
+
+struct NumaNode {
+  int32_t id = 0;
+
+  // CPUs of this node, e.g., {0, 1, 2, 3}
+  std::vector<int32_t> cpus;
+};
+
+// Return the NUMA nodes that have CPUs. It reads /sys/devices/system/node
+// and returns an empty vector if the information is not available, e.g.,
+// on platforms other than Linux.
+std::vector<NumaNode> GetNumaNodes();
+
+// Parse a CPU list in the format of the Linux kernel, e.g., "0-3,8,10-11".
+//
+// @return Return false if s is not a valid CPU list.
+bool ParseCpuList(const std::string &s, std::vector<int32_t> *cpus);
+
+// Format CPUs as a CPU list, e.g., {0, 1, 2, 3, 8} -> "0-3,8".
+// The CPUs must be sorted in ascending order.
+std::string CpuListToString(const std::vector<int32_t> &cpus);
+
+// Restrict the calling thread to run on the given CPUs. Memory the thread
+// touches first is then allocated on the node of the CPUs by the default
+// policy of Linux.
+//
+// @return Return false if it fails or is not supported on this platform.
+bool SetThreadAffinity(const std::vector<int32_t> &cpus);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_NUMA_H_
@@ -0,0 +1,146 @@
+// sherpa-onnx/csrc/offline-batch-transcriber-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-batch-transcriber.h"
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/wave-writer.h"
+
+namespace sherpa_onnx {
+
+// It "recognizes" a stream as its number of feature frames. Batches take
+// a random amount of time, so they finish out of order.
+class FakeBatchDecoder : public OfflineBatchDecoder {
+ public:
+  std::unique_ptr<OfflineStream> CreateStream() const override {
+    return std::make_unique<OfflineStream>();
+  }
+
+  void DecodeStreams(OfflineStream **ss, int32_t n) const override {
+    int32_t ms = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ms = dist_(rng_);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+
+    for (int32_t i = 0; i != n; ++i) {
+      OfflineRecognitionResult r;
+      r.text = std::to_string(ss[i]->NumFrames());
+      ss[i]->SetResult(r);
+    }
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  mutable std::mt19937 rng_{20251019};
+  mutable std::uniform_int_distribution<int32_t> dist_{0, 20};
+};
+
+class ThrowingBatchDecoder : public OfflineBatchDecoder {
+ public:
+  std::unique_ptr<OfflineStream> CreateStream() const override {
+    return std::make_unique<OfflineStream>();
+  }
+
+  void DecodeStreams(OfflineStream ** /*ss*/, int32_t /*n*/) const override {
+    throw std::runtime_error("Failed to decode");
+  }
+};
+
+TEST(OfflineBatchTranscriber, OrderedOutput) {
+  // More files than workers and batches, with a missing file in between
+  int32_t num_files = 23;
+  int32_t sample_rate = 16000;
+
+  std::vector<std::string> filenames;
+  std::vector<std::string> expected_text(num_files);
+  std::vector<float> expected_duration(num_files);
+
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int32_t> num_samples_dist(1600, 16000);
+
+  for (int32_t i = 0; i != num_files; ++i) {
+    std::string filename =
+        "offline-batch-transcriber-test-" + std::to_string(i) + ".wav";
+    filenames.push_back(filename);
+
+    if (i == 5) {
+      // It does not exist
+      continue;
+    }
+
+    std::vector<float> samples(num_samples_dist(rng), 0.1f);
+    ASSERT_TRUE(
+        WriteWave(filename, sample_rate, samples.data(), samples.size()));
+
+    OfflineStream s;
+    s.AcceptWaveform(sample_rate, samples.data(), samples.size());
+    expected_text[i] = std::to_string(s.NumFrames());
+    expected_duration[i] = samples.size() / static_cast<float>(sample_rate);
+  }
+
+  OfflineBatchTranscriberConfig config(3, 2, 1);
+  OfflineBatchTranscriber transcriber(std::make_unique<FakeBatchDecoder>(),
+                                      config);
+
+  int32_t next = 0;
+  transcriber.Run(filenames, [&](const OfflineBatchTranscriberResult &r) {
+    EXPECT_EQ(r.index, next);
+    EXPECT_EQ(r.filename, filenames[next]);
+    if (next == 5) {
+      EXPECT_FALSE(r.ok);
+    } else {
+      EXPECT_TRUE(r.ok);
+      EXPECT_NEAR(r.duration, expected_duration[next], 1e-5);
+      EXPECT_EQ(r.result.text, expected_text[next]);
+    }
+    ++next;
+  });
+
+  EXPECT_EQ(next, num_files);
+
+  for (const auto &f : filenames) {
+    std::remove(f.c_str());
+  }
+}
+
+// Run() rethrows the exception, and reader tasks of buckets that are
+// prefetched but never decoded must finish before Run() returns
+TEST(OfflineBatchTranscriber, Exception) {
+  int32_t num_files = 20;
+  std::vector<std::string> filenames;
+  std::vector<float> samples(16000, 0.1f);
+  for (int32_t i = 0; i != num_files; ++i) {
+    std::string filename =
+        "offline-batch-transcriber-test-" + std::to_string(i) + ".wav";
+    filenames.push_back(filename);
+    ASSERT_TRUE(WriteWave(filename, 16000, samples.data(), samples.size()));
+  }
+
+  OfflineBatchTranscriberConfig config(2, 1, 4);
+  OfflineBatchTranscriber transcriber(std::make_unique<ThrowingBatchDecoder>(),
+                                      config);
+
+  EXPECT_THROW(
+      transcriber.Run(filenames,
+                      [](const OfflineBatchTranscriberResult & /*r*/) {}),
+      std::runtime_error);
+
+  for (const auto &f : filenames) {
+    std::remove(f.c_str());
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,370 @@
+// sherpa-onnx/csrc/offline-batch-transcriber.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-batch-transcriber.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <deque>
+#include <future>  // NOLINT
+#include <limits>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/audio-source.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
+
+namespace sherpa_onnx {
+
+void OfflineBatchTranscriberConfig::Register(ParseOptions *po) {
+  po->Register("nj", &num_workers,
+               "Number of threads decoding files in parallel");
+
+  po->Register("batch-size", &batch_size,
+               "Maximum number of files decoded at once by a thread. Files "
+               "are grouped by duration to reduce paddings");
+
+  po->Register("num-readers", &num_readers,
+               "Number of threads reading files ahead of the decoding "
+               "threads. 0 to read files in the decoding threads");
+}
+
+bool OfflineBatchTranscriberConfig::Validate() const {
+  if (num_workers < 1) {
+    SHERPA_ONNX_LOGE("--nj should be >= 1. Given: %d", num_workers);
+    return false;
+  }
+
+  if (batch_size < 1) {
+    SHERPA_ONNX_LOGE("--batch-size should be >= 1. Given: %d", batch_size);
+    return false;
+  }
+
+  if (num_readers < 0) {
+    SHERPA_ONNX_LOGE("--num-readers should be >= 0. Given: %d", num_readers);
+    return false;
+  }
+
+  return true;
+}
+
+std::string OfflineBatchTranscriberConfig::ToString() const {
+  std::ostringstream os;
+
+  os << "OfflineBatchTranscriberConfig(";
+  os << "num_workers=" << num_workers << ", ";
+  os << "batch_size=" << batch_size << ", ";
+  os << "num_readers=" << num_readers << ")";
+
+  return os.str();
+}
+
+namespace {
+
+class RecognizerBatchDecoder : public OfflineBatchDecoder {
+ public:
+  explicit RecognizerBatchDecoder(const OfflineRecognizer *recognizer)
+      : recognizer_(recognizer) {}
+
+  std::unique_ptr<OfflineStream> CreateStream() const override {
+    return recognizer_->CreateStream();
+  }
+
+  void DecodeStreams(OfflineStream **ss, int32_t n) const override {
+    recognizer_->DecodeStreams(ss, n);
+  }
+
+ private:
+  const OfflineRecognizer *recognizer_;  // not owned
+};
+
+using Streams = std::vector<std::unique_ptr<OfflineStream>>;
+
+struct Bucket {
+  std::vector<int32_t> indexes;  // into the list of files
+
+  std::mutex mutex;
+  bool started = false;
+  // Streams of the files in this bucket after their features are computed.
+  // An entry is nullptr if the file cannot be read.
+  std::future<Streams> streams;
+};
+
+// Wait for the reader tasks of all prefetched buckets when Run() exits.
+// If a worker throws, ParallelFor() skips the remaining buckets, so
+// some prefetched streams are never collected, and their reader tasks
+// would otherwise still refer to the local variables of Run().
+class PrefetchGuard {
+ public:
+  explicit PrefetchGuard(const std::vector<std::unique_ptr<Bucket>> *buckets)
+      : buckets_(buckets) {}
+
+  ~PrefetchGuard() {
+    for (const auto &b : *buckets_) {
+      std::lock_guard<std::mutex> lock(b->mutex);
+      if (b->streams.valid()) {
+        b->streams.wait();
+      }
+    }
+  }
+
+ private:
+  const std::vector<std::unique_ptr<Bucket>> *buckets_;  // not owned
+};
+
+// One queue of buckets per worker. A worker takes buckets from the front
+// of its own queue and, when it is empty, steals from the back of the
+// others. Buckets are pushed longest first, so a thief takes the shortest
+// remaining work of its victim.
+class BucketQueues {
+ public:
+  explicit BucketQueues(int32_t num_workers) : queues_(num_workers) {}
+
+  void Push(int32_t worker, int32_t bucket) {
+    auto &q = queues_[worker];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    q.buckets.push_back(bucket);
+  }
+
+  // Return -1 if all queues are empty
+  int32_t Pop(int32_t worker) {
+    {
+      auto &q = queues_[worker];
+      std::lock_guard<std::mutex> lock(q.mutex);
+      if (!q.buckets.empty()) {
+        int32_t ans = q.buckets.front();
+        q.buckets.pop_front();
+        return ans;
+      }
+    }
+
+    int32_t n = queues_.size();
+    for (int32_t i = 1; i != n; ++i) {
+      auto &q = queues_[(worker + i) % n];
+      std::lock_guard<std::mutex> lock(q.mutex);
+      if (!q.buckets.empty()) {
+        int32_t ans = q.buckets.back();
+        q.buckets.pop_back();
+        return ans;
+      }
+    }
+
+    return -1;
+  }
+
+  // Return the bucket that worker would take next from its own queue,
+  // or -1 if there is none
+  int32_t Peek(int32_t worker) {
+    auto &q = queues_[worker];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    return q.buckets.empty() ? -1 : q.buckets.front();
+  }
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<int32_t> buckets;
+  };
+
+  std::vector<Queue> queues_;
+};
+
+// Pass results to the callback in the order of the input files
+class OrderedOutput {
+ public:
+  OrderedOutput(int32_t n, const OfflineBatchTranscriberCallback &callback)
+      : results_(n), callback_(callback) {}
+
+  void Put(std::unique_ptr<OfflineBatchTranscriberResult> r) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int32_t index = r->index;
+    results_[index] = std::move(r);
+
+    while (next_ < static_cast<int32_t>(results_.size()) && results_[next_]) {
+      callback_(*results_[next_]);
+      results_[next_].reset();
+      ++next_;
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<OfflineBatchTranscriberResult>> results_;
+  int32_t next_ = 0;
+  const OfflineBatchTranscriberCallback &callback_;
+};
+
+}  // namespace
+
+OfflineBatchTranscriber::OfflineBatchTranscriber(
+    const OfflineRecognizer *recognizer,
+    const OfflineBatchTranscriberConfig &config)
+    : OfflineBatchTranscriber(
+          std::make_unique<RecognizerBatchDecoder>(recognizer), config) {}
+
+OfflineBatchTranscriber::OfflineBatchTranscriber(
+    std::unique_ptr<OfflineBatchDecoder> decoder,
+    const OfflineBatchTranscriberConfig &config)
+    : decoder_(std::move(decoder)),
+      config_(config),
+      // The calling thread of Run() is also a worker
+      workers_(std::make_unique<ThreadPool>(config.num_workers - 1)),
+      readers_(std::make_unique<ThreadPool>(config.num_readers)) {}
+
+OfflineBatchTranscriber::~OfflineBatchTranscriber() = default;
+
+void OfflineBatchTranscriber::Run(
+    const std::vector<std::string> &filenames,
+    const OfflineBatchTranscriberCallback &callback) const {
+  int32_t n = filenames.size();
+  if (n == 0) {
+    return;
+  }
+
+  // Only the headers are read here. Samples are read when a bucket is
+  // about to be decoded.
+  std::vector<float> durations(n, -1);
+  readers_->ParallelFor(n, [&](int32_t i) {
+    auto source = AudioFileSource::CreateFromWave(filenames[i]);
+    if (source) {
+      durations[i] =
+          source->NumSamples() / static_cast<float>(source->SampleRate());
+    }
+  });
+
+  OrderedOutput output(n, callback);
+
+  std::vector<int32_t> indexes;
+  indexes.reserve(n);
+  for (int32_t i = 0; i != n; ++i) {
+    if (durations[i] < 0) {
+      auto r = std::make_unique<OfflineBatchTranscriberResult>();
+      r->index = i;
+      r->filename = filenames[i];
+      output.Put(std::move(r));
+    } else {
+      indexes.push_back(i);
+    }
+  }
+
+  std::stable_sort(indexes.begin(), indexes.end(), [&](int32_t a, int32_t b) {
+    return durations[a] > durations[b];
+  });
+
+  std::vector<std::unique_ptr<Bucket>> buckets;
+  for (int32_t i = 0; i < static_cast<int32_t>(indexes.size());
+       i += config_.batch_size) {
+    auto b = std::make_unique<Bucket>();
+    int32_t end =
+        std::min<int32_t>(i + config_.batch_size, indexes.size());
+    b->indexes.assign(indexes.begin() + i, indexes.begin() + end);
+    buckets.push_back(std::move(b));
+  }
+
+  int32_t num_workers = config_.num_workers;
+  BucketQueues queues(num_workers);
+  for (int32_t i = 0; i != static_cast<int32_t>(buckets.size()); ++i) {
+    queues.Push(i % num_workers, i);
+  }
+
+  auto read = [&](const Bucket &b) {
+    Streams ans(b.indexes.size());
+    std::vector<float> samples;
+    for (int32_t k = 0; k != static_cast<int32_t>(b.indexes.size()); ++k) {
+      auto source = AudioFileSource::CreateFromWave(filenames[b.indexes[k]]);
+      if (!source) {
+        continue;
+      }
+
+      if (source->NumSamples() > std::numeric_limits<int32_t>::max()) {
+        SHERPA_ONNX_LOGE("Skip %s: %" PRId64
+                         " samples are too many to decode at once",
+                         filenames[b.indexes[k]].c_str(), source->NumSamples());
+        continue;
+      }
+
+      source->Read(source->NumSamples(), &samples);
+
+      ans[k] = decoder_->CreateStream();
+      ans[k]->AcceptWaveform(source->SampleRate(), samples.data(),
+                             samples.size());
+    }
+    return ans;
+  };
+
+  // Start reading a bucket on a reader thread if it has not been started
+  auto prefetch = [&](int32_t i) {
+    if (i == -1 || readers_->NumThreads() == 0) {
+      return;
+    }
+
+    Bucket &b = *buckets[i];
+    std::lock_guard<std::mutex> lock(b.mutex);
+    if (!b.started) {
+      b.started = true;
+      b.streams = readers_->Submit([&read, &b]() { return read(b); });
+    }
+  };
+
+  // It is declared after read so that it is destroyed first
+  PrefetchGuard guard(&buckets);
+
+  // Every bucket is taken by exactly one worker, so the streams of a
+  // prefetched bucket are collected when ParallelFor() returns normally.
+  // If it throws, guard waits for the ones that are not collected.
+  auto get_streams = [&](int32_t i) {
+    Bucket &b = *buckets[i];
+    {
+      std::lock_guard<std::mutex> lock(b.mutex);
+      if (!b.started) {
+        b.started = true;
+        return read(b);
+      }
+    }
+    return b.streams.get();
+  };
+
+  workers_->ParallelFor(num_workers, [&](int32_t worker) {
+    prefetch(queues.Peek(worker));
+
+    int32_t i;
+    while ((i = queues.Pop(worker)) != -1) {
+      prefetch(queues.Peek(worker));
+
+      const Bucket &b = *buckets[i];
+      Streams streams = get_streams(i);
+
+      std::vector<OfflineStream *> ss;
+      ss.reserve(streams.size());
+      for (auto &s : streams) {
+        if (s) {
+          ss.push_back(s.get());
+        }
+      }
+
+      if (!ss.empty()) {
+        decoder_->DecodeStreams(ss.data(), ss.size());
+      }
+
+      for (int32_t k = 0; k != static_cast<int32_t>(streams.size()); ++k) {
+        auto r = std::make_unique<OfflineBatchTranscriberResult>();
+        r->index = b.indexes[k];
+        r->filename = filenames[r->index];
+        r->duration = durations[r->index];
+        if (streams[k]) {
+          r->ok = true;
+          r->result = streams[k]->GetResult();
+        }
+        output.Put(std::move(r));
+      }
+    }
+  });
+}
+
+}  // namespace sherpa_onnx
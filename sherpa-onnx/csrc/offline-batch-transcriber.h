@@ -0,0 +1,113 @@
+// sherpa-onnx/csrc/offline-batch-transcriber.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_OFFLINE_BATCH_TRANSCRIBER_H_
+#define SHERPA_ONNX_CSRC_OFFLINE_BATCH_TRANSCRIBER_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/offline-recognizer.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+
+namespace sherpa_onnx {
+
+struct OfflineBatchTranscriberConfig {
+  // Number of threads calling OfflineRecognizer::DecodeStreams()
+  int32_t num_workers = 1;
+
+  // Maximum number of files decoded in one call of DecodeStreams()
+  int32_t batch_size = 8;
+
+  // Number of threads reading files and computing features ahead of the
+  // workers. 0 to read files in the worker threads.
+  int32_t num_readers = 1;
+
+  OfflineBatchTranscriberConfig() = default;
+
+  OfflineBatchTranscriberConfig(int32_t num_workers, int32_t batch_size,
+                                int32_t num_readers)
+      : num_workers(num_workers),
+        batch_size(batch_size),
+        num_readers(num_readers) {}
+
+  void Register(ParseOptions *po);
+  bool Validate() const;
+
+  std::string ToString() const;
+};
+
+struct OfflineBatchTranscriberResult {
+  // Index of the file in the input list
+  int32_t index = 0;
+
+  std::string filename;
+
+  // False if the file cannot be read. result is empty in that case.
+  bool ok = false;
+
+  // Duration of the file in seconds
+  float duration = 0;
+
+  OfflineRecognitionResult result;
+};
+
+using OfflineBatchTranscriberCallback =
+    std::function<void(const OfflineBatchTranscriberResult &r)>;
+
+class ThreadPool;
+
+// The operations of OfflineRecognizer used by OfflineBatchTranscriber.
+// Tests can provide a fake one that does not need a model.
+class OfflineBatchDecoder {
+ public:
+  virtual ~OfflineBatchDecoder() = default;
+
+  virtual std::unique_ptr<OfflineStream> CreateStream() const = 0;
+
+  // It may be called from several threads at the same time
+  virtual void DecodeStreams(OfflineStream **ss, int32_t n) const = 0;
+};
+
+/* Transcribe a list of wave files with an OfflineRecognizer.
+ *
+ * Files are sorted by duration and grouped into buckets of up to
+ * batch_size files of similar length, which reduces the padding inside a
+ * batch. Buckets are distributed among the workers, longest first, and a
+ * worker that runs out of buckets steals from the others, so long and
+ * short files mixed in the input do not leave threads idle. Files of the
+ * next bucket of a worker are read while the current bucket is decoded.
+ */
+class OfflineBatchTranscriber {
+ public:
+  // recognizer is not owned and must outlive this object
+  OfflineBatchTranscriber(const OfflineRecognizer *recognizer,
+                          const OfflineBatchTranscriberConfig &config);
+
+  OfflineBatchTranscriber(std::unique_ptr<OfflineBatchDecoder> decoder,
+                          const OfflineBatchTranscriberConfig &config);
+
+  ~OfflineBatchTranscriber();
+
+  /*
+   * @param filenames Wave files to transcribe.
+   * @param callback It is invoked once for each file, in the order of
+   *                 filenames, as soon as the file and all files before it
+   *                 are decoded. Calls are not concurrent, but they may come
+   *                 from different threads.
+   */
+  void Run(const std::vector<std::string> &filenames,
+           const OfflineBatchTranscriberCallback &callback) const;
+
+ private:
+  std::unique_ptr<OfflineBatchDecoder> decoder_;
+  OfflineBatchTranscriberConfig config_;
+  std::unique_ptr<ThreadPool> workers_;
+  std::unique_ptr<ThreadPool> readers_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_OFFLINE_BATCH_TRANSCRIBER_H_
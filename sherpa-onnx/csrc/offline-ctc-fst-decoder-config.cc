@@ -17,7 +17,8 @@ std::string OfflineCtcFstDecoderConfig::ToString() const {
 
   os << "OfflineCtcFstDecoderConfig(";
   os << "graph=\"" << graph << "\", ";
-  os << "max_active=" << max_active << ")";
+  os << "max_active=" << max_active << ", ";
+  os << "num_threads=" << num_threads << ")";
 
   return os.str();
 }
@@ -30,6 +31,9 @@ void OfflineCtcFstDecoderConfig::Register(ParseOptions *po) {
 
   p.Register("max-active", &max_active,
              "Decoder max active states.  Larger->slower; more accurate");
+
+  p.Register("num-threads", &num_threads,
+             "Number of threads to run FST decoding of a batch in parallel");
 }
 
 bool OfflineCtcFstDecoderConfig::Validate() const {
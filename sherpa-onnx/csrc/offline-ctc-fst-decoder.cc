@@ -4,6 +4,7 @@
 
 #include "sherpa-onnx/csrc/offline-ctc-fst-decoder.h"
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -81,7 +82,33 @@ static OfflineCtcDecoderResult DecodeOne(kaldi_decoder::FasterDecoder *decoder,
 
 OfflineCtcFstDecoder::OfflineCtcFstDecoder(
     const OfflineCtcFstDecoderConfig &config)
-    : config_(config), fst_(ReadGraph(config_.graph)) {}
+    : config_(config),
+      fst_(ReadGraph(config_.graph)),
+      pool_(std::make_unique<ThreadPool>(config_.num_threads - 1)) {
+  options_.max_active = config_.max_active;
+}
+
+OfflineCtcFstDecoder::~OfflineCtcFstDecoder() = default;
+
+std::unique_ptr<kaldi_decoder::FasterDecoder>
+OfflineCtcFstDecoder::AcquireDecoder() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_decoders_.empty()) {
+      auto ans = std::move(free_decoders_.back());
+      free_decoders_.pop_back();
+      return ans;
+    }
+  }
+
+  return std::make_unique<kaldi_decoder::FasterDecoder>(*fst_, options_);
+}
+
+void OfflineCtcFstDecoder::ReleaseDecoder(
+    std::unique_ptr<kaldi_decoder::FasterDecoder> decoder) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  free_decoders_.push_back(std::move(decoder));
+}
 
 std::vector<OfflineCtcDecoderResult> OfflineCtcFstDecoder::Decode(
     Ort::Value log_probs, Ort::Value log_probs_length) {
@@ -98,21 +125,19 @@ std::vector<OfflineCtcDecoderResult> OfflineCtcFstDecoder::Decode(
 
   assert(shape[0] == length_shape[0]);
 
-  kaldi_decoder::FasterDecoderOptions opts;
-  opts.max_active = config_.max_active;
-  kaldi_decoder::FasterDecoder faster_decoder(*fst_, opts);
-
   const float *start = log_probs.GetTensorData<float>();
+  const int64_t *p_length = log_probs_length.GetTensorData<int64_t>();
 
-  std::vector<OfflineCtcDecoderResult> ans;
-  ans.reserve(batch_size);
+  std::vector<OfflineCtcDecoderResult> ans(batch_size);
 
-  for (int32_t i = 0; i != batch_size; ++i) {
+  pool_->ParallelFor(batch_size, [&](int32_t i) {
     const float *p = start + i * T * vocab_size;
-    int32_t num_frames = log_probs_length.GetTensorData<int64_t>()[i];
-    auto r = DecodeOne(&faster_decoder, p, num_frames, vocab_size);
-    ans.push_back(std::move(r));
-  }
+    int32_t num_frames = p_length[i];
+
+    auto decoder = AcquireDecoder();
+    ans[i] = DecodeOne(decoder.get(), p, num_frames, vocab_size);
+    ReleaseDecoder(std::move(decoder));
+  });
 
   return ans;
 }
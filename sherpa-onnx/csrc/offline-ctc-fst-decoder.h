@@ -6,26 +6,46 @@
 #define SHERPA_ONNX_CSRC_OFFLINE_CTC_FST_DECODER_H_
 
 #include <memory>
+#include <mutex>  // NOLINT
 #include <vector>
 
 #include "fst/fst.h"
+#include "kaldi-decoder/csrc/faster-decoder.h"
 #include "sherpa-onnx/csrc/offline-ctc-decoder.h"
 #include "sherpa-onnx/csrc/offline-ctc-fst-decoder-config.h"
 #include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
 
 namespace sherpa_onnx {
 
 class OfflineCtcFstDecoder : public OfflineCtcDecoder {
  public:
   explicit OfflineCtcFstDecoder(const OfflineCtcFstDecoderConfig &config);
+  ~OfflineCtcFstDecoder() override;
 
+  // Utterances of the batch are decoded in parallel if
+  // config.num_threads > 1
   std::vector<OfflineCtcDecoderResult> Decode(
       Ort::Value log_probs, Ort::Value log_probs_length) override;
 
+ private:
+  // Get a decoder from the free list or create a new one if it is empty.
+  // A decoder keeps its internal buffers between utterances, so reusing
+  // it avoids allocating them again for every utterance.
+  std::unique_ptr<kaldi_decoder::FasterDecoder> AcquireDecoder();
+
+  void ReleaseDecoder(std::unique_ptr<kaldi_decoder::FasterDecoder> decoder);
+
  private:
   OfflineCtcFstDecoderConfig config_;
 
   std::unique_ptr<fst::Fst<fst::StdArc>> fst_;
+  kaldi_decoder::FasterDecoderOptions options_;
+
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<kaldi_decoder::FasterDecoder>> free_decoders_;
+
+  std::unique_ptr<ThreadPool> pool_;
 };
 
 }  // namespace sherpa_onnx
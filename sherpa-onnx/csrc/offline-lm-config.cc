@@ -18,7 +18,9 @@ void OfflineLMConfig::Register(ParseOptions *po) {
                "Number of threads to run the neural network of LM model");
   po->Register("lm-provider", &lm_provider,
                "Specify a provider to LM model use: cpu, cuda, coreml");
-  po->Register("lodr-fst", &lodr_fst, "Path to LODR FST model.");
+  po->Register("lodr-fst", &lodr_fst,
+               "Path to LODR FST model. It can also be a flat n-gram file "
+               "produced by sherpa-onnx-compile-lodr-fst.");
   po->Register("lodr-scale", &lodr_scale, "LODR scale.");
   po->Register("lodr-backoff-id", &lodr_backoff_id,
                "ID of the backoff in the LODR FST. -1 means autodetect");
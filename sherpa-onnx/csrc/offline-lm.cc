@@ -5,6 +5,7 @@
 #include "sherpa-onnx/csrc/offline-lm.h"
 
 #include <algorithm>
+#include <map>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -35,54 +36,71 @@ std::unique_ptr<OfflineLM> OfflineLM::Create(Manager *mgr,
 
 void OfflineLM::ComputeLMScore(float scale, int32_t context_size,
                                std::vector<Hypotheses> *hyps) {
+  // Different hyps, e.g., from different streams, may contain identical
+  // token sequences. Each unique sequence is sent to the LM only once.
+  //
+  // we subtract context_size below since each token sequence is prepended
+  // with context_size blanks
+  std::map<std::vector<int64_t>, int32_t> seq2row;
+  std::vector<int32_t> hyp2row;
+  std::vector<const std::vector<int64_t> *> rows;
+
   // compute the max token seq so that we know how much space to allocate
   int32_t max_token_seq = 0;
-  int32_t num_hyps = 0;
 
-  // we subtract context_size below since each token sequence is prepended
-  // with context_size blanks
   for (const auto &h : *hyps) {
-    num_hyps += h.Size();
     for (const auto &t : h) {
-      max_token_seq =
-          std::max<int32_t>(max_token_seq, t.second.ys.size() - context_size);
+      const auto &ys = t.second.ys;
+      std::vector<int64_t> seq(ys.begin() + context_size, ys.end());
+
+      auto it = seq2row.find(seq);
+      if (it == seq2row.end()) {
+        max_token_seq =
+            std::max<int32_t>(max_token_seq, static_cast<int32_t>(seq.size()));
+
+        it = seq2row.emplace(std::move(seq), static_cast<int32_t>(rows.size()))
+                 .first;
+        rows.push_back(&it->first);
+      }
+
+      hyp2row.push_back(it->second);
     }
   }
 
+  int32_t num_rows = static_cast<int32_t>(rows.size());
+
   Ort::AllocatorWithDefaultOptions allocator;
-  std::array<int64_t, 2> x_shape{num_hyps, max_token_seq};
+  std::array<int64_t, 2> x_shape{num_rows, max_token_seq};
   Ort::Value x = Ort::Value::CreateTensor<int64_t>(allocator, x_shape.data(),
                                                    x_shape.size());
 
-  std::array<int64_t, 1> x_lens_shape{num_hyps};
+  std::array<int64_t, 1> x_lens_shape{num_rows};
   Ort::Value x_lens = Ort::Value::CreateTensor<int64_t>(
       allocator, x_lens_shape.data(), x_lens_shape.size());
 
   int64_t *p = x.GetTensorMutableData<int64_t>();
-  std::fill(p, p + num_hyps * max_token_seq, 0);
+  std::fill(p, p + num_rows * max_token_seq, 0);
 
   int64_t *p_lens = x_lens.GetTensorMutableData<int64_t>();
 
-  for (const auto &h : *hyps) {
-    for (const auto &t : h) {
-      const auto &ys = t.second.ys;
-      int32_t len = ys.size() - context_size;
-      std::copy(ys.begin() + context_size, ys.end(), p);
-      *p_lens = len;
+  for (const auto *seq : rows) {
+    std::copy(seq->begin(), seq->end(), p);
+    *p_lens = seq->size();
 
-      p += max_token_seq;
-      ++p_lens;
-    }
+    p += max_token_seq;
+    ++p_lens;
   }
+
   auto negative_loglike = Rescore(std::move(x), std::move(x_lens));
   const float *p_nll = negative_loglike.GetTensorData<float>();
   // We scale LODR scale with LM scale to replicate Icefall code
   auto lodr_scale = config_.lodr_scale * scale;
+  int32_t i = 0;
   for (auto &h : *hyps) {
     for (auto &t : h) {
       // Use -scale here since we want to change negative loglike to loglike.
-      t.second.lm_log_prob = -scale * (*p_nll);
-      ++p_nll;
+      t.second.lm_log_prob = -scale * p_nll[hyp2row[i]];
+      ++i;
       // apply LODR to hyp score
       if (lodr_fst_ != nullptr) {
         lodr_fst_->ComputeScore(lodr_scale, &t.second, context_size);
@@ -5,6 +5,7 @@
 #ifndef SHERPA_ONNX_CSRC_OFFLINE_RECOGNIZER_CTC_IMPL_H_
 #define SHERPA_ONNX_CSRC_OFFLINE_RECOGNIZER_CTC_IMPL_H_
 
+#include <algorithm>
 #include <ios>
 #include <memory>
 #include <sstream>
@@ -18,7 +19,6 @@
 #include "sherpa-onnx/csrc/offline-ctc-greedy-search-decoder.h"
 #include "sherpa-onnx/csrc/offline-ctc-model.h"
 #include "sherpa-onnx/csrc/offline-recognizer-impl.h"
-#include "sherpa-onnx/csrc/pad-sequence.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
 
 namespace sherpa_onnx {
@@ -239,43 +239,31 @@ class OfflineRecognizerCtcImpl : public OfflineRecognizerImpl {
 
     int32_t feat_dim = ss[0]->FeatureDim();
 
-    std::vector<Ort::Value> features;
-    features.reserve(n);
-
-    std::vector<std::vector<float>> features_vec(n);
     std::vector<int64_t> features_length_vec(n);
-
+    int64_t max_num_frames = 0;
     for (int32_t i = 0; i != n; ++i) {
-      std::vector<float> f = ss[i]->GetFrames();
-
-      int32_t num_frames = f.size() / feat_dim;
-
-      model_->NormalizeFeatures(f.data(), num_frames, feat_dim);
-
-      features_vec[i] = std::move(f);
-
-      features_length_vec[i] = num_frames;
+      features_length_vec[i] = ss[i]->NumFrames();
+      max_num_frames = std::max(max_num_frames, features_length_vec[i]);
+    }
 
-      std::array<int64_t, 2> shape = {num_frames, feat_dim};
+    // Frames of each stream are written into the padded batch directly
+    std::array<int64_t, 3> x_shape = {n, max_num_frames, feat_dim};
+    Ort::Value x = Ort::Value::CreateTensor<float>(
+        model_->Allocator(), x_shape.data(), x_shape.size());
 
-      Ort::Value x = Ort::Value::CreateTensor(
-          memory_info, features_vec[i].data(), features_vec[i].size(),
-          shape.data(), shape.size());
-      features.push_back(std::move(x));
-    }  // for (int32_t i = 0; i != n; ++i)
+    float *p = x.GetTensorMutableData<float>();
+    std::fill(p, p + n * max_num_frames * feat_dim, -23.025850929940457f);
 
-    std::vector<const Ort::Value *> features_pointer(n);
     for (int32_t i = 0; i != n; ++i) {
-      features_pointer[i] = &features[i];
-    }
+      float *f = p + i * max_num_frames * feat_dim;
+      ss[i]->GetFrames(f);
+      model_->NormalizeFeatures(f, features_length_vec[i], feat_dim);
+    }  // for (int32_t i = 0; i != n; ++i)
 
     std::array<int64_t, 1> features_length_shape = {n};
     Ort::Value x_length = Ort::Value::CreateTensor(
         memory_info, features_length_vec.data(), n,
         features_length_shape.data(), features_length_shape.size());
-
-    Ort::Value x = PadSequence(model_->Allocator(), features_pointer,
-                               -23.025850929940457f);
     auto t = model_->Forward(std::move(x), std::move(x_length));
 
     auto results = decoder_->Decode(std::move(t[0]), std::move(t[1]));
@@ -5,6 +5,7 @@
 #ifndef SHERPA_ONNX_CSRC_OFFLINE_RECOGNIZER_TRANSDUCER_IMPL_H_
 #define SHERPA_ONNX_CSRC_OFFLINE_RECOGNIZER_TRANSDUCER_IMPL_H_
 
+#include <algorithm>
 #include <fstream>
 #include <ios>
 #include <memory>
@@ -23,7 +24,6 @@
 #include "sherpa-onnx/csrc/offline-transducer-greedy-search-decoder.h"
 #include "sherpa-onnx/csrc/offline-transducer-model.h"
 #include "sherpa-onnx/csrc/offline-transducer-modified-beam-search-decoder.h"
-#include "sherpa-onnx/csrc/pad-sequence.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
 #include "sherpa-onnx/csrc/utils.h"
 #include "ssentencepiece/csrc/ssentencepiece.h"
@@ -205,30 +205,23 @@ class OfflineRecognizerTransducerImpl : public OfflineRecognizerImpl {
 
     int32_t feat_dim = ss[0]->FeatureDim();
 
-    std::vector<Ort::Value> features;
-
-    features.reserve(n);
-
-    std::vector<std::vector<float>> features_vec(n);
     std::vector<int64_t> features_length_vec(n);
+    int64_t max_num_frames = 0;
     for (int32_t i = 0; i != n; ++i) {
-      auto f = ss[i]->GetFrames();
-      int32_t num_frames = f.size() / feat_dim;
-
-      features_length_vec[i] = num_frames;
-      features_vec[i] = std::move(f);
+      features_length_vec[i] = ss[i]->NumFrames();
+      max_num_frames = std::max(max_num_frames, features_length_vec[i]);
+    }
 
-      std::array<int64_t, 2> shape = {num_frames, feat_dim};
+    // Frames of each stream are written into the padded batch directly
+    std::array<int64_t, 3> x_shape = {n, max_num_frames, feat_dim};
+    Ort::Value x = Ort::Value::CreateTensor<float>(
+        model_->Allocator(), x_shape.data(), x_shape.size());
 
-      Ort::Value x = Ort::Value::CreateTensor(
-          memory_info, features_vec[i].data(), features_vec[i].size(),
-          shape.data(), shape.size());
-      features.push_back(std::move(x));
-    }
+    float *p = x.GetTensorMutableData<float>();
+    std::fill(p, p + n * max_num_frames * feat_dim, -23.025850929940457f);
 
-    std::vector<const Ort::Value *> features_pointer(n);
     for (int32_t i = 0; i != n; ++i) {
-      features_pointer[i] = &features[i];
+      ss[i]->GetFrames(p + i * max_num_frames * feat_dim);
     }
 
     std::array<int64_t, 1> features_length_shape = {n};
@@ -236,9 +229,6 @@ class OfflineRecognizerTransducerImpl : public OfflineRecognizerImpl {
         memory_info, features_length_vec.data(), n,
         features_length_shape.data(), features_length_shape.size());
 
-    Ort::Value x = PadSequence(model_->Allocator(), features_pointer,
-                               -23.025850929940457f);
-
     auto t = model_->RunEncoder(std::move(x), std::move(x_length));
     auto results =
         decoder_->Decode(std::move(t.first), std::move(t.second), ss, n);
@@ -6,7 +6,9 @@
 #define SHERPA_ONNX_CSRC_OFFLINE_RECOGNIZER_WHISPER_IMPL_H_
 
 #include <algorithm>
+#include <chrono>  // NOLINT
 #include <cmath>
+#include <future>  // NOLINT
 #include <memory>
 #include <string>
 #include <utility>
@@ -20,7 +22,9 @@
 #include "sherpa-onnx/csrc/offline-whisper-dtw.h"
 #include "sherpa-onnx/csrc/offline-whisper-greedy-search-decoder.h"
 #include "sherpa-onnx/csrc/offline-whisper-model.h"
+#include "sherpa-onnx/csrc/offline-whisper-timestamp-rules.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
 #include "sherpa-onnx/csrc/transpose.h"
 
 namespace sherpa_onnx {
@@ -59,6 +63,10 @@ class OfflineRecognizerWhisperImpl : public OfflineRecognizerImpl {
           config_.decoding_method.c_str());
       SHERPA_ONNX_EXIT(-1);
     }
+
+    // For encoding the next window of a long input while the current one
+    // is being decoded
+    pool_ = std::make_unique<ThreadPool>(1);
   }
 
   std::unique_ptr<OfflineStream> CreateStream() const override {
@@ -84,24 +92,186 @@ class OfflineRecognizerWhisperImpl : public OfflineRecognizerImpl {
   void DecodeStream(OfflineStream *s) const {
     decoder_->SetConfig(config_.model_config.whisper);
 
-    int32_t max_num_frames = 3000;
-    auto memory_info =
-        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
-
     int32_t feat_dim = s->FeatureDim();
     std::vector<float> f = s->GetFrames();
     int32_t num_frames = f.size() / feat_dim;
 
+    model_->NormalizeFeatures(f.data(), num_frames, feat_dim);
+
     // we use 50 here so that there will be some zero tail paddings
-    if (num_frames >= max_num_frames - 50) {
+    if (num_frames >= kMaxNumFrames - 50) {
+      DecodeLongForm(s, f.data(), num_frames, feat_dim);
+      return;
+    }
+
+    try {
+      auto cross_kv = RunEncoder(f.data(), num_frames, feat_dim);
+
+      auto results =
+          decoder_->Decode(std::move(cross_kv.first),
+                           std::move(cross_kv.second), num_frames, {});
+
+      auto r = Convert(results[0], symbol_table_);
+      s->SetResult(r);
+    } catch (const Ort::Exception &ex) {
       SHERPA_ONNX_LOGE(
-          "Only waves less than 30 seconds are supported. We process only the "
-          "first 30 seconds and discard the remaining data");
-      num_frames = max_num_frames - 50;
+          "\n\nCaught exception:\n\n%s\n\nReturn an empty result. Number of "
+          "input frames: %d, Current tail "
+          "paddings: %d. If you see a lot of such exceptions, please consider "
+          "using a larger --whisper-tail-paddings",
+          ex.what(), num_frames, TailPaddingFrames());
+      return;
     }
+  }
 
-    model_->NormalizeFeatures(f.data(), num_frames, feat_dim);
+  /* Decode an input longer than 30 seconds.
+   *
+   * Like OpenAI Whisper, a window of 30 seconds is moved along the input.
+   * After a window is decoded, the next one starts after its last complete
+   * segment (see FindLongFormSeek()) and the text decoded so far is used as
+   * the prompt.
+   *
+   * Where the next window starts is known only after the current one is
+   * decoded. However, the whole window is consumed whenever its last segment
+   * is complete. If the previous window was consumed completely, the window
+   * right after the current one is encoded on another thread while the
+   * current one is being decoded, and is used if the guess is right. A
+   * wrong guess is not waited for; it finishes in the background and is
+   * joined before returning.
+   *
+   * Token timestamps from DTW are not computed for long inputs.
+   */
+  void DecodeLongForm(OfflineStream *s, const float *f, int32_t num_frames,
+                      int32_t feat_dim) const {
+    auto config = config_.model_config.whisper;
+
+    // Timestamp tokens are required to find where the next window starts
+    config.enable_segment_timestamps = true;
+    config.enable_token_timestamps = false;
+
+    int32_t timestamp_begin = model_->TimestampBegin();
+    int32_t eot = model_->EOT();
+
+    using CrossKV = std::pair<Ort::Value, Ort::Value>;
+
+    // Encoder output of the window starting at next_seek
+    std::future<CrossKV> next;
+    int32_t next_seek = -1;
+
+    // Wrong guesses that may still be running. They read f, which is owned
+    // by the caller, so they are joined before returning.
+    std::vector<std::future<CrossKV>> stale;
+
+    // Whether the last window was consumed completely, i.e., whether to
+    // guess that the next window starts right after the current one
+    bool prefetch = true;
+
+    auto is_done = [](const std::future<CrossKV> &t) {
+      return t.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    };
+
+    auto join = [&next, &stale]() {
+      if (next.valid()) {
+        next.wait();
+      }
+
+      for (auto &t : stale) {
+        t.wait();
+      }
+    };
+
+    OfflineWhisperDecoderResult merged;
+    std::vector<int32_t> prompt;
+    int32_t seek = 0;
+
+    try {
+      while (seek < num_frames) {
+        int32_t n = std::min(kMaxNumFrames, num_frames - seek);
+
+        if (seek != next_seek && next.valid()) {
+          // The guess was wrong, so its result is discarded once it is done
+          stale.push_back(std::move(next));
+        }
+
+        // Release the encoder outputs of finished wrong guesses
+        stale.erase(std::remove_if(stale.begin(), stale.end(), is_done),
+                    stale.end());
+
+        CrossKV cross_kv = next.valid()
+                               ? next.get()
+                               : RunEncoder(f + seek * feat_dim, n, feat_dim);
 
+        if (prefetch && seek + n < num_frames) {
+          next_seek = seek + n;
+          int32_t m = std::min(kMaxNumFrames, num_frames - next_seek);
+          const float *p = f + next_seek * feat_dim;
+          next = pool_->Submit(
+              [this, p, m, feat_dim]() { return RunEncoder(p, m, feat_dim); });
+        }
+
+        decoder_->SetConfig(config);
+        auto results =
+            decoder_->Decode(std::move(cross_kv.first),
+                             std::move(cross_kv.second), n, prompt);
+        auto &r = results[0];
+
+        if (merged.lang.empty()) {
+          merged.lang = r.lang;
+          // Detect the language only once
+          config.language = r.lang;
+        }
+
+        int32_t num_consumed = n;
+        int32_t num_kept =
+            FindLongFormSeek(r.tokens, timestamp_begin, n, &num_consumed);
+        r.tokens.resize(num_kept);
+
+        float offset = seek * kSecondsPerFrame;
+        auto segments = ParseTimestampTokens(r.tokens, timestamp_begin, eot);
+        for (auto &seg : segments) {
+          seg.start_time += offset;
+          seg.end_time = seg.end_time < 0 ? offset + n * kSecondsPerFrame
+                                          : seg.end_time + offset;
+          merged.segments.push_back(std::move(seg));
+        }
+
+        for (auto t : r.tokens) {
+          if (t < timestamp_begin) {
+            merged.tokens.push_back(t);
+          }
+        }
+
+        prompt.insert(prompt.end(), r.tokens.begin(), r.tokens.end());
+        seek += num_consumed;
+        prefetch = num_consumed == n;
+      }
+    } catch (const Ort::Exception &ex) {
+      // The pending tasks read f, which is owned by the caller
+      join();
+
+      SHERPA_ONNX_LOGE(
+          "\n\nCaught exception:\n\n%s\n\nReturn an empty result. Number of "
+          "input frames: %d, current window starts at frame %d",
+          ex.what(), num_frames, seek);
+      return;
+    } catch (...) {
+      // Any other exception, e.g., std::bad_alloc, is passed on, but only
+      // after the pending tasks are done with f
+      join();
+      throw;
+    }
+
+    join();
+
+    merged.num_audio_frames = num_frames / 2;
+
+    // Timestamp tokens have been removed from merged.tokens, so segments
+    // are used only if the user asks for them
+    auto r = Convert(merged, symbol_table_);
+    s->SetResult(r);
+  }
+
+  int32_t TailPaddingFrames() const {
     // note that 1000 is an experience-value.
     // You can replace 1000 by other values, say, 100.
     //
@@ -113,8 +283,16 @@ class OfflineRecognizerWhisperImpl : public OfflineRecognizerImpl {
       tail_padding_frames = config_.model_config.whisper.tail_paddings;
     }
 
+    return tail_padding_frames;
+  }
+
+  // Run the encoder on num_frames normalized frames plus tail paddings.
+  // It is called from pool_ as well, so it must not change any member.
+  std::pair<Ort::Value, Ort::Value> RunEncoder(const float *f,
+                                               int32_t num_frames,
+                                               int32_t feat_dim) const {
     int32_t actual_frames =
-        std::min(num_frames + tail_padding_frames, max_num_frames);
+        std::min(num_frames + TailPaddingFrames(), kMaxNumFrames);
 
     std::array<int64_t, 3> shape{1, actual_frames, feat_dim};
 
@@ -122,30 +300,14 @@ class OfflineRecognizerWhisperImpl : public OfflineRecognizerImpl {
         model_->Allocator(), shape.data(), shape.size());
 
     float *p_mel = mel.GetTensorMutableData<float>();
-    std::copy(f.data(), f.data() + num_frames * feat_dim, p_mel);
+    std::copy(f, f + num_frames * feat_dim, p_mel);
 
     std::fill_n(p_mel + num_frames * feat_dim,
                 (actual_frames - num_frames) * feat_dim, 0);
 
     mel = Transpose12(model_->Allocator(), &mel);
 
-    try {
-      auto cross_kv = model_->ForwardEncoder(std::move(mel));
-
-      auto results = decoder_->Decode(std::move(cross_kv.first),
-                                      std::move(cross_kv.second), num_frames);
-
-      auto r = Convert(results[0], symbol_table_);
-      s->SetResult(r);
-    } catch (const Ort::Exception &ex) {
-      SHERPA_ONNX_LOGE(
-          "\n\nCaught exception:\n\n%s\n\nReturn an empty result. Number of "
-          "input frames: %d, Current tail "
-          "paddings: %d. If you see a lot of such exceptions, please consider "
-          "using a larger --whisper-tail-paddings",
-          ex.what(), num_frames, tail_padding_frames);
-      return;
-    }
+    return model_->ForwardEncoder(std::move(mel));
   }
 
  private:
@@ -287,6 +449,11 @@ class OfflineRecognizerWhisperImpl : public OfflineRecognizerImpl {
   SymbolTable symbol_table_;
   std::unique_ptr<OfflineWhisperModel> model_;
   std::unique_ptr<OfflineWhisperDecoder> decoder_;
+  std::unique_ptr<ThreadPool> pool_;
+
+  // The encoder accepts at most 30 seconds of input
+  static constexpr int32_t kMaxNumFrames = 3000;
+  static constexpr float kSecondsPerFrame = 0.01f;
 };
 
 }  // namespace sherpa_onnx
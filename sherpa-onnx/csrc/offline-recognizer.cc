@@ -4,6 +4,7 @@
 
 #include "sherpa-onnx/csrc/offline-recognizer.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -18,10 +19,12 @@
 #endif
 
 #include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/length-buckets.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/offline-lm-config.h"
 #include "sherpa-onnx/csrc/offline-recognizer-impl.h"
 #include "sherpa-onnx/csrc/text-utils.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
 
 namespace sherpa_onnx {
 
@@ -67,6 +70,16 @@ void OfflineRecognizerConfig::Register(ParseOptions *po) {
       "rule-fars", &rule_fars,
       "If not empty, it specifies fst archives for inverse text normalization. "
       "If there are multiple archives, they are separated by a comma.");
+
+  po->Register("max-padding-ratio", &max_padding_ratio,
+               "Streams decoded together are split into groups of similar "
+               "lengths, so that at most this fraction of the frames in a "
+               "group is padding. Each group is run as a separate batch. "
+               "1 (the default) to decode all streams in a single batch.");
+
+  po->Register("num-bucket-threads", &num_bucket_threads,
+               "Number of threads decoding the groups of --max-padding-ratio "
+               "in parallel");
 }
 
 bool OfflineRecognizerConfig::Validate() const {
@@ -127,6 +140,18 @@ bool OfflineRecognizerConfig::Validate() const {
     return false;
   }
 
+  if (max_padding_ratio < 0 || max_padding_ratio > 1) {
+    SHERPA_ONNX_LOGE("--max-padding-ratio should be in [0, 1]. Given: %f",
+                     max_padding_ratio);
+    return false;
+  }
+
+  if (num_bucket_threads < 1) {
+    SHERPA_ONNX_LOGE("--num-bucket-threads should be >= 1. Given: %d",
+                     num_bucket_threads);
+    return false;
+  }
+
   return model_config.Validate();
 }
 
@@ -146,7 +171,9 @@ std::string OfflineRecognizerConfig::ToString() const {
   os << "blank_penalty=" << blank_penalty << ", ";
   os << "rule_fsts=\"" << rule_fsts << "\", ";
   os << "rule_fars=\"" << rule_fars << "\", ";
-  os << "hr=" << hr.ToString() << ")";
+  os << "hr=" << hr.ToString() << ", ";
+  os << "max_padding_ratio=" << max_padding_ratio << ", ";
+  os << "num_bucket_threads=" << num_bucket_threads << ")";
 
   return os.str();
 }
@@ -154,10 +181,17 @@ std::string OfflineRecognizerConfig::ToString() const {
 template <typename Manager>
 OfflineRecognizer::OfflineRecognizer(Manager *mgr,
                                      const OfflineRecognizerConfig &config)
-    : impl_(OfflineRecognizerImpl::Create(mgr, config)) {}
+    : impl_(OfflineRecognizerImpl::Create(mgr, config)),
+      max_padding_ratio_(config.max_padding_ratio),
+      // The calling thread of DecodeStreams() also decodes
+      pool_(std::make_unique<ThreadPool>(
+          std::max(config.num_bucket_threads - 1, 0))) {}
 
 OfflineRecognizer::OfflineRecognizer(const OfflineRecognizerConfig &config)
-    : impl_(OfflineRecognizerImpl::Create(config)) {}
+    : impl_(OfflineRecognizerImpl::Create(config)),
+      max_padding_ratio_(config.max_padding_ratio),
+      pool_(std::make_unique<ThreadPool>(
+          std::max(config.num_bucket_threads - 1, 0))) {}
 
 OfflineRecognizer::~OfflineRecognizer() = default;
 
@@ -171,15 +205,59 @@ std::unique_ptr<OfflineStream> OfflineRecognizer::CreateStream() const {
 }
 
 void OfflineRecognizer::DecodeStreams(OfflineStream **ss, int32_t n) const {
-  impl_->DecodeStreams(ss, n);
+  std::vector<int32_t> lengths(n);
+  for (int32_t i = 0; i != n; ++i) {
+    lengths[i] = ss[i]->NumFrames();
+  }
+
+  auto buckets = SplitByLength(lengths, max_padding_ratio_);
+
+  std::vector<std::vector<OfflineStream *>> groups(buckets.size());
+  int64_t num_frames = 0;
+  int64_t num_batch_frames = 0;
+  for (size_t b = 0; b != buckets.size(); ++b) {
+    for (auto i : buckets[b]) {
+      groups[b].push_back(ss[i]);
+      num_frames += lengths[i];
+    }
+    num_batch_frames +=
+        static_cast<int64_t>(lengths[buckets[b][0]]) * buckets[b].size();
+  }
+
+  num_frames_ += num_frames;
+  num_batch_frames_ += num_batch_frames;
+
+  if (groups.size() <= 1) {
+    impl_->DecodeStreams(ss, n);
+    return;
+  }
+
+  pool_->ParallelFor(groups.size(), [this, &groups](int32_t i) {
+    impl_->DecodeStreams(groups[i].data(), groups[i].size());
+  });
+}
+
+float OfflineRecognizer::PaddingEfficiency() const {
+  int64_t total = num_batch_frames_;
+  return total ? static_cast<float>(num_frames_) / total : 1;
 }
 
 void OfflineRecognizer::SetConfig(const OfflineRecognizerConfig &config) {
   impl_->SetConfig(config);
+
+  max_padding_ratio_ = config.max_padding_ratio;
+
+  int32_t num_threads = std::max(config.num_bucket_threads - 1, 0);
+  if (num_threads != pool_->NumThreads()) {
+    pool_ = std::make_unique<ThreadPool>(num_threads);
+  }
 }
 
 OfflineRecognizerConfig OfflineRecognizer::GetConfig() const {
-  return impl_->GetConfig();
+  OfflineRecognizerConfig config = impl_->GetConfig();
+  config.max_padding_ratio = max_padding_ratio_;
+  config.num_bucket_threads = pool_->NumThreads() + 1;
+  return config;
 }
 
 #if __ANDROID_API__ >= 9
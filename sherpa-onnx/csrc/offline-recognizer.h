@@ -5,6 +5,7 @@
 #ifndef SHERPA_ONNX_CSRC_OFFLINE_RECOGNIZER_H_
 #define SHERPA_ONNX_CSRC_OFFLINE_RECOGNIZER_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -43,6 +44,15 @@ struct OfflineRecognizerConfig {
   std::string rule_fars;
   HomophoneReplacerConfig hr;
 
+  // DecodeStreams() splits its input into groups of streams of similar
+  // lengths, so that at most this fraction of the frames in a group is
+  // padding. Each group is a separate encoder batch. 1 to disable it,
+  // i.e., all streams are decoded in a single batch as before.
+  float max_padding_ratio = 1;
+
+  // Number of threads decoding the groups above in parallel
+  int32_t num_bucket_threads = 1;
+
   // only greedy_search is implemented
   // TODO(fangjun): Implement modified_beam_search
 
@@ -75,6 +85,7 @@ struct OfflineRecognizerConfig {
 };
 
 class OfflineRecognizerImpl;
+class ThreadPool;
 
 class OfflineRecognizer {
  public:
@@ -120,13 +131,27 @@ class OfflineRecognizer {
    * The exact behavior can be defined by a specific recognizer impl.
    * For instance, for the whisper recognizer, you can retrieve the language and
    * task from the config and ignore any remaining fields in `config`.
+   *
+   * max_padding_ratio and num_bucket_threads are always applied. It must
+   * not be called while DecodeStreams() is running.
    */
   void SetConfig(const OfflineRecognizerConfig &config);
 
   OfflineRecognizerConfig GetConfig() const;
 
+  /** Return the fraction of frames passed to the encoder by DecodeStreams()
+   * that are not padding, accumulated over all calls so far. It is 1 if
+   * nothing has been decoded.
+   */
+  float PaddingEfficiency() const;
+
  private:
   std::unique_ptr<OfflineRecognizerImpl> impl_;
+  float max_padding_ratio_;
+  std::unique_ptr<ThreadPool> pool_;
+
+  mutable std::atomic<int64_t> num_frames_{0};
+  mutable std::atomic<int64_t> num_batch_frames_{0};
 };
 
 }  // namespace sherpa_onnx
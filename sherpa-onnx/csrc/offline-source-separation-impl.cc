@@ -58,6 +58,12 @@ OfflineSourceSeparationImpl::Create(
   return nullptr;
 }
 
+void OfflineSourceSeparationImpl::Process(
+    const OfflineSourceSeparationInput &input,
+    const OfflineSourceSeparationCallback &callback) const {
+  callback(Process(input));
+}
+
 OfflineSourceSeparationInput OfflineSourceSeparationImpl::Resample(
     const OfflineSourceSeparationInput &input, bool debug /*= false*/) const {
   const OfflineSourceSeparationInput *p_input = &input;
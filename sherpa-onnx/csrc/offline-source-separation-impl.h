@@ -26,6 +26,11 @@ class OfflineSourceSeparationImpl {
   virtual OfflineSourceSeparationOutput Process(
       const OfflineSourceSeparationInput &input) const = 0;
 
+  // The default implementation invokes the callback only once with
+  // the whole output.
+  virtual void Process(const OfflineSourceSeparationInput &input,
+                       const OfflineSourceSeparationCallback &callback) const;
+
   virtual int32_t GetOutputSampleRate() const = 0;
 
   virtual int32_t GetNumberOfStems() const = 0;
@@ -6,6 +6,8 @@
 #define SHERPA_ONNX_CSRC_OFFLINE_SOURCE_SEPARATION_UVR_IMPL_H_
 
 #include <algorithm>
+#include <array>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -17,6 +19,7 @@
 #include "sherpa-onnx/csrc/offline-source-separation.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/resample.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
 
 namespace sherpa_onnx {
 
@@ -24,85 +27,105 @@ class OfflineSourceSeparationUvrImpl : public OfflineSourceSeparationImpl {
  public:
   explicit OfflineSourceSeparationUvrImpl(
       const OfflineSourceSeparationConfig &config)
-      : config_(config), model_(config_.model) {}
+      : config_(config),
+        model_(config_.model),
+        pool_(std::make_unique<ThreadPool>(config_.model.num_threads - 1)) {}
 
   template <typename Manager>
   OfflineSourceSeparationUvrImpl(Manager *mgr,
                                  const OfflineSourceSeparationConfig &config)
-      : config_(config), model_(mgr, config_.model) {}
+      : config_(config),
+        model_(mgr, config_.model),
+        pool_(std::make_unique<ThreadPool>(config_.model.num_threads - 1)) {}
 
   OfflineSourceSeparationOutput Process(
-      const OfflineSourceSeparationInput &_input) const override {
+      const OfflineSourceSeparationInput &input) const override {
+    OfflineSourceSeparationOutput ans;
+    ans.sample_rate = GetOutputSampleRate();
+
+    ans.stems.resize(2);
+    for (auto &stem : ans.stems) {
+      stem.data.resize(2);
+    }
+
+    Process(input, [&ans](const OfflineSourceSeparationOutput &out) {
+      for (int32_t s = 0; s != static_cast<int32_t>(out.stems.size()); ++s) {
+        for (int32_t c = 0; c != 2; ++c) {
+          const auto &src = out.stems[s].data[c];
+          auto &dst = ans.stems[s].data[c];
+          dst.insert(dst.end(), src.begin(), src.end());
+        }
+      }
+    });
+
+    return ans;
+  }
+
+  void Process(const OfflineSourceSeparationInput &_input,
+               const OfflineSourceSeparationCallback &callback) const override {
     auto input = Resample(_input, config_.model.debug);
 
-    auto chunks_ch0 = SplitIntoChunks(input.samples.data[0]);
+    const auto &samples_ch0 = input.samples.data[0];
+    const auto &samples_ch1 = input.samples.data.size() > 1
+                                  ? input.samples.data[1]
+                                  : input.samples.data[0];
+    bool is_mono = input.samples.data.size() == 1;
 
-    std::vector<std::vector<float>> chunks_ch1;
-    if (input.samples.data.size() > 1) {
-      chunks_ch1 = SplitIntoChunks(input.samples.data[1]);
-    }
+    auto chunks = SplitIntoChunks(samples_ch0.size());
+    int32_t num_chunks = static_cast<int32_t>(chunks.size());
+    int32_t batch_size = std::max(config_.model.uvr.batch_size, 1);
 
-    std::vector<float> samples_ch0;
-    std::vector<float> samples_ch1;
+    // Position in the input of the first sample of the next output piece
+    int32_t offset = 0;
 
-    for (int32_t i = 0; i != static_cast<int32_t>(chunks_ch0.size()); ++i) {
-      bool is_first_chunk = (i == 0);
-      bool is_last_chunk = (i == static_cast<int32_t>(chunks_ch0.size()) - 1);
+    for (int32_t b = 0; b < num_chunks; b += batch_size) {
+      int32_t n = std::min(batch_size, num_chunks - b);
 
-      auto s = ProcessChunk(
-          chunks_ch0[i],
-          chunks_ch1.empty() ? std::vector<float>{} : chunks_ch1[i],
-          is_first_chunk, is_last_chunk);
+      std::vector<ChunkInfo> batch(n);
+      for (int32_t i = 0; i != n; ++i) {
+        batch[i].start = chunks[b + i].first;
+        batch[i].end = chunks[b + i].second;
+        batch[i].is_first_chunk = (b + i == 0);
+        batch[i].is_last_chunk = (b + i == num_chunks - 1);
+      }
 
-      samples_ch0.insert(samples_ch0.end(), s.first.begin(), s.first.end());
-      samples_ch1.insert(samples_ch1.end(), s.second.begin(), s.second.end());
-    }
+      ProcessBatch(samples_ch0.data(), samples_ch1.data(), is_mono, &batch);
 
-    auto &vocals_ch0 = samples_ch0;
-    auto &vocals_ch1 = samples_ch1;
-
-    std::vector<float> non_vocals_ch0(vocals_ch0.size());
-    std::vector<float> non_vocals_ch1(vocals_ch1.size());
-
-    Eigen::Map<Eigen::VectorXf>(non_vocals_ch0.data(), non_vocals_ch0.size()) =
-        Eigen::Map<Eigen::VectorXf>(input.samples.data[0].data(),
-                                    input.samples.data[0].size())
-            .array() -
-        Eigen::Map<Eigen::VectorXf>(vocals_ch0.data(), vocals_ch0.size())
-            .array();
-
-    if (input.samples.data.size() > 1) {
-      Eigen::Map<Eigen::VectorXf>(non_vocals_ch1.data(),
-                                  non_vocals_ch1.size()) =
-          Eigen::Map<Eigen::VectorXf>(input.samples.data[1].data(),
-                                      input.samples.data[1].size())
-              .array() -
-          Eigen::Map<Eigen::VectorXf>(vocals_ch1.data(), vocals_ch1.size())
-              .array();
-    } else {
-      Eigen::Map<Eigen::VectorXf>(non_vocals_ch1.data(),
-                                  non_vocals_ch1.size()) =
-          Eigen::Map<Eigen::VectorXf>(input.samples.data[0].data(),
-                                      input.samples.data[0].size())
-              .array() -
-          Eigen::Map<Eigen::VectorXf>(vocals_ch1.data(), vocals_ch1.size())
-              .array();
-    }
+      for (auto &c : batch) {
+        OfflineSourceSeparationOutput out;
+        out.sample_rate = GetOutputSampleRate();
+        out.stems.resize(2);
 
-    OfflineSourceSeparationOutput ans;
-    ans.sample_rate = GetOutputSampleRate();
+        int32_t num_samples = static_cast<int32_t>(c.vocals[0].size());
 
-    ans.stems.resize(2);
-    ans.stems[0].data.reserve(2);
-    ans.stems[1].data.reserve(2);
+        std::vector<float> non_vocals_ch0(num_samples);
+        std::vector<float> non_vocals_ch1(num_samples);
 
-    ans.stems[0].data.push_back(std::move(vocals_ch0));
-    ans.stems[0].data.push_back(std::move(vocals_ch1));
+        Eigen::Map<Eigen::VectorXf>(non_vocals_ch0.data(), num_samples) =
+            Eigen::Map<const Eigen::VectorXf>(samples_ch0.data() + offset,
+                                              num_samples)
+                .array() -
+            Eigen::Map<Eigen::VectorXf>(c.vocals[0].data(), num_samples)
+                .array();
 
-    ans.stems[1].data.push_back(std::move(non_vocals_ch0));
-    ans.stems[1].data.push_back(std::move(non_vocals_ch1));
+        Eigen::Map<Eigen::VectorXf>(non_vocals_ch1.data(), num_samples) =
+            Eigen::Map<const Eigen::VectorXf>(samples_ch1.data() + offset,
+                                              num_samples)
+                .array() -
+            Eigen::Map<Eigen::VectorXf>(c.vocals[1].data(), num_samples)
+                .array();
 
-    return ans;
+        offset += num_samples;
+
+        out.stems[0].data.push_back(std::move(c.vocals[0]));
+        out.stems[0].data.push_back(std::move(c.vocals[1]));
+
+        out.stems[1].data.push_back(std::move(non_vocals_ch0));
+        out.stems[1].data.push_back(std::move(non_vocals_ch1));
+
+        callback(out);
+      }
+    }
   }
 
   int32_t GetOutputSampleRate() const override {
@@ -114,25 +137,54 @@ class OfflineSourceSeparationUvrImpl : public OfflineSourceSeparationImpl {
   }
 
  private:
-  std::pair<std::vector<float>, std::vector<float>> ProcessChunk(
-      const std::vector<float> &chunk_ch0, const std::vector<float> &chunk_ch1,
-      bool is_first_chunk, bool is_last_chunk) const {
-    int32_t pad0 = 0;
-
-    auto stft_results_ch0 = ComputeStft(chunk_ch0, &pad0);
-
-    int32_t pad1 = pad0;
-    std::vector<knf::StftResult> stft_results_ch1;
-
-    if (!chunk_ch1.empty()) {
-      stft_results_ch1 = ComputeStft(chunk_ch1, &pad1);
-    } else {
-      stft_results_ch1 = stft_results_ch0;
+  struct ChunkInfo {
+    // [start, end) of this chunk in the input samples, including margins
+    int32_t start = 0;
+    int32_t end = 0;
+
+    bool is_first_chunk = false;
+    bool is_last_chunk = false;
+
+    // stft[c] is for channel c
+    std::vector<knf::StftResult> stft[2];
+    int32_t pad[2] = {0, 0};
+
+    // vocals[c] is for channel c
+    std::vector<float> vocals[2];
+  };
+
+  using RowMajorMatrixXf =
+      Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+  // All chunks in the batch are sent to the model in a single call.
+  // STFT, packing, unpacking and ISTFT of different chunks and channels
+  // are independent of each other and are run in parallel.
+  void ProcessBatch(const float *samples_ch0, const float *samples_ch1,
+                    bool is_mono, std::vector<ChunkInfo> *batch) const {
+    auto &chunks = *batch;
+    int32_t n = static_cast<int32_t>(chunks.size());
+
+    // For mono input, channel 1 is a copy of channel 0
+    int32_t num_channels = is_mono ? 1 : 2;
+
+    pool_->ParallelFor(n * num_channels, [&](int32_t k) {
+      auto &c = chunks[k / num_channels];
+      int32_t ch = k % num_channels;
+      const float *p = ch == 0 ? samples_ch0 : samples_ch1;
+
+      c.stft[ch] = ComputeStft(p + c.start, c.end - c.start, &c.pad[ch]);
+    });
+
+    if (is_mono) {
+      for (auto &c : chunks) {
+        c.stft[1] = c.stft[0];
+        c.pad[1] = c.pad[0];
+      }
     }
 
     const auto &meta_ = model_.GetMetaData();
 
-    int32_t num_frames = stft_results_ch0[0].num_frames;
+    int32_t num_frames = chunks[0].stft[0][0].num_frames;
     int32_t dim_f = meta_.dim_f;
     int32_t dim_t = meta_.dim_t;
     int32_t n_fft_bin = meta_.n_fft / 2 + 1;
@@ -141,57 +193,46 @@ class OfflineSourceSeparationUvrImpl : public OfflineSourceSeparationImpl {
       SHERPA_ONNX_EXIT(-1);
     }
 
-    // the first 2: number of channels
-    // the second 2: real and image
-    std::vector<float> x(stft_results_ch0.size() * 2 * 2 * dim_f * dim_t);
-    float *px = x.data();
-
-    for (int32_t i = 0; i != static_cast<int32_t>(stft_results_ch0.size());
-         ++i) {
-      const auto &ch0 = stft_results_ch0[i];
-      const auto &ch1 = stft_results_ch1[i];
-
-      const float *p_real_ch0 = ch0.real.data();
-      const float *p_imag_ch0 = ch0.imag.data();
-
-      const float *p_real_ch1 = ch1.real.data();
-      const float *p_imag_ch1 = ch1.imag.data();
-
-      for (int32_t j = 0; j != dim_f; ++j) {
-        for (int32_t k = 0; k != num_frames; ++k) {
-          *px = p_real_ch0[k * n_fft_bin + j];
-          ++px;
-        }
-      }
-
-      for (int32_t j = 0; j != dim_f; ++j) {
-        for (int32_t k = 0; k != num_frames; ++k) {
-          *px = p_imag_ch0[k * n_fft_bin + j];
-          ++px;
-        }
+    // (chunk index, segment index within the chunk) of each segment
+    std::vector<std::pair<int32_t, int32_t>> segments;
+    for (int32_t i = 0; i != n; ++i) {
+      int32_t num_segments = static_cast<int32_t>(chunks[i].stft[0].size());
+      for (int32_t j = 0; j != num_segments; ++j) {
+        segments.emplace_back(i, j);
       }
-
-      for (int32_t j = 0; j != dim_f; ++j) {
-        for (int32_t k = 0; k != num_frames; ++k) {
-          *px = p_real_ch1[k * n_fft_bin + j];
-          ++px;
-        }
-      }
-
-      for (int32_t j = 0; j != dim_f; ++j) {
-        for (int32_t k = 0; k != num_frames; ++k) {
-          *px = p_imag_ch1[k * n_fft_bin + j];
-          ++px;
-        }
+    }
+    int32_t num_segments = static_cast<int32_t>(segments.size());
+
+    // Each segment is packed into 4 planes of shape (dim_f, dim_t):
+    // real ch0, imag ch0, real ch1, imag ch1
+    int32_t plane_size = dim_f * dim_t;
+    int32_t segment_size = 4 * plane_size;
+
+    std::vector<float> x(num_segments * segment_size);
+
+    pool_->ParallelFor(num_segments, [&](int32_t s) {
+      const auto &c = chunks[segments[s].first];
+      int32_t j = segments[s].second;
+
+      const float *planes[4] = {
+          c.stft[0][j].real.data(), c.stft[0][j].imag.data(),
+          c.stft[1][j].real.data(), c.stft[1][j].imag.data()};
+
+      float *px = x.data() + s * segment_size;
+      for (int32_t p = 0; p != 4; ++p) {
+        Eigen::Map<RowMajorMatrixXf>(px + p * plane_size, dim_f, num_frames) =
+            Eigen::Map<const RowMajorMatrixXf>(planes[p], num_frames,
+                                               n_fft_bin)
+                .leftCols(dim_f)
+                .transpose();
       }
-    }  // for (int32_t i = 0; i !=
+    });
 
     auto memory_info =
         Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
 
-    std::array<int64_t, 4> x_shape{
-        static_cast<int32_t>(stft_results_ch0.size()) * 4 / meta_.dim_c,
-        meta_.dim_c, dim_f, dim_t};
+    std::array<int64_t, 4> x_shape{num_segments * 4 / meta_.dim_c,
+                                   meta_.dim_c, dim_f, dim_t};
 
     Ort::Value x_tensor = Ort::Value::CreateTensor(
         memory_info, x.data(), x.size(), x_shape.data(), x_shape.size());
@@ -200,63 +241,35 @@ class OfflineSourceSeparationUvrImpl : public OfflineSourceSeparationImpl {
 
     const float *p_spec = spec.GetTensorData<float>();
 
-    for (int32_t i = 0; i != static_cast<int32_t>(stft_results_ch0.size());
-         ++i) {
-      auto &ch0 = stft_results_ch0[i];
-      auto &ch1 = stft_results_ch1[i];
-
-      float *p_real_ch0 = ch0.real.data();
-      float *p_imag_ch0 = ch0.imag.data();
+    pool_->ParallelFor(num_segments, [&](int32_t s) {
+      auto &c = chunks[segments[s].first];
+      int32_t j = segments[s].second;
 
-      float *p_real_ch1 = ch1.real.data();
-      float *p_imag_ch1 = ch1.imag.data();
+      float *planes[4] = {c.stft[0][j].real.data(), c.stft[0][j].imag.data(),
+                          c.stft[1][j].real.data(), c.stft[1][j].imag.data()};
 
-      for (int32_t j = 0; j != dim_f; ++j) {
-        for (int32_t k = 0; k != num_frames; ++k) {
-          p_real_ch0[k * n_fft_bin + j] = *p_spec;
-          ++p_spec;
-        }
-      }
-
-      for (int32_t j = 0; j != dim_f; ++j) {
-        for (int32_t k = 0; k != num_frames; ++k) {
-          p_imag_ch0[k * n_fft_bin + j] = *p_spec;
-          ++p_spec;
-        }
-      }
+      const float *p = p_spec + s * segment_size;
+      for (int32_t k = 0; k != 4; ++k) {
+        Eigen::Map<RowMajorMatrixXf> dst(planes[k], num_frames, n_fft_bin);
 
-      for (int32_t j = 0; j != dim_f; ++j) {
-        for (int32_t k = 0; k != num_frames; ++k) {
-          p_real_ch1[k * n_fft_bin + j] = *p_spec;
-          ++p_spec;
-        }
+        dst.leftCols(dim_f) =
+            Eigen::Map<const RowMajorMatrixXf>(p + k * plane_size, dim_f,
+                                               num_frames)
+                .transpose();
+        dst.rightCols(n_fft_bin - dim_f).setZero();
       }
+    });
 
-      for (int32_t j = 0; j != dim_f; ++j) {
-        for (int32_t k = 0; k != num_frames; ++k) {
-          p_imag_ch1[k * n_fft_bin + j] = *p_spec;
-          ++p_spec;
-        }
-      }
+    pool_->ParallelFor(n * 2, [&](int32_t k) {
+      auto &c = chunks[k / 2];
+      int32_t ch = k % 2;
 
-      for (int32_t k = 0; k != num_frames; ++k) {
-        for (int32_t j = dim_f; j != n_fft_bin; ++j) {
-          p_real_ch0[k * n_fft_bin + j] = 0;
-          p_real_ch1[k * n_fft_bin + j] = 0;
+      c.vocals[ch] = ComputeInverseStft(c.stft[ch], c.pad[ch],
+                                        c.is_first_chunk, c.is_last_chunk);
 
-          p_imag_ch0[k * n_fft_bin + j] = 0;
-          p_imag_ch1[k * n_fft_bin + j] = 0;
-        }
-      }
-    }
-
-    auto samples_ch0 = ComputeInverseStft(stft_results_ch0, pad0,
-                                          is_first_chunk, is_last_chunk);
-
-    auto samples_ch1 = ComputeInverseStft(stft_results_ch1, pad1,
-                                          is_first_chunk, is_last_chunk);
-
-    return {std::move(samples_ch0), std::move(samples_ch1)};
+      // Release the memory as early as possible
+      c.stft[ch] = {};
+    });
   }
 
   std::vector<float> ComputeInverseStft(
@@ -293,18 +306,18 @@ class OfflineSourceSeparationUvrImpl : public OfflineSourceSeparationImpl {
     return {ans.begin() + start, ans.begin() + end};
   }
 
-  std::vector<knf::StftResult> ComputeStft(const std::vector<float> &chunk,
+  std::vector<knf::StftResult> ComputeStft(const float *chunk,
+                                           int32_t num_samples,
                                            int32_t *pad) const {
     const auto &meta_ = model_.GetMetaData();
 
-    int32_t num_samples = static_cast<int32_t>(chunk.size());
     int32_t trim = meta_.n_fft / 2;
     int32_t chunk_size = meta_.hop_length * (meta_.dim_t - 1);
     int32_t gen_size = chunk_size - 2 * trim;
     *pad = gen_size - num_samples % gen_size;
 
-    std::vector<float> samples(trim + chunk.size() + *pad + trim);
-    std::copy(chunk.begin(), chunk.end(), samples.begin() + trim);
+    std::vector<float> samples(trim + num_samples + *pad + trim);
+    std::copy(chunk, chunk + num_samples, samples.begin() + trim);
 
     auto stft_config = GetStftConfig();
     knf::Stft stft(stft_config);
@@ -319,11 +332,12 @@ class OfflineSourceSeparationUvrImpl : public OfflineSourceSeparationImpl {
     return stft_results;
   }
 
-  std::vector<std::vector<float>> SplitIntoChunks(
-      const std::vector<float> &samples) const {
-    std::vector<std::vector<float>> ans;
+  // Return the [start, end) of each chunk, including the margins
+  std::vector<std::pair<int32_t, int32_t>> SplitIntoChunks(
+      int32_t num_samples) const {
+    std::vector<std::pair<int32_t, int32_t>> ans;
 
-    if (samples.empty()) {
+    if (num_samples == 0) {
       return ans;
     }
 
@@ -332,26 +346,24 @@ class OfflineSourceSeparationUvrImpl : public OfflineSourceSeparationImpl {
 
     int32_t chunk_size = meta_.num_chunks * meta_.sample_rate;
 
-    if (static_cast<int32_t>(samples.size()) < chunk_size) {
-      chunk_size = samples.size();
+    if (num_samples < chunk_size) {
+      chunk_size = num_samples;
     }
 
     if (margin > chunk_size) {
       margin = chunk_size;
     }
 
-    for (int32_t i = 0; i < static_cast<int32_t>(samples.size());
-         i += chunk_size) {
+    for (int32_t i = 0; i < num_samples; i += chunk_size) {
       int32_t start = std::max<int32_t>(0, i - margin);
-      int32_t end = std::min<int32_t>(i + chunk_size + margin,
-                                      static_cast<int32_t>(samples.size()));
+      int32_t end = std::min<int32_t>(i + chunk_size + margin, num_samples);
       if (start >= end) {
         break;
       }
 
-      ans.emplace_back(samples.begin() + start, samples.begin() + end);
+      ans.emplace_back(start, end);
 
-      if (end == static_cast<int32_t>(samples.size())) {
+      if (end == num_samples) {
         break;
       }
     }
@@ -375,6 +387,10 @@ class OfflineSourceSeparationUvrImpl : public OfflineSourceSeparationImpl {
  private:
   OfflineSourceSeparationConfig config_;
   OfflineSourceSeparationUvrModel model_;
+
+  // The calling thread also takes part in the work, so there are
+  // num_threads - 1 workers
+  std::unique_ptr<ThreadPool> pool_;
 };
 
 }  // namespace sherpa_onnx
@@ -13,6 +13,9 @@ namespace sherpa_onnx {
 
 void OfflineSourceSeparationUvrModelConfig::Register(ParseOptions *po) {
   po->Register("uvr-model", &model, "Path to the UVR model");
+
+  po->Register("uvr-batch-size", &batch_size,
+               "Number of chunks to process in one call of the UVR model");
 }
 
 bool OfflineSourceSeparationUvrModelConfig::Validate() const {
@@ -26,6 +29,12 @@ bool OfflineSourceSeparationUvrModelConfig::Validate() const {
     return false;
   }
 
+  if (batch_size < 1) {
+    SHERPA_ONNX_LOGE("--uvr-batch-size should be >= 1. Given: %d",
+                     batch_size);
+    return false;
+  }
+
   return true;
 }
 
@@ -33,7 +42,8 @@ std::string OfflineSourceSeparationUvrModelConfig::ToString() const {
   std::ostringstream os;
 
   os << "OfflineSourceSeparationUvrModelConfig(";
-  os << "model=\"" << model << "\")";
+  os << "model=\"" << model << "\", ";
+  os << "batch_size=" << batch_size << ")";
 
   return os.str();
 }
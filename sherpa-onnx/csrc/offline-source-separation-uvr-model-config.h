@@ -15,10 +15,15 @@ namespace sherpa_onnx {
 struct OfflineSourceSeparationUvrModelConfig {
   std::string model;
 
+  // Number of chunks to run in a single call of the model.
+  // A larger value uses more memory but gives a higher throughput.
+  int32_t batch_size = 1;
+
   OfflineSourceSeparationUvrModelConfig() = default;
 
-  explicit OfflineSourceSeparationUvrModelConfig(const std::string &model)
-      : model(model) {}
+  explicit OfflineSourceSeparationUvrModelConfig(const std::string &model,
+                                                 int32_t batch_size = 1)
+      : model(model), batch_size(batch_size) {}
 
   void Register(ParseOptions *po);
 
@@ -53,6 +53,12 @@ OfflineSourceSeparationOutput OfflineSourceSeparation::Process(
   return impl_->Process(input);
 }
 
+void OfflineSourceSeparation::Process(
+    const OfflineSourceSeparationInput &input,
+    const OfflineSourceSeparationCallback &callback) const {
+  impl_->Process(input, callback);
+}
+
 int32_t OfflineSourceSeparation::GetOutputSampleRate() const {
   return impl_->GetOutputSampleRate();
 }
@@ -5,6 +5,7 @@
 #ifndef SHERPA_ONNX_CSRC_OFFLINE_SOURCE_SEPARATION_H_
 #define SHERPA_ONNX_CSRC_OFFLINE_SOURCE_SEPARATION_H_
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -49,6 +50,12 @@ struct OfflineSourceSeparationOutput {
   int32_t sample_rate;
 };
 
+// It is called with consecutive pieces of the separated stems, in order.
+// Concatenating all the pieces gives the same result as the
+// non-streaming Process().
+using OfflineSourceSeparationCallback =
+    std::function<void(const OfflineSourceSeparationOutput &output)>;
+
 class OfflineSourceSeparationImpl;
 
 class OfflineSourceSeparation {
@@ -64,6 +71,12 @@ class OfflineSourceSeparation {
   OfflineSourceSeparationOutput Process(
       const OfflineSourceSeparationInput &input) const;
 
+  // Like Process() above, but the result is delivered piece by piece
+  // via the callback so that the whole output needs not to be kept in
+  // memory. Only the UVR model produces more than one piece.
+  void Process(const OfflineSourceSeparationInput &input,
+               const OfflineSourceSeparationCallback &callback) const;
+
   int32_t GetOutputSampleRate() const;
 
   // e.g., it is 2 for 2stems from spleeter
@@ -4,7 +4,13 @@
 
 #include "sherpa-onnx/csrc/offline-speech-denoiser.h"
 
+#include <algorithm>
+#include <cinttypes>
+#include <limits>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #if __ANDROID_API__ >= 9
 #include "android/asset_manager.h"
@@ -15,38 +21,256 @@
 #include "rawfile/raw_file_manager.h"
 #endif
 
+#include "sherpa-onnx/csrc/audio-source.h"
+#include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/offline-speech-denoiser-impl.h"
+#include "sherpa-onnx/csrc/resample.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
 
 namespace sherpa_onnx {
 
 void OfflineSpeechDenoiserConfig::Register(ParseOptions *po) {
   model.Register(po);
+
+  po->Register("segment-duration", &segment_duration,
+               "If positive, split the input into segments of this many "
+               "seconds and denoise them independently to bound the memory "
+               "usage for long inputs. 0 to process the whole input at once");
+
+  po->Register("segment-overlap", &segment_overlap,
+               "Overlap in seconds between two adjacent segments. Used only "
+               "when --segment-duration is positive");
+
+  po->Register("segment-num-threads", &segment_num_threads,
+               "Number of threads to denoise segments in parallel. Used only "
+               "when --segment-duration is positive");
 }
 
-bool OfflineSpeechDenoiserConfig::Validate() const { return model.Validate(); }
+bool OfflineSpeechDenoiserConfig::Validate() const {
+  if (segment_duration < 0) {
+    SHERPA_ONNX_LOGE("--segment-duration should be >= 0. Given: %.3f",
+                     segment_duration);
+    return false;
+  }
+
+  if (segment_duration > 0) {
+    if (segment_overlap < 0 || 2 * segment_overlap >= segment_duration) {
+      SHERPA_ONNX_LOGE(
+          "--segment-overlap should be in the range [0, %.3f). Given: %.3f",
+          segment_duration / 2, segment_overlap);
+      return false;
+    }
+
+    if (segment_num_threads < 1) {
+      SHERPA_ONNX_LOGE("--segment-num-threads should be >= 1. Given: %d",
+                       segment_num_threads);
+      return false;
+    }
+  }
+
+  return model.Validate();
+}
 
 std::string OfflineSpeechDenoiserConfig::ToString() const {
   std::ostringstream os;
 
   os << "OfflineSpeechDenoiserConfig(";
-  os << "model=" << model.ToString() << ")";
+  os << "model=" << model.ToString() << ", ";
+  os << "segment_duration=" << segment_duration << ", ";
+  os << "segment_overlap=" << segment_overlap << ", ";
+  os << "segment_num_threads=" << segment_num_threads << ")";
   return os.str();
 }
 
 template <typename Manager>
 OfflineSpeechDenoiser::OfflineSpeechDenoiser(
     Manager *mgr, const OfflineSpeechDenoiserConfig &config)
-    : impl_(OfflineSpeechDenoiserImpl::Create(mgr, config)) {}
+    : config_(config),
+      impl_(OfflineSpeechDenoiserImpl::Create(mgr, config)),
+      pool_(std::make_unique<ThreadPool>(config.segment_num_threads - 1)) {}
 
 OfflineSpeechDenoiser::OfflineSpeechDenoiser(
     const OfflineSpeechDenoiserConfig &config)
-    : impl_(OfflineSpeechDenoiserImpl::Create(config)) {}
+    : config_(config),
+      impl_(OfflineSpeechDenoiserImpl::Create(config)),
+      pool_(std::make_unique<ThreadPool>(config.segment_num_threads - 1)) {}
 
 OfflineSpeechDenoiser::~OfflineSpeechDenoiser() = default;
 
 DenoisedAudio OfflineSpeechDenoiser::Run(const float *samples, int32_t n,
                                          int32_t sample_rate) const {
-  return impl_->Run(samples, n, sample_rate);
+  if (config_.segment_duration <= 0) {
+    return impl_->Run(samples, n, sample_rate);
+  }
+
+  DenoisedAudio ans;
+  ans.sample_rate = GetSampleRate();
+
+  MemoryAudioSource source(samples, n, sample_rate);
+  RunSegments(&source, [&ans](const DenoisedAudio &audio) {
+    ans.samples.insert(ans.samples.end(), audio.samples.begin(),
+                       audio.samples.end());
+  });
+
+  return ans;
+}
+
+void OfflineSpeechDenoiser::Run(
+    const float *samples, int32_t n, int32_t sample_rate,
+    const OfflineSpeechDenoiserCallback &callback) const {
+  if (config_.segment_duration <= 0) {
+    callback(impl_->Run(samples, n, sample_rate));
+    return;
+  }
+
+  MemoryAudioSource source(samples, n, sample_rate);
+  RunSegments(&source, callback);
+}
+
+void OfflineSpeechDenoiser::Run(
+    AudioSource *source, const OfflineSpeechDenoiserCallback &callback) const {
+  if (config_.segment_duration <= 0) {
+    if (source->NumSamples() > std::numeric_limits<int32_t>::max()) {
+      SHERPA_ONNX_LOGE(
+          "The input has %" PRId64
+          " samples, which is too long to denoise at once. Please set a "
+          "positive segment duration",
+          source->NumSamples());
+      return;
+    }
+
+    std::vector<float> samples;
+    source->Read(source->NumSamples(), &samples);
+    callback(impl_->Run(samples.data(), samples.size(), source->SampleRate()));
+    return;
+  }
+
+  RunSegments(source, callback);
+}
+
+/*
+ * Segment i covers [i * step, i * step + segment_size) of the input at
+ * the sample rate of the model, where step = segment_size - overlap.
+ * Up to segment_num_threads segments are denoised in parallel. The last
+ * overlap samples of a segment are crossfaded with the first overlap
+ * samples of the next one. Only the samples of the segments being
+ * processed are kept in memory.
+ */
+void OfflineSpeechDenoiser::RunSegments(
+    AudioSource *source, const OfflineSpeechDenoiserCallback &callback) const {
+  int32_t sample_rate = source->SampleRate();
+  int64_t n = source->NumSamples();
+  int32_t model_sample_rate = GetSampleRate();
+
+  int32_t segment_size = config_.segment_duration * model_sample_rate;
+  int32_t overlap = config_.segment_overlap * model_sample_rate;
+  overlap = std::min(overlap, (segment_size - 1) / 2);
+  int32_t step = segment_size - overlap;
+  int32_t num_parallel = config_.segment_num_threads;
+
+  std::unique_ptr<LinearResample> resampler;
+  if (sample_rate != model_sample_rate) {
+    float min_freq = std::min<int32_t>(sample_rate, model_sample_rate);
+    float lowpass_cutoff = 0.99 * 0.5 * min_freq;
+
+    int32_t lowpass_filter_width = 6;
+    resampler = std::make_unique<LinearResample>(
+        sample_rate, model_sample_rate, lowpass_cutoff, lowpass_filter_width);
+  }
+
+  // Input samples at the sample rate of the model, starting from the
+  // first segment that has not been processed yet
+  std::vector<float> buffer;
+  int64_t offset = 0;  // number of input samples consumed
+
+  auto fill = [&](int32_t num_samples) {
+    std::vector<float> samples;
+    std::vector<float> tmp;
+    while (static_cast<int32_t>(buffer.size()) < num_samples && offset < n) {
+      int32_t k = source->Read(segment_size, &samples);
+      if (k == 0) {
+        // The source is shorter than it claims
+        n = offset;
+      }
+      offset += k;
+
+      if (resampler) {
+        resampler->Resample(samples.data(), k, offset == n, &tmp);
+        buffer.insert(buffer.end(), tmp.begin(), tmp.end());
+      } else {
+        buffer.insert(buffer.end(), samples.begin(), samples.end());
+      }
+    }
+  };
+
+  std::vector<float> tail;  // last overlap samples of the previous segment
+  bool done = false;
+
+  while (!done) {
+    fill(num_parallel * step + overlap);
+
+    int32_t available = buffer.size();
+    bool eof = offset == n;
+
+    std::vector<std::pair<int32_t, int32_t>> segments;  // [start, end)
+    for (int32_t i = 0; i != num_parallel; ++i) {
+      int32_t start = i * step;
+      if (eof && start + segment_size >= available) {
+        segments.emplace_back(start, available);
+        done = true;
+        break;
+      }
+
+      if (start + segment_size > available) {
+        break;
+      }
+
+      segments.emplace_back(start, start + segment_size);
+    }
+
+    int32_t num_segments = segments.size();
+    std::vector<std::vector<float>> outputs(num_segments);
+
+    pool_->ParallelFor(num_segments, [&](int32_t i) {
+      int32_t start = segments[i].first;
+      int32_t len = segments[i].second - start;
+      if (len <= 0) {
+        return;
+      }
+
+      outputs[i] =
+          impl_->Run(buffer.data() + start, len, model_sample_rate).samples;
+      outputs[i].resize(len);
+    });
+
+    for (int32_t i = 0; i != num_segments; ++i) {
+      auto &y = outputs[i];
+      int32_t len = y.size();
+      bool is_last = done && i + 1 == num_segments;
+
+      int32_t num_fade = std::min<int32_t>(tail.size(), len);
+      for (int32_t k = 0; k != num_fade; ++k) {
+        float w = (k + 0.5f) / num_fade;
+        y[k] = (1 - w) * tail[k] + w * y[k];
+      }
+
+      int32_t end = is_last ? len : std::max(len - overlap, 0);
+
+      DenoisedAudio audio;
+      audio.sample_rate = model_sample_rate;
+      audio.samples.assign(y.begin(), y.begin() + end);
+      if (!audio.samples.empty()) {
+        callback(audio);
+      }
+
+      tail.assign(y.begin() + end, y.end());
+    }
+
+    if (!done) {
+      int32_t consumed = std::min<int32_t>(num_segments * step, buffer.size());
+      buffer.erase(buffer.begin(), buffer.begin() + consumed);
+    }
+  }
 }
 
 int32_t OfflineSpeechDenoiser::GetSampleRate() const {
@@ -4,6 +4,7 @@
 #ifndef SHERPA_ONNX_CSRC_OFFLINE_SPEECH_DENOISER_H_
 #define SHERPA_ONNX_CSRC_OFFLINE_SPEECH_DENOISER_H_
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -21,13 +22,40 @@ struct DenoisedAudio {
 struct OfflineSpeechDenoiserConfig {
   OfflineSpeechDenoiserModelConfig model;
 
+  // If positive, the input is split into segments of this many seconds.
+  // Segments are denoised independently and joined with a crossfade over
+  // segment_overlap seconds, so memory usage does not grow with the
+  // length of the input. If 0, the whole input is processed at once.
+  float segment_duration = 0;
+  float segment_overlap = 0.5;
+
+  // Number of threads to denoise segments in parallel
+  int32_t segment_num_threads = 1;
+
+  OfflineSpeechDenoiserConfig() = default;
+
+  explicit OfflineSpeechDenoiserConfig(
+      const OfflineSpeechDenoiserModelConfig &model,
+      float segment_duration = 0, float segment_overlap = 0.5,
+      int32_t segment_num_threads = 1)
+      : model(model),
+        segment_duration(segment_duration),
+        segment_overlap(segment_overlap),
+        segment_num_threads(segment_num_threads) {}
+
   void Register(ParseOptions *po);
   bool Validate() const;
 
   std::string ToString() const;
 };
 
+// It is called with consecutive pieces of the denoised audio, in order.
+using OfflineSpeechDenoiserCallback =
+    std::function<void(const DenoisedAudio &audio)>;
+
+class AudioSource;
 class OfflineSpeechDenoiserImpl;
+class ThreadPool;
 
 class OfflineSpeechDenoiser {
  public:
@@ -47,13 +75,39 @@ class OfflineSpeechDenoiser {
    */
   DenoisedAudio Run(const float *samples, int32_t n, int32_t sample_rate) const;
 
+  /*
+   * Like Run() above, but the result is delivered piece by piece via the
+   * callback. If config.segment_duration is positive, the input is
+   * processed segment by segment so that neither the spectrogram nor the
+   * output of the whole input is kept in memory.
+   */
+  void Run(const float *samples, int32_t n, int32_t sample_rate,
+           const OfflineSpeechDenoiserCallback &callback) const;
+
+  /*
+   * Like Run() above, but the input is read from the given source. Only
+   * the first channel is used. With a positive config.segment_duration,
+   * the input is read segment by segment, so a memory-mapped file of any
+   * length can be denoised in bounded memory. Otherwise, an input with
+   * more than INT32_MAX samples is rejected with an error and the callback
+   * is not invoked.
+   */
+  void Run(AudioSource *source,
+           const OfflineSpeechDenoiserCallback &callback) const;
+
   /*
    * Return the sample rate of the denoised audio
    */
   int32_t GetSampleRate() const;
 
  private:
+  void RunSegments(AudioSource *source,
+                   const OfflineSpeechDenoiserCallback &callback) const;
+
+ private:
+  OfflineSpeechDenoiserConfig config_;
   std::unique_ptr<OfflineSpeechDenoiserImpl> impl_;
+  std::unique_ptr<ThreadPool> pool_;
 };
 
 }  // namespace sherpa_onnx
@@ -125,6 +125,21 @@ class OfflineStream::Impl {
     }
   }
 
+  void AcceptWaveform(int32_t sampling_rate, const void *waveform, int32_t n,
+                      SampleFormat format) {
+    if (CanReadAsFloat(waveform, format)) {
+      AcceptWaveform(sampling_rate, static_cast<const float *>(waveform), n);
+      return;
+    }
+
+    // All samples are needed at once, so convert them in a single pass,
+    // including the scaling for normalize_samples == false
+    std::vector<float> buf(n);
+    ConvertToFloat(waveform, n, format, config_.normalize_samples ? 1 : 32768,
+                   buf.data());
+    AcceptWaveformImpl(sampling_rate, buf.data(), n);
+  }
+
   void AcceptWaveformImpl(int32_t sampling_rate, const float *waveform,
                           int32_t n) {
     if (sampling_rate != config_.sampling_rate) {
@@ -185,21 +200,28 @@ class OfflineStream::Impl {
     return mfcc_ ? mfcc_opts_.num_ceps : opts_.mel_opts.num_bins;
   }
 
-  std::vector<float> GetFrames() const {
+  int32_t NumFrames() const {
+    if (is_moonshine_ || is_omnilingual_asr_) {
+      return 1;
+    }
+
+    return fbank_  ? fbank_->NumFramesReady()
+           : mfcc_ ? mfcc_->NumFramesReady()
+                   : whisper_fbank_->NumFramesReady();
+  }
+
+  void GetFrames(float *features) const {
     if (is_moonshine_ || is_omnilingual_asr_) {
-      return samples_;
+      std::copy(samples_.begin(), samples_.end(), features);
+      return;
     }
 
-    int32_t n = fbank_  ? fbank_->NumFramesReady()
-                : mfcc_ ? mfcc_->NumFramesReady()
-                        : whisper_fbank_->NumFramesReady();
+    int32_t n = NumFrames();
     assert(n > 0 && "Please first call AcceptWaveform()");
 
     int32_t feature_dim = FeatureDim();
 
-    std::vector<float> features(n * feature_dim);
-
-    float *p = features.data();
+    float *p = features;
 
     for (int32_t i = 0; i != n; ++i) {
       const float *f = fbank_  ? fbank_->GetFrame(i)
@@ -209,13 +231,11 @@ class OfflineStream::Impl {
       p += feature_dim;
     }
 
-    NemoNormalizeFeatures(features.data(), n, feature_dim);
+    NemoNormalizeFeatures(features, n, feature_dim);
 
     if (is_ced_) {
-      AmplitudeToDB(features.data(), features.size());
+      AmplitudeToDB(features, n * feature_dim);
     }
-
-    return features;
   }
 
   void SetResult(const OfflineRecognitionResult &r) { r_ = r; }
@@ -359,10 +379,28 @@ void OfflineStream::AcceptWaveform(int32_t sampling_rate, const float *waveform,
   impl_->AcceptWaveform(sampling_rate, waveform, n);
 }
 
+void OfflineStream::AcceptWaveform(int32_t sampling_rate,
+                                   const CircularBufferView &waveform) const {
+  impl_->AcceptWaveform(sampling_rate, waveform.Data(), waveform.Size());
+}
+
+void OfflineStream::AcceptWaveform(int32_t sampling_rate, const void *waveform,
+                                   int32_t n, SampleFormat format) const {
+  impl_->AcceptWaveform(sampling_rate, waveform, n, format);
+}
+
 int32_t OfflineStream::FeatureDim() const { return impl_->FeatureDim(); }
 
+int32_t OfflineStream::NumFrames() const { return impl_->NumFrames(); }
+
 std::vector<float> OfflineStream::GetFrames() const {
-  return impl_->GetFrames();
+  std::vector<float> features(NumFrames() * FeatureDim());
+  impl_->GetFrames(features.data());
+  return features;
+}
+
+void OfflineStream::GetFrames(float *features) const {
+  impl_->GetFrames(features);
 }
 
 void OfflineStream::SetResult(const OfflineRecognitionResult &r) {
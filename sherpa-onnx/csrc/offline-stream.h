@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 
+#include "sherpa-onnx/csrc/circular-buffer.h"
 #include "sherpa-onnx/csrc/context-graph.h"
 #include "sherpa-onnx/csrc/features.h"
 #include "sherpa-onnx/csrc/parse-options.h"
@@ -96,16 +97,36 @@ class OfflineStream {
   void AcceptWaveform(int32_t sampling_rate, const float *waveform,
                       int32_t n) const;
 
+  // Like the above one, but the samples are read directly from a view,
+  // e.g., SpeechSegmentView::samples from the VAD.
+  void AcceptWaveform(int32_t sampling_rate,
+                      const CircularBufferView &waveform) const;
+
+  // Like the first one, but the n samples are in the given format, e.g.,
+  // 16-bit PCM or G.711 mu-law.
+  void AcceptWaveform(int32_t sampling_rate, const void *waveform, int32_t n,
+                      SampleFormat format) const;
+
   /// Return feature dim of this extractor.
   ///
   /// Note: if it is Moonshine, then it returns the number of audio samples
   /// currently received.
   int32_t FeatureDim() const;
 
+  /// Return the number of feature frames of this stream.
+  ///
+  /// Note: if it is Moonshine, then it returns 1.
+  int32_t NumFrames() const;
+
   // Get all the feature frames of this stream in a 1-D array, which is
   // flattened from a 2-D array of shape (num_frames, feat_dim).
   std::vector<float> GetFrames() const;
 
+  // Like the above one, but write the frames to the given buffer of
+  // NumFrames() * FeatureDim() floats, e.g., a row of a padded batch,
+  // instead of allocating a new vector.
+  void GetFrames(float *features) const;
+
   /** Set the recognition result for this stream. */
   void SetResult(const OfflineRecognitionResult &r);
 
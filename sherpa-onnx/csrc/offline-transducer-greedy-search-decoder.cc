@@ -37,8 +37,7 @@ OfflineTransducerGreedySearchDecoder::Decode(Ort::Value encoder_out,
     r.tokens.back() = 0;
   }
 
-  auto decoder_input = model_->BuildDecoderInput(ans, ans.size());
-  Ort::Value decoder_out = model_->RunDecoder(std::move(decoder_input));
+  Ort::Value decoder_out = model_->RunDecoderWithCache(ans, ans.size());
 
   int32_t start = 0;
   int32_t t = 0;
@@ -73,8 +72,7 @@ OfflineTransducerGreedySearchDecoder::Decode(Ort::Value encoder_out,
       }
     }
     if (emitted) {
-      Ort::Value decoder_input = model_->BuildDecoderInput(ans, n);
-      decoder_out = model_->RunDecoder(std::move(decoder_input));
+      decoder_out = model_->RunDecoderWithCache(ans, n);
     }
     ++t;
   }
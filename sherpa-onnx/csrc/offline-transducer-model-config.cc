@@ -15,9 +15,23 @@ void OfflineTransducerModelConfig::Register(ParseOptions *po) {
   po->Register("encoder", &encoder_filename, "Path to encoder.onnx");
   po->Register("decoder", &decoder_filename, "Path to decoder.onnx");
   po->Register("joiner", &joiner_filename, "Path to joiner.onnx");
+  po->Register("native-joiner", &native_joiner,
+               "true to compute the joiner in C++ instead of running "
+               "joiner.onnx. It is faster for small joiners. Ignored if the "
+               "joiner model is not supported, e.g., if it is quantized");
+  po->Register("decoder-output-cache-size", &decoder_output_cache_size,
+               "Maximum number of decoder outputs cached per model. The "
+               "decoder model runs only for token contexts that are not in "
+               "the cache. 0 to disable the cache");
 }
 
 bool OfflineTransducerModelConfig::Validate() const {
+  if (decoder_output_cache_size < 0) {
+    SHERPA_ONNX_LOGE("--decoder-output-cache-size should be >= 0. Given: %d",
+                     decoder_output_cache_size);
+    return false;
+  }
+
   if (!FileExists(encoder_filename)) {
     SHERPA_ONNX_LOGE("transducer encoder: '%s' does not exist",
                      encoder_filename.c_str());
@@ -45,7 +59,9 @@ std::string OfflineTransducerModelConfig::ToString() const {
   os << "OfflineTransducerModelConfig(";
   os << "encoder_filename=\"" << encoder_filename << "\", ";
   os << "decoder_filename=\"" << decoder_filename << "\", ";
-  os << "joiner_filename=\"" << joiner_filename << "\")";
+  os << "joiner_filename=\"" << joiner_filename << "\", ";
+  os << "native_joiner=" << (native_joiner ? "True" : "False") << ", ";
+  os << "decoder_output_cache_size=" << decoder_output_cache_size << ")";
 
   return os.str();
 }
@@ -15,6 +15,14 @@ struct OfflineTransducerModelConfig {
   std::string decoder_filename;
   std::string joiner_filename;
 
+  // Compute the joiner in C++ instead of running joiner.onnx if the
+  // joiner model is supported
+  bool native_joiner = false;
+
+  // Maximum number of decoder outputs cached per model, see
+  // decoder-output-cache.h. 0 disables the cache.
+  int32_t decoder_output_cache_size = 8192;
+
   OfflineTransducerModelConfig() = default;
   OfflineTransducerModelConfig(const std::string &encoder_filename,
                                const std::string &decoder_filename,
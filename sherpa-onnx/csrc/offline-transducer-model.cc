@@ -21,6 +21,7 @@
 
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/native-joiner.h"
 #include "sherpa-onnx/csrc/offline-transducer-decoder.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/session.h"
@@ -49,6 +50,13 @@ class OfflineTransducerModel::Impl {
         env_, SHERPA_ONNX_TO_ORT_PATH(config.transducer.joiner_filename),
         sess_opts_);
     InitJoiner(nullptr, 0);
+
+    if (config.transducer.native_joiner) {
+      InitNativeJoiner(ReadFile(config.transducer.joiner_filename));
+    }
+
+    decoder_output_cache_.SetCapacity(
+        config.transducer.decoder_output_cache_size);
   }
 
   template <typename Manager>
@@ -70,6 +78,20 @@ class OfflineTransducerModel::Impl {
     {
       auto buf = ReadFile(mgr, config.transducer.joiner_filename);
       InitJoiner(buf.data(), buf.size());
+
+      if (config.transducer.native_joiner) {
+        InitNativeJoiner(buf);
+      }
+    }
+
+    decoder_output_cache_.SetCapacity(
+        config.transducer.decoder_output_cache_size);
+  }
+
+  ~Impl() {
+    const auto &cache = decoder_output_cache_;
+    if (config_.debug && cache.NumHits() + cache.NumMisses() > 0) {
+      SHERPA_ONNX_LOGE("%s", cache.ToString().c_str());
     }
   }
 
@@ -94,6 +116,14 @@ class OfflineTransducerModel::Impl {
   }
 
   Ort::Value RunJoiner(Ort::Value encoder_out, Ort::Value decoder_out) {
+    if (native_joiner_) {
+      return native_joiner_->Run(encoder_out, decoder_out, Allocator());
+    }
+
+    return RunOnnxJoiner(std::move(encoder_out), std::move(decoder_out));
+  }
+
+  Ort::Value RunOnnxJoiner(Ort::Value encoder_out, Ort::Value decoder_out) {
     std::array<Ort::Value, 2> joiner_input = {std::move(encoder_out),
                                               std::move(decoder_out)};
     auto logit = joiner_sess_->Run({}, joiner_input_names_ptr_.data(),
@@ -156,7 +186,75 @@ class OfflineTransducerModel::Impl {
     return decoder_input;
   }
 
+  Ort::Value RunDecoderWithCache(
+      const std::vector<OfflineTransducerDecoderResult> &results,
+      int32_t end_index) {
+    int32_t context_size = ContextSize();
+    std::vector<int64_t> contexts;
+    contexts.reserve(end_index * context_size);
+
+    for (int32_t i = 0; i != end_index; ++i) {
+      const auto &r = results[i];
+      contexts.insert(contexts.end(), r.tokens.end() - context_size,
+                      r.tokens.end());
+    }
+
+    return RunDecoderOnContexts(contexts);
+  }
+
+  Ort::Value RunDecoderWithCache(const std::vector<Hypothesis> &results,
+                                 int32_t end_index) {
+    int32_t context_size = ContextSize();
+    std::vector<int64_t> contexts;
+    contexts.reserve(end_index * context_size);
+
+    for (int32_t i = 0; i != end_index; ++i) {
+      const auto &r = results[i];
+      contexts.insert(contexts.end(), r.ys.end() - context_size, r.ys.end());
+    }
+
+    return RunDecoderOnContexts(contexts);
+  }
+
+  DecoderOutputCache &GetDecoderOutputCache() { return decoder_output_cache_; }
+
  private:
+  Ort::Value RunDecoderOnContexts(const std::vector<int64_t> &contexts) {
+    int32_t context_size = ContextSize();
+    return decoder_output_cache_.Run(
+        contexts.data(), contexts.size() / context_size, context_size,
+        Allocator(), [this](Ort::Value decoder_input) {
+          return RunDecoder(std::move(decoder_input));
+        });
+  }
+
+  void InitNativeJoiner(const std::vector<char> &model_data) {
+    auto joiner = NativeJoiner::Create(model_data.data(), model_data.size(),
+                                       config_.debug);
+    if (!joiner) {
+      SHERPA_ONNX_LOGE(
+          "The joiner model is not supported by the native joiner. Use "
+          "onnxruntime instead");
+      return;
+    }
+
+    bool ok = joiner->VocabSize() == VocabSize() &&
+              joiner->Verify(
+                  [this](Ort::Value encoder_out, Ort::Value decoder_out) {
+                    return RunOnnxJoiner(std::move(encoder_out),
+                                         std::move(decoder_out));
+                  },
+                  Allocator());
+    if (!ok) {
+      SHERPA_ONNX_LOGE(
+          "The native joiner does not match the joiner model. Use "
+          "onnxruntime instead");
+      return;
+    }
+
+    native_joiner_ = std::move(joiner);
+  }
+
   void InitEncoder(void *model_data, size_t model_data_length) {
     if (model_data) {
       encoder_sess_ = std::make_unique<Ort::Session>(
@@ -276,6 +374,9 @@ class OfflineTransducerModel::Impl {
 
   int32_t vocab_size_ = 0;    // initialized in InitDecoder
   int32_t context_size_ = 0;  // initialized in InitDecoder
+
+  DecoderOutputCache decoder_output_cache_;
+  std::unique_ptr<NativeJoiner> native_joiner_;
 };
 
 OfflineTransducerModel::OfflineTransducerModel(const OfflineModelConfig &config)
@@ -327,6 +428,21 @@ Ort::Value OfflineTransducerModel::BuildDecoderInput(
   return impl_->BuildDecoderInput(results, end_index);
 }
 
+Ort::Value OfflineTransducerModel::RunDecoderWithCache(
+    const std::vector<OfflineTransducerDecoderResult> &results,
+    int32_t end_index) {
+  return impl_->RunDecoderWithCache(results, end_index);
+}
+
+Ort::Value OfflineTransducerModel::RunDecoderWithCache(
+    const std::vector<Hypothesis> &results, int32_t end_index) {
+  return impl_->RunDecoderWithCache(results, end_index);
+}
+
+DecoderOutputCache &OfflineTransducerModel::GetDecoderOutputCache() {
+  return impl_->GetDecoderOutputCache();
+}
+
 #if __ANDROID_API__ >= 9
 template OfflineTransducerModel::OfflineTransducerModel(
     AAssetManager *mgr, const OfflineModelConfig &config);
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "onnxruntime_cxx_api.h"  // NOLINT
+#include "sherpa-onnx/csrc/decoder-output-cache.h"
 #include "sherpa-onnx/csrc/hypothesis.h"
 #include "sherpa-onnx/csrc/offline-model-config.h"
 
@@ -94,6 +95,19 @@ class OfflineTransducerModel {
   Ort::Value BuildDecoderInput(const std::vector<Hypothesis> &results,
                                int32_t end_index) const;
 
+  /** Same as RunDecoder(BuildDecoderInput(results, end_index)), but the
+   * decoder runs only on contexts whose outputs are not in
+   * GetDecoderOutputCache().
+   */
+  Ort::Value RunDecoderWithCache(
+      const std::vector<OfflineTransducerDecoderResult> &results,
+      int32_t end_index);
+
+  Ort::Value RunDecoderWithCache(const std::vector<Hypothesis> &results,
+                                 int32_t end_index);
+
+  DecoderOutputCache &GetDecoderOutputCache();
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
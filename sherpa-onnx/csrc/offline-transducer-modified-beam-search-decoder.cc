@@ -83,10 +83,7 @@ OfflineTransducerModifiedBeamSearchDecoder::Decode(
     cur.clear();
     cur.reserve(n);
 
-    auto decoder_input = model_->BuildDecoderInput(prev, num_hyps);
-    // decoder_input shape: (num_hyps, context_size)
-
-    auto decoder_out = model_->RunDecoder(std::move(decoder_input));
+    auto decoder_out = model_->RunDecoderWithCache(prev, num_hyps);
     // decoder_out is (num_hyps, joiner_dim)
 
     cur_encoder_out =
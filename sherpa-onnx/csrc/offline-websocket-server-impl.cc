@@ -5,13 +5,16 @@
 #include "sherpa-onnx/csrc/offline-websocket-server-impl.h"
 
 #include <algorithm>
+#include <chrono>  // NOLINT
 #include <iostream>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/server-utils.h"
 
 namespace sherpa_onnx {
 
@@ -26,6 +29,17 @@ void OfflineWebsocketDecoderConfig::Register(ParseOptions *po) {
       "Max utterance length in seconds. If we receive an utterance "
       "longer than this value, we will reject the connection. "
       "If you have enough memory, you can select a large value for it.");
+
+  po->Register("max-queued-seconds", &max_queued_seconds,
+               "Max seconds of audio waiting for decoding, summed over "
+               "all models of the server. If it is exceeded, new utterances "
+               "are rejected with code 1013 (try again later).");
+
+  po->Register("max-queue-delay", &max_queue_delay,
+               "If positive, new utterances are rejected with code 1013 "
+               "(try again later) if the estimated waiting time in seconds, "
+               "based on the RTF measured while decoding, exceeds it. "
+               "0 disables it.");
 }
 
 void OfflineWebsocketDecoderConfig::Validate() const {
@@ -44,16 +58,75 @@ void OfflineWebsocketDecoderConfig::Validate() const {
                      max_utterance_length);
     SHERPA_ONNX_EXIT(-1);
   }
+
+  if (max_queued_seconds < max_utterance_length) {
+    SHERPA_ONNX_LOGE(
+        "Expect --max-queued-seconds >= --max-utterance-length. Given: %f, %f",
+        max_queued_seconds, max_utterance_length);
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  if (max_queue_delay < 0) {
+    SHERPA_ONNX_LOGE("Expect --max-queue-delay >= 0. Given: %f",
+                     max_queue_delay);
+    SHERPA_ONNX_EXIT(-1);
+  }
+}
+
+// Duration of an utterance in seconds
+static float Duration(const ConnectionData &d) {
+  return static_cast<float>(d.expected_byte_size) / sizeof(float) /
+         d.sample_rate;
 }
 
-OfflineWebsocketDecoder::OfflineWebsocketDecoder(OfflineWebsocketServer *server)
-    : config_(server->GetConfig().decoder_config),
+OfflineWebsocketDecoder::OfflineWebsocketDecoder(
+    OfflineWebsocketServer *server, const OfflineWebsocketDecoderConfig &config)
+    : config_(config),
       server_(server),
       recognizer_(config_.recognizer_config) {}  // NOLINT
 
 void OfflineWebsocketDecoder::Push(connection_hdl hdl, ConnectionDataPtr d) {
   std::lock_guard<std::mutex> lock(mutex_);
   streams_.push_back({hdl, d});
+  queued_seconds_ += Duration(*d);
+}
+
+void OfflineWebsocketDecoder::GetQueuedWork(float *seconds,
+                                            float *decoding_seconds) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  *seconds = queued_seconds_;
+  *decoding_seconds = queued_seconds_ * rtf_;
+}
+
+bool OfflineWebsocketDecoder::CanAccept(float seconds) {
+  int32_t num_work_threads = server_->GetConfig().num_work_threads;
+
+  // The work threads are shared by all models, so we count the queues of
+  // all of them. Note that it locks mutex_ of each decoder, so we must not
+  // hold our own mutex_ here.
+  float queued = 0;
+  float decoding_seconds = 0;
+  server_->GetQueuedWork(&queued, &decoding_seconds);
+
+  float rtf = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rtf = rtf_;
+  }
+
+  queued += seconds;
+  if (queued > config_.max_queued_seconds) {
+    return false;
+  }
+
+  // Queues of models whose RTF is not measured yet count as no work
+  decoding_seconds += seconds * rtf;
+  if (config_.max_queue_delay > 0 &&
+      decoding_seconds / num_work_threads > config_.max_queue_delay) {
+    return false;
+  }
+
+  return true;
 }
 
 void OfflineWebsocketDecoder::Decode() {
@@ -79,6 +152,7 @@ void OfflineWebsocketDecoder::Decode() {
   std::vector<int32_t> samples_length(size);
   std::vector<std::unique_ptr<OfflineStream>> ss(size);
   std::vector<OfflineStream *> p_ss(size);
+  float audio_seconds = 0;
 
   for (int32_t i = 0; i != size; ++i) {
     auto &p = streams_.front();
@@ -86,6 +160,8 @@ void OfflineWebsocketDecoder::Decode() {
     connection_data[i] = p.second;
     streams_.pop_front();
 
+    audio_seconds += Duration(*connection_data[i]);
+
     auto sample_rate = connection_data[i]->sample_rate;
     auto samples =
         reinterpret_cast<const float *>(&connection_data[i]->data[0]);
@@ -97,11 +173,31 @@ void OfflineWebsocketDecoder::Decode() {
     p_ss[i] = ss[i].get();
   }
 
+  queued_seconds_ = std::max(0.0f, queued_seconds_ - audio_seconds);
+
   lock.unlock();
 
+  auto start = std::chrono::steady_clock::now();
+
   // Note: DecodeStreams is thread-safe
   recognizer_.DecodeStreams(p_ss.data(), size);
 
+  float elapsed = std::chrono::duration<float>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+
+  if (audio_seconds > 0) {
+    float rtf = elapsed / audio_seconds;
+    lock.lock();
+    num_batches_ += 1;
+    int32_t k = num_batches_ - kNumRtfWarmupBatches;
+    if (k > 0) {
+      float alpha = std::max(1.0f / k, 0.1f);
+      rtf_ += alpha * (rtf - rtf_);
+    }
+    lock.unlock();
+  }
+
   for (int32_t i = 0; i != size; ++i) {
     connection_hdl hdl = handles[i];
     asio::post(server_->GetConnectionContext(),
@@ -120,13 +216,66 @@ void OfflineWebsocketDecoder::Decode() {
 
 void OfflineWebsocketServerConfig::Register(ParseOptions *po) {
   decoder_config.Register(po);
+  ort_thread_pool_config.Register(po);
   po->Register("log-file", &log_file,
                "Path to the log file. Logs are "
                "appended to this file");
+
+  po->Register("model-name", &model_name,
+               "Name of the model given by the above options. Clients "
+               "select a model with ws://<server>:<port>/?model=<name> or "
+               "with the HTTP header X-Model. Without them, this model "
+               "is used.");
+
+  po->Register("extra-models", &extra_models,
+               "Other models served by this server, in the format "
+               "name1:/path/to/config1.txt,name2:/path/to/config2.txt, "
+               "where each config file contains the model options, e.g., "
+               "--tokens=/path/to/tokens.txt, one per line. All models "
+               "share --num-work-threads, but are batched separately.");
+
+  po->Register("num-work-threads", &num_work_threads,
+               "Thread pool size for for neural network "
+               "computation and decoding.");
 }
 
 void OfflineWebsocketServerConfig::Validate() const {
   decoder_config.Validate();
+
+  if (!ort_thread_pool_config.Validate()) {
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  if (model_name.empty()) {
+    SHERPA_ONNX_LOGE("Please provide --model-name");
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  std::vector<std::pair<std::string, std::string>> models;
+  if (!ParseNamedModels(extra_models, &models)) {
+    SHERPA_ONNX_LOGE("Invalid --extra-models: '%s'", extra_models.c_str());
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  for (const auto &m : models) {
+    if (m.first == model_name) {
+      SHERPA_ONNX_LOGE("--extra-models uses the name of --model-name '%s'",
+                       model_name.c_str());
+      SHERPA_ONNX_EXIT(-1);
+    }
+
+    if (!FileExists(m.second)) {
+      SHERPA_ONNX_LOGE("Config file '%s' of model '%s' does not exist",
+                       m.second.c_str(), m.first.c_str());
+      SHERPA_ONNX_EXIT(-1);
+    }
+  }
+
+  if (num_work_threads <= 0) {
+    SHERPA_ONNX_LOGE("Expect --num-work-threads > 0. Given: %d",
+                     num_work_threads);
+    SHERPA_ONNX_EXIT(-1);
+  }
 }
 
 OfflineWebsocketServer::OfflineWebsocketServer(
@@ -137,12 +286,32 @@ OfflineWebsocketServer::OfflineWebsocketServer(
       io_work_(io_work),
       config_(config),
       log_(config.log_file, std::ios::app),
-      tee_(std::cout, log_),
-      decoder_(this) {
+      tee_(std::cout, log_) {
   SetupLog();
 
+  decoders_[config.model_name] =
+      std::make_unique<OfflineWebsocketDecoder>(this, config.decoder_config);
+
+  std::vector<std::pair<std::string, std::string>> models;
+  ParseNamedModels(config.extra_models, &models);  // checked in Validate()
+
+  for (const auto &m : models) {
+    OfflineWebsocketDecoderConfig decoder_config;
+    ReadConfigFromFile(m.second, &decoder_config);
+    decoder_config.Validate();
+
+    SHERPA_ONNX_LOGE("Model '%s': %s", m.first.c_str(),
+                     decoder_config.recognizer_config.ToString().c_str());
+
+    decoders_[m.first] =
+        std::make_unique<OfflineWebsocketDecoder>(this, decoder_config);
+  }
+
   server_.init_asio(&io_conn_);
 
+  server_.set_validate_handler(
+      [this](connection_hdl hdl) { return OnValidate(hdl); });
+
   server_.set_open_handler([this](connection_hdl hdl) { OnOpen(hdl); });
 
   server_.set_close_handler([this](connection_hdl hdl) { OnClose(hdl); });
@@ -163,9 +332,63 @@ void OfflineWebsocketServer::SetupLog() {
   server_.get_elog().set_ostream(&tee_);
 }
 
+void OfflineWebsocketServer::GetQueuedWork(float *seconds,
+                                           float *decoding_seconds) const {
+  // decoders_ is not changed after the constructor, so no lock is needed
+  *seconds = 0;
+  *decoding_seconds = 0;
+  for (const auto &p : decoders_) {
+    float s = 0;
+    float d = 0;
+    p.second->GetQueuedWork(&s, &d);
+    *seconds += s;
+    *decoding_seconds += d;
+  }
+}
+
+OfflineWebsocketDecoder *OfflineWebsocketServer::SelectDecoder(
+    connection_hdl hdl, std::string *error) {
+  auto con = server_.get_con_from_hdl(hdl);
+
+  std::string name = con->get_request_header("X-Model");
+  if (name.empty()) {
+    name = GetQueryValue(con->get_resource(), "model");
+  }
+
+  if (name.empty()) {
+    name = config_.model_name;
+  }
+
+  auto it = decoders_.find(name);
+  if (it == decoders_.end()) {
+    *error = "Unknown model: " + name;
+    return nullptr;
+  }
+
+  return it->second.get();
+}
+
+bool OfflineWebsocketServer::OnValidate(connection_hdl hdl) {
+  std::string error;
+  if (SelectDecoder(hdl, &error)) {
+    return true;
+  }
+
+  auto con = server_.get_con_from_hdl(hdl);
+  con->set_status(websocketpp::http::status_code::not_found);
+  con->set_body(error);
+
+  return false;
+}
+
 void OfflineWebsocketServer::OnOpen(connection_hdl hdl) {
+  auto d = std::make_shared<ConnectionData>();
+
+  std::string error;
+  d->decoder = SelectDecoder(hdl, &error);  // checked in OnValidate()
+
   std::lock_guard<std::mutex> lock(mutex_);
-  connections_.emplace(hdl, std::make_shared<ConnectionData>());
+  connections_.emplace(hdl, d);
 
   SHERPA_ONNX_LOGE("Number of active connections: %d",
                    static_cast<int32_t>(connections_.size()));
@@ -184,6 +407,7 @@ void OfflineWebsocketServer::OnMessage(connection_hdl hdl,
   std::unique_lock<std::mutex> lock(mutex_);
   auto connection_data = connections_.find(hdl)->second;
   lock.unlock();
+  OfflineWebsocketDecoder *decoder = connection_data->decoder;
   const std::string &payload = msg->get_payload();
 
   switch (msg->get_opcode()) {
@@ -213,7 +437,7 @@ void OfflineWebsocketServer::OnMessage(connection_hdl hdl,
         connection_data->expected_byte_size =
             *reinterpret_cast<const int32_t *>(p + 4);
 
-        int32_t max_byte_size_ = decoder_.GetConfig().max_utterance_length *
+        int32_t max_byte_size_ = decoder->GetConfig().max_utterance_length *
                                  connection_data->sample_rate * sizeof(float);
         if (connection_data->expected_byte_size > max_byte_size_) {
           float num_samples =
@@ -223,13 +447,22 @@ void OfflineWebsocketServer::OnMessage(connection_hdl hdl,
 
           std::ostringstream os;
           os << "Max utterance length is configured to "
-             << decoder_.GetConfig().max_utterance_length
+             << decoder->GetConfig().max_utterance_length
              << " seconds, received length is " << duration << " seconds. "
              << "Payload is too large!";
           Close(hdl, websocketpp::close::status::message_too_big, os.str());
           break;
         }
 
+        // Reject it before receiving the samples if we cannot decode it
+        // in time
+        if (!decoder->CanAccept(Duration(*connection_data))) {
+          connection_data->Clear();
+          Close(hdl, websocketpp::close::status::try_again_later,
+                "Server is overloaded. Please try again later.");
+          break;
+        }
+
         connection_data->data.resize(connection_data->expected_byte_size);
         std::copy(payload.begin() + 8, payload.end(),
                   connection_data->data.data());
@@ -249,11 +482,11 @@ void OfflineWebsocketServer::OnMessage(connection_hdl hdl,
         connection_data->expected_byte_size = 0;
         connection_data->cur = 0;
 
-        decoder_.Push(hdl, d);
+        decoder->Push(hdl, d);
 
         connection_data->Clear();
 
-        asio::post(io_work_, [this]() { decoder_.Decode(); });
+        asio::post(io_work_, [decoder]() { decoder->Decode(); });
       }
       break;
     }
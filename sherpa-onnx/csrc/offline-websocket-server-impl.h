@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "sherpa-onnx/csrc/offline-recognizer.h"
+#include "sherpa-onnx/csrc/ort-thread-pool-config.h"
 #include "sherpa-onnx/csrc/parse-options.h"
 #include "sherpa-onnx/csrc/tee-stream.h"
 #include "websocketpp/config/asio_no_tls.hpp"  // TODO(fangjun): support TLS
@@ -24,6 +25,8 @@ using connection_hdl = websocketpp::connection_hdl;
 
 namespace sherpa_onnx {
 
+class OfflineWebsocketDecoder;
+
 /** Communication protocol
  *
  * The client sends a byte stream to the server. The first 4 bytes in little
@@ -52,6 +55,10 @@ struct ConnectionData {
   // We expect that data.size() == expected_byte_size
   std::vector<int8_t> data;
 
+  // Decoder of the model selected by the client when it connects.
+  // Not owned. It is not changed by Clear().
+  OfflineWebsocketDecoder *decoder = nullptr;
+
   void Clear() {
     sample_rate = 0;
     expected_byte_size = 0;
@@ -69,6 +76,16 @@ struct OfflineWebsocketDecoderConfig {
 
   float max_utterance_length = 300;  // seconds
 
+  // Max seconds of audio waiting for decoding in the queues of all models
+  // of the server. It bounds the memory used by queued utterances.
+  float max_queued_seconds = 3600;
+
+  // If positive, an utterance is rejected if its estimated waiting time,
+  // i.e., the sum of queued_seconds * RTF over all models divided by
+  // num_work_threads with RTF measured while decoding, exceeds this number
+  // of seconds. 0 disables it.
+  float max_queue_delay = 0;
+
   void Register(ParseOptions *po);
   void Validate() const;
 };
@@ -78,10 +95,11 @@ class OfflineWebsocketServer;
 class OfflineWebsocketDecoder {
  public:
   /**
-   * @param config Configuration for the decoder.
    * @param server **Borrowed** from outside.
+   * @param config Configuration for the decoder.
    */
-  explicit OfflineWebsocketDecoder(OfflineWebsocketServer *server);
+  OfflineWebsocketDecoder(OfflineWebsocketServer *server,
+                          const OfflineWebsocketDecoderConfig &config);
 
   /** Insert received data to the queue for decoding.
    *
@@ -91,6 +109,23 @@ class OfflineWebsocketDecoder {
    */
   void Push(connection_hdl hdl, ConnectionDataPtr d);
 
+  /** Admission control. It considers the queues of all decoders of the
+   * server since they share the work threads.
+   *
+   * @param seconds Duration of an utterance.
+   * @return Return false if the queues cannot accept an utterance of the
+   *         given duration, i.e., the server is overloaded.
+   */
+  bool CanAccept(float seconds);
+
+  /** Get the queued work of this decoder.
+   *
+   * @param seconds  Seconds of audio in the queue.
+   * @param decoding_seconds  Estimated seconds to decode them. It is 0 if
+   *                          the RTF is not measured yet.
+   */
+  void GetQueuedWork(float *seconds, float *decoding_seconds);
+
   /** It is called by one of the work thread.
    */
   void Decode();
@@ -111,14 +146,46 @@ class OfflineWebsocketDecoder {
   std::mutex mutex_;
   std::deque<std::pair<connection_hdl, ConnectionDataPtr>> streams_;
 
+  // Seconds of audio in streams_. Protected by mutex_
+  float queued_seconds_ = 0;
+
+  // The first batches include the first-run cost of onnxruntime and are
+  // not used to measure the RTF
+  static constexpr int32_t kNumRtfWarmupBatches = 2;
+
+  // Average of the decoding time per second of audio over the first
+  // measured batches and an exponential moving average afterwards.
+  // 0 means it is not measured yet. Protected by mutex_
+  float rtf_ = 0;
+
+  // Number of decoded batches, including the warmup ones. Protected by
+  // mutex_
+  int32_t num_batches_ = 0;
+
   OfflineWebsocketServer *server_;  // Not owned
   OfflineRecognizer recognizer_;
 };
 
 struct OfflineWebsocketServerConfig {
   OfflineWebsocketDecoderConfig decoder_config;
+
+  // Thread pools of onnxruntime shared by all models of the server
+  OrtThreadPoolConfig ort_thread_pool_config;
   std::string log_file = "./log.txt";
 
+  // Name of the model given by decoder_config. Clients select a model with
+  // the query of the request URI, e.g., ws://localhost:6006/?model=en, or
+  // with the HTTP header X-Model. The default is this one.
+  std::string model_name = "default";
+
+  // Other models served by the same process, in the format
+  //   name1:/path/to/config1.txt,name2:/path/to/config2.txt
+  // where each config file contains the options of the model, one per line.
+  std::string extra_models;
+
+  // Size of the thread pool for neural network computation and decoding
+  int32_t num_work_threads = 3;
+
   void Register(ParseOptions *po);
   void Validate() const;
 };
@@ -136,9 +203,19 @@ class OfflineWebsocketServer {
 
   const OfflineWebsocketServerConfig &GetConfig() const { return config_; }
 
+  // Sum of OfflineWebsocketDecoder::GetQueuedWork() over all models
+  void GetQueuedWork(float *seconds, float *decoding_seconds) const;
+
  private:
   void SetupLog();
 
+  // Return false to reject a connection to an unknown model with 404
+  bool OnValidate(connection_hdl hdl);
+
+  // Return nullptr and set error if the requested model does not exist
+  OfflineWebsocketDecoder *SelectDecoder(connection_hdl hdl,
+                                         std::string *error);
+
   // When a websocket client is connected, it will invoke this method
   // (Not for HTTP)
   void OnOpen(connection_hdl hdl);
@@ -197,7 +274,8 @@ class OfflineWebsocketServer {
   std::ofstream log_;
   TeeStream tee_;
 
-  OfflineWebsocketDecoder decoder_;
+  // model name -> decoder
+  std::map<std::string, std::unique_ptr<OfflineWebsocketDecoder>> decoders_;
 };
 
 }  // namespace sherpa_onnx
@@ -8,6 +8,7 @@
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/offline-websocket-server-impl.h"
 #include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/session.h"
 
 static constexpr const char *kUsageMessage = R"(
 Automatic speech recognition with sherpa-onnx using websocket.
@@ -38,6 +39,16 @@ Usage:
   --log-file=./log.txt \
   --max-batch-size=5
 
+To serve several models from one process, give the other models with
+--extra-models=zh:/path/to/zh.txt, where zh.txt contains the model options,
+e.g., --tokens=/path/to/tokens.txt, one per line. Clients select a model with
+ws://localhost:6006/?model=zh or with the HTTP header X-Model. Requests
+without a model use the model named by --model-name.
+
+Use --ort-global-thread-pool=true to let all models share one set of
+onnxruntime thread pools of --ort-intra-op-num-threads threads instead of
+creating --num-threads threads per model session.
+
 Please refer to
 https://k2-fsa.github.io/sherpa/onnx/pretrained_models/index.html
 for a list of pre-trained models to download.
@@ -54,16 +65,9 @@ int32_t main(int32_t argc, char *argv[]) {
   // size of the thread pool for handling network connections
   int32_t num_io_threads = 1;
 
-  // size of the thread pool for neural network computation and decoding
-  int32_t num_work_threads = 3;
-
   po.Register("num-io-threads", &num_io_threads,
               "Thread pool size for network connections.");
 
-  po.Register("num-work-threads", &num_work_threads,
-              "Thread pool size for for neural network "
-              "computation and decoding.");
-
   po.Register("port", &port, "The port on which the server will listen.");
 
   config.Register(&po);
@@ -84,6 +88,9 @@ int32_t main(int32_t argc, char *argv[]) {
 
   config.Validate();
 
+  // It must be called before the models are created
+  sherpa_onnx::InitGlobalThreadPool(config.ort_thread_pool_config);
+
   asio::io_context io_conn;  // for network connections
   asio::io_context io_work;  // for neural network and decoding
 
@@ -92,7 +99,7 @@ int32_t main(int32_t argc, char *argv[]) {
 
   SHERPA_ONNX_LOGE("Started!");
   SHERPA_ONNX_LOGE("Listening on: %d", port);
-  SHERPA_ONNX_LOGE("Number of work threads: %d", num_work_threads);
+  SHERPA_ONNX_LOGE("Number of work threads: %d", config.num_work_threads);
 
   // give some work to do for the io_work pool
   auto work_guard = asio::make_work_guard(io_work);
@@ -105,7 +112,7 @@ int32_t main(int32_t argc, char *argv[]) {
   }
 
   std::vector<std::thread> work_threads;
-  for (int32_t i = 0; i < num_work_threads; ++i) {
+  for (int32_t i = 0; i < config.num_work_threads; ++i) {
     work_threads.emplace_back([&io_work]() { io_work.run(); });
   }
 
@@ -21,9 +21,9 @@ void OfflineWhisperGreedySearchDecoder::SetConfig(
 }
 
 std::vector<OfflineWhisperDecoderResult>
-OfflineWhisperGreedySearchDecoder::Decode(Ort::Value cross_k,
-                                          Ort::Value cross_v,
-                                          int32_t num_feature_frames) {
+OfflineWhisperGreedySearchDecoder::Decode(
+    Ort::Value cross_k, Ort::Value cross_v, int32_t num_feature_frames,
+    const std::vector<int32_t> &prompt) {
   auto memory_info =
       Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
 
@@ -101,16 +101,34 @@ OfflineWhisperGreedySearchDecoder::Decode(Ort::Value cross_k,
   // Max initial timestamp: 50 = 1.0 second (each timestamp is 0.02s)
   constexpr int32_t kMaxInitialTimestampIndex = 50;
 
+  int32_t n_text_ctx = model_->TextCtx();
+
+  // The prompt [sot_prev, prompt...] goes before the sot sequence. Like
+  // OpenAI Whisper, we keep at most the last n_text_ctx / 2 - 1 tokens of
+  // it so that there is room left for the output.
+  std::vector<int64_t> decoder_input;
+  if (!prompt.empty()) {
+    int32_t max_prompt_len = n_text_ctx / 2 - 1;
+    int32_t start =
+        std::max<int32_t>(0, static_cast<int32_t>(prompt.size()) -
+                                 max_prompt_len);
+    decoder_input.push_back(model_->SOTPrev());
+    decoder_input.insert(decoder_input.end(), prompt.begin() + start,
+                         prompt.end());
+  }
+  decoder_input.insert(decoder_input.end(), initial_tokens.begin(),
+                       initial_tokens.end());
+
   // Maintain running list of all tokens for timestamp rules
-  std::vector<int64_t> all_tokens = initial_tokens;
-  int32_t sample_begin = static_cast<int32_t>(initial_tokens.size());
+  std::vector<int64_t> all_tokens = decoder_input;
+  int32_t sample_begin = static_cast<int32_t>(decoder_input.size());
 
   int32_t batch_size = 1;
   std::array<int64_t, 2> token_shape{
-      batch_size, static_cast<int64_t>(initial_tokens.size())};
+      batch_size, static_cast<int64_t>(decoder_input.size())};
 
   Ort::Value tokens = Ort::Value::CreateTensor(
-      memory_info, initial_tokens.data(), initial_tokens.size(),
+      memory_info, decoder_input.data(), decoder_input.size(),
       token_shape.data(), token_shape.size());
 
   std::array<int64_t, 1> offset_shape{1};
@@ -129,13 +147,12 @@ OfflineWhisperGreedySearchDecoder::Decode(Ort::Value cross_k,
   // Indices: 0=logits, 1=self_k, 2=self_v, 3=cross_k, 4=cross_v, 5=offset,
   // 6=attention
   *(std::get<5>(decoder_out).GetTensorMutableData<int64_t>()) =
-      initial_tokens.size();
+      decoder_input.size();
 
   auto logits_shape =
       std::get<0>(decoder_out).GetTensorTypeAndShapeInfo().GetShape();
   int32_t vocab_size = logits_shape[2];
 
-  int32_t n_text_ctx = model_->TextCtx();
   int32_t max_token_id = 0;
 
   // Get initial logits
@@ -207,8 +224,8 @@ OfflineWhisperGreedySearchDecoder::Decode(Ort::Value cross_k,
 
     // Track if this is a timestamp token (for filtering in DTW)
     if (max_token_id >= timestamp_begin) {
-      // The attention index is: initial_tokens.size() + current predicted index
-      int32_t attn_idx = static_cast<int32_t>(initial_tokens.size()) +
+      // The attention index is: decoder_input.size() + current predicted index
+      int32_t attn_idx = static_cast<int32_t>(decoder_input.size()) +
                          static_cast<int32_t>(predicted_tokens.size()) - 1;
       timestamp_token_indices.push_back(attn_idx);
     }
@@ -310,6 +310,8 @@ class OfflineWhisperModel::Impl {
 
   int32_t SOT() const { return sot_; }
 
+  int32_t SOTPrev() const { return sot_prev_; }
+
   int32_t TextCtx() const { return n_text_ctx_; }
 
   int32_t VocabSize() const { return n_vocab_; }
@@ -368,6 +370,10 @@ class OfflineWhisperModel::Impl {
     // It's typically no_timestamps + 1 in OpenAI Whisper tokenizer
     timestamp_begin_ = no_timestamps_ + 1;
     SHERPA_ONNX_READ_META_DATA(no_speech_, "no_speech");
+    // <|startofprev|> is two tokens before <|notimestamps|> in all
+    // OpenAI Whisper tokenizers. Old exported models do not save it.
+    SHERPA_ONNX_READ_META_DATA_WITH_DEFAULT(sot_prev_, "sot_prev",
+                                            no_timestamps_ - 2);
     SHERPA_ONNX_READ_META_DATA_VEC(sot_sequence_, "sot_sequence");
 
     if (is_multilingual_) {
@@ -481,6 +487,7 @@ class OfflineWhisperModel::Impl {
   int32_t n_text_state_ = 0;
   int32_t n_vocab_ = 0;
   int32_t sot_ = 0;
+  int32_t sot_prev_ = 0;
   int32_t eot_ = 0;
   int32_t blank_ = 0;
   int32_t translate_ = 0;
@@ -583,6 +590,8 @@ int32_t OfflineWhisperModel::EOT() const { return impl_->EOT(); }
 
 int32_t OfflineWhisperModel::SOT() const { return impl_->SOT(); }
 
+int32_t OfflineWhisperModel::SOTPrev() const { return impl_->SOTPrev(); }
+
 int32_t OfflineWhisperModel::TextCtx() const { return impl_->TextCtx(); }
 
 int32_t OfflineWhisperModel::VocabSize() const { return impl_->VocabSize(); }
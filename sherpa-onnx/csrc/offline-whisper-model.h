@@ -101,6 +101,7 @@ class OfflineWhisperModel {
   int32_t TimestampEnd() const;    // Last timestamp token (30.00s)
   int32_t EOT() const;
   int32_t SOT() const;
+  int32_t SOTPrev() const;  // <|startofprev|>, which starts a text prompt
   int32_t TextCtx() const;
   int32_t VocabSize() const;
   int32_t FeatureDim() const;
@@ -443,4 +443,43 @@ TEST_F(ParseTimestampTokensTest, TextBeforeFirstTimestampIgnored) {
   EXPECT_EQ(segments[0].token_ids[0], 300);
 }
 
+TEST(FindLongFormSeekTest, SingleTimestampEnding) {
+  int32_t ts_0_00 = kTimestampBegin;
+  int32_t ts_5_00 = kTimestampBegin + 250;
+  std::vector<int32_t> tokens = {ts_0_00, 100, 200, ts_5_00};
+
+  int32_t consumed = 0;
+  EXPECT_EQ(FindLongFormSeek(tokens, kTimestampBegin, 3000, &consumed), 4);
+  EXPECT_EQ(consumed, 3000);
+}
+
+TEST(FindLongFormSeekTest, UnfinishedSegment) {
+  int32_t ts_0_00 = kTimestampBegin;
+  int32_t ts_5_00 = kTimestampBegin + 250;
+  int32_t ts_5_50 = kTimestampBegin + 275;
+  std::vector<int32_t> tokens = {ts_0_00, 100, ts_5_00, ts_5_50, 200, 300};
+
+  int32_t consumed = 0;
+  EXPECT_EQ(FindLongFormSeek(tokens, kTimestampBegin, 3000, &consumed), 3);
+  EXPECT_EQ(consumed, 500);
+}
+
+TEST(FindLongFormSeekTest, NoConsecutiveTimestamps) {
+  int32_t ts_0_00 = kTimestampBegin;
+  std::vector<int32_t> tokens = {ts_0_00, 100, 200, 300};
+
+  int32_t consumed = 0;
+  EXPECT_EQ(FindLongFormSeek(tokens, kTimestampBegin, 3000, &consumed), 4);
+  EXPECT_EQ(consumed, 3000);
+}
+
+TEST(FindLongFormSeekTest, AlwaysMoveForward) {
+  int32_t ts_0_00 = kTimestampBegin;
+  std::vector<int32_t> tokens = {ts_0_00, ts_0_00, 100};
+
+  int32_t consumed = 0;
+  EXPECT_EQ(FindLongFormSeek(tokens, kTimestampBegin, 3000, &consumed), 3);
+  EXPECT_EQ(consumed, 3000);
+}
+
 }  // namespace sherpa_onnx
@@ -341,4 +341,44 @@ std::vector<OfflineWhisperSegment> ParseTimestampTokens(
   return segments;
 }
 
+int32_t FindLongFormSeek(const std::vector<int32_t> &tokens,
+                         int32_t timestamp_begin, int32_t num_frames,
+                         int32_t *num_frames_consumed) {
+  // Each timestamp token represents 0.02 seconds, i.e., 2 feature frames
+  constexpr int32_t kFramesPerTimestamp = 2;
+
+  int32_t n = static_cast<int32_t>(tokens.size());
+  *num_frames_consumed = num_frames;
+
+  bool single_timestamp_ending = n >= 2 && tokens[n - 1] >= timestamp_begin &&
+                                 tokens[n - 2] < timestamp_begin;
+  if (single_timestamp_ending) {
+    return n;
+  }
+
+  // Index of the second token of the last pair of consecutive timestamps
+  int32_t last_slice = -1;
+  for (int32_t i = n - 1; i > 0; --i) {
+    if (tokens[i] >= timestamp_begin && tokens[i - 1] >= timestamp_begin) {
+      last_slice = i;
+      break;
+    }
+  }
+
+  if (last_slice == -1) {
+    return n;
+  }
+
+  int32_t frames =
+      (tokens[last_slice - 1] - timestamp_begin) * kFramesPerTimestamp;
+  if (frames <= 0 || frames >= num_frames) {
+    // We would not move forward. Keep the unfinished segment instead.
+    return n;
+  }
+
+  *num_frames_consumed = frames;
+
+  return last_slice;
+}
+
 }  // namespace sherpa_onnx
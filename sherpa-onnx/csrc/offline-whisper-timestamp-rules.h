@@ -42,6 +42,31 @@ void ApplyTimestampRules(float *logits, int32_t vocab_size,
 std::vector<OfflineWhisperSegment> ParseTimestampTokens(
     const std::vector<int32_t> &tokens, int32_t timestamp_begin, int32_t eot);
 
+// Decide where the next window starts in long-form transcription
+// Reference: whisper/transcribe.py
+//
+//   - If the tokens end with a single timestamp, all segments are complete
+//     and the whole window is consumed.
+//   - Otherwise, the tokens after the last pair of consecutive timestamps
+//     belong to an unfinished segment. They are dropped and the next window
+//     starts at that timestamp.
+//   - If there is no pair of consecutive timestamps, the whole window is
+//     consumed.
+//
+// Parameters:
+//   tokens: decoded tokens of the window, without eot
+//   timestamp_begin: token ID of first timestamp (<|0.00|>)
+//   num_frames: number of feature frames of the window (10 ms per frame)
+//   num_frames_consumed: on return, the number of feature frames by which
+//                        the next window is moved. It is in [1, num_frames].
+//                        If the window cannot be split at a timestamp, the
+//                        whole window is consumed and all tokens are kept
+//
+// Returns: the number of leading tokens to keep
+int32_t FindLongFormSeek(const std::vector<int32_t> &tokens,
+                         int32_t timestamp_begin, int32_t num_frames,
+                         int32_t *num_frames_consumed);
+
 }  // namespace sherpa_onnx
 
 #endif  // SHERPA_ONNX_CSRC_OFFLINE_WHISPER_TIMESTAMP_RULES_H_
@@ -17,7 +17,8 @@ std::string OnlineCtcFstDecoderConfig::ToString() const {
 
   os << "OnlineCtcFstDecoderConfig(";
   os << "graph=\"" << graph << "\", ";
-  os << "max_active=" << max_active << ")";
+  os << "max_active=" << max_active << ", ";
+  os << "num_threads=" << num_threads << ")";
 
   return os.str();
 }
@@ -27,6 +28,9 @@ void OnlineCtcFstDecoderConfig::Register(ParseOptions *po) {
 
   po->Register("ctc-max-active", &max_active,
                "Decoder max active states.  Larger->slower; more accurate");
+
+  po->Register("ctc-num-threads", &num_threads,
+               "Number of threads to run FST decoding of a batch in parallel");
 }
 
 bool OnlineCtcFstDecoderConfig::Validate() const {
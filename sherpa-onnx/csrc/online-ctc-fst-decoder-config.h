@@ -16,10 +16,14 @@ struct OnlineCtcFstDecoderConfig {
   std::string graph;
   int32_t max_active = 3000;
 
+  // Number of threads to decode streams of a batch in parallel
+  int32_t num_threads = 1;
+
   OnlineCtcFstDecoderConfig() = default;
 
-  OnlineCtcFstDecoderConfig(const std::string &graph, int32_t max_active)
-      : graph(graph), max_active(max_active) {}
+  OnlineCtcFstDecoderConfig(const std::string &graph, int32_t max_active,
+                          int32_t num_threads = 1)
+      : graph(graph), max_active(max_active), num_threads(num_threads) {}
 
   std::string ToString() const;
 
@@ -21,7 +21,10 @@ namespace sherpa_onnx {
 
 OnlineCtcFstDecoder::OnlineCtcFstDecoder(
     const OnlineCtcFstDecoderConfig &config, int32_t blank_id)
-    : config_(config), fst_(ReadGraph(config.graph)), blank_id_(blank_id) {
+    : config_(config),
+      fst_(ReadGraph(config.graph)),
+      blank_id_(blank_id),
+      pool_(std::make_unique<ThreadPool>(config_.num_threads - 1)) {
   options_.max_active = config_.max_active;
 }
 
@@ -109,10 +112,10 @@ void OnlineCtcFstDecoder::Decode(const float *log_probs, int32_t batch_size,
 
   const float *p = log_probs;
 
-  for (int32_t i = 0; i != batch_size; ++i) {
+  pool_->ParallelFor(batch_size, [&](int32_t i) {
     DecodeOne(p + i * num_frames * vocab_size, num_frames, vocab_size,
               &(*results)[i], ss[i], blank_id_);
-  }
+  });
 }
 
 }  // namespace sherpa_onnx
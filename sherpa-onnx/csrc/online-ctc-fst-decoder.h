@@ -11,6 +11,7 @@
 #include "fst/fst.h"
 #include "sherpa-onnx/csrc/online-ctc-decoder.h"
 #include "sherpa-onnx/csrc/online-ctc-fst-decoder-config.h"
+#include "sherpa-onnx/csrc/thread-pool.h"
 
 namespace sherpa_onnx {
 
@@ -19,6 +20,8 @@ class OnlineCtcFstDecoder : public OnlineCtcDecoder {
   OnlineCtcFstDecoder(const OnlineCtcFstDecoderConfig &config,
                       int32_t blank_id);
 
+  // Each stream owns its decoder, so streams of a batch are decoded in
+  // parallel if config.num_threads > 1
   void Decode(const float *log_probs, int32_t batch_size, int32_t num_frames,
               int32_t vocab_size, std::vector<OnlineCtcDecoderResult> *results,
               OnlineStream **ss = nullptr, int32_t n = 0) override;
@@ -32,6 +35,8 @@ class OnlineCtcFstDecoder : public OnlineCtcDecoder {
 
   std::unique_ptr<fst::Fst<fst::StdArc>> fst_;
   int32_t blank_id_ = 0;
+
+  std::unique_ptr<ThreadPool> pool_;
 };
 
 }  // namespace sherpa_onnx
@@ -20,7 +20,13 @@ void OnlineLMConfig::Register(ParseOptions *po) {
                "Specify a provider to LM model use: cpu, cuda, coreml");
   po->Register("lm-shallow-fusion", &shallow_fusion,
                "Boolean whether to use shallow fusion or rescore.");
-  po->Register("lodr-fst", &lodr_fst, "Path to LODR FST model.");
+  po->Register("lm-cache-size", &lm_cache_size,
+               "Number of token sequences whose LM states are cached during "
+               "shallow fusion. Hypotheses that share the same tokens reuse "
+               "the cached states. 0 to disable the cache.");
+  po->Register("lodr-fst", &lodr_fst,
+               "Path to LODR FST model. It can also be a flat n-gram file "
+               "produced by sherpa-onnx-compile-lodr-fst.");
   po->Register("lodr-scale", &lodr_scale, "LODR scale.");
   po->Register("lodr-backoff-id", &lodr_backoff_id,
                "ID of the backoff in the LODR FST. -1 means autodetect");
@@ -49,7 +55,8 @@ std::string OnlineLMConfig::ToString() const {
   os << "lodr_scale=" << lodr_scale << ", ";
   os << "lodr_fst=\"" << lodr_fst << "\", ";
   os << "lodr_backoff_id=" << lodr_backoff_id << ", ";
-  os << "shallow_fusion=" << (shallow_fusion ? "True" : "False") << ")";
+  os << "shallow_fusion=" << (shallow_fusion ? "True" : "False") << ", ";
+  os << "lm_cache_size=" << lm_cache_size << ")";
 
   return os.str();
 }
@@ -24,6 +24,10 @@ struct OnlineLMConfig {
   // enable shallow fusion
   bool shallow_fusion = true;
 
+  // Maximum number of token sequences whose LM states are cached
+  // during shallow fusion. 0 disables the cache.
+  int32_t lm_cache_size = 4096;
+
   OnlineLMConfig() = default;
 
   OnlineLMConfig(const std::string &model, float scale, int32_t lm_num_threads,
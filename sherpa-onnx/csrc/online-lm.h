@@ -56,6 +56,20 @@ class OnlineLM {
    *
    */
   virtual void ComputeLMScoreSF(float scale, Hypothesis *hyp) = 0;
+
+  /** Batched version of ComputeLMScoreSF() for all hyps that have just
+   * emitted a new token. Implementations may run the LM only once for
+   * hyps with identical token sequences.
+   *
+   * @param scale LM score
+   * @param hyps It is changed in-place.
+   */
+  virtual void ComputeLMScoreSF(float scale,
+                                const std::vector<Hypothesis *> &hyps) {
+    for (auto *hyp : hyps) {
+      ComputeLMScoreSF(scale, hyp);
+    }
+  }
 };
 
 }  // namespace sherpa_onnx
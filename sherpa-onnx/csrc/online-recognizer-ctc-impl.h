@@ -9,6 +9,7 @@
 #include <cassert>
 #include <ios>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <sstream>
 #include <string>
 #include <utility>
@@ -22,6 +23,7 @@
 #include "sherpa-onnx/csrc/online-ctc-greedy-search-decoder.h"
 #include "sherpa-onnx/csrc/online-ctc-model.h"
 #include "sherpa-onnx/csrc/online-recognizer-impl.h"
+#include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
 
 namespace sherpa_onnx {
@@ -137,19 +139,16 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
 
     for (int32_t i = 0; i != n; ++i) {
       const auto num_processed_frames = ss[i]->GetNumProcessedFrames();
-      std::vector<float> features =
-          ss[i]->GetFrames(num_processed_frames, chunk_length);
+      float *features = features_vec.data() + i * chunk_length * feat_dim;
+      ss[i]->GetFrames(num_processed_frames, chunk_length, features);
       if (config_.feat_config.is_whisper) {
-        OfflineWhisperModel::NormalizeFeatures(features.data(), chunk_length,
+        OfflineWhisperModel::NormalizeFeatures(features, chunk_length,
                                                feat_dim);
       }
 
       // Question: should num_processed_frames include chunk_shift?
       ss[i]->GetNumProcessedFrames() += chunk_shift;
 
-      std::copy(features.begin(), features.end(),
-                features_vec.data() + i * chunk_length * feat_dim);
-
       results[i] = std::move(ss[i]->GetCtcResult());
       states_vec[i] = std::move(ss[i]->GetStates());
       all_processed_frames[i] = num_processed_frames;
@@ -252,6 +251,28 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
     s->Reset();
   }
 
+  bool RecycleStream(OnlineStream *s) const override {
+    s->Clear();
+
+    {
+      std::lock_guard<std::mutex> lock(init_states_mutex_);
+      if (init_states_.empty()) {
+        init_states_ = model_->GetInitStates();
+      }
+    }
+
+    if (!CopyInPlace(init_states_, &s->GetStates())) {
+      s->SetStates(model_->GetInitStates());
+    }
+
+    // Clear() keeps the decoder of the stream, so its buffers are reused
+    if (!s->GetFasterDecoder()) {
+      s->SetFasterDecoder(decoder_->CreateFasterDecoder());
+    }
+
+    return true;
+  }
+
  private:
   void PostInit() {
     if (!config_.model_config.wenet_ctc.model.empty()) {
@@ -357,6 +378,10 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
   std::unique_ptr<OnlineCtcDecoder> decoder_;
   SymbolTable sym_;
   Endpoint endpoint_;
+
+  // Initial states. They are copied into recycled streams.
+  mutable std::mutex init_states_mutex_;
+  mutable std::vector<Ort::Value> init_states_;
 };
 
 }  // namespace sherpa_onnx
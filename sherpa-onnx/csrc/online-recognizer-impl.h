@@ -57,6 +57,9 @@ class OnlineRecognizerImpl {
 
   virtual void Reset(OnlineStream *s) const = 0;
 
+  // Return false if the model does not support recycling streams
+  virtual bool RecycleStream(OnlineStream * /*s*/) const { return false; }
+
   std::string ApplyInverseTextNormalization(std::string text) const;
   std::string ApplyHomophoneReplacer(std::string text) const;
 
@@ -228,6 +228,13 @@ class OnlineRecognizerParaformerImpl : public OnlineRecognizerImpl {
     s->Reset();
   }
 
+  bool RecycleStream(OnlineStream *s) const override {
+    // There are no model states, so it only clears the caches and result
+    s->Clear();
+    s->GetStates().clear();
+    return true;
+  }
+
  private:
   void DecodeStream(OnlineStream *s) const {
     const auto num_processed_frames = s->GetNumProcessedFrames();
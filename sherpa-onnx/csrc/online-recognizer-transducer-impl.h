@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <ios>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <regex>  // NOLINT
 #include <sstream>
 #include <string>
@@ -299,20 +300,17 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
       }
 
       const auto num_processed_frames = ss[i]->GetNumProcessedFrames();
-      std::vector<float> features =
-          ss[i]->GetFrames(num_processed_frames, chunk_size);
+      float *features = features_vec.data() + i * chunk_size * feature_dim;
+      ss[i]->GetFrames(num_processed_frames, chunk_size, features);
 
       if (config_.feat_config.is_whisper) {
-        OfflineWhisperModel::NormalizeFeatures(features.data(), chunk_size,
+        OfflineWhisperModel::NormalizeFeatures(features, chunk_size,
                                                feature_dim);
       }
 
       // Question: should num_processed_frames include chunk_shift?
       ss[i]->GetNumProcessedFrames() += chunk_shift;
 
-      std::copy(features.begin(), features.end(),
-                features_vec.data() + i * chunk_size * feature_dim);
-
       results[i] = std::move(ss[i]->GetResult());
       states_vec[i] = std::move(ss[i]->GetStates());
       all_processed_frames[i] = num_processed_frames;
@@ -435,6 +433,23 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
     s->Reset();
   }
 
+  bool RecycleStream(OnlineStream *s) const override {
+    if (s->GetContextGraph() != hotwords_graph_) {
+      // It was created with its own hotwords
+      return false;
+    }
+
+    s->Clear();
+
+    if (!CopyInPlace(InitStates(), &s->GetStates())) {
+      s->SetStates(model_->GetEncoderInitStates());
+    }
+
+    InitResult(s);
+
+    return true;
+  }
+
  private:
   void InitHotwords() {
     // each line in hotwords_file contains space-separated words
@@ -495,6 +510,11 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
   }
 
   void InitOnlineStream(OnlineStream *stream) const {
+    InitResult(stream);
+    stream->SetStates(model_->GetEncoderInitStates());
+  }
+
+  void InitResult(OnlineStream *stream) const {
     auto r = decoder_->GetEmptyResult();
 
     if (config_.decoding_method == "modified_beam_search" &&
@@ -506,7 +526,16 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
     }
 
     stream->SetResult(r);
-    stream->SetStates(model_->GetEncoderInitStates());
+  }
+
+  // Initial encoder states. They are copied into recycled streams.
+  const std::vector<Ort::Value> &InitStates() const {
+    std::lock_guard<std::mutex> lock(init_states_mutex_);
+    if (init_states_.empty()) {
+      init_states_ = model_->GetEncoderInitStates();
+    }
+
+    return init_states_;
   }
 
  private:
@@ -521,6 +550,9 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
   SymbolTable sym_;
   Endpoint endpoint_;
   int32_t unk_id_ = -1;
+
+  mutable std::mutex init_states_mutex_;
+  mutable std::vector<Ort::Value> init_states_;
 };
 
 }  // namespace sherpa_onnx
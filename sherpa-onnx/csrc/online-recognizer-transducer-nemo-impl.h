@@ -10,6 +10,7 @@
 #include <fstream>
 #include <ios>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <regex>  // NOLINT
 #include <sstream>
 #include <string>
@@ -21,6 +22,7 @@
 #include "sherpa-onnx/csrc/online-recognizer.h"
 #include "sherpa-onnx/csrc/online-transducer-greedy-search-nemo-decoder.h"
 #include "sherpa-onnx/csrc/online-transducer-nemo-model.h"
+#include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
 #include "sherpa-onnx/csrc/transpose.h"
 #include "sherpa-onnx/csrc/utils.h"
@@ -146,6 +148,28 @@ class OnlineRecognizerTransducerNeMoImpl : public OnlineRecognizerImpl {
     s->Reset();
   }
 
+  bool RecycleStream(OnlineStream *s) const override {
+    s->Clear();
+
+    {
+      std::lock_guard<std::mutex> lock(init_states_mutex_);
+      if (init_states_.empty()) {
+        init_states_ = model_->GetEncoderInitStates();
+        init_decoder_states_ = model_->GetDecoderInitStates();
+      }
+    }
+
+    if (!CopyInPlace(init_states_, &s->GetStates())) {
+      s->SetStates(model_->GetEncoderInitStates());
+    }
+
+    if (!CopyInPlace(init_decoder_states_, &s->GetNeMoDecoderStates())) {
+      s->SetNeMoDecoderStates(model_->GetDecoderInitStates());
+    }
+
+    return true;
+  }
+
   void DecodeStreams(OnlineStream **ss, int32_t n) const override {
     int32_t chunk_size = model_->ChunkSize();
     int32_t chunk_shift = model_->ChunkShift();
@@ -157,15 +181,12 @@ class OnlineRecognizerTransducerNeMoImpl : public OnlineRecognizerImpl {
 
     for (int32_t i = 0; i != n; ++i) {
       const auto num_processed_frames = ss[i]->GetNumProcessedFrames();
-      std::vector<float> features =
-          ss[i]->GetFrames(num_processed_frames, chunk_size);
+      ss[i]->GetFrames(num_processed_frames, chunk_size,
+                       features_vec.data() + i * chunk_size * feature_dim);
 
       // Question: should num_processed_frames include chunk_shift?
       ss[i]->GetNumProcessedFrames() += chunk_shift;
 
-      std::copy(features.begin(), features.end(),
-                features_vec.data() + i * chunk_size * feature_dim);
-
       encoder_states[i] = std::move(ss[i]->GetStates());
     }
 
@@ -248,6 +269,11 @@ class OnlineRecognizerTransducerNeMoImpl : public OnlineRecognizerImpl {
   std::unique_ptr<OnlineTransducerNeMoModel> model_;
   std::unique_ptr<OnlineTransducerGreedySearchNeMoDecoder> decoder_;
   Endpoint endpoint_;
+
+  // Initial states. They are copied into recycled streams.
+  mutable std::mutex init_states_mutex_;
+  mutable std::vector<Ort::Value> init_states_;
+  mutable std::vector<Ort::Value> init_decoder_states_;
 };
 
 }  // namespace sherpa_onnx
@@ -261,6 +261,10 @@ bool OnlineRecognizer::IsEndpoint(OnlineStream *s) const {
 
 void OnlineRecognizer::Reset(OnlineStream *s) const { impl_->Reset(s); }
 
+bool OnlineRecognizer::RecycleStream(OnlineStream *s) const {
+  return impl_->RecycleStream(s);
+}
+
 #if __ANDROID_API__ >= 9
 template OnlineRecognizer::OnlineRecognizer(
     AAssetManager *mgr, const OnlineRecognizerConfig &config);
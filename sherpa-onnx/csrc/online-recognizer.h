@@ -222,6 +222,15 @@ class OnlineRecognizer {
   // after calling this function, IsEndpoint(s) will return false
   void Reset(OnlineStream *s) const;
 
+  // Restore a stream created by CreateStream() to the state of a new one,
+  // so that it can be reused, e.g., for another connection of a server.
+  // Model states are reinitialized in place, which avoids allocating them
+  // again.
+  //
+  // Return false if it is not supported for this model or the stream was
+  // created with hotwords. Please create a new stream in that case.
+  bool RecycleStream(OnlineStream *s) const;
+
  private:
   std::unique_ptr<OnlineRecognizerImpl> impl_;
 };
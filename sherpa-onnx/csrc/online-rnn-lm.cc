@@ -6,21 +6,42 @@
 #include "sherpa-onnx/csrc/online-rnn-lm.h"
 
 #include <algorithm>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "onnxruntime_cxx_api.h"  // NOLINT
+#include "sherpa-onnx/csrc/cat.h"
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/lodr-fst.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/session.h"
 #include "sherpa-onnx/csrc/text-utils.h"
+#include "sherpa-onnx/csrc/unbind.h"
 
 namespace sherpa_onnx {
 
+namespace {
+
+// FNV-1a hash of a token sequence
+struct TokenSeqHash {
+  size_t operator()(const std::vector<int64_t> &ys) const {
+    uint64_t h = 14695981039346656037ULL;
+    for (auto y : ys) {
+      h ^= static_cast<uint64_t>(y);
+      h *= 1099511628211ULL;
+    }
+    return static_cast<size_t>(h);
+  }
+};
+
+}  // namespace
+
 class OnlineRnnLM::Impl {
  public:
   explicit Impl(const OnlineLMConfig &config)
@@ -33,40 +54,122 @@ class OnlineRnnLM::Impl {
 
   // shallow fusion scoring function
   void ComputeLMScoreSF(float scale, Hypothesis *hyp) {
-    if (hyp->nn_lm_states.empty()) {
-      auto init_states = GetInitStatesSF();
-      hyp->nn_lm_scores.value = std::move(init_states.first);
-      hyp->nn_lm_states = Convert(std::move(init_states.second));
-      // if LODR enabled, we need to initialize the LODR state
+    ComputeLMScoreSF(scale, std::vector<Hypothesis *>{hyp});
+  }
+
+  // batched shallow fusion scoring function
+  void ComputeLMScoreSF(float scale, const std::vector<Hypothesis *> &hyps) {
+    for (auto *hyp : hyps) {
+      if (hyp->nn_lm_states.empty()) {
+        auto init_states = GetInitStatesSF();
+        hyp->nn_lm_scores.value = std::move(init_states.first);
+        hyp->nn_lm_states = Convert(std::move(init_states.second));
+        // if LODR enabled, we need to initialize the LODR state
+        if (lodr_fst_ != nullptr) {
+          hyp->lodr_state = std::make_unique<LodrStateCost>(lodr_fst_.get());
+        }
+      }
+
+      // get lm score for cur token given the hyp->ys[:-1] and save to
+      // lm_log_prob
+      const float *nn_lm_scores =
+          hyp->nn_lm_scores.value.GetTensorData<float>();
+      hyp->lm_log_prob += nn_lm_scores[hyp->ys.back()] * scale;
+
+      // if LODR enabled, we need to update the LODR state
       if (lodr_fst_ != nullptr) {
-        hyp->lodr_state = std::make_unique<LodrStateCost>(lodr_fst_.get());
+        auto next_lodr_state = std::make_unique<LodrStateCost>(
+            hyp->lodr_state->ForwardOneStep(hyp->ys.back()));
+        // calculate the score of the latest token
+        auto score = next_lodr_state->Score() - hyp->lodr_state->Score();
+        hyp->lodr_state = std::move(next_lodr_state);
+        // apply LODR to hyp score
+        hyp->lm_log_prob += score * config_.lodr_scale;
+      }
+    }
+
+    // get lm scores for next tokens given the hyp->ys[:] and save to
+    // nn_lm_scores.
+    //
+    // Hyps found in the cache are not sent to the NN LM. Hyps with the
+    // same ys are run only once.
+    std::vector<std::vector<Hypothesis *>> groups;
+    std::unordered_map<std::vector<int64_t>, int32_t, TokenSeqHash> ys2group;
+
+    for (auto *hyp : hyps) {
+      if (LookupCache(hyp)) {
+        continue;
       }
+
+      auto it = ys2group.find(hyp->ys);
+      if (it != ys2group.end()) {
+        groups[it->second].push_back(hyp);
+        continue;
+      }
+
+      ys2group.emplace(hyp->ys, static_cast<int32_t>(groups.size()));
+      groups.push_back({hyp});
     }
 
-    // get lm score for cur token given the hyp->ys[:-1] and save to lm_log_prob
-    const float *nn_lm_scores = hyp->nn_lm_scores.value.GetTensorData<float>();
-    hyp->lm_log_prob += nn_lm_scores[hyp->ys.back()] * scale;
-
-    // if LODR enabled, we need to update the LODR state
-    if (lodr_fst_ != nullptr) {
-      auto next_lodr_state = std::make_unique<LodrStateCost>(
-          hyp->lodr_state->ForwardOneStep(hyp->ys.back()));
-      // calculate the score of the latest token
-      auto score = next_lodr_state->Score() - hyp->lodr_state->Score();
-      hyp->lodr_state = std::move(next_lodr_state);
-      // apply LODR to hyp score
-      hyp->lm_log_prob += score * config_.lodr_scale;
+    if (groups.empty()) {
+      return;
     }
 
-    // get lm scores for next tokens given the hyp->ys[:] and save to
-    // nn_lm_scores
-    std::array<int64_t, 2> x_shape{1, 1};
+    int32_t n = static_cast<int32_t>(groups.size());
+
+    std::array<int64_t, 2> x_shape{n, 1};
     Ort::Value x = Ort::Value::CreateTensor<int64_t>(allocator_, x_shape.data(),
                                                      x_shape.size());
-    *x.GetTensorMutableData<int64_t>() = hyp->ys.back();
-    auto lm_out = ScoreToken(std::move(x), Convert(hyp->nn_lm_states));
-    hyp->nn_lm_scores.value = std::move(lm_out.first);
-    hyp->nn_lm_states = Convert(std::move(lm_out.second));
+    int64_t *p_x = x.GetTensorMutableData<int64_t>();
+
+    int32_t num_states = static_cast<int32_t>(init_states_.size());
+    std::vector<std::vector<const Ort::Value *>> batch_states(num_states);
+
+    for (int32_t i = 0; i != n; ++i) {
+      const auto *hyp = groups[i][0];
+      p_x[i] = hyp->ys.back();
+
+      for (int32_t k = 0; k != num_states; ++k) {
+        batch_states[k].push_back(&hyp->nn_lm_states[k].value);
+      }
+    }
+
+    // states are of shape (num_layers, batch_size, hidden_size)
+    std::vector<Ort::Value> states;
+    states.reserve(num_states);
+    for (int32_t k = 0; k != num_states; ++k) {
+      states.push_back(Cat(allocator_, batch_states[k], 1));
+    }
+
+    auto lm_out = ScoreToken(std::move(x), std::move(states));
+
+    auto next_scores = Unbind(allocator_, &lm_out.first, 0);
+
+    std::vector<std::vector<Ort::Value>> next_states;
+    next_states.reserve(num_states);
+    for (int32_t k = 0; k != num_states; ++k) {
+      next_states.push_back(Unbind(allocator_, &lm_out.second[k], 1));
+    }
+
+    for (int32_t i = 0; i != n; ++i) {
+      CopyableOrtValue scores = std::move(next_scores[i]);
+
+      std::vector<CopyableOrtValue> s;
+      s.reserve(num_states);
+      for (int32_t k = 0; k != num_states; ++k) {
+        s.emplace_back(std::move(next_states[k][i]));
+      }
+
+      AddToCache(groups[i][0]->ys, scores, s);
+
+      for (int32_t j = 1; j < static_cast<int32_t>(groups[i].size()); ++j) {
+        groups[i][j]->nn_lm_scores = scores;
+        groups[i][j]->nn_lm_states = s;
+      }
+
+      groups[i][0]->nn_lm_scores = std::move(scores);
+      groups[i][0]->nn_lm_states = std::move(s);
+    }
   }
 
   // classic rescore function
@@ -183,6 +286,51 @@ class OnlineRnnLM::Impl {
     }
   }
 
+  // Return true if the LM scores and states for hyp->ys are found in
+  // the cache. In that case, they are copied to hyp.
+  bool LookupCache(Hypothesis *hyp) {
+    if (config_.lm_cache_size <= 0) {
+      return false;
+    }
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+
+    auto it = cache_map_.find(hyp->ys);
+    if (it == cache_map_.end()) {
+      return false;
+    }
+
+    // move it to the front as it is the most recently used one
+    cache_list_.splice(cache_list_.begin(), cache_list_, it->second);
+
+    hyp->nn_lm_scores = it->second->scores;
+    hyp->nn_lm_states = it->second->states;
+
+    return true;
+  }
+
+  void AddToCache(const std::vector<int64_t> &ys,
+                  const CopyableOrtValue &scores,
+                  const std::vector<CopyableOrtValue> &states) {
+    if (config_.lm_cache_size <= 0) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+
+    if (cache_map_.count(ys)) {
+      return;
+    }
+
+    cache_list_.push_front({ys, scores, states});
+    cache_map_.emplace(ys, cache_list_.begin());
+
+    if (static_cast<int32_t>(cache_list_.size()) > config_.lm_cache_size) {
+      cache_map_.erase(cache_list_.back().ys);
+      cache_list_.pop_back();
+    }
+  }
+
   void ComputeInitStates() {
     constexpr int32_t kBatchSize = 1;
     std::array<int64_t, 3> h_shape{rnn_num_layers_, kBatchSize,
@@ -232,6 +380,21 @@ class OnlineRnnLM::Impl {
   int32_t sos_id_ = 1;
 
   std::unique_ptr<LodrFst> lodr_fst_;
+
+  // LRU cache of the NN LM output for a given token sequence.
+  // It is shared by all streams.
+  struct CacheEntry {
+    std::vector<int64_t> ys;
+    CopyableOrtValue scores;
+    std::vector<CopyableOrtValue> states;
+  };
+
+  // the front is the most recently used one
+  std::list<CacheEntry> cache_list_;
+  std::unordered_map<std::vector<int64_t>, std::list<CacheEntry>::iterator,
+                     TokenSeqHash>
+      cache_map_;
+  std::mutex cache_mutex_;
 };
 
 OnlineRnnLM::OnlineRnnLM(const OnlineLMConfig &config)
@@ -265,4 +428,10 @@ void OnlineRnnLM::ComputeLMScoreSF(float scale, Hypothesis *hyp) {
   return impl_->ComputeLMScoreSF(scale, hyp);
 }
 
+// batched shallow fusion scores
+void OnlineRnnLM::ComputeLMScoreSF(float scale,
+                                   const std::vector<Hypothesis *> &hyps) {
+  return impl_->ComputeLMScoreSF(scale, hyps);
+}
+
 }  // namespace sherpa_onnx
@@ -58,6 +58,14 @@ class OnlineRnnLM : public OnlineLM {
    */
   void ComputeLMScoreSF(float scale, Hypothesis *hyp) override;
 
+  /** It runs the NN LM once for all hyps that are not in the cache.
+   *
+   * @param scale LM score
+   * @param hyps It is changed in-place.
+   */
+  void ComputeLMScoreSF(float scale,
+                        const std::vector<Hypothesis *> &hyps) override;
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
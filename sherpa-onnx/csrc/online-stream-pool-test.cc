@@ -0,0 +1,73 @@
+// sherpa-onnx/csrc/online-stream-pool-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/online-stream-pool.h"
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(OnlineStreamPool, ReturnToPool) {
+  int32_t num_created = 0;
+  std::vector<OnlineStream *> recycled;
+  bool can_recycle = true;
+
+  auto pool = std::make_shared<OnlineStreamPool>(
+      [&num_created]() {
+        num_created += 1;
+        return std::make_unique<OnlineStream>();
+      },
+      [&recycled, &can_recycle](OnlineStream *s) {
+        recycled.push_back(s);
+        return can_recycle;
+      },
+      2);
+
+  auto s1 = pool->Get();
+  auto s2 = pool->Get();
+  auto s3 = pool->Get();
+  EXPECT_EQ(num_created, 3);
+  EXPECT_EQ(pool->Size(), 0);
+
+  // A stream goes back to the pool when its last reference is released
+  OnlineStream *p1 = s1.get();
+  auto copy = s1;
+  s1.reset();
+  EXPECT_EQ(pool->Size(), 0);
+  copy.reset();
+  EXPECT_EQ(pool->Size(), 1);
+
+  // At most 2 streams are kept
+  s2.reset();
+  s3.reset();
+  EXPECT_EQ(pool->Size(), 2);
+
+  // The last stream returned is reused first
+  auto s4 = pool->Get();
+  auto s5 = pool->Get();
+  EXPECT_EQ(num_created, 3);
+  EXPECT_EQ(pool->NumRecycled(), 2);
+  ASSERT_EQ(recycled.size(), 2);
+  EXPECT_EQ(recycled[0], s4.get());
+  EXPECT_EQ(recycled[1], s5.get());
+  EXPECT_EQ(s5.get(), p1);
+  EXPECT_EQ(pool->Size(), 0);
+
+  // A stream that cannot be recycled is replaced by a new one
+  s4.reset();
+  can_recycle = false;
+  auto s6 = pool->Get();
+  EXPECT_EQ(num_created, 4);
+  EXPECT_EQ(pool->NumRecycled(), 2);
+
+  // Streams that outlive the pool are destroyed when they are released
+  pool.reset();
+  s5.reset();
+  s6.reset();
+}
+
+}  // namespace sherpa_onnx
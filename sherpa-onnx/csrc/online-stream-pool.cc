@@ -0,0 +1,63 @@
+// sherpa-onnx/csrc/online-stream-pool.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/online-stream-pool.h"
+
+#include <memory>
+#include <utility>
+
+namespace sherpa_onnx {
+
+OnlineStreamPool::OnlineStreamPool(const OnlineRecognizer *recognizer,
+                                   int32_t max_size)
+    : OnlineStreamPool([recognizer]() { return recognizer->CreateStream(); },
+                       [recognizer](OnlineStream *s) {
+                         return recognizer->RecycleStream(s);
+                       },
+                       max_size) {}
+
+std::shared_ptr<OnlineStream> OnlineStreamPool::Get() {
+  std::unique_ptr<OnlineStream> s;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_.empty()) {
+      s = std::move(free_.back());
+      free_.pop_back();
+    }
+  }
+
+  // It is reset here instead of in Put() so that the thread releasing
+  // the last reference does not pay for it
+  if (s && recycle_(s.get())) {
+    num_recycled_ += 1;
+  } else {
+    s = create_();
+  }
+
+  std::weak_ptr<OnlineStreamPool> pool = weak_from_this();
+
+  return std::shared_ptr<OnlineStream>(s.release(), [pool](OnlineStream *p) {
+    if (auto self = pool.lock()) {
+      self->Put(p);
+    } else {
+      delete p;
+    }
+  });
+}
+
+int32_t OnlineStreamPool::Size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return free_.size();
+}
+
+void OnlineStreamPool::Put(OnlineStream *s) {
+  std::unique_ptr<OnlineStream> p(s);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (static_cast<int32_t>(free_.size()) < max_size_) {
+    free_.push_back(std::move(p));
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,73 @@
+// sherpa-onnx/csrc/online-stream-pool.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_ONLINE_STREAM_POOL_H_
+#define SHERPA_ONNX_CSRC_ONLINE_STREAM_POOL_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/online-recognizer.h"
+#include "sherpa-onnx/csrc/online-stream.h"
+
+namespace sherpa_onnx {
+
+/* A pool of streams for servers with many short connections.
+ *
+ * When the last reference to a stream returned by Get() is released,
+ * the stream goes back to the pool instead of being destroyed. The next
+ * Get() resets it with OnlineRecognizer::RecycleStream(), which
+ * reinitializes the model states in place, instead of allocating a new
+ * stream with new states.
+ *
+ * Please create it with std::make_shared().
+ */
+class OnlineStreamPool : public std::enable_shared_from_this<OnlineStreamPool> {
+ public:
+  /**
+   * @param recognizer Not owned. It must outlive the returned streams.
+   * @param max_size Max number of free streams kept in the pool.
+   */
+  OnlineStreamPool(const OnlineRecognizer *recognizer, int32_t max_size);
+
+  using CreateStreamFunc = std::function<std::unique_ptr<OnlineStream>()>;
+  using RecycleStreamFunc = std::function<bool(OnlineStream *)>;
+
+  // Like the above one, but streams are created and recycled by the given
+  // functions, e.g., in tests
+  OnlineStreamPool(CreateStreamFunc create, RecycleStreamFunc recycle,
+                   int32_t max_size)
+      : create_(std::move(create)),
+        recycle_(std::move(recycle)),
+        max_size_(max_size) {}
+
+  // Return a recycled stream if there is one; otherwise, return a new stream
+  std::shared_ptr<OnlineStream> Get();
+
+  // Number of free streams
+  int32_t Size() const;
+
+  // Number of streams returned by Get() that are recycled
+  int64_t NumRecycled() const { return num_recycled_; }
+
+ private:
+  void Put(OnlineStream *s);
+
+ private:
+  CreateStreamFunc create_;
+  RecycleStreamFunc recycle_;
+  int32_t max_size_;
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<OnlineStream>> free_;
+
+  std::atomic<int64_t> num_recycled_{0};
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_ONLINE_STREAM_POOL_H_
@@ -26,6 +26,12 @@ class OnlineStream::Impl {
     feat_extractor_.AcceptWaveform(sampling_rate, waveform, n);
   }
 
+  void AcceptWaveform(int32_t sampling_rate, const void *waveform, int32_t n,
+                      SampleFormat format) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    feat_extractor_.AcceptWaveform(sampling_rate, waveform, n, format);
+  }
+
   void InputFinished() const {
     std::lock_guard<std::mutex> lock(mutex_);
     feat_extractor_.InputFinished();
@@ -41,9 +47,9 @@ class OnlineStream::Impl {
     return feat_extractor_.IsLastFrame(frame);
   }
 
-  std::vector<float> GetFrames(int32_t frame_index, int32_t n) const {
+  void GetFrames(int32_t frame_index, int32_t n, float *features) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return feat_extractor_.GetFrames(frame_index + start_frame_index_, n);
+    feat_extractor_.GetFrames(frame_index + start_frame_index_, n, features);
   }
 
   void Reset() {
@@ -53,6 +59,26 @@ class OnlineStream::Impl {
     num_processed_frames_ = 0;
   }
 
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    feat_extractor_.Reset();
+    num_processed_frames_ = 0;
+    start_frame_index_ = 0;
+    segment_ = 0;
+    result_ = {};
+    prev_keyword_result_ = {};
+    keyword_result_ = {};
+    ctc_result_ = {};
+    paraformer_feat_cache_.clear();
+    paraformer_encoder_out_cache_.clear();
+    paraformer_alpha_cache_.clear();
+    paraformer_result_ = {};
+    options_.clear();
+    // faster_decoder_ is kept so that a recycled stream can reuse its
+    // token buffers. It is re-initialized when processed frames is 0
+    faster_decoder_processed_frames_ = 0;
+  }
+
   int32_t &GetNumProcessedFrames() {
     std::lock_guard<std::mutex> lock(mutex_);
     return num_processed_frames_;
@@ -211,6 +237,11 @@ void OnlineStream::AcceptWaveform(int32_t sampling_rate, const float *waveform,
   impl_->AcceptWaveform(sampling_rate, waveform, n);
 }
 
+void OnlineStream::AcceptWaveform(int32_t sampling_rate, const void *waveform,
+                                  int32_t n, SampleFormat format) const {
+  impl_->AcceptWaveform(sampling_rate, waveform, n, format);
+}
+
 void OnlineStream::InputFinished() const { impl_->InputFinished(); }
 
 int32_t OnlineStream::NumFramesReady() const { return impl_->NumFramesReady(); }
@@ -221,13 +252,22 @@ bool OnlineStream::IsLastFrame(int32_t frame) const {
 
 std::vector<float> OnlineStream::GetFrames(int32_t frame_index,
                                            int32_t n) const {
-  return impl_->GetFrames(frame_index, n);
+  std::vector<float> features(n * FeatureDim());
+  impl_->GetFrames(frame_index, n, features.data());
+  return features;
+}
+
+void OnlineStream::GetFrames(int32_t frame_index, int32_t n,
+                             float *features) const {
+  impl_->GetFrames(frame_index, n, features);
 }
 
 void OnlineStream::Reset() { impl_->Reset(); }
 
 int32_t OnlineStream::FeatureDim() const { return impl_->FeatureDim(); }
 
+void OnlineStream::Clear() { impl_->Clear(); }
+
 int32_t &OnlineStream::GetNumProcessedFrames() {
   return impl_->GetNumProcessedFrames();
 }
@@ -38,6 +38,17 @@ class OnlineStream {
   void AcceptWaveform(int32_t sampling_rate, const float *waveform,
                       int32_t n) const;
 
+  /**
+     Like the above one, but the samples are in the given format, e.g.,
+     16-bit PCM or G.711 mu-law from telephony. They are converted to float
+     block by block, so the caller needs not to allocate a float copy.
+
+     @param waveform Pointer to n samples, i.e., n * BytesPerSample(format)
+                     bytes.
+   */
+  void AcceptWaveform(int32_t sampling_rate, const void *waveform, int32_t n,
+                      SampleFormat format) const;
+
   /**
    * InputFinished() tells the class you won't be providing any
    * more waveform.  This will help flush out the last frame or two
@@ -62,8 +73,24 @@ class OnlineStream {
    */
   std::vector<float> GetFrames(int32_t frame_index, int32_t n) const;
 
+  /** Like the above one, but write the frames to the given buffer, e.g.,
+   * a row of a batched input tensor, instead of allocating a new vector.
+   *
+   * @param features  Output array of n * FeatureDim() floats.
+   */
+  void GetFrames(int32_t frame_index, int32_t n, float *features) const;
+
   void Reset();
 
+  // Discard all audio, features and results so that the stream can be
+  // reused for a new utterance from the start.
+  //
+  // The model states from GetStates() and GetNeMoDecoderStates() and the
+  // decoder from GetFasterDecoder() are kept so that they can be
+  // reinitialized in place. Please use
+  // OnlineRecognizer::RecycleStream() instead of calling it directly.
+  void Clear();
+
   int32_t FeatureDim() const;
 
   // Return a reference to the number of processed frames so far
@@ -108,15 +108,12 @@ void OnlineTransducerGreedySearchDecoder::Decode(
                                                   decoder_out_shape.size());
     UseCachedDecoderOut(*result, &decoder_out);
   } else {
-    Ort::Value decoder_input = model_->BuildDecoderInput(*result);
-    decoder_out = model_->RunDecoder(std::move(decoder_input));
+    decoder_out = model_->RunDecoderWithCache(*result);
   }
 
   for (int32_t t = 0; t != num_frames; ++t) {
-    Ort::Value cur_encoder_out =
-        GetEncoderOutFrame(model_->Allocator(), &encoder_out, t);
     Ort::Value logit =
-        model_->RunJoiner(std::move(cur_encoder_out), View(&decoder_out));
+        model_->RunJoinerOnFrame(&encoder_out, t, View(&decoder_out));
 
     float *p_logit = logit.GetTensorMutableData<float>();
 
@@ -158,8 +155,7 @@ void OnlineTransducerGreedySearchDecoder::Decode(
       }
     }
     if (emitted) {
-      Ort::Value decoder_input = model_->BuildDecoderInput(*result);
-      decoder_out = model_->RunDecoder(std::move(decoder_input));
+      decoder_out = model_->RunDecoderWithCache(*result);
     }
   }
 
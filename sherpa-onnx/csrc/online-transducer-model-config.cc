@@ -15,9 +15,23 @@ void OnlineTransducerModelConfig::Register(ParseOptions *po) {
   po->Register("encoder", &encoder, "Path to encoder.onnx");
   po->Register("decoder", &decoder, "Path to decoder.onnx");
   po->Register("joiner", &joiner, "Path to joiner.onnx");
+  po->Register("native-joiner", &native_joiner,
+               "true to compute the joiner in C++ instead of running "
+               "joiner.onnx. It is faster for small joiners. Ignored if the "
+               "joiner model is not supported, e.g., if it is quantized");
+  po->Register("decoder-output-cache-size", &decoder_output_cache_size,
+               "Maximum number of decoder outputs cached per model. The "
+               "decoder model runs only for token contexts that are not in "
+               "the cache. 0 to disable the cache");
 }
 
 bool OnlineTransducerModelConfig::Validate() const {
+  if (decoder_output_cache_size < 0) {
+    SHERPA_ONNX_LOGE("--decoder-output-cache-size should be >= 0. Given: %d",
+                     decoder_output_cache_size);
+    return false;
+  }
+
   if (!FileExists(encoder)) {
     SHERPA_ONNX_LOGE("transducer encoder: '%s' does not exist",
                      encoder.c_str());
@@ -44,7 +58,9 @@ std::string OnlineTransducerModelConfig::ToString() const {
   os << "OnlineTransducerModelConfig(";
   os << "encoder=\"" << encoder << "\", ";
   os << "decoder=\"" << decoder << "\", ";
-  os << "joiner=\"" << joiner << "\")";
+  os << "joiner=\"" << joiner << "\", ";
+  os << "native_joiner=" << (native_joiner ? "True" : "False") << ", ";
+  os << "decoder_output_cache_size=" << decoder_output_cache_size << ")";
 
   return os.str();
 }
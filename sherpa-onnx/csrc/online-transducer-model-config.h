@@ -15,6 +15,14 @@ struct OnlineTransducerModelConfig {
   std::string decoder;
   std::string joiner;
 
+  // Compute the joiner in C++ instead of running joiner.onnx if the
+  // joiner model is supported
+  bool native_joiner = false;
+
+  // Maximum number of decoder outputs cached per model, see
+  // decoder-output-cache.h. 0 disables the cache.
+  int32_t decoder_output_cache_size = 8192;
+
   OnlineTransducerModelConfig() = default;
   OnlineTransducerModelConfig(const std::string &encoder,
                               const std::string &decoder,
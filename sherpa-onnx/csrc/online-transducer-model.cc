@@ -14,9 +14,11 @@
 #endif
 
 #include <algorithm>
+#include <array>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "sherpa-onnx/csrc/file-utils.h"
@@ -141,7 +143,7 @@ static ModelType GetModelType(char *model_data, size_t model_data_length,
   }
 }
 
-std::unique_ptr<OnlineTransducerModel> OnlineTransducerModel::Create(
+static std::unique_ptr<OnlineTransducerModel> CreateModel(
     const OnlineModelConfig &config) {
   if (!config.model_type.empty()) {
     const auto &model_type = config.model_type;
@@ -187,6 +189,28 @@ std::unique_ptr<OnlineTransducerModel> OnlineTransducerModel::Create(
   return nullptr;
 }
 
+OnlineTransducerModel::~OnlineTransducerModel() {
+  const auto &cache = decoder_output_cache_;
+  if (debug_ && cache.NumHits() + cache.NumMisses() > 0) {
+    SHERPA_ONNX_LOGE("%s", cache.ToString().c_str());
+  }
+}
+
+std::unique_ptr<OnlineTransducerModel> OnlineTransducerModel::Create(
+    const OnlineModelConfig &config) {
+  auto model = CreateModel(config);
+  if (model) {
+    model->GetDecoderOutputCache().SetCapacity(
+        config.transducer.decoder_output_cache_size);
+    model->debug_ = config.debug;
+  }
+
+  if (model && config.transducer.native_joiner) {
+    model->InitNativeJoiner(ReadFile(config.transducer.joiner), config.debug);
+  }
+  return model;
+}
+
 Ort::Value OnlineTransducerModel::BuildDecoderInput(
     const std::vector<OnlineTransducerDecoderResult> &results) {
   int32_t batch_size = static_cast<int32_t>(results.size());
@@ -221,8 +245,108 @@ Ort::Value OnlineTransducerModel::BuildDecoderInput(
   return decoder_input;
 }
 
+Ort::Value OnlineTransducerModel::RunDecoderWithCache(
+    const std::vector<OnlineTransducerDecoderResult> &results) {
+  int32_t context_size = ContextSize();
+  std::vector<int64_t> contexts;
+  contexts.reserve(results.size() * context_size);
+
+  for (const auto &r : results) {
+    contexts.insert(contexts.end(), r.tokens.end() - context_size,
+                    r.tokens.end());
+  }
+
+  return RunDecoderOnContexts(contexts);
+}
+
+Ort::Value OnlineTransducerModel::RunDecoderWithCache(
+    const std::vector<Hypothesis> &hyps) {
+  int32_t context_size = ContextSize();
+  std::vector<int64_t> contexts;
+  contexts.reserve(hyps.size() * context_size);
+
+  for (const auto &h : hyps) {
+    contexts.insert(contexts.end(), h.ys.end() - context_size, h.ys.end());
+  }
+
+  return RunDecoderOnContexts(contexts);
+}
+
+Ort::Value OnlineTransducerModel::RunDecoderOnContexts(
+    const std::vector<int64_t> &contexts) {
+  int32_t context_size = ContextSize();
+  return decoder_output_cache_.Run(
+      contexts.data(), contexts.size() / context_size, context_size,
+      Allocator(), [this](Ort::Value decoder_input) {
+        return RunDecoder(std::move(decoder_input));
+      });
+}
+
+Ort::Value OnlineTransducerModel::RunJoinerOnFrame(
+    Ort::Value *encoder_out, int32_t t, Ort::Value decoder_out,
+    const std::vector<int32_t> &row_splits) {
+  if (!native_joiner_) {
+    Ort::Value cur_encoder_out =
+        GetEncoderOutFrame(Allocator(), encoder_out, t);
+    if (!row_splits.empty()) {
+      cur_encoder_out = Repeat(Allocator(), &cur_encoder_out, row_splits);
+    }
+    return RunJoiner(std::move(cur_encoder_out), std::move(decoder_out));
+  }
+
+  std::vector<int64_t> shape =
+      encoder_out->GetTensorTypeAndShapeInfo().GetShape();
+  int32_t batch_size = shape[0];
+  int64_t stride = shape[1] * shape[2];
+  const float *p = encoder_out->GetTensorData<float>() + t * shape[2];
+
+  std::vector<const float *> rows;
+  for (int32_t b = 0; b != batch_size; ++b) {
+    int32_t n = row_splits.empty() ? 1 : row_splits[b + 1] - row_splits[b];
+    rows.insert(rows.end(), n, p + b * stride);
+  }
+
+  std::array<int64_t, 2> logit_shape{static_cast<int64_t>(rows.size()),
+                                     native_joiner_->VocabSize()};
+  Ort::Value logit = Ort::Value::CreateTensor<float>(
+      Allocator(), logit_shape.data(), logit_shape.size());
+
+  native_joiner_->Run(rows.data(), decoder_out.GetTensorData<float>(),
+                      rows.size(), logit.GetTensorMutableData<float>());
+
+  return logit;
+}
+
+void OnlineTransducerModel::InitNativeJoiner(
+    const std::vector<char> &model_data, bool debug) {
+  auto joiner =
+      NativeJoiner::Create(model_data.data(), model_data.size(), debug);
+  if (!joiner) {
+    SHERPA_ONNX_LOGE(
+        "The joiner model is not supported by the native joiner. Use "
+        "onnxruntime instead");
+    return;
+  }
+
+  bool ok = joiner->VocabSize() == VocabSize() &&
+            joiner->Verify(
+                [this](Ort::Value encoder_out, Ort::Value decoder_out) {
+                  return RunJoiner(std::move(encoder_out),
+                                   std::move(decoder_out));
+                },
+                Allocator());
+  if (!ok) {
+    SHERPA_ONNX_LOGE(
+        "The native joiner does not match the joiner model. Use onnxruntime "
+        "instead");
+    return;
+  }
+
+  native_joiner_ = std::move(joiner);
+}
+
 template <typename Manager>
-std::unique_ptr<OnlineTransducerModel> OnlineTransducerModel::Create(
+static std::unique_ptr<OnlineTransducerModel> CreateModel(
     Manager *mgr, const OnlineModelConfig &config) {
   if (!config.model_type.empty()) {
     const auto &model_type = config.model_type;
@@ -266,6 +390,23 @@ std::unique_ptr<OnlineTransducerModel> OnlineTransducerModel::Create(
   return nullptr;
 }
 
+template <typename Manager>
+std::unique_ptr<OnlineTransducerModel> OnlineTransducerModel::Create(
+    Manager *mgr, const OnlineModelConfig &config) {
+  auto model = CreateModel(mgr, config);
+  if (model) {
+    model->GetDecoderOutputCache().SetCapacity(
+        config.transducer.decoder_output_cache_size);
+    model->debug_ = config.debug;
+  }
+
+  if (model && config.transducer.native_joiner) {
+    model->InitNativeJoiner(ReadFile(mgr, config.transducer.joiner),
+                            config.debug);
+  }
+  return model;
+}
+
 #if __ANDROID_API__ >= 9
 template std::unique_ptr<OnlineTransducerModel> OnlineTransducerModel::Create(
     AAssetManager *mgr, const OnlineModelConfig &config);
@@ -9,7 +9,9 @@
 #include <vector>
 
 #include "onnxruntime_cxx_api.h"  // NOLINT
+#include "sherpa-onnx/csrc/decoder-output-cache.h"
 #include "sherpa-onnx/csrc/hypothesis.h"
+#include "sherpa-onnx/csrc/native-joiner.h"
 #include "sherpa-onnx/csrc/online-model-config.h"
 #include "sherpa-onnx/csrc/online-transducer-decoder.h"
 #include "sherpa-onnx/csrc/online-transducer-model-config.h"
@@ -20,7 +22,7 @@ struct OnlineTransducerDecoderResult;
 
 class OnlineTransducerModel {
  public:
-  virtual ~OnlineTransducerModel() = default;
+  virtual ~OnlineTransducerModel();
 
   static std::unique_ptr<OnlineTransducerModel> Create(
       const OnlineModelConfig &config);
@@ -140,6 +142,52 @@ class OnlineTransducerModel {
       const std::vector<OnlineTransducerDecoderResult> &results);
 
   Ort::Value BuildDecoderInput(const std::vector<Hypothesis> &hyps);
+
+  /** Same as RunDecoder(BuildDecoderInput(results)), but the decoder runs
+   * only on contexts whose outputs are not in GetDecoderOutputCache().
+   */
+  Ort::Value RunDecoderWithCache(
+      const std::vector<OnlineTransducerDecoderResult> &results);
+
+  Ort::Value RunDecoderWithCache(const std::vector<Hypothesis> &hyps);
+
+  DecoderOutputCache &GetDecoderOutputCache() { return decoder_output_cache_; }
+
+  /** Run the joiner on frame t of the encoder output.
+   *
+   * It is equivalent to
+   *
+   *   RunJoiner(Repeat(GetEncoderOutFrame(encoder_out, t), row_splits),
+   *             decoder_out)
+   *
+   * When the native joiner is enabled, frames are read from encoder_out in
+   * place and the joiner runs in C++.
+   *
+   * @param encoder_out A tensor of shape (N, T, joiner_dim).
+   * @param t The frame index.
+   * @param decoder_out A tensor of shape (M, joiner_dim).
+   * @param row_splits If not empty, rows row_splits[i] to row_splits[i+1]-1
+   *                   of decoder_out are paired with encoder_out[i, t].
+   *                   Otherwise, M equals N.
+   * @return Return a tensor of shape (M, vocab_size).
+   */
+  Ort::Value RunJoinerOnFrame(Ort::Value *encoder_out, int32_t t,
+                              Ort::Value decoder_out,
+                              const std::vector<int32_t> &row_splits = {});
+
+ private:
+  Ort::Value RunDecoderOnContexts(const std::vector<int64_t> &contexts);
+
+  // Enable the native joiner if it supports the joiner model and
+  // agrees with it
+  void InitNativeJoiner(const std::vector<char> &model_data, bool debug);
+
+ private:
+  DecoderOutputCache decoder_output_cache_;
+  std::unique_ptr<NativeJoiner> native_joiner_;
+
+  // If true, statistics of decoder_output_cache_ are printed on destruction
+  bool debug_ = false;
 };
 
 }  // namespace sherpa_onnx
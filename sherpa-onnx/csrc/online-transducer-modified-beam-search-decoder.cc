@@ -116,18 +116,13 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
     cur.clear();
     cur.reserve(batch_size);
 
-    Ort::Value decoder_input = model_->BuildDecoderInput(prev);
-    Ort::Value decoder_out = model_->RunDecoder(std::move(decoder_input));
+    Ort::Value decoder_out = model_->RunDecoderWithCache(prev);
     if (t == 0) {
       UseCachedDecoderOut(hyps_row_splits, *result, &decoder_out);
     }
 
-    Ort::Value cur_encoder_out =
-        GetEncoderOutFrame(model_->Allocator(), &encoder_out, t);
-    cur_encoder_out =
-        Repeat(model_->Allocator(), &cur_encoder_out, hyps_row_splits);
-    Ort::Value logit =
-        model_->RunJoiner(std::move(cur_encoder_out), View(&decoder_out));
+    Ort::Value logit = model_->RunJoinerOnFrame(
+        &encoder_out, t, View(&decoder_out), hyps_row_splits);
 
     float *p_logit = logit.GetTensorMutableData<float>();
 
@@ -168,6 +163,14 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
     }
     p_logprob = p_logit;  // we changed p_logprob in the above for loop
 
+    // new_hyps[b] contains the expanded hyps of the b-th stream.
+    // They are added to cur only after the LM scores of all hyps that
+    // have emitted a new token are computed in a single batch.
+    std::vector<std::vector<Hypothesis>> new_hyps(batch_size);
+    std::vector<std::vector<float>> prev_lm_log_probs(batch_size);
+    std::vector<std::vector<bool>> has_new_token(batch_size);
+    std::vector<Hypothesis *> lm_hyps;
+
     for (int32_t b = 0; b != batch_size; ++b) {
       int32_t frame_offset = (*result)[b].frame_offset;
       int32_t start = hyps_row_splits[b];
@@ -175,7 +178,7 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
       auto topk =
           TopkIndex(p_logprob, vocab_size * (end - start), max_active_paths_);
 
-      Hypotheses hyps;
+      new_hyps[b].reserve(topk.size());
       for (auto k : topk) {
         int32_t hyp_index = k / vocab_size + start;
         int32_t new_token = k % vocab_size;
@@ -197,9 +200,6 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
             context_score = std::get<0>(context_res);
             new_hyp.context_state = std::get<1>(context_res);
           }
-          if (lm_ && shallow_fusion_) {
-            lm_->ComputeLMScoreSF(lm_scale_, &new_hyp);
-          }
         } else {
           ++new_hyp.num_trailing_blanks;
         }
@@ -218,27 +218,54 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
           float y_prob = logit_with_temperature[start * vocab_size + k];
           new_hyp.ys_probs.push_back(y_prob);
 
-          if (lm_ && shallow_fusion_) {  // export only if
-                                         // LM shallow fusion is used
-            float lm_prob = new_hyp.lm_log_prob - prev_lm_log_prob;
-
-            if (lm_scale_ != 0.0) {
-              lm_prob /= lm_scale_;  // remove lm-scale
-            }
-            new_hyp.lm_probs.push_back(lm_prob);
-          }
-
           // export only when `ContextGraph` is used
           if (ss != nullptr && ss[b]->GetContextGraph() != nullptr) {
             new_hyp.context_scores.push_back(context_score);
           }
         }
 
-        hyps.Add(std::move(new_hyp));
+        new_hyps[b].push_back(std::move(new_hyp));
+        prev_lm_log_probs[b].push_back(prev_lm_log_prob);
+        has_new_token[b].push_back(new_token != 0 && new_token != unk_id_);
       }  // for (auto k : topk)
-      cur.push_back(std::move(hyps));
       p_logprob += (end - start) * vocab_size;
     }  // for (int32_t b = 0; b != batch_size; ++b)
+
+    if (lm_ && shallow_fusion_) {
+      for (int32_t b = 0; b != batch_size; ++b) {
+        for (int32_t i = 0; i != static_cast<int32_t>(new_hyps[b].size());
+             ++i) {
+          if (has_new_token[b][i]) {
+            lm_hyps.push_back(&new_hyps[b][i]);
+          }
+        }
+      }
+
+      if (!lm_hyps.empty()) {
+        lm_->ComputeLMScoreSF(lm_scale_, lm_hyps);
+      }
+    }
+
+    for (int32_t b = 0; b != batch_size; ++b) {
+      Hypotheses hyps;
+      for (int32_t i = 0; i != static_cast<int32_t>(new_hyps[b].size());
+           ++i) {
+        auto &new_hyp = new_hyps[b][i];
+
+        if (lm_ && shallow_fusion_ && has_new_token[b][i]) {
+          // export only if LM shallow fusion is used
+          float lm_prob = new_hyp.lm_log_prob - prev_lm_log_probs[b][i];
+
+          if (lm_scale_ != 0.0) {
+            lm_prob /= lm_scale_;  // remove lm-scale
+          }
+          new_hyp.lm_probs.push_back(lm_prob);
+        }
+
+        hyps.Add(std::move(new_hyp));
+      }
+      cur.push_back(std::move(hyps));
+    }
   }    // for (int32_t t = 0; t != num_frames; ++t)
 
   // classic lm rescore
@@ -264,8 +291,7 @@ void OnlineTransducerModifiedBeamSearchDecoder::UpdateDecoderOut(
     result->decoder_out = Ort::Value{nullptr};
     return;
   }
-  Ort::Value decoder_input = model_->BuildDecoderInput({*result});
-  result->decoder_out = model_->RunDecoder(std::move(decoder_input));
+  result->decoder_out = model_->RunDecoderWithCache({*result});
 }
 
 }  // namespace sherpa_onnx
@@ -1,7 +1,9 @@
 // sherpa/cpp_api/websocket/online-websocket-client.cc
 //
 // Copyright (c)  2022  Xiaomi Corporation
+#include <algorithm>
 #include <chrono>  // NOLINT
+#include <cstring>
 #include <fstream>
 #include <string>
 #include <vector>
@@ -33,18 +35,37 @@ Usage:
   /path/to/foo.wav
 
 It support only wave of with a single channel, 16kHz, 16-bit samples.
+
+Use --sample-format=int16 to send 16-bit samples, which halves the
+number of bytes sent to the server.
 )";
 
 class Client {
  public:
   Client(asio::io_context &io,  // NOLINT
          const std::string &ip, int16_t port, const std::vector<float> &samples,
+         int32_t sample_rate, const std::string &sample_format,
          int32_t samples_per_message, float seconds_per_message)
       : io_(io),
-        uri_(/*secure*/ false, ip, port, /*resource*/ "/"),
-        samples_(samples),
+        uri_(/*secure*/ false, ip, port,
+             /*resource*/ sample_format == "float32"
+                 ? std::string("/")
+                 : "/?sample_format=" + sample_format +
+                       "&sample_rate=" + std::to_string(sample_rate)),
         samples_per_message_(samples_per_message),
         seconds_per_message_(seconds_per_message) {
+    if (sample_format == "int16") {
+      bytes_per_sample_ = sizeof(int16_t);
+      data_.resize(samples.size() * bytes_per_sample_);
+      for (size_t i = 0; i != samples.size(); ++i) {
+        int16_t s = std::max(-1.0f, std::min(samples[i], 1.0f)) * 32767;
+        std::memcpy(&data_[i * bytes_per_sample_], &s, bytes_per_sample_);
+      }
+    } else {
+      data_.assign(reinterpret_cast<const char *>(samples.data()),
+                   samples.size() * sizeof(float));
+    }
+
     c_.clear_access_channels(websocketpp::log::alevel::all);
     // c_.set_access_channels(websocketpp::log::alevel::connect);
     // c_.set_access_channels(websocketpp::log::alevel::disconnect);
@@ -96,7 +117,7 @@ class Client {
   void SendMessage(
       connection_hdl hdl,
       std::chrono::time_point<std::chrono::steady_clock> start_time) {
-    int32_t num_samples = samples_.size();
+    int32_t num_samples = data_.size() / bytes_per_sample_;
     int32_t num_messages = num_samples / samples_per_message_;
 
     websocketpp::lib::error_code ec;
@@ -116,8 +137,10 @@ class Client {
     }
 
     if (num_sent_messages_ < num_messages) {
-      c_.send(hdl, samples_.data() + num_sent_messages_ * samples_per_message_,
-              samples_per_message_ * sizeof(float),
+      c_.send(hdl,
+              data_.data() +
+                  num_sent_messages_ * samples_per_message_ * bytes_per_sample_,
+              samples_per_message_ * bytes_per_sample_,
               websocketpp::frame::opcode::binary, ec);
 
       if (ec) {
@@ -135,8 +158,9 @@ class Client {
       int32_t remaining_samples = num_samples % samples_per_message_;
       if (remaining_samples) {
         c_.send(hdl,
-                samples_.data() + num_sent_messages_ * samples_per_message_,
-                remaining_samples * sizeof(float),
+                data_.data() + num_sent_messages_ * samples_per_message_ *
+                                   bytes_per_sample_,
+                remaining_samples * bytes_per_sample_,
                 websocketpp::frame::opcode::binary, ec);
 
         if (ec) {
@@ -167,7 +191,8 @@ class Client {
   client c_;
   asio::io_context &io_;
   websocketpp::uri uri_;
-  std::vector<float> samples_;
+  std::string data_;  // samples encoded in the selected format
+  int32_t bytes_per_sample_ = sizeof(float);
   int32_t samples_per_message_ = 8000;  // 0.5 seconds
   float seconds_per_message_ = 0.2;
   int32_t num_sent_messages_ = 0;
@@ -181,6 +206,7 @@ int32_t main(int32_t argc, char *argv[]) {
   int32_t sample_rate = 16000;
   int32_t samples_per_message = 8000;
   float seconds_per_message = 0.2;
+  std::string sample_format = "float32";
 
   sherpa_onnx::ParseOptions po(kUsageMessage);
 
@@ -190,6 +216,9 @@ int32_t main(int32_t argc, char *argv[]) {
               "Sample rate of the input wave. Should be the one expected by "
               "the server");
 
+  po.Register("sample-format", &sample_format,
+              "Format of the samples sent to the server: float32 or int16");
+
   po.Register("samples-per-message", &samples_per_message,
               "Send this number of samples per message.");
 
@@ -225,6 +254,11 @@ int32_t main(int32_t argc, char *argv[]) {
     return -1;
   }
 
+  if (sample_format != "float32" && sample_format != "int16") {
+    SHERPA_ONNX_LOGE("Unsupported --sample-format: %s", sample_format.c_str());
+    return -1;
+  }
+
   if (seconds_per_message < 0) {
     SHERPA_ONNX_LOGE("--seconds-per-message is too small: %.3f",
                      seconds_per_message);
@@ -265,8 +299,8 @@ int32_t main(int32_t argc, char *argv[]) {
   }
 
   asio::io_context io_conn;  // for network connections
-  Client c(io_conn, server_ip, server_port, samples, samples_per_message,
-           seconds_per_message);
+  Client c(io_conn, server_ip, server_port, samples, sample_rate, sample_format,
+           samples_per_message, seconds_per_message);
 
   io_conn.run();  // will exit when the above connection is closed
 
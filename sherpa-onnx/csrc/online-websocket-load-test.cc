@@ -0,0 +1,501 @@
+// sherpa-onnx/csrc/online-websocket-load-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/histogram.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
+#include "websocketpp/client.hpp"
+#include "websocketpp/config/asio_no_tls_client.hpp"
+#include "websocketpp/uri.hpp"
+
+using client = websocketpp::client<websocketpp::config::asio_client>;
+
+using message_ptr = client::message_ptr;
+using websocketpp::connection_hdl;
+
+static constexpr const char *kUsageMessage = R"(
+Load test for sherpa-onnx-online-websocket-server.
+
+It opens --num-streams connections to the server. Each connection sends
+a wave file in real time, i.e., one message of --samples-per-message
+samples every --seconds-per-message seconds. New connections are started at
+--arrival-rate connections per second, so the number of concurrent streams
+is about arrival-rate * duration-of-a-wave.
+
+Usage:
+
+./bin/sherpa-onnx-online-websocket-load-test \
+  --server-ip=127.0.0.1 \
+  --server-port=6006 \
+  --num-streams=100 \
+  --arrival-rate=5 \
+  /path/to/foo.wav \
+  /path/to/bar.wav
+
+or
+
+./bin/sherpa-onnx-online-websocket-load-test \
+  --num-streams=100 \
+  --wav-scp=/path/to/wav.list
+
+where each line of wav.list is the path to a wave file. Wave files are
+used in a round-robin fashion.
+
+It supports only wave files with a single channel, 16-bit samples at
+--sample-rate.
+
+At the end, it prints latency statistics measured by the client:
+  - result_latency_ms: time from sending an audio chunk to receiving the
+    first result after it
+  - final_latency_ms: time from sending the last chunk to receiving Done!
+
+Latencies measured by the server are available at
+http://server-ip:server-port/metrics
+)";
+
+struct LoadTestConfig {
+  std::string server_ip = "127.0.0.1";
+  int32_t server_port = 6006;
+  int32_t sample_rate = 16000;
+  std::string sample_format = "int16";
+  int32_t samples_per_message = 1600;
+  float seconds_per_message = 0.1;
+  int32_t num_streams = 10;
+
+  // New streams per second. 0 means to start all of them at once.
+  float arrival_rate = 0;
+
+  // If true, inter-arrival times are exponentially distributed with mean
+  // 1/arrival_rate. Otherwise, they are fixed.
+  bool poisson = false;
+
+  // If not empty, the model to use on a server with --extra-models
+  std::string model;
+};
+
+// Resource of the request URI, which selects the audio format and the model
+static std::string GetResource(const LoadTestConfig &config) {
+  std::string query;
+  if (config.sample_format != "float32") {
+    query = "sample_format=" + config.sample_format +
+            "&sample_rate=" + std::to_string(config.sample_rate);
+  }
+
+  if (!config.model.empty()) {
+    query += (query.empty() ? "model=" : "&model=") + config.model;
+  }
+
+  return query.empty() ? "/" : "/?" + query;
+}
+
+class LoadTest {
+ public:
+  LoadTest(asio::io_context &io,  // NOLINT
+           const LoadTestConfig &config, std::vector<std::string> waves)
+      : io_(io),
+        config_(config),
+        uri_(/*secure*/ false, config.server_ip, config.server_port,
+             /*resource*/ GetResource(config)),
+        waves_(std::move(waves)),
+        arrival_timer_(io),
+        result_latency_ms_(sherpa_onnx::ExponentialBuckets(1, 2, 15)),
+        final_latency_ms_(sherpa_onnx::ExponentialBuckets(1, 2, 15)) {
+    c_.clear_access_channels(websocketpp::log::alevel::all);
+    c_.clear_error_channels(websocketpp::log::elevel::all);
+    c_.init_asio(&io_);
+  }
+
+  void Run() {
+    start_time_ = std::chrono::steady_clock::now();
+    StartStream();
+  }
+
+  void PrintSummary() const {
+    float elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        end_time_ - start_time_)
+                        .count() /
+                    1000.;
+
+    std::ostringstream os;
+    os << "{ ";
+    os << "\"num_streams\": " << config_.num_streams << ", ";
+    os << "\"num_failed\": " << num_failed_ << ", ";
+    os << "\"max_concurrent_streams\": " << max_concurrent_ << ", ";
+    os << "\"elapsed_s\": " << elapsed << ", ";
+    os << "\"audio_s\": " << audio_seconds_ << ", ";
+    os << "\"result_latency_ms\": " << result_latency_ms_.ToJson() << ", ";
+    os << "\"final_latency_ms\": " << final_latency_ms_.ToJson();
+    os << " }";
+
+    fprintf(stdout, "%s\n", os.str().c_str());
+
+    fprintf(stderr, "Streams: %d, failed: %d, max concurrent: %d\n",
+            config_.num_streams, num_failed_, max_concurrent_);
+    fprintf(stderr,
+            "Result latency (ms): p50 %.1f, p90 %.1f, p99 %.1f, max %.1f\n",
+            result_latency_ms_.Percentile(50),
+            result_latency_ms_.Percentile(90),
+            result_latency_ms_.Percentile(99), result_latency_ms_.Max());
+    fprintf(stderr,
+            "Final latency (ms): p50 %.1f, p90 %.1f, p99 %.1f, max %.1f\n",
+            final_latency_ms_.Percentile(50), final_latency_ms_.Percentile(90),
+            final_latency_ms_.Percentile(99), final_latency_ms_.Max());
+  }
+
+ private:
+  using TimePoint = std::chrono::steady_clock::time_point;
+
+  // All methods are called by the thread running io_, so there are no locks
+  struct Stream {
+    const std::string *data;  // samples in the selected format
+    int32_t num_sent_messages = 0;
+    asio::steady_timer timer;
+    TimePoint start_time;
+
+    // Send time of the oldest chunk not followed by a result yet
+    TimePoint pending_since;
+    bool has_pending = false;
+
+    TimePoint done_time;
+    bool finished = false;
+
+    Stream(asio::io_context &io, const std::string *data)  // NOLINT
+        : data(data), timer(io) {}
+  };
+
+  void StartStream() {
+    const std::string *data = &waves_[num_started_ % waves_.size()];
+    auto s = std::make_shared<Stream>(io_, data);
+    ++num_started_;
+
+    websocketpp::lib::error_code ec;
+    client::connection_ptr con = c_.get_connection(uri_.str(), ec);
+    if (ec) {
+      SHERPA_ONNX_LOGE("Could not create connection to %s because %s",
+                       uri_.str().c_str(), ec.message().c_str());
+      SHERPA_ONNX_EXIT(EXIT_FAILURE);
+    }
+
+    con->set_open_handler([this, s](connection_hdl hdl) {
+      ++num_concurrent_;
+      max_concurrent_ = std::max(max_concurrent_, num_concurrent_);
+      s->start_time = std::chrono::steady_clock::now();
+      SendMessage(hdl, s);
+    });
+
+    con->set_message_handler([this, s](connection_hdl hdl, message_ptr msg) {
+      OnMessage(hdl, s, msg);
+    });
+
+    con->set_fail_handler([this, s](connection_hdl /*hdl*/) {
+      ++num_failed_;
+      Finish(s);
+    });
+
+    con->set_close_handler([this, s](connection_hdl /*hdl*/) {
+      --num_concurrent_;
+      if (!s->finished) {
+        ++num_failed_;
+        Finish(s);
+      }
+    });
+
+    c_.connect(con);
+
+    if (num_started_ < config_.num_streams) {
+      arrival_timer_.expires_after(NextArrival());
+      arrival_timer_.async_wait([this](const asio::error_code &ec) {
+        if (!ec) {
+          StartStream();
+        }
+      });
+    }
+  }
+
+  std::chrono::microseconds NextArrival() {
+    if (config_.arrival_rate <= 0) {
+      return std::chrono::microseconds(0);
+    }
+
+    double seconds = 1 / config_.arrival_rate;
+    if (config_.poisson) {
+      std::exponential_distribution<double> d(config_.arrival_rate);
+      seconds = d(rng_);
+    }
+
+    return std::chrono::microseconds(static_cast<int64_t>(seconds * 1e6));
+  }
+
+  int32_t BytesPerSample() const {
+    return config_.sample_format == "int16" ? sizeof(int16_t) : sizeof(float);
+  }
+
+  void SendMessage(connection_hdl hdl, std::shared_ptr<Stream> s) {
+    int32_t bytes_per_message = config_.samples_per_message * BytesPerSample();
+    int64_t offset =
+        static_cast<int64_t>(s->num_sent_messages) * bytes_per_message;
+    int64_t num_bytes = std::min<int64_t>(bytes_per_message,
+                                          s->data->size() - offset);
+
+    websocketpp::lib::error_code ec;
+    if (num_bytes > 0) {
+      c_.send(hdl, s->data->data() + offset, num_bytes,
+              websocketpp::frame::opcode::binary, ec);
+      if (ec) {
+        SHERPA_ONNX_LOGE("Failed to send audio samples because %s",
+                         ec.message().c_str());
+        return;
+      }
+
+      if (!s->has_pending) {
+        s->pending_since = std::chrono::steady_clock::now();
+        s->has_pending = true;
+      }
+
+      ++s->num_sent_messages;
+    }
+
+    if (offset + num_bytes >= static_cast<int64_t>(s->data->size())) {
+      // To signal that we have sent all the messages
+      c_.send(hdl, "Done", websocketpp::frame::opcode::text, ec);
+      if (ec) {
+        SHERPA_ONNX_LOGE("Failed to send Done because %s",
+                         ec.message().c_str());
+      }
+      s->done_time = std::chrono::steady_clock::now();
+      return;
+    }
+
+    // Send the next message in real time, relative to the start of the
+    // stream so that delays do not accumulate
+    s->timer.expires_at(s->start_time +
+                        std::chrono::microseconds(static_cast<int64_t>(
+                            config_.seconds_per_message * 1e6 *
+                            s->num_sent_messages)));
+    s->timer.async_wait([this, hdl, s](const asio::error_code &ec) {
+      if (!ec) {
+        SendMessage(hdl, s);
+      }
+    });
+  }
+
+  void OnMessage(connection_hdl hdl, std::shared_ptr<Stream> s,
+                 message_ptr msg) {
+    auto now = std::chrono::steady_clock::now();
+    const std::string &payload = msg->get_payload();
+
+    if (payload == "Done!") {
+      final_latency_ms_.Record(
+          std::chrono::duration<double, std::milli>(now - s->done_time)
+              .count());
+
+      audio_seconds_ += static_cast<float>(s->data->size()) /
+                        BytesPerSample() / config_.sample_rate;
+
+      Finish(s);
+
+      websocketpp::lib::error_code ec;
+      c_.close(hdl, websocketpp::close::status::normal, "I'm exiting now", ec);
+      if (ec) {
+        SHERPA_ONNX_LOGE("Failed to close because %s", ec.message().c_str());
+      }
+      return;
+    }
+
+    if (s->has_pending) {
+      result_latency_ms_.Record(
+          std::chrono::duration<double, std::milli>(now - s->pending_since)
+              .count());
+      s->has_pending = false;
+    }
+  }
+
+  void Finish(std::shared_ptr<Stream> s) {
+    if (s->finished) {
+      return;
+    }
+
+    s->finished = true;
+    s->timer.cancel();
+
+    ++num_finished_;
+    if (num_finished_ == config_.num_streams) {
+      end_time_ = std::chrono::steady_clock::now();
+    }
+  }
+
+ private:
+  client c_;
+  asio::io_context &io_;
+  LoadTestConfig config_;
+  websocketpp::uri uri_;
+  std::vector<std::string> waves_;
+  asio::steady_timer arrival_timer_;
+  std::mt19937 rng_{20250101};
+
+  TimePoint start_time_;
+  TimePoint end_time_;
+
+  int32_t num_started_ = 0;
+  int32_t num_finished_ = 0;
+  int32_t num_failed_ = 0;
+  int32_t num_concurrent_ = 0;
+  int32_t max_concurrent_ = 0;
+  float audio_seconds_ = 0;
+
+  sherpa_onnx::Histogram result_latency_ms_;
+  sherpa_onnx::Histogram final_latency_ms_;
+};
+
+// Return the samples in the given format
+static std::string EncodeSamples(const std::vector<float> &samples,
+                                 const std::string &sample_format) {
+  std::string data;
+  if (sample_format == "int16") {
+    data.resize(samples.size() * sizeof(int16_t));
+    for (size_t i = 0; i != samples.size(); ++i) {
+      int16_t s = std::max(-1.0f, std::min(samples[i], 1.0f)) * 32767;
+      std::memcpy(&data[i * sizeof(int16_t)], &s, sizeof(int16_t));
+    }
+  } else {
+    data.assign(reinterpret_cast<const char *>(samples.data()),
+                samples.size() * sizeof(float));
+  }
+
+  return data;
+}
+
+int32_t main(int32_t argc, char *argv[]) {
+  LoadTestConfig config;
+  std::string wav_scp;
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+
+  po.Register("server-ip", &config.server_ip,
+              "IP address of the websocket server");
+  po.Register("server-port", &config.server_port,
+              "Port of the websocket server");
+  po.Register("sample-rate", &config.sample_rate,
+              "Sample rate of the input waves. Should be the one expected by "
+              "the server");
+  po.Register("sample-format", &config.sample_format,
+              "Format of the samples sent to the server: float32 or int16");
+  po.Register("samples-per-message", &config.samples_per_message,
+              "Send this number of samples per message.");
+  po.Register("seconds-per-message", &config.seconds_per_message,
+              "Interval between two messages of a stream. Use "
+              "samples-per-message / sample-rate to simulate real time");
+  po.Register("num-streams", &config.num_streams,
+              "Total number of streams to send");
+  po.Register("arrival-rate", &config.arrival_rate,
+              "Number of new streams per second. If 0, all streams are "
+              "started at once");
+  po.Register("poisson-arrivals", &config.poisson,
+              "If true, streams arrive as a Poisson process with "
+              "--arrival-rate. Otherwise, at fixed intervals");
+  po.Register("model", &config.model,
+              "Name of the model to use if the server serves several "
+              "models. If empty, the default model of the server is used");
+  po.Register("wav-scp", &wav_scp,
+              "A file containing the path of a wave file per line. "
+              "Positional arguments are also used as wave files");
+
+  po.Read(argc, argv);
+
+  if (!websocketpp::uri_helper::ipv4_literal(config.server_ip.begin(),
+                                             config.server_ip.end())) {
+    SHERPA_ONNX_LOGE("Invalid server IP: %s", config.server_ip.c_str());
+    return -1;
+  }
+
+  if (config.server_port <= 0 || config.server_port > 65535) {
+    SHERPA_ONNX_LOGE("Invalid server port: %d", config.server_port);
+    return -1;
+  }
+
+  if (config.sample_format != "float32" && config.sample_format != "int16") {
+    SHERPA_ONNX_LOGE("Unsupported --sample-format: %s",
+                     config.sample_format.c_str());
+    return -1;
+  }
+
+  if (config.samples_per_message <= 0 || config.seconds_per_message < 0) {
+    SHERPA_ONNX_LOGE("Invalid --samples-per-message or --seconds-per-message");
+    return -1;
+  }
+
+  if (config.num_streams <= 0 || config.arrival_rate < 0) {
+    SHERPA_ONNX_LOGE("Invalid --num-streams or --arrival-rate");
+    return -1;
+  }
+
+  std::vector<std::string> wave_filenames;
+  for (int32_t i = 1; i <= po.NumArgs(); ++i) {
+    wave_filenames.push_back(po.GetArg(i));
+  }
+
+  if (!wav_scp.empty()) {
+    std::ifstream is(wav_scp);
+    if (!is) {
+      SHERPA_ONNX_LOGE("Failed to open '%s'", wav_scp.c_str());
+      return -1;
+    }
+
+    std::string line;
+    while (std::getline(is, line)) {
+      if (!line.empty()) {
+        wave_filenames.push_back(line);
+      }
+    }
+  }
+
+  if (wave_filenames.empty()) {
+    po.PrintUsage();
+    return -1;
+  }
+
+  std::vector<std::string> waves;
+  for (const auto &filename : wave_filenames) {
+    bool is_ok = false;
+    int32_t actual_sample_rate = -1;
+    std::vector<float> samples =
+        sherpa_onnx::ReadWave(filename, &actual_sample_rate, &is_ok);
+
+    if (!is_ok) {
+      SHERPA_ONNX_LOGE("Failed to read '%s'", filename.c_str());
+      return -1;
+    }
+
+    if (actual_sample_rate != config.sample_rate) {
+      SHERPA_ONNX_LOGE("Expected sample rate: %d, given %d for '%s'",
+                       config.sample_rate, actual_sample_rate,
+                       filename.c_str());
+      return -1;
+    }
+
+    waves.push_back(EncodeSamples(samples, config.sample_format));
+  }
+
+  asio::io_context io_conn;  // for network connections
+  LoadTest load_test(io_conn, config, std::move(waves));
+  load_test.Run();
+
+  io_conn.run();  // will exit when all connections are closed
+
+  load_test.PrintSummary();
+
+  return 0;
+}
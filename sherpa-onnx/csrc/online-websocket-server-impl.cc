@@ -5,17 +5,101 @@
 #include "sherpa-onnx/csrc/online-websocket-server-impl.h"
 #include "sherpa-onnx/csrc/macros.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <functional>
+#include <iomanip>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/log.h"
+#include "sherpa-onnx/csrc/server-utils.h"
+#include "sherpa-onnx/csrc/text-utils.h"
 
 namespace sherpa_onnx {
 
+// Parse the audio format from the resource of a request URI, e.g.,
+// "/?sample_format=int16&sample_rate=8000". Missing fields are left
+// unchanged.
+//
+// @return Return false and set error if a field is invalid.
+static bool ParseAudioFormat(const std::string &resource,
+                             SampleFormat *format, int32_t *sample_rate,
+                             std::string *error) {
+  auto pos = resource.find('?');
+  if (pos == std::string::npos) {
+    return true;
+  }
+
+  std::vector<std::string> fields;
+  SplitStringToVector(resource.substr(pos + 1), "&", true, &fields);
+
+  for (const auto &f : fields) {
+    auto eq = f.find('=');
+    std::string key = f.substr(0, eq);
+    std::string value = eq == std::string::npos ? "" : f.substr(eq + 1);
+
+    if (key == "sample_format") {
+      if (!ParseSampleFormat(value, format)) {
+        *error = "Unsupported sample_format: " + value;
+        return false;
+      }
+    } else if (key == "sample_rate") {
+      if (!ConvertStringToInteger(value, sample_rate) || *sample_rate <= 0) {
+        *error = "Invalid sample_rate: " + value;
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+std::string OnlineWebsocketServerMetrics::ToJson(
+    const std::string &models, const std::string &nodes) const {
+  auto now = std::chrono::steady_clock::now();
+  float uptime =
+      std::chrono::duration_cast<std::chrono::milliseconds>(now - start_time)
+          .count() /
+      1000.;
+
+  std::ostringstream os;
+  os << "{ ";
+  os << "\"uptime_s\": " << std::fixed << std::setprecision(3) << uptime
+     << ", ";
+  os << "\"num_active_connections\": " << num_active_connections.load()
+     << ", ";
+  os << "\"num_connections\": " << num_connections.load() << ", ";
+  os << "\"num_audio_messages\": " << num_audio_messages.load() << ", ";
+  os << "\"num_results\": " << num_results.load() << ", ";
+  os << "\"num_rejected_connections\": " << num_rejected_connections.load()
+     << ", ";
+  os << "\"num_overloaded_connections\": "
+     << num_overloaded_connections.load() << ", ";
+  os << "\"num_idle_connections\": " << num_idle_connections.load() << ", ";
+  os << "\"load\": " << load.load() << ", ";
+  os << "\"result_latency_ms\": " << result_latency_ms.ToJson() << ", ";
+  os << "\"decode_ms\": " << decode_ms.ToJson() << ", ";
+  os << "\"batch_size\": " << batch_size.ToJson() << ", ";
+  os << "\"queue_depth\": " << queue_depth.ToJson();
+  if (!models.empty()) {
+    os << ", \"models\": " << models;
+  }
+  if (!nodes.empty()) {
+    os << ", \"nodes\": " << nodes;
+  }
+  os << " }";
+
+  return os.str();
+}
+
 void OnlineWebsocketDecoderConfig::Register(ParseOptions *po) {
   recognizer_config.Register(po);
 
@@ -27,6 +111,19 @@ void OnlineWebsocketDecoderConfig::Register(ParseOptions *po) {
 
   po->Register("end-tail-padding", &end_tail_padding,
                "It determines the length of tail_padding at the end of audio.");
+
+  po->Register("max-buffered-seconds", &max_buffered_seconds,
+               "A connection is closed with code 1013 (try again later) if "
+               "it has more than this number of seconds of audio that is not "
+               "decoded yet, i.e., if the server cannot keep up with it.");
+
+  po->Register("max-idle-seconds", &max_idle_seconds,
+               "A connection is closed if the server receives nothing from "
+               "it for this number of seconds. 0 means to never close it.");
+
+  po->Register("stream-pool-size", &stream_pool_size,
+               "Max number of streams of closed connections kept for reuse "
+               "by new connections, which saves reallocating model states.");
 }
 
 void OnlineWebsocketDecoderConfig::Validate() const {
@@ -34,37 +131,147 @@ void OnlineWebsocketDecoderConfig::Validate() const {
   SHERPA_ONNX_CHECK_GT(loop_interval_ms, 0);
   SHERPA_ONNX_CHECK_GT(max_batch_size, 0);
   SHERPA_ONNX_CHECK_GT(end_tail_padding, 0);
+  SHERPA_ONNX_CHECK_GT(max_buffered_seconds, 0);
+  SHERPA_ONNX_CHECK_GE(max_idle_seconds, 0);
+  SHERPA_ONNX_CHECK_GE(stream_pool_size, 0);
 }
 
 void OnlineWebsocketServerConfig::Register(sherpa_onnx::ParseOptions *po) {
   decoder_config.Register(po);
+  ort_thread_pool_config.Register(po);
 
   po->Register("log-file", &log_file,
                "Path to the log file. Logs are "
                "appended to this file");
+
+  po->Register("model-name", &model_name,
+               "Name of the model given by the above options. Clients "
+               "select a model with ws://<server>:<port>/?model=<name> or "
+               "with the HTTP header X-Model. Without them, this model "
+               "is used.");
+
+  po->Register("extra-models", &extra_models,
+               "Other models served by this server, in the format "
+               "name1:/path/to/config1.txt,name2:/path/to/config2.txt, "
+               "where each config file contains the model options, e.g., "
+               "--tokens=/path/to/tokens.txt, one per line. All models "
+               "share --num-work-threads, but are batched separately.");
+
+  po->Register("metrics-file", &metrics_file,
+               "If not empty, latency and batching statistics are appended "
+               "to this file as a line of JSON every --metrics-interval-ms "
+               "milliseconds. They are also available at "
+               "http://<server>:<port>/metrics");
+
+  po->Register("metrics-interval-ms", &metrics_interval_ms,
+               "How often to write to --metrics-file");
+
+  po->Register("num-work-threads", &num_work_threads,
+               "Thread pool size for for neural network "
+               "computation and decoding.");
+
+  po->Register("numa", &numa,
+               "If true, load a replica of each model on every NUMA node "
+               "and run --num-work-threads threads per node, pinned to the "
+               "CPUs of the node. New connections go to the node with the "
+               "fewest connections. It is ignored if NUMA information is "
+               "not available.");
+
+  po->Register("max-active-connections", &max_active_connections,
+               "New connections are rejected with HTTP 503 if there are "
+               "this number of active connections. 0 means no limit.");
+
+  po->Register("admission-utilization", &admission_utilization,
+               "If positive, new connections are also rejected with HTTP 503 "
+               "if num_active_connections * RTF / num_work_threads would "
+               "exceed it, where RTF is measured while decoding. The RTF "
+               "is measured per batch, so it is larger at low load with "
+               "small batches. Check the RTF in /metrics under load before "
+               "choosing a value. 0 disables it.");
 }
 
 void OnlineWebsocketServerConfig::Validate() const {
   decoder_config.Validate();
+
+  if (!ort_thread_pool_config.Validate()) {
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  if (model_name.empty()) {
+    SHERPA_ONNX_LOGE("Please provide --model-name");
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  std::vector<std::pair<std::string, std::string>> models;
+  if (!ParseNamedModels(extra_models, &models)) {
+    SHERPA_ONNX_LOGE("Invalid --extra-models: '%s'", extra_models.c_str());
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  for (const auto &m : models) {
+    if (m.first == model_name) {
+      SHERPA_ONNX_LOGE("--extra-models uses the name of --model-name '%s'",
+                       model_name.c_str());
+      SHERPA_ONNX_EXIT(-1);
+    }
+
+    if (!FileExists(m.second)) {
+      SHERPA_ONNX_LOGE("Config file '%s' of model '%s' does not exist",
+                       m.second.c_str(), m.first.c_str());
+      SHERPA_ONNX_EXIT(-1);
+    }
+  }
+
+  if (!metrics_file.empty()) {
+    SHERPA_ONNX_CHECK_GT(metrics_interval_ms, 0);
+  }
+
+  SHERPA_ONNX_CHECK_GT(num_work_threads, 0);
+
+  if (numa && ort_thread_pool_config.enabled) {
+    SHERPA_ONNX_LOGE(
+        "The global onnxruntime thread pool is shared by all NUMA nodes. "
+        "Consider --ort-global-thread-pool=false with --numa=true.");
+  }
+
+  SHERPA_ONNX_CHECK_GE(max_active_connections, 0);
+  SHERPA_ONNX_CHECK_GE(admission_utilization, 0);
 }
 
-OnlineWebsocketDecoder::OnlineWebsocketDecoder(OnlineWebsocketServer *server)
+OnlineWebsocketDecoder::OnlineWebsocketDecoder(
+    OnlineWebsocketServer *server, const OnlineWebsocketDecoderConfig &config,
+    asio::io_context &io_work, int32_t node)
     : server_(server),
-      config_(server->GetConfig().decoder_config),
-      timer_(server->GetWorkContext()) {
+      config_(config),
+      io_work_(io_work),
+      node_(node),
+      timer_(io_work) {
   recognizer_ = std::make_unique<OnlineRecognizer>(config_.recognizer_config);
+  stream_pool_ = std::make_shared<OnlineStreamPool>(recognizer_.get(),
+                                                    config_.stream_pool_size);
 }
 
-std::shared_ptr<Connection> OnlineWebsocketDecoder::GetOrCreateConnection(
+std::shared_ptr<Connection> OnlineWebsocketDecoder::GetConnection(
     connection_hdl hdl) {
   std::lock_guard<std::mutex> lock(mutex_);
   auto it = connections_.find(hdl);
+  return it == connections_.end() ? nullptr : it->second;
+}
+
+std::shared_ptr<Connection> OnlineWebsocketDecoder::GetOrCreateConnection(
+    connection_hdl hdl, SampleFormat format, int32_t sample_rate) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = connections_.find(hdl);
   if (it != connections_.end()) {
     return it->second;
   } else {
     // create a new connection
-    std::shared_ptr<OnlineStream> s = recognizer_->CreateStream();
+    std::shared_ptr<OnlineStream> s = stream_pool_->Get();
     auto c = std::make_shared<Connection>(hdl, s);
+    c->format = format;
+    c->sample_rate = sample_rate > 0
+                         ? sample_rate
+                         : config_.recognizer_config.feat_config.sampling_rate;
     connections_.insert({hdl, c});
     return c;
   }
@@ -72,29 +279,67 @@ std::shared_ptr<Connection> OnlineWebsocketDecoder::GetOrCreateConnection(
 
 void OnlineWebsocketDecoder::AcceptWaveform(std::shared_ptr<Connection> c) {
   std::lock_guard<std::mutex> lock(c->mutex);
-  float sample_rate = config_.recognizer_config.feat_config.sampling_rate;
+  if (!c->samples.empty() && !c->has_pending_audio) {
+    c->pending_arrival = c->samples_arrival;
+    c->has_pending_audio = true;
+  }
+
+  AcceptQueuedSamples(c.get());
+}
+
+void OnlineWebsocketDecoder::AcceptQueuedSamples(Connection *c) {
+  int32_t bytes_per_sample = BytesPerSample(c->format);
   while (!c->samples.empty()) {
-    const auto &s = c->samples.front();
-    c->s->AcceptWaveform(sample_rate, s.data(), s.size());
+    const std::string &s = c->samples.front();
+    const char *p = s.data();
+    int32_t n = s.size();
+
+    // Messages need not end at a sample boundary. Complete the sample
+    // left over from the previous message first
+    if (!c->partial_sample.empty()) {
+      int32_t k = std::min<int32_t>(
+          bytes_per_sample - c->partial_sample.size(), n);
+      c->partial_sample.append(p, k);
+      p += k;
+      n -= k;
+
+      if (static_cast<int32_t>(c->partial_sample.size()) == bytes_per_sample) {
+        c->s->AcceptWaveform(c->sample_rate, c->partial_sample.data(), 1,
+                             c->format);
+        c->partial_sample.clear();
+      }
+    }
+
+    int32_t num_samples = n / bytes_per_sample;
+    if (num_samples > 0) {
+      c->s->AcceptWaveform(c->sample_rate, p, num_samples, c->format);
+    }
+
+    c->partial_sample.append(p + num_samples * bytes_per_sample,
+                             n - num_samples * bytes_per_sample);
+
     c->samples.pop_front();
   }
 }
 
 void OnlineWebsocketDecoder::InputFinished(std::shared_ptr<Connection> c) {
   std::lock_guard<std::mutex> lock(c->mutex);
+  if (!c->samples.empty() && !c->has_pending_audio) {
+    c->pending_arrival = c->samples_arrival;
+    c->has_pending_audio = true;
+  }
 
-  float sample_rate = config_.recognizer_config.feat_config.sampling_rate;
+  AcceptQueuedSamples(c.get());
 
-  while (!c->samples.empty()) {
-    const auto &s = c->samples.front();
-    c->s->AcceptWaveform(sample_rate, s.data(), s.size());
-    c->samples.pop_front();
-  }
+  // An incomplete sample at the end of the input is discarded
+  c->partial_sample.clear();
 
+  // The sample rate must not change within a stream
   std::vector<float> tail_padding(
-      static_cast<int64_t>(config_.end_tail_padding * sample_rate));
+      static_cast<int64_t>(config_.end_tail_padding * c->sample_rate));
 
-  c->s->AcceptWaveform(sample_rate, tail_padding.data(), tail_padding.size());
+  c->s->AcceptWaveform(c->sample_rate, tail_padding.data(),
+                       tail_padding.size());
 
   c->s->InputFinished();
   c->eof = true;
@@ -112,12 +357,45 @@ void OnlineWebsocketDecoder::Run() {
       [this](const asio::error_code &ec) { ProcessConnections(ec); });
 }
 
+float OnlineWebsocketDecoder::Rtf() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (num_decodes_ < kNumRtfWarmupDecodes + kMinNumRtfDecodes) {
+    return 0;
+  }
+
+  return rtf_;
+}
+
+OnlineWebsocketDecoderStats OnlineWebsocketDecoder::GetStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  OnlineWebsocketDecoderStats ans;
+  ans.num_connections = connections_.size();
+  ans.rtf = rtf_;
+  ans.decoded_seconds = decoded_seconds_;
+  ans.num_recycled_streams = stream_pool_->NumRecycled();
+
+  return ans;
+}
+
+bool OnlineWebsocketDecoder::IsOverloaded(const Connection &c) const {
+  float frame_shift = config_.recognizer_config.feat_config.frame_shift_ms;
+
+  float received = static_cast<float>(c.num_received_samples) / c.sample_rate;
+  float decoded = c.num_decoded_frames * frame_shift / 1000;
+
+  return received - decoded > config_.max_buffered_seconds;
+}
+
 void OnlineWebsocketDecoder::ProcessConnections(const asio::error_code &ec) {
   if (ec) {
     SHERPA_ONNX_LOG(FATAL) << "The decoder loop is aborted!";
   }
 
   std::lock_guard<std::mutex> lock(mutex_);
+  auto &metrics = server_->GetMetrics();
+  auto now = std::chrono::steady_clock::now();
+
   std::vector<connection_hdl> to_remove;
   for (auto &p : connections_) {
     auto hdl = p.first;
@@ -135,6 +413,30 @@ void OnlineWebsocketDecoder::ProcessConnections(const asio::error_code &ec) {
       continue;
     }
 
+    if (!c->eof && config_.max_idle_seconds > 0) {
+      std::chrono::steady_clock::time_point last_active;
+      {
+        std::lock_guard<std::mutex> c_lock(c->mutex);
+        last_active = c->last_active;
+      }
+
+      float idle = std::chrono::duration<float>(now - last_active).count();
+      if (idle > config_.max_idle_seconds) {
+        asio::post(server_->GetConnectionContext(), [this, hdl]() {
+          if (server_->Contains(hdl)) {
+            server_->Close(hdl, websocketpp::close::status::normal,
+                           "Idle timeout");
+          }
+        });
+
+        metrics.num_idle_connections += 1;
+
+        // Its stream goes back to the pool once all references are gone
+        to_remove.push_back(hdl);
+        continue;
+      }
+    }
+
     if (!recognizer_->IsReady(c->s.get()) && !c->eof) {
       // this stream has not enough frames to decode, so skip it
       continue;
@@ -143,16 +445,13 @@ void OnlineWebsocketDecoder::ProcessConnections(const asio::error_code &ec) {
     if (!recognizer_->IsReady(c->s.get()) && c->eof) {
       // We won't receive samples from the client, so send a Done! to client
 
-      asio::post(server_->GetWorkContext(),
+      asio::post(io_work_,
                  [this, hdl = c->hdl]() { server_->Send(hdl, "Done!"); });
 
       to_remove.push_back(hdl);
       continue;
     }
 
-    // TODO(fangun): If the connection is timed out, we need to also
-    // add it to `to_remove`
-
     // this stream has enough frames and is currently not processed by any
     // threads, so put it into the ready queue
     ready_connections_.push_back(c);
@@ -165,8 +464,10 @@ void OnlineWebsocketDecoder::ProcessConnections(const asio::error_code &ec) {
     connections_.erase(hdl);
   }
 
+  metrics.queue_depth.Record(ready_connections_.size());
+
   if (!ready_connections_.empty()) {
-    asio::post(server_->GetWorkContext(), [this]() { Decode(); });
+    asio::post(io_work_, [this]() { Decode(); });
   }
 
   // Schedule another call
@@ -199,13 +500,54 @@ void OnlineWebsocketDecoder::Decode() {
     // there are too many ready connections but this thread can only handle
     // max_batch_size connections at a time, so we schedule another call
     // to Decode() and let other threads to process the ready connections
-    asio::post(server_->GetWorkContext(), [this]() { Decode(); });
+    asio::post(io_work_, [this]() { Decode(); });
+  }
+
+  auto &metrics = server_->GetMetrics();
+  metrics.batch_size.Record(s_vec.size());
+
+  // Number of decoded frames of a stream, including those before the last
+  // endpoint
+  auto num_decoded_frames = [](OnlineStream *s) {
+    return s->GetNumFramesSinceStart() + s->GetNumProcessedFrames();
+  };
+
+  int64_t num_frames = 0;
+  for (auto s : s_vec) {
+    num_frames -= num_decoded_frames(s);
   }
 
   lock.unlock();
+  auto start = std::chrono::steady_clock::now();
   recognizer_->DecodeStreams(s_vec.data(), s_vec.size());
+  auto end = std::chrono::steady_clock::now();
   lock.lock();
 
+  float elapsed = std::chrono::duration<float>(end - start).count();
+  metrics.decode_ms.Record(elapsed * 1000);
+
+  for (auto c : c_vec) {
+    int32_t n = num_decoded_frames(c->s.get());
+    c->num_decoded_frames = n;
+    num_frames += n;
+  }
+
+  float audio_seconds = num_frames *
+                        config_.recognizer_config.feat_config.frame_shift_ms /
+                        1000;
+  if (audio_seconds > 0) {
+    num_decodes_ += 1;
+    int32_t k = num_decodes_ - kNumRtfWarmupDecodes;
+    if (k > 0) {
+      // A plain average of the first measurements, so that a single slow
+      // decode does not dominate, and then an exponential moving average
+      float rtf = elapsed / audio_seconds;
+      float alpha = std::max(1.0f / k, 0.05f);
+      rtf_ += alpha * (rtf - rtf_);
+    }
+    decoded_seconds_ += audio_seconds;
+  }
+
   for (auto c : c_vec) {
     auto result = recognizer_->GetResult(c->s.get());
     if (recognizer_->IsEndpoint(c->s.get())) {
@@ -218,6 +560,18 @@ void OnlineWebsocketDecoder::Decode() {
       result.is_eof = true;
     }
 
+    {
+      std::lock_guard<std::mutex> c_lock(c->mutex);
+      if (c->has_pending_audio) {
+        metrics.result_latency_ms.Record(
+            std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - c->pending_arrival)
+                .count());
+        c->has_pending_audio = false;
+      }
+    }
+    metrics.num_results += 1;
+
     asio::post(server_->GetConnectionContext(),
                [this, hdl = c->hdl, str = result.AsJsonString()]() {
                  server_->Send(hdl, str);
@@ -234,11 +588,56 @@ OnlineWebsocketServer::OnlineWebsocketServer(
       io_work_(io_work),
       log_(config.log_file, std::ios::app),
       tee_(std::cout, log_),
-      decoder_(this) {
+      metrics_timer_(io_conn) {
   SetupLog();
 
+  if (config.numa) {
+    nodes_ = GetNumaNodes();
+    if (nodes_.empty()) {
+      SHERPA_ONNX_LOGE("NUMA information is not available. Ignore --numa");
+    }
+  }
+
+  if (nodes_.empty()) {
+    nodes_.resize(1);
+  }
+
+  for (int32_t i = 1; i < NumNodes(); ++i) {
+    node_io_work_.push_back(std::make_unique<asio::io_context>());
+  }
+
+  CreateDecoders(config.model_name, config.decoder_config);
+
+  std::vector<std::pair<std::string, std::string>> models;
+  ParseNamedModels(config.extra_models, &models);  // checked in Validate()
+
+  for (const auto &m : models) {
+    OnlineWebsocketDecoderConfig decoder_config;
+    ReadConfigFromFile(m.second, &decoder_config);
+    decoder_config.Validate();
+
+    SHERPA_ONNX_LOG(INFO) << "Model '" << m.first << "': "
+                          << decoder_config.recognizer_config.ToString()
+                          << "\n";
+
+    CreateDecoders(m.first, decoder_config);
+  }
+
+  if (!config.metrics_file.empty()) {
+    metrics_os_.open(config.metrics_file, std::ios::app);
+    if (!metrics_os_) {
+      SHERPA_ONNX_LOGE("Failed to open '%s'", config.metrics_file.c_str());
+      SHERPA_ONNX_EXIT(-1);
+    }
+  }
+
   server_.init_asio(&io_conn_);
 
+  server_.set_http_handler([this](connection_hdl hdl) { OnHttp(hdl); });
+
+  server_.set_validate_handler(
+      [this](connection_hdl hdl) { return OnValidate(hdl); });
+
   server_.set_open_handler([this](connection_hdl hdl) { OnOpen(hdl); });
 
   server_.set_close_handler([this](connection_hdl hdl) { OnClose(hdl); });
@@ -249,29 +648,285 @@ OnlineWebsocketServer::OnlineWebsocketServer(
       });
 }
 
+void OnlineWebsocketServer::RunOnNode(int32_t node,
+                                      const std::function<void()> &f) {
+  const auto &cpus = nodes_[node].cpus;
+  if (cpus.empty()) {
+    f();
+    return;
+  }
+
+  std::thread t([&cpus, &f]() {
+    if (!SetThreadAffinity(cpus)) {
+      SHERPA_ONNX_LOGE("Failed to pin a thread to CPUs %s",
+                       CpuListToString(cpus).c_str());
+    }
+    f();
+  });
+  t.join();
+}
+
+void OnlineWebsocketServer::CreateDecoders(
+    const std::string &name, const OnlineWebsocketDecoderConfig &config) {
+  auto &decoders = decoders_[name];
+  for (int32_t i = 0; i != NumNodes(); ++i) {
+    // The model weights are allocated in the memory of the node
+    RunOnNode(i, [this, &config, &decoders, i]() {
+      decoders.push_back(std::make_unique<OnlineWebsocketDecoder>(
+          this, config, GetWorkContext(i), i));
+    });
+
+    if (config_.numa) {
+      SHERPA_ONNX_LOGE("Created '%s' on NUMA node %d (CPUs %s)", name.c_str(),
+                       nodes_[i].id, CpuListToString(nodes_[i].cpus).c_str());
+    }
+  }
+}
+
+asio::io_context &OnlineWebsocketServer::GetWorkContext(int32_t node) {
+  return node == 0 ? io_work_ : *node_io_work_[node - 1];
+}
+
 void OnlineWebsocketServer::Run(uint16_t port) {
   server_.set_reuse_addr(true);
   server_.listen(asio::ip::tcp::v4(), port);
   server_.start_accept();
-  auto recognizer_config = config_.decoder_config.recognizer_config;
-  int32_t warm_up = recognizer_config.model_config.warm_up;
-  const std::string &model_type = recognizer_config.model_config.model_type;
-  if (0 < warm_up && warm_up < 100) {
-    if (model_type == "zipformer2") {
-      decoder_.Warmup();
-      SHERPA_ONNX_LOGE("Warm up completed : %d times.", warm_up);
+  for (auto &p : decoders_) {
+    const auto &recognizer_config = p.second[0]->GetConfig().recognizer_config;
+    int32_t warm_up = recognizer_config.model_config.warm_up;
+    const std::string &model_type = recognizer_config.model_config.model_type;
+    if (0 < warm_up && warm_up < 100) {
+      if (model_type == "zipformer2") {
+        for (auto &decoder : p.second) {
+          // So that buffers allocated by warmup are also on the node
+          RunOnNode(decoder->GetNode(), [&decoder]() { decoder->Warmup(); });
+        }
+        SHERPA_ONNX_LOGE("Warm up of '%s' completed : %d times.",
+                         p.first.c_str(), warm_up);
+      } else {
+        SHERPA_ONNX_LOGE("Only Zipformer2 has warmup support for now.");
+        SHERPA_ONNX_LOGE("Given: %s", model_type.c_str());
+        SHERPA_ONNX_EXIT(0);
+      }
+    } else if (warm_up == 0) {
+      SHERPA_ONNX_LOGE("Starting '%s' without warmup!", p.first.c_str());
     } else {
-      SHERPA_ONNX_LOGE("Only Zipformer2 has warmup support for now.");
-      SHERPA_ONNX_LOGE("Given: %s", model_type.c_str());
+      SHERPA_ONNX_LOGE("Invalid Warm up Value!. Expected 0 < warm_up < 100");
       SHERPA_ONNX_EXIT(0);
     }
-  } else if (warm_up == 0) {
-    SHERPA_ONNX_LOGE("Starting without warmup!");
+    for (auto &decoder : p.second) {
+      decoder->Run();
+    }
+  }
+
+  if (metrics_os_.is_open()) {
+    DumpMetrics();
+  }
+}
+
+void OnlineWebsocketServer::DumpMetrics() {
+  metrics_timer_.expires_after(
+      std::chrono::milliseconds(config_.metrics_interval_ms));
+
+  metrics_timer_.async_wait([this](const asio::error_code &ec) {
+    if (ec) {
+      return;
+    }
+
+    metrics_os_ << MetricsJson() << std::endl;
+    DumpMetrics();
+  });
+}
+
+std::string OnlineWebsocketServer::MetricsJson() {
+  metrics_.load = EstimateLoad();
+
+  float uptime = std::chrono::duration<float>(
+                     std::chrono::steady_clock::now() - metrics_.start_time)
+                     .count();
+
+  std::vector<OnlineWebsocketDecoderStats> node_stats(NumNodes());
+
+  std::ostringstream models;
+  models << std::fixed << std::setprecision(3);
+  models << "{ ";
+  std::string sep;
+  for (auto &p : decoders_) {
+    // Sum over the replicas of the model
+    OnlineWebsocketDecoderStats stats;
+    int32_t num_measured = 0;
+    for (auto &decoder : p.second) {
+      auto s = decoder->GetStats();
+      stats.num_connections += s.num_connections;
+      stats.decoded_seconds += s.decoded_seconds;
+      stats.num_recycled_streams += s.num_recycled_streams;
+      if (s.rtf > 0) {
+        stats.rtf += s.rtf;
+        num_measured += 1;
+      }
+
+      auto &n = node_stats[decoder->GetNode()];
+      n.num_connections += s.num_connections;
+      n.decoded_seconds += s.decoded_seconds;
+    }
+
+    if (num_measured > 0) {
+      stats.rtf /= num_measured;
+    }
+
+    models << sep << "\"" << p.first << "\": { ";
+    models << "\"num_connections\": " << stats.num_connections << ", ";
+    models << "\"rtf\": " << stats.rtf << ", ";
+    models << "\"decoded_seconds\": " << stats.decoded_seconds << ", ";
+    models << "\"num_recycled_streams\": " << stats.num_recycled_streams;
+    models << " }";
+    sep = ", ";
+  }
+  models << " }";
+
+  if (!config_.numa) {
+    return metrics_.ToJson(models.str());
+  }
+
+  std::ostringstream nodes;
+  nodes << std::fixed << std::setprecision(3);
+  nodes << "[ ";
+  sep.clear();
+  for (int32_t i = 0; i != NumNodes(); ++i) {
+    const auto &n = node_stats[i];
+
+    nodes << sep << "{ ";
+    nodes << "\"node\": " << nodes_[i].id << ", ";
+    nodes << "\"cpus\": \"" << CpuListToString(nodes_[i].cpus) << "\", ";
+    nodes << "\"num_connections\": " << n.num_connections << ", ";
+    nodes << "\"decoded_seconds\": " << n.decoded_seconds << ", ";
+    // Seconds of audio decoded per second
+    nodes << "\"throughput\": "
+          << (uptime > 0 ? n.decoded_seconds / uptime : 0);
+    nodes << " }";
+    sep = ", ";
+  }
+  nodes << " ]";
+
+  return metrics_.ToJson(models.str(), nodes.str());
+}
+
+OnlineWebsocketDecoder *OnlineWebsocketServer::SelectDecoder(
+    connection_hdl hdl, std::string *error) {
+  auto con = server_.get_con_from_hdl(hdl);
+
+  std::string name = con->get_request_header("X-Model");
+  if (name.empty()) {
+    name = GetQueryValue(con->get_resource(), "model");
+  }
+
+  if (name.empty()) {
+    name = config_.model_name;
+  }
+
+  auto it = decoders_.find(name);
+  if (it == decoders_.end()) {
+    *error = "Unknown model: " + name;
+    return nullptr;
+  }
+
+  const auto &decoders = it->second;
+  if (decoders.size() == 1) {
+    return decoders[0].get();
+  }
+
+  // Use the node with the fewest connections of all models
+  std::vector<int32_t> counts(NumNodes());
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &p : connections_) {
+      counts[p.second->GetNode()] += 1;
+    }
+  }
+
+  int32_t node = std::min_element(counts.begin(), counts.end()) -
+                 counts.begin();
+
+  return decoders[node].get();
+}
+
+OnlineWebsocketDecoder *OnlineWebsocketServer::GetDecoder(
+    connection_hdl hdl) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = connections_.find(hdl);
+  return it == connections_.end() ? nullptr : it->second;
+}
+
+float OnlineWebsocketServer::EstimateLoad() const {
+  // Copy the counts so that we don't hold mutex_ while locking a decoder,
+  // which calls Contains() with its own mutex locked
+  std::map<OnlineWebsocketDecoder *, int32_t> counts;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &p : connections_) {
+      counts[p.second] += 1;
+    }
+  }
+
+  float load = 0;
+  for (const auto &p : counts) {
+    load += p.second * p.first->Rtf();
+  }
+
+  return load / (config_.num_work_threads * NumNodes());
+}
+
+bool OnlineWebsocketServer::OnValidate(connection_hdl hdl) {
+  auto con = server_.get_con_from_hdl(hdl);
+
+  std::string error;
+  OnlineWebsocketDecoder *decoder = SelectDecoder(hdl, &error);
+  if (!decoder) {
+    con->set_status(websocketpp::http::status_code::not_found);
+    con->set_body(error);
+    return false;
+  }
+
+  int32_t n = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    n = connections_.size();
+  }
+
+  bool accept = config_.max_active_connections == 0 ||
+                n < config_.max_active_connections;
+
+  if (accept && config_.admission_utilization > 0) {
+    // Load after accepting this connection
+    float load = EstimateLoad() +
+                 decoder->Rtf() / (config_.num_work_threads * NumNodes());
+    accept = load <= config_.admission_utilization;
+  }
+
+  if (accept) {
+    return true;
+  }
+
+  metrics_.num_rejected_connections += 1;
+
+  con->set_status(websocketpp::http::status_code::service_unavailable);
+  con->append_header("Retry-After", "1");
+  con->set_body("Server is overloaded. Please try again later.");
+
+  return false;
+}
+
+void OnlineWebsocketServer::OnHttp(connection_hdl hdl) {
+  auto con = server_.get_con_from_hdl(hdl);
+
+  if (con->get_resource() == "/metrics") {
+    con->set_body(MetricsJson());
+    con->append_header("Content-Type", "application/json");
+    con->set_status(websocketpp::http::status_code::ok);
   } else {
-    SHERPA_ONNX_LOGE("Invalid Warm up Value!. Expected 0 < warm_up < 100");
-    SHERPA_ONNX_EXIT(0);
+    con->set_body("Not found");
+    con->set_status(websocketpp::http::status_code::not_found);
   }
-  decoder_.Run();
 }
 
 void OnlineWebsocketServer::SetupLog() {
@@ -297,19 +952,45 @@ void OnlineWebsocketServer::Send(connection_hdl hdl, const std::string &text) {
 }
 
 void OnlineWebsocketServer::OnOpen(connection_hdl hdl) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  connections_.insert(hdl);
+  SampleFormat format = SampleFormat::kFloat32;
+  int32_t sample_rate = 0;
+  std::string error;
+  if (!ParseAudioFormat(server_.get_con_from_hdl(hdl)->get_resource(), &format,
+                        &sample_rate, &error)) {
+    Close(hdl, websocketpp::close::status::invalid_payload, error);
+    return;
+  }
+
+  // It has been checked in OnValidate()
+  OnlineWebsocketDecoder *decoder = SelectDecoder(hdl, &error);
+
+  // Insert it before creating the stream so that the decoder loop does
+  // not drop the new connection
+  int32_t n = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    connections_.insert({hdl, decoder});
+    n = connections_.size();
+  }
+
+  // Don't hold mutex_ here. The decoder loop calls Contains() with the
+  // mutex of the decoder locked.
+  decoder->GetOrCreateConnection(hdl, format, sample_rate);
+
+  metrics_.num_active_connections = n;
+  metrics_.num_connections += 1;
 
   std::ostringstream os;
   os << "New connection: "
      << server_.get_con_from_hdl(hdl)->get_remote_endpoint() << ". "
-     << "Number of active connections: " << connections_.size() << ".\n";
+     << "Number of active connections: " << n << ".\n";
   SHERPA_ONNX_LOG(INFO) << os.str();
 }
 
 void OnlineWebsocketServer::OnClose(connection_hdl hdl) {
   std::lock_guard<std::mutex> lock(mutex_);
   connections_.erase(hdl);
+  metrics_.num_active_connections = connections_.size();
 
   SHERPA_ONNX_LOG(INFO) << "Number of active connections: "
                         << connections_.size() << "\n";
@@ -322,27 +1003,61 @@ bool OnlineWebsocketServer::Contains(connection_hdl hdl) const {
 
 void OnlineWebsocketServer::OnMessage(connection_hdl hdl,
                                       server::message_ptr msg) {
-  auto c = decoder_.GetOrCreateConnection(hdl);
+  OnlineWebsocketDecoder *decoder = GetDecoder(hdl);
+  if (!decoder) {
+    // It was rejected in OnOpen()
+    return;
+  }
+
+  auto c = decoder->GetConnection(hdl);
+  if (!c) {
+    // The connection was created in OnOpen(). It is gone if the stream has
+    // finished or the connection has been removed, so a late message
+    // must not create a new stream for it.
+    return;
+  }
 
   const std::string &payload = msg->get_payload();
 
   switch (msg->get_opcode()) {
     case websocketpp::frame::opcode::text:
       if (payload == "Done") {
-        asio::post(io_work_, [this, c]() { decoder_.InputFinished(c); });
+        asio::post(decoder->GetWorkContext(),
+                   [decoder, c]() { decoder->InputFinished(c); });
       }
       break;
     case websocketpp::frame::opcode::binary: {
-      auto p = reinterpret_cast<const float *>(payload.data());
-      int32_t num_samples = payload.size() / sizeof(float);
-      std::vector<float> samples(p, p + num_samples);
+      // The samples are moved out of the message without a copy and
+      // are converted to float by a work thread
+      if (c->overloaded) {
+        break;
+      }
+
+      std::string samples = std::move(msg->get_raw_payload());
+      c->num_received_samples += samples.size() / BytesPerSample(c->format);
+
+      if (decoder->IsOverloaded(*c)) {
+        // Reject it explicitly instead of letting the latency grow for
+        // all clients
+        c->overloaded = true;
+        metrics_.num_overloaded_connections += 1;
+        Close(hdl, websocketpp::close::status::try_again_later,
+              "Server is overloaded. Please try again later.");
+        break;
+      }
 
       {
         std::lock_guard<std::mutex> lock(c->mutex);
+        c->last_active = std::chrono::steady_clock::now();
+        if (c->samples.empty()) {
+          c->samples_arrival = c->last_active;
+        }
         c->samples.push_back(std::move(samples));
       }
+      metrics_.num_audio_messages += 1;
 
-      asio::post(io_work_, [this, c]() { decoder_.AcceptWaveform(c); });
+      asio::post(decoder->GetWorkContext(),
+                 [decoder, c]() { decoder->AcceptWaveform(c); });
       break;
     }
     default:
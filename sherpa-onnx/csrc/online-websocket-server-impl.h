@@ -5,8 +5,11 @@
 #ifndef SHERPA_ONNX_CSRC_ONLINE_WEBSOCKET_SERVER_IMPL_H_
 #define SHERPA_ONNX_CSRC_ONLINE_WEBSOCKET_SERVER_IMPL_H_
 
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <deque>
 #include <fstream>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -17,9 +20,14 @@
 #include <vector>
 
 #include "asio.hpp"  // NOLINT
+#include "sherpa-onnx/csrc/histogram.h"
+#include "sherpa-onnx/csrc/numa.h"
 #include "sherpa-onnx/csrc/online-recognizer.h"
+#include "sherpa-onnx/csrc/online-stream-pool.h"
 #include "sherpa-onnx/csrc/online-stream.h"
+#include "sherpa-onnx/csrc/ort-thread-pool-config.h"
 #include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/sample-format.h"
 #include "sherpa-onnx/csrc/tee-stream.h"
 #include "websocketpp/config/asio_no_tls.hpp"  // TODO(fangjun): support TLS
 #include "websocketpp/server.hpp"
@@ -36,24 +44,101 @@ struct Connection {
   // set it to true when InputFinished() is called
   bool eof = false;
 
-  // The last time we received a message from the client
-  // TODO(fangjun): Use it to disconnect from a client if it is inactive
-  // for a specified time.
+  // The last time we received a message from the client. The connection
+  // is closed if it is inactive for --max-idle-seconds.
+  // It is protected by `mutex`.
   std::chrono::steady_clock::time_point last_active;
 
-  std::mutex mutex;  // protect samples
+  // Format and sample rate of the audio sent by the client. They are
+  // selected by the query of the request URI, e.g.,
+  // ws://localhost:6006/?sample_format=mulaw&sample_rate=8000
+  // The default is float32 at the sample rate of the model.
+  SampleFormat format = SampleFormat::kFloat32;
+  int32_t sample_rate = 16000;
 
-  // Audio samples received from the client.
+  std::mutex mutex;  // protect samples and last_active
+
+  // Audio samples received from the client, as raw bytes in `format`.
   //
   // The I/O threads receive audio samples into this queue
-  // and invoke work threads to compute features
-  std::deque<std::vector<float>> samples;
+  // and invoke work threads to convert them and compute features
+  std::deque<std::string> samples;
+
+  // Leading bytes of a sample that is split across two messages, e.g.,
+  // a message of 3 bytes with int16 samples. It is used only by work
+  // threads.
+  std::string partial_sample;
+
+  // Arrival time of samples.front()
+  std::chrono::steady_clock::time_point samples_arrival;
+
+  // Arrival time of the oldest audio chunk that has been accepted by `s`
+  // but is not covered by a result sent to the client yet.
+  // It is valid only if has_pending_audio is true.
+  std::chrono::steady_clock::time_point pending_arrival;
+  bool has_pending_audio = false;
+
+  // Number of samples received from the client and number of feature frames
+  // decoded so far. The difference is the audio buffered for this
+  // connection, which is bounded by --max-buffered-seconds.
+  std::atomic<int64_t> num_received_samples{0};
+  std::atomic<int32_t> num_decoded_frames{0};
+
+  // Set to true when the connection is closed since it falls too far behind
+  std::atomic<bool> overloaded{false};
 
   Connection() = default;
   Connection(connection_hdl hdl, std::shared_ptr<OnlineStream> s)
       : hdl(hdl), s(s), last_active(std::chrono::steady_clock::now()) {}
 };
 
+// Statistics of the server, for sizing deployments.
+// All members are thread-safe.
+struct OnlineWebsocketServerMetrics {
+  std::chrono::steady_clock::time_point start_time =
+      std::chrono::steady_clock::now();
+
+  std::atomic<int64_t> num_active_connections{0};
+  std::atomic<int64_t> num_connections{0};
+  std::atomic<int64_t> num_audio_messages{0};
+  std::atomic<int64_t> num_results{0};
+
+  // Connections rejected by admission control
+  std::atomic<int64_t> num_rejected_connections{0};
+
+  // Connections closed since they have too much unprocessed audio
+  std::atomic<int64_t> num_overloaded_connections{0};
+
+  // Connections closed since they are inactive for too long
+  std::atomic<int64_t> num_idle_connections{0};
+
+  // Fraction of the work threads needed to decode all active connections
+  // in real time, estimated from the RTF measured for each model
+  std::atomic<float> load{0};
+
+  // Time from the arrival of an audio chunk to the emission of the first
+  // result that includes it
+  Histogram result_latency_ms{ExponentialBuckets(1, 2, 15)};
+
+  // Time of one OnlineRecognizer::DecodeStreams() call
+  Histogram decode_ms{ExponentialBuckets(1, 2, 12)};
+
+  // Number of streams in one OnlineRecognizer::DecodeStreams() call
+  Histogram batch_size{ExponentialBuckets(1, 2, 8)};
+
+  // Number of streams waiting for decoding, sampled at each decoder loop
+  Histogram queue_depth{{0, 1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024}};
+
+  /*
+   * @param models If not empty, it is a JSON object with statistics of each
+   *               model and is included as the field "models".
+   * @param nodes  If not empty, it is a JSON array with statistics of each
+   *               NUMA node and is included as the field "nodes".
+   */
+  std::string ToJson(const std::string &models = "",
+                     const std::string &nodes = "") const;
+};
+
 struct OnlineWebsocketDecoderConfig {
   OnlineRecognizerConfig recognizer_config;
 
@@ -64,20 +149,52 @@ struct OnlineWebsocketDecoderConfig {
 
   float end_tail_padding = 0.8;
 
+  // A connection is closed if it has more than this number of seconds of
+  // audio that is not decoded yet
+  float max_buffered_seconds = 10;
+
+  // A connection is closed if we receive nothing from it for this number
+  // of seconds. 0 means to never close it.
+  float max_idle_seconds = 300;
+
+  // Max number of free streams kept for reuse by new connections
+  int32_t stream_pool_size = 100;
+
   void Register(ParseOptions *po);
   void Validate() const;
 };
 
+struct OnlineWebsocketDecoderStats {
+  int32_t num_connections = 0;
+  float rtf = 0;
+  double decoded_seconds = 0;
+  int64_t num_recycled_streams = 0;
+};
+
 class OnlineWebsocketServer;
 
 class OnlineWebsocketDecoder {
  public:
   /**
    * @param server  Not owned.
+   * @param config  Configuration of the model served by this decoder.
+   * @param io_work The work threads that run this decoder.
+   * @param node    Index of the NUMA node of io_work. 0 if NUMA is not used.
    */
-  explicit OnlineWebsocketDecoder(OnlineWebsocketServer *server);
+  OnlineWebsocketDecoder(OnlineWebsocketServer *server,
+                         const OnlineWebsocketDecoderConfig &config,
+                         asio::io_context &io_work,  // NOLINT
+                         int32_t node);
+
+  // Return nullptr if hdl has no connection, e.g., it has finished or has
+  // been removed.
+  std::shared_ptr<Connection> GetConnection(connection_hdl hdl);
 
-  std::shared_ptr<Connection> GetOrCreateConnection(connection_hdl hdl);
+  // A new connection uses the given audio format. If sample_rate is 0, the
+  // sample rate of the model is used.
+  std::shared_ptr<Connection> GetOrCreateConnection(connection_hdl hdl,
+                                                    SampleFormat format,
+                                                    int32_t sample_rate);
 
   // Compute features for a stream given audio samples
   void AcceptWaveform(std::shared_ptr<Connection> c);
@@ -89,9 +206,26 @@ class OnlineWebsocketDecoder {
 
   void Run();
 
+  const OnlineWebsocketDecoderConfig &GetConfig() const { return config_; }
+  asio::io_context &GetWorkContext() { return io_work_; }
+  int32_t GetNode() const { return node_; }
+
+  // Return the measured decoding time per second of audio of a stream.
+  // Return 0 if there are not enough measurements yet.
+  float Rtf();
+
+  OnlineWebsocketDecoderStats GetStats();
+
+  // Return true if the audio buffered for the connection exceeds
+  // --max-buffered-seconds
+  bool IsOverloaded(const Connection &c) const;
+
  private:
   void ProcessConnections(const asio::error_code &ec);
 
+  // Pass all queued messages of c to its stream. c->mutex must be held.
+  void AcceptQueuedSamples(Connection *c);
+
   /** It is called by one of the worker thread.
    */
   void Decode();
@@ -99,7 +233,10 @@ class OnlineWebsocketDecoder {
  private:
   OnlineWebsocketServer *server_;  // not owned
   std::unique_ptr<OnlineRecognizer> recognizer_;
+  std::shared_ptr<OnlineStreamPool> stream_pool_;
   OnlineWebsocketDecoderConfig config_;
+  asio::io_context &io_work_;
+  int32_t node_;
   asio::steady_timer timer_;
 
   // It protects `connections_`, `ready_connections_`, and `active_`
@@ -116,13 +253,74 @@ class OnlineWebsocketDecoder {
   // If we are decoding a stream, we put it in the active_ set so that
   // only one thread can decode a stream at a time.
   std::set<connection_hdl, std::owner_less<connection_hdl>> active_;
+
+  // The first decodes include the first-run cost of onnxruntime and are
+  // not used to measure the RTF
+  static constexpr int32_t kNumRtfWarmupDecodes = 10;
+
+  // Rtf() returns 0 until the RTF is averaged over this many decodes
+  static constexpr int32_t kMinNumRtfDecodes = 20;
+
+  // Average of the decoding time per second of audio of a stream over the
+  // first kMinNumRtfDecodes measured decodes and an exponential moving
+  // average afterwards. It is protected by mutex_
+  float rtf_ = 0;
+
+  // Number of decodes so far, including the warmup ones. It is protected
+  // by mutex_
+  int32_t num_decodes_ = 0;
+
+  // Seconds of audio decoded so far. It is protected by mutex_
+  double decoded_seconds_ = 0;
 };
 
 struct OnlineWebsocketServerConfig {
   OnlineWebsocketDecoderConfig decoder_config;
 
+  // Thread pools of onnxruntime shared by all models of the server
+  OrtThreadPoolConfig ort_thread_pool_config;
+
   std::string log_file = "./log.txt";
 
+  // Name of the model given by decoder_config. Clients select a model with
+  // the query of the request URI, e.g., ws://localhost:6006/?model=en, or
+  // with the HTTP header X-Model. The default is this one.
+  std::string model_name = "default";
+
+  // Other models served by the same process, in the format
+  //   name1:/path/to/config1.txt,name2:/path/to/config2.txt
+  // where each config file contains the options of the model, e.g.,
+  // --tokens, --encoder, and --max-batch-size, one per line.
+  // All models share the work threads, but are batched separately.
+  std::string extra_models;
+
+  // If not empty, metrics are appended to this file as a line of JSON
+  // every metrics_interval_ms milliseconds.
+  // They are also available via HTTP GET /metrics.
+  std::string metrics_file;
+
+  int32_t metrics_interval_ms = 10000;
+
+  // Size of the thread pool for neural network computation and decoding.
+  // With numa, it is the size of the pool of each NUMA node.
+  int32_t num_work_threads = 3;
+
+  // If true, each NUMA node has a replica of every model, created on the
+  // node, and num_work_threads threads pinned to the CPUs of the node.
+  // A new connection is served by the node with the fewest connections.
+  bool numa = false;
+
+  // New connections are rejected with 503 if there are this many active
+  // connections. 0 means no static limit.
+  int32_t max_active_connections = 0;
+
+  // If positive, new connections are also rejected once the measured
+  // decoding load, i.e., num_active_connections * RTF / num_work_threads,
+  // would exceed it. It is disabled by default since the RTF measured at
+  // small batch sizes, i.e., at low load, overstates the cost of a
+  // connection at high load.
+  float admission_utilization = 0;
+
   void Register(sherpa_onnx::ParseOptions *po);
   void Validate() const;
 };
@@ -137,16 +335,66 @@ class OnlineWebsocketServer {
 
   const OnlineWebsocketServerConfig &GetConfig() const { return config_; }
   asio::io_context &GetConnectionContext() { return io_conn_; }
-  asio::io_context &GetWorkContext() { return io_work_; }
+
+  // Number of NUMA nodes used. It is 1 if --numa is false.
+  int32_t NumNodes() const { return nodes_.size(); }
+
+  // Work threads of the given node run this context. Node 0 uses the
+  // io_work passed to the constructor.
+  asio::io_context &GetWorkContext(int32_t node);
+
+  // CPUs to pin the work threads of the given node to. Empty means
+  // no pinning.
+  const std::vector<int32_t> &GetNodeCpus(int32_t node) const {
+    return nodes_[node].cpus;
+  }
   server &GetServer() { return server_; }
+  OnlineWebsocketServerMetrics &GetMetrics() { return metrics_; }
+
+  // Metrics of the server and of each model as JSON
+  std::string MetricsJson();
 
   void Send(connection_hdl hdl, const std::string &text);
 
   bool Contains(connection_hdl hdl) const;
 
+  // Close a websocket connection with given code and reason
+  void Close(connection_hdl hdl, websocketpp::close::status::value code,
+             const std::string &reason);
+
  private:
   void SetupLog();
 
+  // Schedule the next write to config_.metrics_file
+  void DumpMetrics();
+
+  // Serve GET /metrics. Other HTTP requests get 404.
+  void OnHttp(connection_hdl hdl);
+
+  // Select a model and apply admission control.
+  // Return false to reject a new connection with 404 or 503.
+  bool OnValidate(connection_hdl hdl);
+
+  // Run f on a thread pinned to the CPUs of the node, so that the memory
+  // it touches first is allocated on the node. It returns when f returns.
+  void RunOnNode(int32_t node, const std::function<void()> &f);
+
+  // Create a decoder of the model for each node
+  void CreateDecoders(const std::string &name,
+                      const OnlineWebsocketDecoderConfig &config);
+
+  // Return the decoder of the requested model on the node with the
+  // fewest connections.
+  // Return nullptr and set error if the requested model does not exist.
+  OnlineWebsocketDecoder *SelectDecoder(connection_hdl hdl,
+                                        std::string *error);
+
+  // Return the decoder of a connection, or nullptr if it is closed
+  OnlineWebsocketDecoder *GetDecoder(connection_hdl hdl) const;
+
+  // Return the value of OnlineWebsocketServerMetrics::load
+  float EstimateLoad() const;
+
   // When a websocket client is connected, it will invoke this method
   // (Not for HTTP)
   void OnOpen(connection_hdl hdl);
@@ -156,10 +404,6 @@ class OnlineWebsocketServer {
 
   void OnMessage(connection_hdl hdl, server::message_ptr msg);
 
-  // Close a websocket connection with given code and reason
-  void Close(connection_hdl hdl, websocketpp::close::status::value code,
-             const std::string &reason);
-
  private:
   OnlineWebsocketServerConfig config_;
   asio::io_context &io_conn_;
@@ -169,11 +413,27 @@ class OnlineWebsocketServer {
   std::ofstream log_;
   sherpa_onnx::TeeStream tee_;
 
-  OnlineWebsocketDecoder decoder_;
+  OnlineWebsocketServerMetrics metrics_;
+  std::ofstream metrics_os_;
+  asio::steady_timer metrics_timer_;
+
+  // The NUMA nodes used. There is a single node with no CPUs if --numa
+  // is false.
+  std::vector<NumaNode> nodes_;
+
+  // Work contexts of nodes 1, 2, ...
+  std::vector<std::unique_ptr<asio::io_context>> node_io_work_;
+
+  // model name -> decoder of each node
+  std::map<std::string, std::vector<std::unique_ptr<OnlineWebsocketDecoder>>>
+      decoders_;
 
   mutable std::mutex mutex_;
 
-  std::set<connection_hdl, std::owner_less<connection_hdl>> connections_;
+  // connection -> decoder of the model it uses
+  std::map<connection_hdl, OnlineWebsocketDecoder *,
+           std::owner_less<connection_hdl>>
+      connections_;
 };
 
 }  // namespace sherpa_onnx
@@ -6,8 +6,10 @@
 
 #include "asio.hpp"  // NOLINT
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/numa.h"
 #include "sherpa-onnx/csrc/online-websocket-server-impl.h"
 #include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/session.h"
 
 static constexpr const char *kUsageMessage = R"(
 Automatic speech recognition with sherpa-onnx using websocket.
@@ -27,6 +29,25 @@ Usage:
   --max-batch-size=5 \
   --loop-interval-ms=10
 
+Latency, batch size and queue depth statistics are available at
+http://localhost:6006/metrics as JSON. Use --metrics-file=./metrics.jsonl
+to also append them to a file periodically.
+
+To serve several models from one process, give the other models with
+--extra-models=zh:/path/to/zh.txt, where zh.txt contains the model options,
+e.g., --tokens=/path/to/tokens.txt, one per line. Clients select a model with
+ws://localhost:6006/?model=zh or with the HTTP header X-Model. Requests
+without a model use the model named by --model-name.
+
+Use --ort-global-thread-pool=true to let all models share one set of
+onnxruntime thread pools of --ort-intra-op-num-threads threads instead of
+creating --num-threads threads per model session.
+
+On servers with several NUMA nodes, use --numa=true to load a replica of
+each model on every node and run --num-work-threads threads per node,
+pinned to the CPUs of the node. The metrics then include the connections
+and the decoded audio per second of each node.
+
 Please refer to
 https://k2-fsa.github.io/sherpa/onnx/pretrained_models/index.html
 for a list of pre-trained models to download.
@@ -43,16 +64,9 @@ int32_t main(int32_t argc, char *argv[]) {
   // size of the thread pool for handling network connections
   int32_t num_io_threads = 1;
 
-  // size of the thread pool for neural network computation and decoding
-  int32_t num_work_threads = 3;
-
   po.Register("num-io-threads", &num_io_threads,
               "Thread pool size for network connections.");
 
-  po.Register("num-work-threads", &num_work_threads,
-              "Thread pool size for for neural network "
-              "computation and decoding.");
-
   po.Register("port", &port, "The port on which the server will listen.");
 
   config.Register(&po);
@@ -72,6 +86,9 @@ int32_t main(int32_t argc, char *argv[]) {
 
   config.Validate();
 
+  // It must be called before the models are created
+  sherpa_onnx::InitGlobalThreadPool(config.ort_thread_pool_config);
+
   asio::io_context io_conn;  // for network connections
   asio::io_context io_work;  // for neural network and decoding
 
@@ -80,10 +97,15 @@ int32_t main(int32_t argc, char *argv[]) {
 
   SHERPA_ONNX_LOGE("Started!");
   SHERPA_ONNX_LOGE("Listening on: %d", port);
-  SHERPA_ONNX_LOGE("Number of work threads: %d", num_work_threads);
-
-  // give some work to do for the io_work pool
-  auto work_guard = asio::make_work_guard(io_work);
+  SHERPA_ONNX_LOGE("Number of work threads: %d", config.num_work_threads);
+  SHERPA_ONNX_LOGE("Number of NUMA nodes: %d", server.NumNodes());
+
+  // give some work to do for the io_work pool of each node
+  std::vector<asio::executor_work_guard<asio::io_context::executor_type>>
+      work_guards;
+  for (int32_t n = 0; n != server.NumNodes(); ++n) {
+    work_guards.push_back(asio::make_work_guard(server.GetWorkContext(n)));
+  }
 
   std::vector<std::thread> io_threads;
 
@@ -93,8 +115,16 @@ int32_t main(int32_t argc, char *argv[]) {
   }
 
   std::vector<std::thread> work_threads;
-  for (int32_t i = 0; i < num_work_threads; ++i) {
-    work_threads.emplace_back([&io_work]() { io_work.run(); });
+  for (int32_t n = 0; n != server.NumNodes(); ++n) {
+    for (int32_t i = 0; i < config.num_work_threads; ++i) {
+      work_threads.emplace_back([&server, n]() {
+        const auto &cpus = server.GetNodeCpus(n);
+        if (!cpus.empty()) {
+          sherpa_onnx::SetThreadAffinity(cpus);
+        }
+        server.GetWorkContext(n).run();
+      });
+    }
   }
 
   io_conn.run();
@@ -0,0 +1,102 @@
+// sherpa-onnx/csrc/onnx-utils-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/onnx-utils.h"
+
+#include <array>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+static Ort::Value CreateFloat(OrtAllocator *allocator,
+                              const std::vector<int64_t> &shape, float start) {
+  Ort::Value v =
+      Ort::Value::CreateTensor<float>(allocator, shape.data(), shape.size());
+  auto n = v.GetTensorTypeAndShapeInfo().GetElementCount();
+  float *p = v.GetTensorMutableData<float>();
+  std::iota(p, p + n, start);
+  return v;
+}
+
+TEST(CopyInPlace, Copy) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  Ort::Value src = CreateFloat(allocator, {2, 3}, 0);
+  Ort::Value dst = CreateFloat(allocator, {2, 3}, 100);
+  const float *buffer = dst.GetTensorData<float>();
+
+  EXPECT_TRUE(CopyInPlace(src, &dst));
+
+  // The buffer of dst is reused
+  EXPECT_EQ(dst.GetTensorData<float>(), buffer);
+  for (int32_t i = 0; i != 6; ++i) {
+    EXPECT_EQ(buffer[i], i);
+  }
+}
+
+TEST(CopyInPlace, Mismatch) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  Ort::Value src = CreateFloat(allocator, {2, 3}, 0);
+
+  // Same number of elements but a different shape
+  Ort::Value dst = CreateFloat(allocator, {3, 2}, 100);
+  EXPECT_FALSE(CopyInPlace(src, &dst));
+  EXPECT_EQ(dst.GetTensorData<float>()[0], 100);
+
+  // Same shape but a different element type
+  std::array<int64_t, 2> shape{2, 3};
+  Ort::Value i32 = Ort::Value::CreateTensor<int32_t>(allocator, shape.data(),
+                                                     shape.size());
+  i32.GetTensorMutableData<int32_t>()[0] = 100;
+  EXPECT_FALSE(CopyInPlace(src, &i32));
+  EXPECT_EQ(i32.GetTensorData<int32_t>()[0], 100);
+
+  // If one tensor of a list does not match, none of them is copied
+  std::vector<Ort::Value> srcs;
+  srcs.push_back(CreateFloat(allocator, {2}, 0));
+  srcs.push_back(CreateFloat(allocator, {2, 3}, 0));
+
+  std::vector<Ort::Value> dsts;
+  dsts.push_back(CreateFloat(allocator, {2}, 100));
+  dsts.push_back(CreateFloat(allocator, {6}, 100));
+
+  EXPECT_FALSE(CopyInPlace(srcs, &dsts));
+  EXPECT_EQ(dsts[0].GetTensorData<float>()[0], 100);
+  EXPECT_EQ(dsts[1].GetTensorData<float>()[0], 100);
+
+  dsts.pop_back();
+  EXPECT_FALSE(CopyInPlace(srcs, &dsts));
+}
+
+TEST(CopyInPlace, View) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  Ort::Value src = CreateFloat(allocator, {2, 3}, 0);
+
+  // An initial state that is shared with the model
+  Ort::Value dst = View(&src);
+  EXPECT_TRUE(CopyInPlace(src, &dst));
+  EXPECT_EQ(dst.GetTensorData<float>(), src.GetTensorData<float>());
+  for (int32_t i = 0; i != 6; ++i) {
+    EXPECT_EQ(src.GetTensorData<float>()[i], i);
+  }
+
+  std::vector<Ort::Value> srcs;
+  srcs.push_back(CreateFloat(allocator, {4}, 0));
+  srcs.push_back(CreateFloat(allocator, {4}, 10));
+
+  std::vector<Ort::Value> dsts;
+  dsts.push_back(View(&srcs[0]));
+  dsts.push_back(CreateFloat(allocator, {4}, 100));
+
+  EXPECT_TRUE(CopyInPlace(srcs, &dsts));
+  for (int32_t i = 0; i != 4; ++i) {
+    EXPECT_EQ(dsts[0].GetTensorData<float>()[i], i);
+    EXPECT_EQ(dsts[1].GetTensorData<float>()[i], 10 + i);
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -187,6 +187,78 @@ Ort::Value Clone(OrtAllocator *allocator, const Ort::Value *v) {
   }
 }
 
+static int32_t ElementSize(ONNXTensorElementDataType type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+      return 4;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+      return 8;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+      return 2;
+    default:
+      return 0;
+  }
+}
+
+// Return the number of bytes to copy from src to dst, or -1 if they differ
+static int64_t NumBytesToCopy(const Ort::Value &src, const Ort::Value &dst) {
+  if (!src || !dst) {
+    return -1;
+  }
+
+  auto src_info = src.GetTensorTypeAndShapeInfo();
+  auto dst_info = dst.GetTensorTypeAndShapeInfo();
+
+  int32_t element_size = ElementSize(src_info.GetElementType());
+  if (element_size == 0 ||
+      src_info.GetElementType() != dst_info.GetElementType() ||
+      src_info.GetShape() != dst_info.GetShape()) {
+    return -1;
+  }
+
+  return src_info.GetElementCount() * element_size;
+}
+
+bool CopyInPlace(const Ort::Value &src, Ort::Value *dst) {
+  int64_t n = NumBytesToCopy(src, *dst);
+  if (n < 0) {
+    return false;
+  }
+
+  uint8_t *p = dst->GetTensorMutableData<uint8_t>();
+  const uint8_t *q = src.GetTensorData<uint8_t>();
+
+  // dst may be a View() of src, e.g., an initial state that has not been
+  // replaced yet. It already has the content of src, and writing to it
+  // would write into the shared tensor of the model.
+  if (p != q) {
+    std::memcpy(p, q, n);
+  }
+
+  return true;
+}
+
+bool CopyInPlace(const std::vector<Ort::Value> &src,
+                 std::vector<Ort::Value> *dst) {
+  if (src.size() != dst->size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i != src.size(); ++i) {
+    if (NumBytesToCopy(src[i], (*dst)[i]) < 0) {
+      return false;
+    }
+  }
+
+  for (size_t i = 0; i != src.size(); ++i) {
+    CopyInPlace(src[i], &(*dst)[i]);
+  }
+
+  return true;
+}
+
 Ort::Value View(Ort::Value *v) {
   auto type_and_shape = v->GetTensorTypeAndShapeInfo();
   std::vector<int64_t> shape = type_and_shape.GetShape();
@@ -67,6 +67,18 @@ Ort::Value Clone(OrtAllocator *allocator, const Ort::Value *v);
 // Return a shallow copy
 Ort::Value View(Ort::Value *v);
 
+// Copy the content of src into the existing buffer of dst, e.g., to reset
+// model states without allocating new tensors.
+// Return false if they differ in shape or element type; dst is unchanged.
+// Nothing is copied if dst shares its buffer with src, e.g., if it is a
+// View() of src.
+bool CopyInPlace(const Ort::Value &src, Ort::Value *dst);
+
+// Like the above one, but for a list of tensors. Either all of them
+// are copied or none of them is.
+bool CopyInPlace(const std::vector<Ort::Value> &src,
+                 std::vector<Ort::Value> *dst);
+
 float ComputeSum(const Ort::Value *v, int32_t n = -1);
 float ComputeMean(const Ort::Value *v, int32_t n = -1);
 
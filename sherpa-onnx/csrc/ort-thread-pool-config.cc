@@ -0,0 +1,88 @@
+// sherpa-onnx/csrc/ort-thread-pool-config.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/ort-thread-pool-config.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/text-utils.h"
+
+namespace sherpa_onnx {
+
+void OrtThreadPoolConfig::Register(ParseOptions *po) {
+  po->Register("ort-global-thread-pool", &enabled,
+               "If true, all onnxruntime sessions of this process share one "
+               "set of thread pools configured by --ort-*, and --num-threads "
+               "of the models is ignored. It avoids oversubscribing the CPU "
+               "when several models are loaded.");
+
+  po->Register("ort-intra-op-num-threads", &intra_op_num_threads,
+               "Number of threads of the shared intra-op thread pool. "
+               "0 means the number of physical cores.");
+
+  po->Register("ort-inter-op-num-threads", &inter_op_num_threads,
+               "Number of threads of the shared inter-op thread pool.");
+
+  po->Register("ort-allow-spinning", &allow_spinning,
+               "If true, idle threads of the shared pools spin before "
+               "sleeping, which trades CPU usage for latency.");
+
+  po->Register("ort-intra-op-thread-affinity", &intra_op_thread_affinity,
+               "CPU affinity of the shared intra-op threads, e.g., "
+               "\"1,2;3,4\" pins the 2nd thread to cores 1 and 2 and the "
+               "3rd thread to cores 3 and 4. Cores are numbered from 1. "
+               "It needs --ort-intra-op-num-threads set to the number of "
+               "groups + 1. Use it to keep the threads on one NUMA node.");
+}
+
+bool OrtThreadPoolConfig::Validate() const {
+  if (!enabled) {
+    return true;
+  }
+
+  if (intra_op_num_threads < 0) {
+    SHERPA_ONNX_LOGE("Expect --ort-intra-op-num-threads >= 0. Given: %d",
+                     intra_op_num_threads);
+    return false;
+  }
+
+  if (inter_op_num_threads < 0) {
+    SHERPA_ONNX_LOGE("Expect --ort-inter-op-num-threads >= 0. Given: %d",
+                     inter_op_num_threads);
+    return false;
+  }
+
+  if (!intra_op_thread_affinity.empty()) {
+    std::vector<std::string> groups;
+    SplitStringToVector(intra_op_thread_affinity, ";", false, &groups);
+
+    if (static_cast<int32_t>(groups.size()) != intra_op_num_threads - 1) {
+      SHERPA_ONNX_LOGE(
+          "--ort-intra-op-thread-affinity has %d groups, but it expects "
+          "--ort-intra-op-num-threads - 1 = %d groups",
+          static_cast<int32_t>(groups.size()), intra_op_num_threads - 1);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::string OrtThreadPoolConfig::ToString() const {
+  std::ostringstream os;
+
+  os << "OrtThreadPoolConfig(";
+  os << "enabled=" << (enabled ? "True" : "False") << ", ";
+  os << "intra_op_num_threads=" << intra_op_num_threads << ", ";
+  os << "inter_op_num_threads=" << inter_op_num_threads << ", ";
+  os << "allow_spinning=" << (allow_spinning ? "True" : "False") << ", ";
+  os << "intra_op_thread_affinity=\"" << intra_op_thread_affinity << "\")";
+
+  return os.str();
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,48 @@
+// sherpa-onnx/csrc/ort-thread-pool-config.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_ORT_THREAD_POOL_CONFIG_H_
+#define SHERPA_ONNX_CSRC_ORT_THREAD_POOL_CONFIG_H_
+
+#include <string>
+
+#include "sherpa-onnx/csrc/parse-options.h"
+
+namespace sherpa_onnx {
+
+// Thread pools of onnxruntime shared by all sessions of a process.
+//
+// By default, each session, e.g., the encoder, decoder and joiner of a
+// transducer, creates its own pools with --num-threads threads, so a
+// process with several models has more threads than cores. If enabled,
+// all sessions use the pools configured here instead and --num-threads
+// of the models is ignored. See InitGlobalThreadPool().
+struct OrtThreadPoolConfig {
+  bool enabled = false;
+
+  // 0 means to use the number of physical cores
+  int32_t intra_op_num_threads = 0;
+
+  // It is used only by sessions that run nodes in parallel
+  int32_t inter_op_num_threads = 1;
+
+  // If true, idle threads spin for a while before sleeping. It reduces
+  // latency but uses more CPU.
+  bool allow_spinning = true;
+
+  // CPU affinity of the intra-op threads in the format of onnxruntime,
+  // e.g., "1,2;3,4;5-8" pins the 1st thread to cores 1 and 2, the 2nd
+  // thread to cores 3 and 4, and the 3rd thread to cores 5 to 8. It
+  // contains intra_op_num_threads - 1 groups since the calling thread is
+  // also used. Cores are numbered from 1. Empty means no affinity.
+  std::string intra_op_thread_affinity;
+
+  void Register(ParseOptions *po);
+  bool Validate() const;
+
+  std::string ToString() const;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_ORT_THREAD_POOL_CONFIG_H_
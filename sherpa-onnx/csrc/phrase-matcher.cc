@@ -4,6 +4,7 @@
 #include "sherpa-onnx/csrc/phrase-matcher.h"
 
 #include <algorithm>
+#include <functional>
 #include <sstream>
 #include <string>
 #include <unordered_set>
@@ -16,10 +17,12 @@
 namespace sherpa_onnx {
 class PhraseMatcher::Impl {
  public:
-  Impl(const std::unordered_set<std::string> *lexicon,
+  Impl(std::function<bool(const std::string &)> contains,
        const std::vector<std::string> &words, bool debug,
        int32_t max_search_len)
-      : lexicon_(lexicon), max_search_len_(max_search_len), debug_(debug) {
+      : contains_(std::move(contains)),
+        max_search_len_(max_search_len),
+        debug_(debug) {
     if (max_search_len_ < 1) {
       max_search_len_ = 1;
     }
@@ -80,7 +83,7 @@ class PhraseMatcher::Impl {
             SHERPA_ONNX_LOGE("%d-%d: %s", start, end, this_word.c_str());
 #endif
           }
-          if (lexicon_->count(this_word)) {
+          if (contains_(this_word)) {
             i = end + 1;
             w = std::move(this_word);
             if (debug_) {
@@ -119,7 +122,7 @@ class PhraseMatcher::Impl {
 
  private:
   std::vector<std::string> phrases_;
-  const std::unordered_set<std::string> *lexicon_;
+  std::function<bool(const std::string &)> contains_;
   int32_t max_search_len_;
   bool debug_;
 };
@@ -128,7 +131,15 @@ PhraseMatcher::PhraseMatcher(const std::unordered_set<std::string> *lexicon,
                              const std::vector<std::string> &words,
                              bool debug /*= false*/,
                              int32_t max_search_len /*= 10*/)
-    : impl_(std::make_unique<Impl>(lexicon, words, debug, max_search_len)) {}
+    : impl_(std::make_unique<Impl>(
+          [lexicon](const std::string &w) { return lexicon->count(w) > 0; },
+          words, debug, max_search_len)) {}
+
+PhraseMatcher::PhraseMatcher(
+    const std::function<bool(const std::string &)> &contains,
+    const std::vector<std::string> &words, bool debug /*= false*/,
+    int32_t max_search_len /*= 10*/)
+    : impl_(std::make_unique<Impl>(contains, words, debug, max_search_len)) {}
 
 PhraseMatcher::~PhraseMatcher() = default;
 
@@ -5,6 +5,7 @@
 #include "sherpa-onnx/csrc/piper-phonemize-lexicon.h"
 
 #include <fstream>
+#include <list>
 #include <locale>
 #include <map>
 #include <mutex>
@@ -58,15 +59,102 @@ static std::string ToString(char32_t cp) {
   return result;
 }
 
+namespace {
+
+// A bounded LRU cache of the results of piper::phonemize_eSpeak().
+//
+// espeak-ng keeps its state in global variables, so only one thread can
+// call into it at a time and we cannot create isolated instances of it
+// within a process. Caching the results lets repeated words and
+// sentences, which are common for the OOV words of Kokoro and Matcha
+// models, skip espeak-ng and its lock entirely.
+class EspeakPhonemizeCache {
+ public:
+  using Phonemes = std::vector<std::vector<piper::Phoneme>>;
+
+  // Texts longer than this are not cached
+  static constexpr int32_t kMaxTextLength = 1024;
+
+  static constexpr int32_t kCapacity = 8192;
+
+  static EspeakPhonemizeCache &GetInstance() {
+    static EspeakPhonemizeCache cache;
+    return cache;
+  }
+
+  bool Get(const std::string &key, Phonemes *phonemes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = map_.find(key);
+    if (it == map_.end()) {
+      return false;
+    }
+
+    // move it to the front of the list as it is the most recently used
+    items_.splice(items_.begin(), items_, it->second);
+    *phonemes = it->second->second;
+    return true;
+  }
+
+  void Put(const std::string &key, const Phonemes &phonemes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (map_.count(key)) {
+      return;
+    }
+
+    items_.emplace_front(key, phonemes);
+    map_[key] = items_.begin();
+
+    if (static_cast<int32_t>(items_.size()) > kCapacity) {
+      map_.erase(items_.back().first);
+      items_.pop_back();
+    }
+  }
+
+ private:
+  EspeakPhonemizeCache() = default;
+
+ private:
+  std::mutex mutex_;
+  std::list<std::pair<std::string, Phonemes>> items_;
+  std::unordered_map<std::string,
+                     std::list<std::pair<std::string, Phonemes>>::iterator>
+      map_;
+};
+
+}  // namespace
+
 void CallPhonemizeEspeak(const std::string &text,
                          piper::eSpeakPhonemeConfig &config,  // NOLINT
                          std::vector<std::vector<piper::Phoneme>> *phonemes) {
   static std::mutex espeak_mutex;
 
-  std::lock_guard<std::mutex> lock(espeak_mutex);
+  // All callers use the default settings except for the voice. Results
+  // for other settings are not cached since they are not part of the key.
+  bool use_cache = static_cast<int32_t>(text.size()) <=
+                       EspeakPhonemizeCache::kMaxTextLength &&
+                   !config.keepLanguageFlags && !config.phonemeMap;
 
-  // keep multi threads from calling into piper::phonemize_eSpeak
-  piper::phonemize_eSpeak(text, config, *phonemes);
+  std::string key;
+  if (use_cache) {
+    key = config.voice;
+    key.push_back('\0');
+    key += text;
+
+    if (EspeakPhonemizeCache::GetInstance().Get(key, phonemes)) {
+      return;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(espeak_mutex);
+
+    // keep multi threads from calling into piper::phonemize_eSpeak
+    piper::phonemize_eSpeak(text, config, *phonemes);
+  }
+
+  if (use_cache) {
+    EspeakPhonemizeCache::GetInstance().Put(key, *phonemes);
+  }
 }
 
 static std::unordered_map<char32_t, int32_t> ReadTokens(std::istream &is) {
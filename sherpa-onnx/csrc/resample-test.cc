@@ -0,0 +1,164 @@
+// sherpa-onnx/csrc/resample-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/resample.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+static std::vector<float> GenerateSignal(int32_t n, int32_t sample_rate) {
+  std::vector<float> ans(n);
+  for (int32_t i = 0; i != n; ++i) {
+    float t = static_cast<float>(i) / sample_rate;
+    ans[i] = 0.5 * std::sin(2 * M_PI * 440 * t) +
+             0.3 * std::sin(2 * M_PI * 1234 * t);
+  }
+  return ans;
+}
+
+// Evaluate the windowed sinc filter directly at each output sample
+static std::vector<float> Reference(const std::vector<float> &x,
+                                    int32_t sample_rate_in,
+                                    int32_t sample_rate_out, float cutoff,
+                                    int32_t num_zeros, int32_t num_output) {
+  double window_width = num_zeros / (2.0 * cutoff);
+  std::vector<float> ans(num_output);
+  for (int32_t j = 0; j != num_output; ++j) {
+    double t_out = static_cast<double>(j) / sample_rate_out;
+    double sum = 0;
+    for (int32_t i = 0; i != static_cast<int32_t>(x.size()); ++i) {
+      double t = static_cast<double>(i) / sample_rate_in - t_out;
+      if (std::fabs(t) >= window_width) {
+        continue;
+      }
+
+      double window = 0.5 * (1 + std::cos(2 * M_PI * cutoff / num_zeros * t));
+      double filter =
+          t != 0 ? std::sin(2 * M_PI * cutoff * t) / (M_PI * t) : 2 * cutoff;
+      sum += x[i] * filter * window / sample_rate_in;
+    }
+    ans[j] = sum;
+  }
+  return ans;
+}
+
+static void TestResample(int32_t sample_rate_in, int32_t sample_rate_out) {
+  float cutoff = 0.99 * 0.5 * std::min(sample_rate_in, sample_rate_out);
+  int32_t num_zeros = 6;
+
+  std::vector<float> x = GenerateSignal(sample_rate_in / 5, sample_rate_in);
+
+  LinearResample resampler(sample_rate_in, sample_rate_out, cutoff, num_zeros);
+
+  std::vector<float> y;
+  resampler.Resample(x.data(), x.size(), true, &y);
+  ASSERT_FALSE(y.empty());
+
+  std::vector<float> expected = Reference(x, sample_rate_in, sample_rate_out,
+                                          cutoff, num_zeros, y.size());
+  for (int32_t i = 0; i != static_cast<int32_t>(y.size()); ++i) {
+    EXPECT_NEAR(y[i], expected[i], 1e-4) << i;
+  }
+
+  // Streaming in pieces of different sizes gives the same result
+  std::vector<float> streamed;
+  std::vector<float> tmp;
+  int32_t start = 0;
+  int32_t chunk = 1;
+  while (start < static_cast<int32_t>(x.size())) {
+    int32_t n = std::min<int32_t>(chunk, x.size() - start);
+    bool flush = start + n == static_cast<int32_t>(x.size());
+    resampler.Resample(x.data() + start, n, flush, &tmp);
+    streamed.insert(streamed.end(), tmp.begin(), tmp.end());
+    start += n;
+    chunk = chunk * 3 % 1000 + 1;
+  }
+
+  ASSERT_EQ(streamed.size(), y.size());
+  for (int32_t i = 0; i != static_cast<int32_t>(y.size()); ++i) {
+    EXPECT_NEAR(streamed[i], y[i], 1e-5) << i;
+  }
+}
+
+TEST(LinearResample, Upsample) {
+  TestResample(8000, 16000);
+  TestResample(22050, 44100);
+}
+
+TEST(LinearResample, Downsample) {
+  TestResample(48000, 16000);
+  TestResample(44100, 16000);
+}
+
+// The same cutoff and number of zeros as the feature extractors use
+static std::unique_ptr<LinearResample> CreateResampler(
+    int32_t sample_rate_in, int32_t sample_rate_out) {
+  float min_freq = std::min(sample_rate_in, sample_rate_out);
+  float lowpass_cutoff = 0.99 * 0.5 * min_freq;
+  int32_t lowpass_filter_width = 6;
+  return std::make_unique<LinearResample>(sample_rate_in, sample_rate_out,
+                                          lowpass_cutoff, lowpass_filter_width);
+}
+
+static int32_t ElapsedMs(std::chrono::steady_clock::time_point start) {
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(stop - start)
+      .count();
+}
+
+// It is disabled since it only prints timings. Run it with
+//
+//  ./bin/resample-test --gtest_also_run_disabled_tests \
+//    --gtest_filter=LinearResample.DISABLED_Benchmark
+//
+// Build with -O2 to get meaningful numbers.
+TEST(LinearResample, DISABLED_Benchmark) {
+  std::vector<std::pair<int32_t, int32_t>> rates = {
+      {8000, 16000}, {48000, 16000}, {44100, 16000}};
+
+  std::vector<float> y;
+  for (const auto &p : rates) {
+    int32_t sample_rate_in = p.first;
+    int32_t chunk = sample_rate_in / 100;  // 10 ms
+
+    // Three signals of 60 seconds, each with a new resampler
+    std::vector<float> x = GenerateSignal(sample_rate_in * 60, sample_rate_in);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t k = 0; k != 3; ++k) {
+      auto resampler = CreateResampler(sample_rate_in, p.second);
+
+      for (int32_t i = 0; i < static_cast<int32_t>(x.size()); i += chunk) {
+        int32_t n = std::min<int32_t>(chunk, x.size() - i);
+        bool flush = i + n == static_cast<int32_t>(x.size());
+        resampler->Resample(x.data() + i, n, flush, &y);
+      }
+    }
+
+    SHERPA_ONNX_LOGE("%d Hz -> %d Hz, 3 x 60 s in 10 ms chunks: %d ms",
+                     sample_rate_in, p.second, ElapsedMs(start));
+  }
+
+  // Short-lived streams, e.g., one per websocket connection
+  std::vector<float> x = GenerateSignal(441, 44100);
+  auto start = std::chrono::steady_clock::now();
+  for (int32_t k = 0; k != 1000; ++k) {
+    auto resampler = CreateResampler(44100, 16000);
+    resampler->Resample(x.data(), x.size(), true, &y);
+  }
+
+  SHERPA_ONNX_LOGE("1000 streams of 44100 Hz -> 16000 Hz: %d ms",
+                   ElapsedMs(start));
+}
+
+}  // namespace sherpa_onnx
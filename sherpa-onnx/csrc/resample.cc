@@ -25,10 +25,15 @@
 //#include "sherpa-onnx/csrc/resample.h"
 #include "resample.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <tuple>
 #include <type_traits>
 #include <vector>
 
@@ -76,43 +81,96 @@ static I Lcm(I m, I n) {
   return gcd * (m / gcd) * (n / gcd);
 }
 
+// Number of independent partial sums in DotProduct(). The weights of each
+// filter phase are zero-padded to a multiple of it.
+static constexpr int32_t kLanes = 4;
+
+// n must be a multiple of kLanes. Since the partial sums of the lanes
+// do not depend on each other, compilers turn the inner loop into
+// SIMD instructions (e.g., SSE or NEON) without any intrinsics.
 static float DotProduct(const float *a, const float *b, int32_t n) {
-  float sum = 0;
-  for (int32_t i = 0; i != n; ++i) {
-    sum += a[i] * b[i];
+  float sum[kLanes] = {0};
+  for (int32_t i = 0; i != n; i += kLanes) {
+    for (int32_t k = 0; k != kLanes; ++k) {
+      sum[k] += a[i + k] * b[i + k];
+    }
+  }
+
+  float ans = 0;
+  for (int32_t k = 0; k != kLanes; ++k) {
+    ans += sum[k];
   }
-  return sum;
+  return ans;
 }
 
-LinearResample::LinearResample(int32_t samp_rate_in_hz,
-                               int32_t samp_rate_out_hz, float filter_cutoff_hz,
-                               int32_t num_zeros)
-    : samp_rate_in_(samp_rate_in_hz),
-      samp_rate_out_(samp_rate_out_hz),
-      filter_cutoff_(filter_cutoff_hz),
-      num_zeros_(num_zeros) {
-  assert(samp_rate_in_hz > 0.0 && samp_rate_out_hz > 0.0 &&
-         filter_cutoff_hz > 0.0 && filter_cutoff_hz * 2 <= samp_rate_in_hz &&
-         filter_cutoff_hz * 2 <= samp_rate_out_hz && num_zeros > 0);
+/** Here, t is a time in seconds representing an offset from
+    the center of the windowed filter function, and FilterFunction(t)
+    returns the windowed filter function, described
+    in the header as h(t) = f(t)g(t), evaluated at t.
+*/
+static float FilterFunc(float t, float filter_cutoff, int32_t num_zeros) {
+  float window = 0,  // raised-cosine (Hanning) window of width
+                     // num_zeros/2*filter_cutoff
+      filter = 0;    // sinc filter function
+  if (std::fabs(t) < num_zeros / (2.0 * filter_cutoff))
+    window = 0.5 * (1 + cos(M_2PI * filter_cutoff / num_zeros * t));
+  else
+    window = 0.0;  // outside support of window function
+  if (t != 0)
+    filter = sin(M_2PI * filter_cutoff * t) / (M_PI * t);
+  else
+    filter = 2 * filter_cutoff;  // limit of the function at t = 0
+  return filter * window;
+}
 
-  // base_freq is the frequency of the repeating unit, which is the gcd
-  // of the input frequencies.
-  int32_t base_freq = Gcd(samp_rate_in_, samp_rate_out_);
-  input_samples_in_unit_ = samp_rate_in_ / base_freq;
-  output_samples_in_unit_ = samp_rate_out_ / base_freq;
+// A polyphase filter: there is one phase for each output-sample index
+// in the repeating unit.
+struct LinearResample::Filter {
+  /// The first input-sample index that we sum over, for each phase.
+  /// May be negative; any truncation at the beginning is handled
+  /// separately.  This is just for the first few output samples, but we can
+  /// extrapolate the correct input-sample index for arbitrary output samples.
+  std::vector<int32_t> first_index;
 
-  SetIndexesAndWeights();
-  Reset();
-}
+  /// Number of non-padded weights of each phase
+  std::vector<int32_t> num_weights;
+
+  /// Number of weights of each phase after padding. A multiple of kLanes.
+  int32_t num_taps = 0;
+
+  /// Weights on the input samples; the weights of phase i are in
+  /// [i * num_taps, (i + 1) * num_taps)
+  std::vector<float> weights;
+};
+
+std::shared_ptr<const LinearResample::Filter> LinearResample::GetFilter(
+    int32_t samp_rate_in_hz, int32_t samp_rate_out_hz, float filter_cutoff_hz,
+    int32_t num_zeros) {
+  using Key = std::tuple<int32_t, int32_t, float, int32_t>;
+  static std::mutex mutex;
+  static std::map<Key, std::shared_ptr<const Filter>> cache;
+
+  Key key{samp_rate_in_hz, samp_rate_out_hz, filter_cutoff_hz, num_zeros};
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = cache.find(key);
+  if (it != cache.end()) {
+    return it->second;
+  }
+
+  int32_t base_freq = Gcd(samp_rate_in_hz, samp_rate_out_hz);
+  int32_t output_samples_in_unit = samp_rate_out_hz / base_freq;
 
-void LinearResample::SetIndexesAndWeights() {
-  first_index_.resize(output_samples_in_unit_);
-  weights_.resize(output_samples_in_unit_);
+  auto filter = std::make_shared<Filter>();
+  filter->first_index.resize(output_samples_in_unit);
+  filter->num_weights.resize(output_samples_in_unit);
 
-  double window_width = num_zeros_ / (2.0 * filter_cutoff_);
+  double window_width = num_zeros / (2.0 * filter_cutoff_hz);
 
-  for (int32_t i = 0; i < output_samples_in_unit_; i++) {
-    double output_t = i / static_cast<double>(samp_rate_out_);
+  std::vector<std::vector<float>> weights(output_samples_in_unit);
+
+  for (int32_t i = 0; i < output_samples_in_unit; i++) {
+    double output_t = i / static_cast<double>(samp_rate_out_hz);
     double min_t = output_t - window_width, max_t = output_t + window_width;
     // we do ceil on the min and floor on the max, because if we did it
     // the other way around we would unnecessarily include indexes just
@@ -121,39 +179,54 @@ void LinearResample::SetIndexesAndWeights() {
     // (e.g. if filter_cutoff_ has an exact ratio with the sample rates),
     // that we unnecessarily include something with a zero coefficient,
     // but this is only a slight efficiency issue.
-    int32_t min_input_index = ceil(min_t * samp_rate_in_),
-            max_input_index = floor(max_t * samp_rate_in_),
+    int32_t min_input_index = ceil(min_t * samp_rate_in_hz),
+            max_input_index = floor(max_t * samp_rate_in_hz),
             num_indices = max_input_index - min_input_index + 1;
-    first_index_[i] = min_input_index;
-    weights_[i].resize(num_indices);
+    filter->first_index[i] = min_input_index;
+    filter->num_weights[i] = num_indices;
+    filter->num_taps = std::max(filter->num_taps, num_indices);
+    weights[i].resize(num_indices);
     for (int32_t j = 0; j < num_indices; j++) {
       int32_t input_index = min_input_index + j;
-      double input_t = input_index / static_cast<double>(samp_rate_in_),
+      double input_t = input_index / static_cast<double>(samp_rate_in_hz),
              delta_t = input_t - output_t;
       // sign of delta_t doesn't matter.
-      weights_[i][j] = FilterFunc(delta_t) / samp_rate_in_;
+      weights[i][j] =
+          FilterFunc(delta_t, filter_cutoff_hz, num_zeros) / samp_rate_in_hz;
     }
   }
+
+  filter->num_taps = (filter->num_taps + kLanes - 1) / kLanes * kLanes;
+  filter->weights.resize(output_samples_in_unit * filter->num_taps);
+  for (int32_t i = 0; i < output_samples_in_unit; i++) {
+    std::copy(weights[i].begin(), weights[i].end(),
+              filter->weights.begin() + i * filter->num_taps);
+  }
+
+  cache[key] = filter;
+
+  return filter;
 }
 
-/** Here, t is a time in seconds representing an offset from
-    the center of the windowed filter function, and FilterFunction(t)
-    returns the windowed filter function, described
-    in the header as h(t) = f(t)g(t), evaluated at t.
-*/
-float LinearResample::FilterFunc(float t) const {
-  float window = 0,  // raised-cosine (Hanning) window of width
-                     // num_zeros_/2*filter_cutoff_
-      filter = 0;    // sinc filter function
-  if (std::fabs(t) < num_zeros_ / (2.0 * filter_cutoff_))
-    window = 0.5 * (1 + cos(M_2PI * filter_cutoff_ / num_zeros_ * t));
-  else
-    window = 0.0;  // outside support of window function
-  if (t != 0)
-    filter = sin(M_2PI * filter_cutoff_ * t) / (M_PI * t);
-  else
-    filter = 2 * filter_cutoff_;  // limit of the function at t = 0
-  return filter * window;
+LinearResample::LinearResample(int32_t samp_rate_in_hz,
+                               int32_t samp_rate_out_hz, float filter_cutoff_hz,
+                               int32_t num_zeros)
+    : samp_rate_in_(samp_rate_in_hz),
+      samp_rate_out_(samp_rate_out_hz),
+      filter_cutoff_(filter_cutoff_hz),
+      num_zeros_(num_zeros) {
+  assert(samp_rate_in_hz > 0.0 && samp_rate_out_hz > 0.0 &&
+         filter_cutoff_hz > 0.0 && filter_cutoff_hz * 2 <= samp_rate_in_hz &&
+         filter_cutoff_hz * 2 <= samp_rate_out_hz && num_zeros > 0);
+
+  // base_freq is the frequency of the repeating unit, which is the gcd
+  // of the input frequencies.
+  int32_t base_freq = Gcd(samp_rate_in_, samp_rate_out_);
+  input_samples_in_unit_ = samp_rate_in_ / base_freq;
+  output_samples_in_unit_ = samp_rate_out_ / base_freq;
+
+  filter_ = GetFilter(samp_rate_in_, samp_rate_out_, filter_cutoff_, num_zeros_);
+  Reset();
 }
 
 void LinearResample::Reset() {
@@ -171,6 +244,8 @@ void LinearResample::Resample(const float *input, int32_t input_dim, bool flush,
 
   output->resize(tot_output_samp - output_sample_offset_);
 
+  const int32_t num_taps = filter_->num_taps;
+
   // samp_out is the index into the total output signal, not just the part
   // of it we are producing here.
   for (int64_t samp_out = output_sample_offset_; samp_out < tot_output_samp;
@@ -178,19 +253,19 @@ void LinearResample::Resample(const float *input, int32_t input_dim, bool flush,
     int64_t first_samp_in = 0;
     int32_t samp_out_wrapped = 0;
     GetIndexes(samp_out, &first_samp_in, &samp_out_wrapped);
-    const std::vector<float> &weights = weights_[samp_out_wrapped];
+    const float *weights =
+        filter_->weights.data() + samp_out_wrapped * num_taps;
+    int32_t num_weights = filter_->num_weights[samp_out_wrapped];
     // first_input_index is the first index into "input" that we have a weight
     // for.
     int32_t first_input_index =
         static_cast<int32_t>(first_samp_in - input_sample_offset_);
     float this_output = 0;
-    if (first_input_index >= 0 &&
-        first_input_index + static_cast<int32_t>(weights.size()) <= input_dim) {
-      this_output =
-          DotProduct(input + first_input_index, weights.data(), weights.size());
+    if (first_input_index >= 0 && first_input_index + num_taps <= input_dim) {
+      this_output = DotProduct(input + first_input_index, weights, num_taps);
     } else {  // Handle edge cases.
       this_output = 0.0;
-      for (int32_t i = 0; i < static_cast<int32_t>(weights.size()); i++) {
+      for (int32_t i = 0; i < num_weights; i++) {
         float weight = weights[i];
         int32_t input_index = first_input_index + i;
         if (input_index < 0 &&
@@ -278,12 +353,11 @@ void LinearResample::GetIndexes(int64_t samp_out, int64_t *first_samp_in,
   // samp_out_wrapped is equal to samp_out % output_samples_in_unit_
   *samp_out_wrapped =
       static_cast<int32_t>(samp_out - unit_index * output_samples_in_unit_);
-  *first_samp_in =
-      first_index_[*samp_out_wrapped] + unit_index * input_samples_in_unit_;
+  *first_samp_in = filter_->first_index[*samp_out_wrapped] +
+                   unit_index * input_samples_in_unit_;
 }
 
 void LinearResample::SetRemainder(const float *input, int32_t input_dim) {
-  std::vector<float> old_remainder(input_remainder_);
   // max_remainder_needed is the width of the filter from side to side,
   // measured in input samples.  you might think it should be half that,
   // but you have to consider that you might be wanting to output samples
@@ -291,6 +365,15 @@ void LinearResample::SetRemainder(const float *input, int32_t input_dim) {
   // input... anyway, storing more remainder than needed is not harmful.
   int32_t max_remainder_needed =
       std::ceil(samp_rate_in_ * num_zeros_ / filter_cutoff_);
+
+  if (input_dim >= max_remainder_needed) {
+    // The usual case in streaming; the old remainder is not needed
+    input_remainder_.assign(input + input_dim - max_remainder_needed,
+                            input + input_dim);
+    return;
+  }
+
+  std::vector<float> old_remainder(input_remainder_);
   input_remainder_.resize(max_remainder_needed);
   for (int32_t index = -static_cast<int32_t>(input_remainder_.size());
        index < 0; index++) {
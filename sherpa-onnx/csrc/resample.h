@@ -25,6 +25,7 @@
 #define SHERPA_ONNX_CSRC_RESAMPLE_H_
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace sherpa_onnx {
@@ -78,9 +79,14 @@ class LinearResample {
   int32_t GetOutputSamplingRate() const { return samp_rate_out_; }
 
  private:
-  void SetIndexesAndWeights();
+  struct Filter;
 
-  float FilterFunc(float) const;
+  /// Return the filter for the given parameters. It is computed only once
+  /// per process and shared by all objects with the same parameters.
+  static std::shared_ptr<const Filter> GetFilter(int32_t samp_rate_in_hz,
+                                                 int32_t samp_rate_out_hz,
+                                                 float filter_cutoff_hz,
+                                                 int32_t num_zeros);
 
   /// This function outputs the number of output samples we will output
   /// for a signal with "input_num_samp" input samples.  If flush == true,
@@ -94,8 +100,8 @@ class LinearResample {
 
   /// Given an output-sample index, this function outputs to *first_samp_in the
   /// first input-sample index that we have a weight on (may be negative),
-  /// and to *samp_out_wrapped the index into weights_ where we can get the
-  /// corresponding weights on the input.
+  /// and to *samp_out_wrapped the index of the filter phase where we can get
+  /// the corresponding weights on the input.
   inline void GetIndexes(int64_t samp_out, int64_t *first_samp_in,
                          int32_t *samp_out_wrapped) const;
 
@@ -118,14 +124,9 @@ class LinearResample {
                                     ///< = samp_rate_out_hz /
                                     ///< Gcd(samp_rate_in_hz, samp_rate_out_hz)
 
-  /// The first input-sample index that we sum over, for this output-sample
-  /// index.  May be negative; any truncation at the beginning is handled
-  /// separately.  This is just for the first few output samples, but we can
-  /// extrapolate the correct input-sample index for arbitrary output samples.
-  std::vector<int32_t> first_index_;
-
-  /// Weights on the input samples, for this output-sample index.
-  std::vector<std::vector<float>> weights_;
+  /// Indexes and weights of the input samples for each output-sample index
+  /// in the repeating unit. It is read-only and shared.
+  std::shared_ptr<const Filter> filter_;
 
   // the following variables keep track of where we are in a particular signal,
   // if it is being provided over multiple calls to Resample().
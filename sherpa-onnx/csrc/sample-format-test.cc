@@ -0,0 +1,80 @@
+// sherpa-onnx/csrc/sample-format-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/sample-format.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(SampleFormat, Parse) {
+  for (auto f : {SampleFormat::kFloat32, SampleFormat::kInt16,
+                 SampleFormat::kInt24, SampleFormat::kInt32,
+                 SampleFormat::kUint8, SampleFormat::kMuLaw,
+                 SampleFormat::kALaw}) {
+    SampleFormat g;
+    EXPECT_TRUE(ParseSampleFormat(SampleFormatToString(f), &g));
+    EXPECT_EQ(f, g);
+  }
+
+  SampleFormat g;
+  EXPECT_FALSE(ParseSampleFormat("int12", &g));
+}
+
+TEST(SampleFormat, Convert) {
+  std::vector<float> f(3);
+
+  // float32 at an odd address
+  std::vector<float> f32 = {0, -1, 0.5};
+  std::vector<uint8_t> unaligned(f32.size() * sizeof(float) + 1);
+  std::memcpy(unaligned.data() + 1, f32.data(), f32.size() * sizeof(float));
+  EXPECT_FALSE(CanReadAsFloat(unaligned.data() + 1, SampleFormat::kFloat32));
+  EXPECT_TRUE(CanReadAsFloat(f32.data(), SampleFormat::kFloat32));
+  EXPECT_FALSE(CanReadAsFloat(f32.data(), SampleFormat::kInt32));
+
+  ConvertToFloat(unaligned.data() + 1, 3, SampleFormat::kFloat32, 1, f.data());
+  EXPECT_EQ(f, f32);
+
+  ConvertToFloat(unaligned.data() + 1, 3, SampleFormat::kFloat32, 32768,
+                 f.data());
+  EXPECT_EQ(f, (std::vector<float>{0, -32768, 16384}));
+
+  std::vector<int16_t> s16 = {0, -32768, 16384};
+  ConvertToFloat(s16.data(), s16.size(), SampleFormat::kInt16, 1, f.data());
+  EXPECT_EQ(f, (std::vector<float>{0, -1, 0.5}));
+
+  ConvertToFloat(s16.data(), s16.size(), SampleFormat::kInt16, 32768,
+                 f.data());
+  EXPECT_EQ(f, (std::vector<float>{0, -32768, 16384}));
+
+  // 0, -1, 0.5 in 24-bit little endian
+  std::vector<uint8_t> s24 = {0, 0, 0, 0, 0, 0x80, 0, 0, 0x40};
+  ConvertToFloat(s24.data(), 3, SampleFormat::kInt24, 1, f.data());
+  EXPECT_EQ(f, (std::vector<float>{0, -1, 0.5}));
+
+  std::vector<int32_t> s32 = {0, INT32_MIN, 1 << 30};
+  ConvertToFloat(s32.data(), s32.size(), SampleFormat::kInt32, 1, f.data());
+  EXPECT_EQ(f, (std::vector<float>{0, -1, 0.5}));
+
+  std::vector<uint8_t> u8 = {128, 0, 192};
+  ConvertToFloat(u8.data(), u8.size(), SampleFormat::kUint8, 1, f.data());
+  EXPECT_EQ(f, (std::vector<float>{0, -1, 0.5}));
+
+  // Values from the tables of ITU-T G.711
+  std::vector<uint8_t> mulaw = {0xff, 0x80, 0x00};
+  ConvertToFloat(mulaw.data(), mulaw.size(), SampleFormat::kMuLaw, 32768,
+                 f.data());
+  EXPECT_EQ(f, (std::vector<float>{0, 32124, -32124}));
+
+  std::vector<uint8_t> alaw = {0xd5, 0x55, 0xaa};
+  ConvertToFloat(alaw.data(), alaw.size(), SampleFormat::kALaw, 32768,
+                 f.data());
+  EXPECT_EQ(f, (std::vector<float>{8, -8, 32256}));
+}
+
+}  // namespace sherpa_onnx
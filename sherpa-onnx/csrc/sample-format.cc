@@ -0,0 +1,173 @@
+// sherpa-onnx/csrc/sample-format.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/sample-format.h"
+
+#include <array>
+#include <cstring>
+#include <string>
+
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+// See ITU-T G.711. The decoded values are in the range of int16.
+static int16_t MuLawToInt16(uint8_t u) {
+  u = ~u;
+  int32_t exponent = (u >> 4) & 0x07;
+  int32_t mantissa = u & 0x0f;
+  int32_t sample = (((mantissa << 3) + 0x84) << exponent) - 0x84;
+  return (u & 0x80) ? -sample : sample;
+}
+
+static int16_t ALawToInt16(uint8_t a) {
+  a ^= 0x55;
+  int32_t segment = (a & 0x70) >> 4;
+  int32_t sample = (a & 0x0f) << 4;
+  if (segment == 0) {
+    sample += 8;
+  } else {
+    sample = (sample + 0x108) << (segment - 1);
+  }
+  return (a & 0x80) ? sample : -sample;
+}
+
+using Table = std::array<float, 256>;
+
+// 8-bit formats are decoded with a lookup table
+static const Table &GetTable(SampleFormat format) {
+  static const Table *tables = [] {
+    static Table t[3];
+    for (int32_t i = 0; i != 256; ++i) {
+      t[0][i] = (i - 128) / 128.0f;
+      t[1][i] = MuLawToInt16(i) / 32768.0f;
+      t[2][i] = ALawToInt16(i) / 32768.0f;
+    }
+    return t;
+  }();
+
+  switch (format) {
+    case SampleFormat::kUint8:
+      return tables[0];
+    case SampleFormat::kMuLaw:
+      return tables[1];
+    default:
+      return tables[2];
+  }
+}
+
+bool ParseSampleFormat(const std::string &name, SampleFormat *format) {
+  for (auto f : {SampleFormat::kFloat32, SampleFormat::kInt16,
+                 SampleFormat::kInt24, SampleFormat::kInt32,
+                 SampleFormat::kUint8, SampleFormat::kMuLaw,
+                 SampleFormat::kALaw}) {
+    if (name == SampleFormatToString(f)) {
+      *format = f;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+const char *SampleFormatToString(SampleFormat format) {
+  switch (format) {
+    case SampleFormat::kFloat32:
+      return "float32";
+    case SampleFormat::kInt16:
+      return "int16";
+    case SampleFormat::kInt24:
+      return "int24";
+    case SampleFormat::kInt32:
+      return "int32";
+    case SampleFormat::kUint8:
+      return "uint8";
+    case SampleFormat::kMuLaw:
+      return "mulaw";
+    case SampleFormat::kALaw:
+      return "alaw";
+  }
+
+  return "unknown";
+}
+
+int32_t BytesPerSample(SampleFormat format) {
+  switch (format) {
+    case SampleFormat::kFloat32:
+    case SampleFormat::kInt32:
+      return 4;
+    case SampleFormat::kInt24:
+      return 3;
+    case SampleFormat::kInt16:
+      return 2;
+    default:
+      return 1;
+  }
+}
+
+void ConvertToFloat(const void *src, int32_t n, SampleFormat format,
+                    float scale, float *dst) {
+  switch (format) {
+    case SampleFormat::kFloat32: {
+      // The input may not be aligned, so it is not read as float directly
+      std::memcpy(dst, src, n * sizeof(float));
+      if (scale != 1) {
+        for (int32_t i = 0; i != n; ++i) {
+          dst[i] *= scale;
+        }
+      }
+      break;
+    }
+    case SampleFormat::kInt16: {
+      // The input may not be aligned, e.g., a websocket payload
+      const uint8_t *p = static_cast<const uint8_t *>(src);
+      float s = scale / 32768;
+      // A simple loop that compilers vectorize
+      for (int32_t i = 0; i != n; ++i) {
+        int16_t v;
+        std::memcpy(&v, p + 2 * i, 2);
+        dst[i] = v * s;
+      }
+      break;
+    }
+    case SampleFormat::kInt24: {
+      const uint8_t *p = static_cast<const uint8_t *>(src);
+      float s = scale / 2147483648.0f;
+      for (int32_t i = 0; i != n; ++i, p += 3) {
+        // Put the 24 bits into the upper bits of an int32
+        uint32_t v = (static_cast<uint32_t>(p[0]) << 8) |
+                     (static_cast<uint32_t>(p[1]) << 16) |
+                     (static_cast<uint32_t>(p[2]) << 24);
+        dst[i] = static_cast<int32_t>(v) * s;
+      }
+      break;
+    }
+    case SampleFormat::kInt32: {
+      const uint8_t *p = static_cast<const uint8_t *>(src);
+      float s = scale / 2147483648.0f;
+      for (int32_t i = 0; i != n; ++i) {
+        int32_t v;
+        std::memcpy(&v, p + 4 * i, 4);
+        dst[i] = v * s;
+      }
+      break;
+    }
+    case SampleFormat::kUint8:
+    case SampleFormat::kMuLaw:
+    case SampleFormat::kALaw: {
+      const uint8_t *p = static_cast<const uint8_t *>(src);
+      const Table &table = GetTable(format);
+      for (int32_t i = 0; i != n; ++i) {
+        dst[i] = table[p[i]] * scale;
+      }
+      break;
+    }
+    default:
+      SHERPA_ONNX_LOGE("Unsupported sample format: %d",
+                       static_cast<int32_t>(format));
+      SHERPA_ONNX_EXIT(-1);
+  }
+}
+
+}  // namespace sherpa_onnx
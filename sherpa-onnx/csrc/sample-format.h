@@ -0,0 +1,49 @@
+// sherpa-onnx/csrc/sample-format.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_SAMPLE_FORMAT_H_
+#define SHERPA_ONNX_CSRC_SAMPLE_FORMAT_H_
+
+#include <cstdint>
+#include <string>
+
+namespace sherpa_onnx {
+
+// Encoding of audio samples. All of them are single channel and, for
+// multi-byte formats, little endian.
+enum class SampleFormat {
+  kFloat32,  // "float32", normalized to [-1, 1]
+  kInt16,    // "int16", 16-bit signed PCM
+  kInt24,    // "int24", 24-bit signed PCM, packed in 3 bytes
+  kInt32,    // "int32", 32-bit signed PCM
+  kUint8,    // "uint8", 8-bit unsigned PCM as used in WAV files
+  kMuLaw,    // "mulaw", G.711 mu-law
+  kALaw,     // "alaw", G.711 A-law
+};
+
+// @return Return false if name is not one of the names listed above.
+bool ParseSampleFormat(const std::string &name, SampleFormat *format);
+
+const char *SampleFormatToString(SampleFormat format);
+
+int32_t BytesPerSample(SampleFormat format);
+
+// Convert n samples of the given format to float.
+//
+// @param src   It contains n * BytesPerSample(format) bytes.
+// @param scale The converted samples in [-1, 1] are multiplied by it,
+//              e.g., use 32768 to get samples in the range of int16.
+// @param dst   It has space for n floats.
+void ConvertToFloat(const void *src, int32_t n, SampleFormat format,
+                    float scale, float *dst);
+
+// Return true if p can be read as floats in place, i.e., it is float32
+// and suitably aligned. Otherwise, use ConvertToFloat().
+inline bool CanReadAsFloat(const void *p, SampleFormat format) {
+  return format == SampleFormat::kFloat32 &&
+         reinterpret_cast<uintptr_t>(p) % alignof(float) == 0;
+}
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_SAMPLE_FORMAT_H_
@@ -0,0 +1,52 @@
+// sherpa-onnx/csrc/server-utils-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/server-utils.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(GetQueryValue, Basic) {
+  std::string r = "/?sample_rate=8000&model=en&empty=&flag";
+  EXPECT_EQ(GetQueryValue(r, "model"), "en");
+  EXPECT_EQ(GetQueryValue(r, "sample_rate"), "8000");
+  EXPECT_EQ(GetQueryValue(r, "empty"), "");
+  EXPECT_EQ(GetQueryValue(r, "flag"), "");
+  EXPECT_EQ(GetQueryValue(r, "mod"), "");
+  EXPECT_EQ(GetQueryValue("/", "model"), "");
+}
+
+TEST(ParseNamedModels, Basic) {
+  std::vector<std::pair<std::string, std::string>> models;
+  EXPECT_TRUE(ParseNamedModels("", &models));
+  EXPECT_TRUE(models.empty());
+
+  EXPECT_TRUE(ParseNamedModels("en:a.txt,zh:C:\\b.txt", &models));
+  ASSERT_EQ(models.size(), 2);
+  EXPECT_EQ(models[0].first, "en");
+  EXPECT_EQ(models[0].second, "a.txt");
+  EXPECT_EQ(models[1].first, "zh");
+  EXPECT_EQ(models[1].second, "C:\\b.txt");
+}
+
+TEST(ParseNamedModels, Invalid) {
+  std::vector<std::pair<std::string, std::string>> models;
+  EXPECT_FALSE(ParseNamedModels("a.txt", &models));
+
+  models.clear();
+  EXPECT_FALSE(ParseNamedModels(":a.txt", &models));
+
+  models.clear();
+  EXPECT_FALSE(ParseNamedModels("en:", &models));
+
+  models.clear();
+  EXPECT_FALSE(ParseNamedModels("en:a.txt,en:b.txt", &models));
+}
+
+}  // namespace sherpa_onnx
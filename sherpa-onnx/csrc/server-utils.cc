@@ -0,0 +1,61 @@
+// sherpa-onnx/csrc/server-utils.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/server-utils.h"
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/text-utils.h"
+
+namespace sherpa_onnx {
+
+std::string GetQueryValue(const std::string &resource,
+                          const std::string &key) {
+  auto pos = resource.find('?');
+  if (pos == std::string::npos) {
+    return {};
+  }
+
+  std::vector<std::string> fields;
+  SplitStringToVector(resource.substr(pos + 1), "&", true, &fields);
+
+  for (const auto &f : fields) {
+    auto eq = f.find('=');
+    if (f.substr(0, eq) == key) {
+      return eq == std::string::npos ? "" : f.substr(eq + 1);
+    }
+  }
+
+  return {};
+}
+
+bool ParseNamedModels(
+    const std::string &s,
+    std::vector<std::pair<std::string, std::string>> *models) {
+  std::vector<std::string> entries;
+  SplitStringToVector(s, ",", true, &entries);
+
+  std::set<std::string> names;
+  for (const auto &e : entries) {
+    // Use the first ':' so that the file name may contain ':'
+    auto pos = e.find(':');
+    if (pos == std::string::npos || pos == 0 || pos + 1 == e.size()) {
+      return false;
+    }
+
+    std::string name = e.substr(0, pos);
+    if (!names.insert(name).second) {
+      return false;
+    }
+
+    models->emplace_back(std::move(name), e.substr(pos + 1));
+  }
+
+  return true;
+}
+
+}  // namespace sherpa_onnx
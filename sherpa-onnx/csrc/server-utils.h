@@ -0,0 +1,27 @@
+// sherpa-onnx/csrc/server-utils.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_SERVER_UTILS_H_
+#define SHERPA_ONNX_CSRC_SERVER_UTILS_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sherpa_onnx {
+
+// Return the value of key in the query of a request URI, e.g.,
+// "/?model=en&sample_rate=8000", or an empty string if there is no such key
+std::string GetQueryValue(const std::string &resource, const std::string &key);
+
+// Parse a list of named models, e.g., "en:/path/to/en.txt,zh:/path/to/zh.txt",
+// into pairs of (name, config file).
+//
+// @return Return false if an entry is not in the format name:file or
+//         if a name is used more than once.
+bool ParseNamedModels(const std::string &s,
+                      std::vector<std::pair<std::string, std::string>> *models);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_SERVER_UTILS_H_
@@ -5,7 +5,10 @@
 #include "sherpa-onnx/csrc/session.h"
 
 #include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <memory>
+#include <mutex>  // NOLINT
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -34,6 +37,62 @@
 
 namespace sherpa_onnx {
 
+// The environment with the shared thread pools. It is never released since
+// models may use it until the process exits.
+static Ort::Env *global_env = nullptr;
+static std::mutex global_env_mutex;
+static std::atomic<bool> has_global_thread_pool{false};
+
+void InitGlobalThreadPool(const OrtThreadPoolConfig &config) {
+  if (!config.enabled) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(global_env_mutex);
+  if (global_env) {
+    SHERPA_ONNX_LOGE("The global thread pool can be initialized only once");
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  const auto &api = Ort::GetApi();
+
+  OrtThreadingOptions *p = nullptr;
+  Ort::ThrowOnError(api.CreateThreadingOptions(&p));
+
+  auto release = [&api](OrtThreadingOptions *p) {
+    api.ReleaseThreadingOptions(p);
+  };
+  std::unique_ptr<OrtThreadingOptions, decltype(release)> options(p, release);
+
+  Ort::ThrowOnError(api.SetGlobalIntraOpNumThreads(
+      options.get(), config.intra_op_num_threads));
+  Ort::ThrowOnError(api.SetGlobalInterOpNumThreads(
+      options.get(), config.inter_op_num_threads));
+  Ort::ThrowOnError(
+      api.SetGlobalSpinControl(options.get(), config.allow_spinning ? 1 : 0));
+
+  if (!config.intra_op_thread_affinity.empty()) {
+#if ORT_API_VERSION >= 14
+    Ort::ThrowOnError(api.SetGlobalIntraOpThreadAffinity(
+        options.get(), config.intra_op_thread_affinity.c_str()));
+#else
+    SHERPA_ONNX_LOGE(
+        "Thread affinity requires onnxruntime >= 1.14. Current API version: "
+        "%d. Ignore it.",
+        static_cast<int32_t>(ORT_API_VERSION));
+#endif
+  }
+
+  OrtEnv *env = nullptr;
+  Ort::ThrowOnError(api.CreateEnvWithGlobalThreadPools(
+      ORT_LOGGING_LEVEL_ERROR, "sherpa-onnx", options.get(), &env));
+
+  global_env = new Ort::Env(env);
+  has_global_thread_pool = true;
+}
+
+bool HasGlobalThreadPool() { return has_global_thread_pool; }
+
 static void OrtStatusFailure(OrtStatus *status, const char *s) {
   const auto &api = Ort::GetApi();
   const char *msg = api.GetErrorMessage(status);
@@ -142,9 +201,14 @@ Ort::SessionOptions GetSessionOptionsImpl(
   Provider p = StringToProvider(new_provider_str);
 
   Ort::SessionOptions sess_opts;
-  sess_opts.SetIntraOpNumThreads(num_threads);
+  if (HasGlobalThreadPool()) {
+    // Use the pools shared by all sessions. num_threads is ignored.
+    sess_opts.DisablePerSessionThreads();
+  } else {
+    sess_opts.SetIntraOpNumThreads(num_threads);
 
-  sess_opts.SetInterOpNumThreads(num_threads);
+    sess_opts.SetInterOpNumThreads(num_threads);
+  }
 
   std::vector<std::string> available_providers = Ort::GetAvailableProviders();
   std::ostringstream os;
@@ -11,9 +11,23 @@
 #include "sherpa-onnx/csrc/offline-lm-config.h"
 #include "sherpa-onnx/csrc/online-lm-config.h"
 #include "sherpa-onnx/csrc/online-model-config.h"
+#include "sherpa-onnx/csrc/ort-thread-pool-config.h"
 
 namespace sherpa_onnx {
 
+/* Create the Ort::Env of this process with thread pools shared by all
+ * sessions. Sessions created afterwards do not have their own pools.
+ *
+ * onnxruntime keeps a single environment per process, and the Ort::Env
+ * created by each model refers to it while it exists, so it has to be
+ * called once, before creating any model. It does nothing if
+ * config.enabled is false.
+ */
+void InitGlobalThreadPool(const OrtThreadPoolConfig &config);
+
+// Return true if InitGlobalThreadPool() has created the shared pools
+bool HasGlobalThreadPool();
+
 Ort::SessionOptions GetSessionOptionsImpl(
     int32_t num_threads, const std::string &provider_str,
     const ProviderConfig *provider_config = nullptr);
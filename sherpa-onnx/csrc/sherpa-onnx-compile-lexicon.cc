@@ -0,0 +1,130 @@
+// sherpa-onnx/csrc/sherpa-onnx-compile-lexicon.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#include <stdio.h>
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/flat-lexicon.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/symbol-table.h"
+#include "sherpa-onnx/csrc/text-utils.h"
+
+int main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Convert lexicon.txt of a TTS model into a flat binary format.
+
+The output file can be passed to --vits-lexicon, --matcha-lexicon or
+--kokoro-lexicon in place of the text lexicons. It is memory-mapped at
+load time, so it loads without parsing and its pages are shared by all
+processes using it.
+
+Words are converted to lowercase. If a word appears more than once, only
+the first pronunciation is kept. Words with unknown tokens are skipped.
+Words without any tokens are saved with an empty pronunciation; whether
+they are used is decided by the model that loads the lexicon, in the same
+way as for the text lexicons.
+
+Usage:
+
+./bin/sherpa-onnx-compile-lexicon \
+  --tokens=/path/to/tokens.txt \
+  /path/to/lexicon-us-en.txt,/path/to/lexicon-zh.txt \
+  /path/to/lexicon.bin
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+
+  std::string tokens;
+  po.Register("tokens", &tokens, "Path to tokens.txt of the model");
+
+  po.Read(argc, argv);
+  if (po.NumArgs() != 2) {
+    fprintf(stderr, "Error: Please provide the input and output filenames.\n\n");
+    po.PrintUsage();
+    SHERPA_ONNX_EXIT(EXIT_FAILURE);
+  }
+
+  if (tokens.empty()) {
+    fprintf(stderr, "Error: Please provide --tokens\n\n");
+    po.PrintUsage();
+    SHERPA_ONNX_EXIT(EXIT_FAILURE);
+  }
+
+  std::string in_filenames = po.GetArg(1);
+  std::string out_filename = po.GetArg(2);
+
+  const auto begin = std::chrono::steady_clock::now();
+
+  std::unordered_map<std::string, int32_t> token2id;
+  {
+    std::ifstream is(tokens);
+    token2id = sherpa_onnx::ReadTokens(is);
+  }
+
+  std::vector<std::string> files;
+  sherpa_onnx::SplitStringToVector(in_filenames, ",", false, &files);
+
+  sherpa_onnx::FlatLexiconBuilder builder;
+
+  std::string line;
+  std::string word;
+  std::string token;
+  std::vector<std::string> token_list;
+
+  for (const auto &f : files) {
+    std::ifstream is(f);
+    if (!is) {
+      fprintf(stderr, "Failed to open '%s'\n", f.c_str());
+      return -1;
+    }
+
+    while (std::getline(is, line)) {
+      std::istringstream iss(line);
+
+      token_list.clear();
+      if (!(iss >> word)) {
+        continue;
+      }
+      sherpa_onnx::ToLowerCase(&word);
+
+      while (iss >> token) {
+        token_list.push_back(std::move(token));
+      }
+
+      std::vector<int32_t> ids =
+          sherpa_onnx::ConvertTokensToIds(token2id, token_list);
+      if (ids.empty() && !token_list.empty()) {
+        // unknown tokens
+        continue;
+      }
+
+      builder.Add(word, ids);
+    }
+  }
+
+  if (!builder.Write(out_filename)) {
+    fprintf(stderr, "Failed to save to '%s'\n", out_filename.c_str());
+    return -1;
+  }
+
+  const auto end = std::chrono::steady_clock::now();
+
+  float elapsed_seconds =
+      std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
+          .count() /
+      1000.;
+
+  fprintf(stderr, "Number of words: %d\n", builder.NumWords());
+  fprintf(stderr, "Saved to '%s'\n", out_filename.c_str());
+  fprintf(stderr, "Elapsed seconds: %.3f s\n", elapsed_seconds);
+
+  return 0;
+}
@@ -0,0 +1,64 @@
+// sherpa-onnx/csrc/sherpa-onnx-compile-lodr-fst.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#include <stdio.h>
+
+#include <chrono>
+#include <string>
+
+#include "sherpa-onnx/csrc/lodr-fst.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+
+int main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Convert an n-gram FST for LODR into a flat binary format.
+
+The output file can be passed to --lodr-fst in place of the original
+FST. It is memory-mapped at load time, so it loads in milliseconds and
+its pages are shared by all processes using it.
+
+Usage:
+
+./bin/sherpa-onnx-compile-lodr-fst \
+  --lodr-backoff-id=-1 \
+  /path/to/2gram.fst \
+  /path/to/2gram.flat
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+
+  int32_t backoff_id = -1;
+  po.Register("lodr-backoff-id", &backoff_id,
+              "ID of the backoff in the LODR FST. -1 means autodetect");
+
+  po.Read(argc, argv);
+  if (po.NumArgs() != 2) {
+    fprintf(stderr, "Error: Please provide the input and output filenames.\n\n");
+    po.PrintUsage();
+    SHERPA_ONNX_EXIT(EXIT_FAILURE);
+  }
+
+  std::string in_filename = po.GetArg(1);
+  std::string out_filename = po.GetArg(2);
+
+  const auto begin = std::chrono::steady_clock::now();
+
+  sherpa_onnx::LodrFst lodr_fst(in_filename, backoff_id);
+  if (!lodr_fst.SaveFlat(out_filename)) {
+    fprintf(stderr, "Failed to save to '%s'\n", out_filename.c_str());
+    return -1;
+  }
+
+  const auto end = std::chrono::steady_clock::now();
+
+  float elapsed_seconds =
+      std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
+          .count() /
+      1000.;
+
+  fprintf(stderr, "Saved to '%s'\n", out_filename.c_str());
+  fprintf(stderr, "Elapsed seconds: %.3f s\n", elapsed_seconds);
+
+  return 0;
+}
@@ -7,9 +7,9 @@
 #include <string>
 #include <vector>
 
-#include "sherpa-onnx/csrc/offline-speech-denoiser.h"
+#include "sherpa-onnx/csrc/audio-source.h"
 #include "sherpa-onnx/csrc/macros.h"
-#include "sherpa-onnx/csrc/wave-reader.h"
+#include "sherpa-onnx/csrc/offline-speech-denoiser.h"
 #include "sherpa-onnx/csrc/wave-writer.h"
 
 int main(int32_t argc, char *argv[]) {
@@ -50,6 +50,19 @@ wget https://github.com/k2-fsa/sherpa-onnx/releases/download/speech-enhancement-
   --speech-denoiser-dpdfnet-model=dpdfnet2_48khz_hr.onnx \
   --input-wav=input.wav \
   --output-wav=output_48k.wav
+
+(3) Long recordings
+
+Pass --segment-duration to denoise the input in segments of that many
+seconds. Memory usage then does not grow with the length of the input and
+--segment-num-threads segments are denoised in parallel, e.g.,
+
+./bin/sherpa-onnx-offline-denoiser \
+  --speech-denoiser-gtcrn-model=gtcrn_simple.onnx \
+  --segment-duration=30 \
+  --segment-num-threads=4 \
+  --input-wav=input.wav \
+  --output-wav=output_16k.wav
 )usage";
 
   sherpa_onnx::ParseOptions po(kUsageMessage);
@@ -69,6 +82,11 @@ wget https://github.com/k2-fsa/sherpa-onnx/releases/download/speech-enhancement-
   }
   fprintf(stderr, "%s\n", config.ToString().c_str());
 
+  if (!config.Validate()) {
+    fprintf(stderr, "Errors in config!\n");
+    SHERPA_ONNX_EXIT(EXIT_FAILURE);
+  }
+
   if (input_wave.empty()) {
     fprintf(stderr, "Please provide --input-wav\n");
     po.PrintUsage();
@@ -82,18 +100,24 @@ wget https://github.com/k2-fsa/sherpa-onnx/releases/download/speech-enhancement-
   }
 
   sherpa_onnx::OfflineSpeechDenoiser denoiser(config);
-  int32_t sampling_rate = -1;
-  bool is_ok = false;
-  std::vector<float> samples =
-      sherpa_onnx::ReadWave(input_wave, &sampling_rate, &is_ok);
-  if (!is_ok) {
+  // The input is memory mapped and, with --segment-duration, read
+  // segment by segment, so long files need not fit into memory as floats
+  auto source = sherpa_onnx::AudioFileSource::CreateFromWave(input_wave);
+  if (!source) {
     fprintf(stderr, "Failed to read '%s'\n", input_wave.c_str());
     return -1;
   }
 
   fprintf(stderr, "Started\n");
   const auto begin = std::chrono::steady_clock::now();
-  auto result = denoiser.Run(samples.data(), samples.size(), sampling_rate);
+  sherpa_onnx::DenoisedAudio result;
+  result.sample_rate = denoiser.GetSampleRate();
+  denoiser.Run(source.get(),
+               [&result](const sherpa_onnx::DenoisedAudio &audio) {
+                 result.samples.insert(result.samples.end(),
+                                       audio.samples.begin(),
+                                       audio.samples.end());
+               });
   const auto end = std::chrono::steady_clock::now();
 
   float elapsed_seconds =
@@ -102,7 +126,7 @@ wget https://github.com/k2-fsa/sherpa-onnx/releases/download/speech-enhancement-
       1000.;
 
   fprintf(stderr, "Done\n");
-  is_ok = sherpa_onnx::WriteWave(output_wave, result.sample_rate,
+  bool is_ok = sherpa_onnx::WriteWave(output_wave, result.sample_rate,
                                  result.samples.data(), result.samples.size());
   if (is_ok) {
     fprintf(stderr, "Saved to %s\n", output_wave.c_str());
@@ -110,8 +134,12 @@ wget https://github.com/k2-fsa/sherpa-onnx/releases/download/speech-enhancement-
     fprintf(stderr, "Failed to save to %s\n", output_wave.c_str());
   }
 
-  float duration = samples.size() / static_cast<float>(sampling_rate);
+  float duration =
+      source->NumSamples() / static_cast<float>(source->SampleRate());
   fprintf(stderr, "num threads: %d\n", config.model.num_threads);
+  if (config.segment_duration > 0) {
+    fprintf(stderr, "segment num threads: %d\n", config.segment_num_threads);
+  }
   fprintf(stderr, "Elapsed seconds: %.3f s\n", elapsed_seconds);
   float rtf = elapsed_seconds / duration;
   fprintf(stderr, "Real time factor (RTF): %.3f / %.3f = %.3f\n",
@@ -4,40 +4,18 @@
 
 #include <stdio.h>
 
-#include <atomic>
 #include <chrono>
 #include <fstream>
-#include <mutex>
+#include <sstream>
 #include <string>
 #include <thread>
 #include <utility>
 #include <vector>
 
-#include "sherpa-onnx/csrc/offline-recognizer.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-batch-transcriber.h"
+#include "sherpa-onnx/csrc/offline-recognizer.h"
 #include "sherpa-onnx/csrc/parse-options.h"
-#include "sherpa-onnx/csrc/wave-reader.h"
-
-std::atomic<int> wav_index(0);
-std::mutex mtx;
-
-std::vector<std::vector<std::string>> SplitToBatches(
-    const std::vector<std::string> &input, int32_t batch_size) {
-  std::vector<std::vector<std::string>> outputs;
-  auto itr = input.cbegin();
-  int32_t process_num = 0;
-
-  while (process_num + batch_size <= static_cast<int32_t>(input.size())) {
-    auto chunk_end = itr + batch_size;
-    outputs.emplace_back(itr, chunk_end);
-    itr = chunk_end;
-    process_num += batch_size;
-  }
-  if (itr != input.cend()) {
-    outputs.emplace_back(itr, input.cend());
-  }
-  return outputs;
-}
 
 std::vector<std::string> LoadScpFile(const std::string &wav_scp_path) {
   std::vector<std::string> wav_paths;
@@ -56,85 +34,6 @@ std::vector<std::string> LoadScpFile(const std::string &wav_scp_path) {
   return wav_paths;
 }
 
-void AsrInference(const std::vector<std::vector<std::string>> &chunk_wav_paths,
-                  sherpa_onnx::OfflineRecognizer *recognizer,
-                  float *total_length, float *total_time) {
-  std::vector<std::unique_ptr<sherpa_onnx::OfflineStream>> ss;
-  std::vector<sherpa_onnx::OfflineStream *> ss_pointers;
-  float duration = 0.0f;
-  float elapsed_seconds_batch = 0.0f;
-
-  // warm up
-  for (const auto &wav_filename : chunk_wav_paths[0]) {
-    int32_t sampling_rate = -1;
-    bool is_ok = false;
-    const std::vector<float> samples =
-        sherpa_onnx::ReadWave(wav_filename, &sampling_rate, &is_ok);
-    if (!is_ok) {
-      fprintf(stderr, "Failed to read '%s'\n", wav_filename.c_str());
-      continue;
-    }
-    duration += samples.size() / static_cast<float>(sampling_rate);
-    auto s = recognizer->CreateStream();
-    s->AcceptWaveform(sampling_rate, samples.data(), samples.size());
-
-    ss.push_back(std::move(s));
-    ss_pointers.push_back(ss.back().get());
-  }
-  recognizer->DecodeStreams(ss_pointers.data(), ss_pointers.size());
-  ss_pointers.clear();
-  ss.clear();
-
-  while (true) {
-    int chunk = wav_index.fetch_add(1);
-    if (chunk >= static_cast<int32_t>(chunk_wav_paths.size())) {
-      break;
-    }
-    const auto &wav_paths = chunk_wav_paths[chunk];
-    const auto begin = std::chrono::steady_clock::now();
-    for (const auto &wav_filename : wav_paths) {
-      int32_t sampling_rate = -1;
-      bool is_ok = false;
-      const std::vector<float> samples =
-          sherpa_onnx::ReadWave(wav_filename, &sampling_rate, &is_ok);
-      if (!is_ok) {
-        fprintf(stderr, "Failed to read '%s'\n", wav_filename.c_str());
-        continue;
-      }
-      duration += samples.size() / static_cast<float>(sampling_rate);
-      auto s = recognizer->CreateStream();
-      s->AcceptWaveform(sampling_rate, samples.data(), samples.size());
-
-      ss.push_back(std::move(s));
-      ss_pointers.push_back(ss.back().get());
-    }
-    recognizer->DecodeStreams(ss_pointers.data(), ss_pointers.size());
-    const auto end = std::chrono::steady_clock::now();
-    float elapsed_seconds =
-        std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
-            .count() /
-        1000.;
-    elapsed_seconds_batch += elapsed_seconds;
-    int i = 0;
-    for (const auto &wav_filename : wav_paths) {
-      fprintf(stderr, "%s\n", wav_filename.c_str());
-      fprintf(stdout, "%s\n", ss[i]->GetResult().AsJsonString().c_str());
-      fprintf(stderr, "----\n");
-      i = i + 1;
-    }
-    ss_pointers.clear();
-    ss.clear();
-  }
-
-  {
-    std::lock_guard<std::mutex> guard(mtx);
-    *total_length += duration;
-    if (*total_time < elapsed_seconds_batch) {
-      *total_time = elapsed_seconds_batch;
-    }
-  }
-}
-
 int main(int32_t argc, char *argv[]) {
   const char *kUsageMessage = R"usage(
 Speech recognition using non-streaming models with sherpa-onnx.
@@ -215,7 +114,9 @@ See https://k2-fsa.github.io/sherpa/onnx/pretrained_models/offline-ctc/yesno/ind
     ./sherpa-onnx-tdnn-yesno/test_wavs/0_0_0_1_0_0_0_1.wav \
     ./sherpa-onnx-tdnn-yesno/test_wavs/0_0_1_0_0_0_1_0.wav
 
-Note: It supports decoding multiple files in batches
+Note: It supports decoding multiple files in batches. Files are grouped
+by duration, so that files in a batch have similar lengths, and results
+are printed in the order of the input files.
 
 foo.wav should be of single channel, 16-bit PCM encoded wave file; its
 sampling rate can be arbitrary and does not need to be 16kHz.
@@ -225,20 +126,17 @@ https://k2-fsa.github.io/sherpa/onnx/pretrained_models/index.html
 for a list of pre-trained models to download.
 )usage";
   std::string wav_scp = "";  // file path, kaldi style wav list.
-  int32_t nj = 1;            // thread number
-  int32_t batch_size = 1;    // number of wav files processed at once.
   sherpa_onnx::ParseOptions po(kUsageMessage);
   sherpa_onnx::OfflineRecognizerConfig config;
+  sherpa_onnx::OfflineBatchTranscriberConfig transcriber_config;
+  transcriber_config.batch_size = 1;
   config.Register(&po);
+  transcriber_config.Register(&po);
   po.Register("wav-scp", &wav_scp,
               "a file including wav-id and wav-path, kaldi style wav list."
               "default="
               ". when it is not empty, wav files which positional "
               "parameters provide are invalid.");
-  po.Register("nj", &nj, "multi-thread num for decoding, default=1");
-  po.Register("batch-size", &batch_size,
-              "number of wav files processed at once during the decoding"
-              "process. default=1");
 
   po.Read(argc, argv);
   if (po.NumArgs() < 1 && wav_scp.empty()) {
@@ -249,7 +147,7 @@ for a list of pre-trained models to download.
 
   fprintf(stderr, "%s\n", config.ToString().c_str());
 
-  if (!config.Validate()) {
+  if (!config.Validate() || !transcriber_config.Validate()) {
     fprintf(stderr, "Errors in config!\n");
     return -1;
   }
@@ -265,7 +163,8 @@ for a list of pre-trained models to download.
   fprintf(stderr,
           "Started nj: %d, batch_size: %d, wav_path: %s. recognizer init time: "
           "%.6f\n",
-          nj, batch_size, wav_scp.c_str(), elapsed_seconds);
+          transcriber_config.num_workers, transcriber_config.batch_size,
+          wav_scp.c_str(), elapsed_seconds);
   std::this_thread::sleep_for(std::chrono::seconds(10));  // sleep 10s
   std::vector<std::string> wav_paths;
   if (!wav_scp.empty()) {
@@ -279,19 +178,32 @@ for a list of pre-trained models to download.
     fprintf(stderr, "wav files is empty.\n");
     return -1;
   }
-  std::vector<std::thread> threads;
-  std::vector<std::vector<std::string>> batch_wav_paths =
-      SplitToBatches(wav_paths, batch_size);
-  float total_length = 0.0f;
-  float total_time = 0.0f;
-  for (int i = 0; i < nj; i++) {
-    threads.emplace_back(std::thread(AsrInference, batch_wav_paths, &recognizer,
-                                     &total_length, &total_time));
-  }
 
-  for (auto &thread : threads) {
-    thread.join();
-  }
+  sherpa_onnx::OfflineBatchTranscriber transcriber(&recognizer,
+                                                   transcriber_config);
+
+  float total_length = 0.0f;
+  const auto start = std::chrono::steady_clock::now();
+
+  transcriber.Run(
+      wav_paths,
+      [&total_length](const sherpa_onnx::OfflineBatchTranscriberResult &r) {
+        if (!r.ok) {
+          fprintf(stderr, "Failed to read '%s'\n", r.filename.c_str());
+          return;
+        }
+
+        total_length += r.duration;
+        fprintf(stderr, "%s\n", r.filename.c_str());
+        fprintf(stdout, "%s\n", r.result.AsJsonString().c_str());
+        fprintf(stderr, "----\n");
+      });
+
+  const auto stop = std::chrono::steady_clock::now();
+  float total_time =
+      std::chrono::duration_cast<std::chrono::milliseconds>(stop - start)
+          .count() /
+      1000.;
 
   fprintf(stderr, "num threads: %d\n", config.model_config.num_threads);
   fprintf(stderr, "decoding method: %s\n", config.decoding_method.c_str());
@@ -299,6 +211,8 @@ for a list of pre-trained models to download.
     fprintf(stderr, "max active paths: %d\n", config.max_active_paths);
   }
   fprintf(stderr, "Elapsed seconds: %.3f s\n", total_time);
+  fprintf(stderr, "Padding efficiency: %.4f\n",
+          recognizer.PaddingEfficiency());
   float rtf = total_time / total_length;
   fprintf(stderr, "Real time factor (RTF): %.6f / %.6f = %.4f\n", total_time,
           total_length, rtf);
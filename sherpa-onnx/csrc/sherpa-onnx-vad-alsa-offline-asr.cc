@@ -143,10 +143,9 @@ as the device_name.
     vad->AcceptWaveform(samples.data(), samples.size());
 
     while (!vad->Empty()) {
-      const auto &segment = vad->Front();
+      const auto &segment = vad->FrontView();
       auto s = recognizer.CreateStream();
-      s->AcceptWaveform(sample_rate, segment.samples.data(),
-                        segment.samples.size());
+      s->AcceptWaveform(sample_rate, segment.samples);
       recognizer.DecodeStream(s.get());
       const auto &result = s->GetResult();
       if (!result.text.empty()) {
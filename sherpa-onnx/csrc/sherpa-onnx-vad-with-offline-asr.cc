@@ -11,12 +11,12 @@
 #include <utility>
 #include <vector>
 
-#include "sherpa-onnx/csrc/offline-recognizer.h"
+#include "sherpa-onnx/csrc/audio-source.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-recognizer.h"
 #include "sherpa-onnx/csrc/parse-options.h"
 #include "sherpa-onnx/csrc/resample.h"
 #include "sherpa-onnx/csrc/voice-activity-detector.h"
-#include "sherpa-onnx/csrc/wave-reader.h"
 
 int main(int32_t argc, char *argv[]) {
   const char *kUsageMessage = R"usage(
@@ -182,43 +182,61 @@ for a list of pre-trained models to download.
 
   std::string wave_filename = po.GetArg(1);
   fprintf(stderr, "Reading: %s\n", wave_filename.c_str());
-  int32_t sampling_rate = -1;
-  bool is_ok = false;
-  auto samples = sherpa_onnx::ReadWave(wave_filename, &sampling_rate, &is_ok);
-  if (!is_ok) {
+  // The file is memory mapped and read block by block, so that it needs
+  // not to fit into memory as floats
+  auto source = sherpa_onnx::AudioFileSource::CreateFromWave(wave_filename);
+  if (!source) {
     fprintf(stderr, "Failed to read '%s'\n", wave_filename.c_str());
     return -1;
   }
 
+  int32_t sampling_rate = source->SampleRate();
+
+  std::unique_ptr<sherpa_onnx::LinearResample> resampler;
   if (sampling_rate != 16000) {
-    fprintf(stderr, "Resampling from %d Hz to 16000 Hz", sampling_rate);
+    fprintf(stderr, "Resampling from %d Hz to 16000 Hz\n", sampling_rate);
     float min_freq = std::min<int32_t>(sampling_rate, 16000);
     float lowpass_cutoff = 0.99 * 0.5 * min_freq;
 
     int32_t lowpass_filter_width = 6;
-    auto resampler = std::make_unique<sherpa_onnx::LinearResample>(
+    resampler = std::make_unique<sherpa_onnx::LinearResample>(
         sampling_rate, 16000, lowpass_cutoff, lowpass_filter_width);
-    std::vector<float> out_samples;
-    resampler->Resample(samples.data(), samples.size(), true, &out_samples);
-    samples = std::move(out_samples);
-    fprintf(stderr, "Resampling done\n");
   }
 
   fprintf(stderr, "Started!\n");
   int32_t window_size = vad_config.silero_vad.window_size;
-  int32_t i = 0;
-  while (i < samples.size()) {
-    if (i + window_size <= samples.size()) {
-      vad->AcceptWaveform(samples.data() + i, window_size);
+
+  std::vector<float> samples;
+  std::vector<float> resampled;
+  std::vector<float> buffer;  // 16 kHz samples not yet sent to the VAD
+  int32_t block_size = std::max(window_size, sampling_rate / 10);
+  bool is_eof = false;
+
+  while (!is_eof) {
+    int32_t k = source->Read(block_size, &samples);
+    is_eof = k < block_size;
+
+    if (resampler) {
+      resampler->Resample(samples.data(), k, is_eof, &resampled);
+      buffer.insert(buffer.end(), resampled.begin(), resampled.end());
     } else {
-      vad->Flush();
+      buffer.insert(buffer.end(), samples.begin(), samples.end());
+    }
+
+    int32_t i = 0;
+    for (; i + window_size <= static_cast<int32_t>(buffer.size());
+         i += window_size) {
+      vad->AcceptWaveform(buffer.data() + i, window_size);
     }
+    buffer.erase(buffer.begin(), buffer.begin() + i);
 
-    i += window_size;
+    if (is_eof) {
+      vad->Flush();
+    }
 
     while (!vad->Empty()) {
-      const auto &segment = vad->Front();
-      float duration = segment.samples.size() / 16000.;
+      const auto &segment = vad->FrontView();
+      float duration = segment.samples.Size() / 16000.;
       float start_time = segment.start / 16000.;
       float end_time = start_time + duration;
       if (duration < 0.1) {
@@ -227,7 +245,7 @@ for a list of pre-trained models to download.
       }
 
       auto s = recognizer.CreateStream();
-      s->AcceptWaveform(16000, segment.samples.data(), segment.samples.size());
+      s->AcceptWaveform(16000, segment.samples);
       recognizer.DecodeStream(s.get());
       const auto &result = s->GetResult();
       if (!result.text.empty()) {
@@ -251,7 +269,7 @@ for a list of pre-trained models to download.
     fprintf(stderr, "max active paths: %d\n", asr_config.max_active_paths);
   }
 
-  float duration = samples.size() / 16000.;
+  float duration = source->NumSamples() / static_cast<float>(sampling_rate);
   fprintf(stderr, "Elapsed seconds: %.3f s\n", elapsed_seconds);
   float rtf = elapsed_seconds / duration;
   fprintf(stderr, "Real time factor (RTF): %.3f / %.3f = %.3f\n",
@@ -11,9 +11,9 @@
 #include <string>
 #include <vector>
 
-#include "sherpa-onnx/csrc/voice-activity-detector.h"
+#include "sherpa-onnx/csrc/audio-source.h"
 #include "sherpa-onnx/csrc/macros.h"
-#include "sherpa-onnx/csrc/wave-reader.h"
+#include "sherpa-onnx/csrc/voice-activity-detector.h"
 #include "sherpa-onnx/csrc/wave-writer.h"
 
 int32_t main(int32_t argc, char *argv[]) {
@@ -56,17 +56,15 @@ input.wav should be 16kHz.
   }
 
   std::string wav_filename = po.GetArg(1);
-  int32_t sampling_rate = -1;
 
-  bool is_ok = false;
-  std::vector<float> samples =
-      sherpa_onnx::ReadWave(wav_filename, &sampling_rate, &is_ok);
-
-  if (!is_ok) {
+  auto source = sherpa_onnx::AudioFileSource::CreateFromWave(wav_filename);
+  if (!source) {
     fprintf(stderr, "Failed to read '%s'\n", wav_filename.c_str());
     return -1;
   }
 
+  int32_t sampling_rate = source->SampleRate();
+
   if (sampling_rate != 16000) {
     fprintf(stderr, "Support only 16000Hz. Given: %d\n", sampling_rate);
     return -1;
@@ -76,15 +74,14 @@ input.wav should be 16kHz.
 
   int32_t window_size = config.silero_vad.window_size;
 
-  int32_t i = 0;
   bool is_eof = false;
 
+  std::vector<float> samples;
   std::vector<float> samples_without_silence;
 
   while (!is_eof) {
-    if (i + window_size < samples.size()) {
-      vad->AcceptWaveform(samples.data() + i, window_size);
-      i += window_size;
+    if (source->Read(window_size, &samples) == window_size) {
+      vad->AcceptWaveform(samples.data(), window_size);
     } else {
       vad->Flush();
       is_eof = true;
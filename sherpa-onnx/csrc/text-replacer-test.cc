@@ -0,0 +1,114 @@
+// sherpa-onnx/csrc/text-replacer-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/text-replacer.h"
+
+#include <chrono>  // NOLINT
+#include <regex>   // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+TEST(TextReplacer, Basic) {
+  TextReplacer replacer({{"ab", "x"}, {"abc", "y"}, {"c", "ab"}});
+
+  EXPECT_EQ(replacer.Apply(""), "");
+  EXPECT_EQ(replacer.Apply("abcd"), "yd");
+  EXPECT_EQ(replacer.Apply("abd"), "xd");
+
+  // the output of a rule is not matched again
+  EXPECT_EQ(replacer.Apply("cc"), "abab");
+}
+
+TEST(TextReplacer, MergeSpaces) {
+  TextReplacer replacer({}, true);
+
+  EXPECT_EQ(replacer.Apply(" a \t\n b  "), " a b ");
+}
+
+// The punctuation rules of the Kokoro and Matcha lexicons
+static std::vector<std::pair<std::string, std::string>> PunctRules() {
+  return {
+      {"，", ","}, {":", ","},  {"、", ","}, {"；", ";"},
+      {"：", ":"}, {"。", "."}, {"？", "?"}, {"！", "!"},
+  };
+}
+
+// What the lexicons did before TextReplacer: compile and apply one
+// std::regex per rule for each text
+static std::string ApplyRegex(
+    const std::vector<std::pair<std::string, std::string>> &rules,
+    std::string text) {
+  for (const auto &p : rules) {
+    text = std::regex_replace(text, std::regex(p.first), p.second);
+  }
+  return std::regex_replace(text, std::regex("\\s+"), " ");
+}
+
+// It should give the same result as the std::regex rules used by
+// the Kokoro and Matcha lexicons
+TEST(TextReplacer, SameAsRegex) {
+  auto rules = PunctRules();
+
+  TextReplacer replacer(rules, true);
+
+  std::vector<std::string> texts = {
+      "你好，世界！How are   you?\tI'm fine：thanks。",
+      "a:b：c；d、e？  ",
+      "",
+  };
+
+  for (const auto &text : texts) {
+    EXPECT_EQ(replacer.Apply(text), ApplyRegex(rules, text));
+  }
+}
+
+static int32_t ElapsedMs(std::chrono::steady_clock::time_point start) {
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(stop - start)
+      .count();
+}
+
+// It is disabled since it only prints timings. Run it with
+//
+//  ./bin/text-replacer-test --gtest_also_run_disabled_tests \
+//    --gtest_filter=TextReplacer.DISABLED_Benchmark
+//
+// Build with -O2 to get meaningful numbers.
+TEST(TextReplacer, DISABLED_Benchmark) {
+  auto rules = PunctRules();
+  std::string text =
+      "你好，世界！今天天气很好：我们去公园吧。How are   you?\tI'm fine, "
+      "thanks；再见！";
+
+  int32_t n = 10000;
+
+  // Use the output so that the loops are not optimized away
+  size_t num_bytes = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int32_t i = 0; i != n; ++i) {
+    num_bytes += ApplyRegex(rules, text).size();
+  }
+  int32_t regex_ms = ElapsedMs(start);
+
+  start = std::chrono::steady_clock::now();
+  TextReplacer replacer(rules, true);
+  for (int32_t i = 0; i != n; ++i) {
+    num_bytes += replacer.Apply(text).size();
+  }
+  int32_t replacer_ms = ElapsedMs(start);
+
+  SHERPA_ONNX_LOGE("%d sentences of %d bytes: std::regex %d ms, "
+                   "TextReplacer %d ms (%d bytes in total)",
+                   n, static_cast<int32_t>(text.size()), regex_ms, replacer_ms,
+                   static_cast<int32_t>(num_bytes));
+}
+
+}  // namespace sherpa_onnx
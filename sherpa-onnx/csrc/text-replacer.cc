@@ -0,0 +1,80 @@
+// sherpa-onnx/csrc/text-replacer.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/text-replacer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+// Same as \s of std::regex in the "C" locale
+static bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+         c == '\r';
+}
+
+TextReplacer::TextReplacer(
+    const std::vector<std::pair<std::string, std::string>> &rules,
+    bool merge_spaces /*= false*/)
+    : merge_spaces_(merge_spaces) {
+  for (const auto &r : rules) {
+    if (r.first.empty()) {
+      SHERPA_ONNX_LOGE("Empty pattern in text replacement rules");
+      SHERPA_ONNX_EXIT(-1);
+    }
+
+    uint8_t c = static_cast<uint8_t>(r.first[0]);
+    rules_[c].push_back(r);
+  }
+
+  for (auto &v : rules_) {
+    std::stable_sort(v.begin(), v.end(), [](const auto &a, const auto &b) {
+      return a.first.size() > b.first.size();
+    });
+  }
+}
+
+std::string TextReplacer::Apply(const std::string &text) const {
+  std::string ans;
+  ans.reserve(text.size());
+
+  int32_t n = text.size();
+  int32_t i = 0;
+  while (i < n) {
+    if (merge_spaces_ && IsSpace(text[i])) {
+      ans.push_back(' ');
+      while (i < n && IsSpace(text[i])) {
+        ++i;
+      }
+      continue;
+    }
+
+    const auto &candidates = rules_[static_cast<uint8_t>(text[i])];
+
+    bool matched = false;
+    for (const auto &r : candidates) {
+      if (text.compare(i, r.first.size(), r.first) == 0) {
+        ans += r.second;
+        i += r.first.size();
+        matched = true;
+        break;
+      }
+    }
+
+    if (!matched) {
+      ans.push_back(text[i]);
+      ++i;
+    }
+  }
+
+  return ans;
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,45 @@
+// sherpa-onnx/csrc/text-replacer.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_TEXT_REPLACER_H_
+#define SHERPA_ONNX_CSRC_TEXT_REPLACER_H_
+
+#include <array>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sherpa_onnx {
+
+// Replace literal substrings of a text in a single pass.
+//
+// It is a fast replacement for a list of std::regex_replace() calls whose
+// patterns are plain strings, plus the common "\\s+" -> " " rule. The rules
+// are compiled once in the constructor and Apply() is const, so an object
+// can be shared by multiple threads.
+class TextReplacer {
+ public:
+  /*
+   * @param rules Pairs of (from, to). from must not be empty. All rules
+   *              are applied simultaneously, i.e., the output of a rule is
+   *              not matched again. If several rules match at the same
+   *              position, the longest one is used.
+   * @param merge_spaces If true, replace each run of ASCII whitespace
+   *                     characters with a single space.
+   */
+  explicit TextReplacer(
+      const std::vector<std::pair<std::string, std::string>> &rules,
+      bool merge_spaces = false);
+
+  std::string Apply(const std::string &text) const;
+
+ private:
+  // rules_[c] contains the rules whose pattern starts with the byte c,
+  // sorted by the length of the pattern in descending order
+  std::array<std::vector<std::pair<std::string, std::string>>, 256> rules_;
+  bool merge_spaces_ = false;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_TEXT_REPLACER_H_
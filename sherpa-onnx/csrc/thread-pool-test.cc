@@ -0,0 +1,88 @@
+// sherpa-onnx/csrc/thread-pool-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/thread-pool.h"
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(ThreadPool, Submit) {
+  ThreadPool pool(3);
+  EXPECT_EQ(pool.NumThreads(), 3);
+
+  std::vector<std::future<int32_t>> results;
+  for (int32_t i = 0; i != 10; ++i) {
+    results.push_back(pool.Submit([i]() { return i * i; }));
+  }
+
+  for (int32_t i = 0; i != 10; ++i) {
+    EXPECT_EQ(results[i].get(), i * i);
+  }
+}
+
+TEST(ThreadPool, Inline) {
+  ThreadPool pool(0);
+  EXPECT_EQ(pool.NumThreads(), 0);
+
+  auto f = pool.Submit([]() { return 5; });
+  EXPECT_EQ(f.get(), 5);
+
+  std::vector<int32_t> v(7);
+  pool.ParallelFor(v.size(), [&v](int32_t i) { v[i] = i + 1; });
+  for (int32_t i = 0; i != static_cast<int32_t>(v.size()); ++i) {
+    EXPECT_EQ(v[i], i + 1);
+  }
+}
+
+TEST(ThreadPool, ParallelFor) {
+  ThreadPool pool(4);
+
+  std::vector<int32_t> v(1000);
+  pool.ParallelFor(v.size(), [&v](int32_t i) { v[i] = 2 * i; });
+
+  for (int32_t i = 0; i != static_cast<int32_t>(v.size()); ++i) {
+    EXPECT_EQ(v[i], 2 * i);
+  }
+}
+
+TEST(ThreadPool, NestedParallelFor) {
+  ThreadPool pool(2);
+
+  std::atomic<int32_t> sum{0};
+  pool.ParallelFor(8, [&pool, &sum](int32_t) {
+    pool.ParallelFor(8, [&sum](int32_t j) { sum += j; });
+  });
+
+  EXPECT_EQ(sum.load(), 8 * 28);
+}
+
+TEST(ThreadPool, ParallelForException) {
+  ThreadPool pool(4);
+
+  std::atomic<int32_t> num_calls{0};
+  auto f = [&num_calls](int32_t i) {
+    num_calls += 1;
+    if (i == 3) {
+      throw std::runtime_error("failed at 3");
+    }
+  };
+
+  EXPECT_THROW(pool.ParallelFor(100, f), std::runtime_error);
+  EXPECT_LE(num_calls.load(), 100);
+
+  // The pool is still usable
+  std::vector<int32_t> v(10);
+  pool.ParallelFor(v.size(), [&v](int32_t i) { v[i] = i; });
+  for (int32_t i = 0; i != static_cast<int32_t>(v.size()); ++i) {
+    EXPECT_EQ(v[i], i);
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,144 @@
+// sherpa-onnx/csrc/thread-pool.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/thread-pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace sherpa_onnx {
+
+ThreadPool::ThreadPool(int32_t num_threads) {
+  workers_.reserve(std::max(num_threads, 0));
+  for (int32_t i = 0; i < num_threads; ++i) {
+    workers_.emplace_back([this]() { WorkerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_all();
+
+  for (auto &t : workers_) {
+    t.join();
+  }
+}
+
+void ThreadPool::WorkerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+
+      if (stop_ && tasks_.empty()) {
+        return;
+      }
+
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+
+    task();
+  }
+}
+
+namespace {
+
+struct ParallelForState {
+  std::atomic<int32_t> next{0};
+  int32_t n = 0;
+  int32_t num_done = 0;
+  std::function<void(int32_t)> f;
+
+  // The first exception thrown by f. Once it is set, the remaining items
+  // are skipped. Protected by mutex
+  std::exception_ptr error;
+  std::atomic<bool> failed{false};
+
+  std::mutex mutex;
+  std::condition_variable cond;
+};
+
+void RunParallelFor(const std::shared_ptr<ParallelForState> &state) {
+  int32_t count = 0;
+  for (int32_t i = state->next++; i < state->n; i = state->next++) {
+    // An item is counted as done even if f throws, so that the caller
+    // does not wait forever. The exception must not escape a worker.
+    if (!state->failed) {
+      try {
+        state->f(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->error) {
+          state->error = std::current_exception();
+        }
+        state->failed = true;
+      }
+    }
+    ++count;
+  }
+
+  if (count == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(state->mutex);
+  state->num_done += count;
+  if (state->num_done == state->n) {
+    state->cond.notify_all();
+  }
+}
+
+}  // namespace
+
+void ThreadPool::ParallelFor(int32_t n,
+                             const std::function<void(int32_t)> &f) {
+  if (n <= 0) {
+    return;
+  }
+
+  if (n == 1 || workers_.empty()) {
+    for (int32_t i = 0; i != n; ++i) {
+      f(i);
+    }
+    return;
+  }
+
+  auto state = std::make_shared<ParallelForState>();
+  state->n = n;
+  state->f = f;
+
+  // A helper may start after all items have been processed by other
+  // threads. It owns a reference to state, so that is harmless.
+  int32_t num_helpers = std::min<int32_t>(NumThreads(), n - 1);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int32_t i = 0; i != num_helpers; ++i) {
+      tasks_.emplace([state]() { RunParallelFor(state); });
+    }
+  }
+  cond_.notify_all();
+
+  RunParallelFor(state);
+
+  // Wait even if f has thrown, since helpers may still be running f,
+  // which refers to the frame of the caller
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->cond.wait(lock, [&state]() { return state->num_done == state->n; });
+
+  if (state->error) {
+    std::rethrow_exception(state->error);
+  }
+}
+
+}  // namespace sherpa_onnx
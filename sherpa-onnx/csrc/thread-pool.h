@@ -0,0 +1,83 @@
+// sherpa-onnx/csrc/thread-pool.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_THREAD_POOL_H_
+#define SHERPA_ONNX_CSRC_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sherpa_onnx {
+
+// A fixed-size pool of worker threads.
+//
+// If num_threads <= 0, no worker is created and every task is run
+// in the calling thread. This keeps single-threaded builds (e.g., wasm)
+// working without any special handling in the callers.
+class ThreadPool {
+ public:
+  explicit ThreadPool(int32_t num_threads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  // Number of worker threads. It is 0 if tasks are run inline.
+  int32_t NumThreads() const { return static_cast<int32_t>(workers_.size()); }
+
+  // Schedule f() to run on a worker thread.
+  template <typename F>
+  std::future<std::invoke_result_t<F>> Submit(F &&f) {
+    using R = std::invoke_result_t<F>;
+    auto task =
+        std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+    auto ans = task->get_future();
+
+    if (workers_.empty()) {
+      (*task)();
+      return ans;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.emplace([task]() { (*task)(); });
+    }
+    cond_.notify_one();
+
+    return ans;
+  }
+
+  // Run f(i) for i in [0, n) and wait until all of them are finished.
+  //
+  // Indexes are handed out one at a time, so slow items do not block
+  // fast ones. The calling thread also takes part in the work, so it is
+  // safe to call ParallelFor() from inside a task of the same pool.
+  //
+  // If f throws, the remaining items are skipped and the first exception
+  // is rethrown in the calling thread after all running calls of f return.
+  void ParallelFor(int32_t n, const std::function<void(int32_t)> &f);
+
+ private:
+  void WorkerLoop();
+
+ private:
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> tasks_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool stop_ = false;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_THREAD_POOL_H_
@@ -71,15 +71,10 @@ void TransducerKeywordDecoder::Decode(
     cur.clear();
     cur.reserve(batch_size);
 
-    Ort::Value decoder_input = model_->BuildDecoderInput(prev);
-    Ort::Value decoder_out = model_->RunDecoder(std::move(decoder_input));
-
-    Ort::Value cur_encoder_out =
-        GetEncoderOutFrame(model_->Allocator(), &encoder_out, t);
-    cur_encoder_out =
-        Repeat(model_->Allocator(), &cur_encoder_out, hyps_row_splits);
-    Ort::Value logit =
-        model_->RunJoiner(std::move(cur_encoder_out), View(&decoder_out));
+    Ort::Value decoder_out = model_->RunDecoderWithCache(prev);
+
+    Ort::Value logit = model_->RunJoinerOnFrame(
+        &encoder_out, t, View(&decoder_out), hyps_row_splits);
 
     float *p_logit = logit.GetTensorMutableData<float>();
     LogSoftmax(p_logit, vocab_size, num_hyps);
@@ -97,25 +97,18 @@ class VoiceActivityDetector::Impl {
         start_ = std::max(buffer_.Tail() - 2 * model_->WindowSize() -
                               model_->MinSpeechDurationSamples(),
                           buffer_.Head());
-        cur_segment_.start = start_;
       }
-      int32_t num_samples = buffer_.Tail() - start_ - 1;
-      cur_segment_.samples = buffer_.Get(start_, num_samples);
     } else {
       // non-speech
 
-      cur_segment_.start = -1;
-      cur_segment_.samples.clear();
-
       if (start_ != -1 && buffer_.Size()) {
         // end of speech, save the speech segment
         int32_t end = buffer_.Tail() - model_->MinSilenceDurationSamples();
 
-        std::vector<float> s = buffer_.Get(start_, end - start_);
-        SpeechSegment segment;
+        SpeechSegmentView segment;
 
         segment.start = start_;
-        segment.samples = std::move(s);
+        segment.samples = buffer_.GetView(start_, end - start_);
 
         segments_.push(std::move(segment));
 
@@ -137,9 +130,15 @@ class VoiceActivityDetector::Impl {
 
   bool Empty() const { return segments_.empty(); }
 
-  void Pop() { segments_.pop(); }
+  void Pop() {
+    segments_.pop();
+    front_.reset();
+  }
 
-  void Clear() { std::queue<SpeechSegment>().swap(segments_); }
+  void Clear() {
+    std::queue<SpeechSegmentView>().swap(segments_);
+    front_.reset();
+  }
 
   const SpeechSegment &Front() const {
     static SpeechSegment tmp;
@@ -151,20 +150,38 @@ class VoiceActivityDetector::Impl {
       return tmp;
     }
 
+    if (!front_) {
+      // Copy the samples only if the caller asks for them
+      const SpeechSegmentView &view = segments_.front();
+      front_ = std::make_unique<SpeechSegment>();
+      front_->start = view.start;
+      front_->samples = view.samples.ToVector();
+    }
+
+    return *front_;
+  }
+
+  const SpeechSegmentView &FrontView() const {
+    static SpeechSegmentView tmp;
+
+    if (Empty()) {
+      SHERPA_ONNX_LOGE(
+          "Make sure you call this method only when Empty() returns false; "
+          "Return an empty segment");
+      return tmp;
+    }
+
     return segments_.front();
   }
 
   void Reset() {
-    std::queue<SpeechSegment>().swap(segments_);
+    Clear();
 
     model_->Reset();
     buffer_.Reset();
     last_.clear();
 
     start_ = -1;
-
-    cur_segment_.start = -1;
-    cur_segment_.samples.clear();
   }
 
   void Flush() {
@@ -177,25 +194,36 @@ class VoiceActivityDetector::Impl {
       return;
     }
 
-    std::vector<float> s = buffer_.Get(start_, end - start_);
-
-    SpeechSegment segment;
+    SpeechSegmentView segment;
 
     segment.start = start_;
-    segment.samples = std::move(s);
+    segment.samples = buffer_.GetView(start_, end - start_);
 
     segments_.push(std::move(segment));
 
     buffer_.Pop(end - buffer_.Head());
     start_ = -1;
-
-    cur_segment_.start = -1;
-    cur_segment_.samples.clear();
   }
 
   bool IsSpeechDetected() const { return start_ != -1; }
 
-  SpeechSegment CurrentSpeechSegment() const { return cur_segment_; }
+  SpeechSegment CurrentSpeechSegment() const {
+    SpeechSegment ans;
+    ans.start = start_;
+    if (start_ != -1) {
+      ans.samples = buffer_.Get(start_, buffer_.Tail() - start_ - 1);
+    }
+    return ans;
+  }
+
+  SpeechSegmentView CurrentSpeechSegmentView() const {
+    SpeechSegmentView ans;
+    ans.start = start_;
+    if (start_ != -1) {
+      ans.samples = buffer_.GetView(start_, buffer_.Tail() - start_ - 1);
+    }
+    return ans;
+  }
 
   const VadModelConfig &GetConfig() const { return config_; }
 
@@ -214,10 +242,11 @@ class VoiceActivityDetector::Impl {
   }
 
  private:
-  std::queue<SpeechSegment> segments_;
+  std::queue<SpeechSegmentView> segments_;
 
-  // it is empty if no speech is detected
-  SpeechSegment cur_segment_;
+  // A copy of the samples of segments_.front(), created by Front() on
+  // demand
+  mutable std::unique_ptr<SpeechSegment> front_;
 
   std::unique_ptr<VadModel> model_;
   VadModelConfig config_;
@@ -257,6 +286,10 @@ const SpeechSegment &VoiceActivityDetector::Front() const {
   return impl_->Front();
 }
 
+const SpeechSegmentView &VoiceActivityDetector::FrontView() const {
+  return impl_->FrontView();
+}
+
 void VoiceActivityDetector::Reset() const { impl_->Reset(); }
 
 void VoiceActivityDetector::Flush() const { impl_->Flush(); }
@@ -269,6 +302,10 @@ SpeechSegment VoiceActivityDetector::CurrentSpeechSegment() const {
   return impl_->CurrentSpeechSegment();
 }
 
+SpeechSegmentView VoiceActivityDetector::CurrentSpeechSegmentView() const {
+  return impl_->CurrentSpeechSegmentView();
+}
+
 const VadModelConfig &VoiceActivityDetector::GetConfig() const {
   return impl_->GetConfig();
 }
@@ -7,6 +7,7 @@
 #include <memory>
 #include <vector>
 
+#include "sherpa-onnx/csrc/circular-buffer.h"
 #include "sherpa-onnx/csrc/vad-model-config.h"
 
 namespace sherpa_onnx {
@@ -16,6 +17,16 @@ struct SpeechSegment {
   std::vector<float> samples;
 };
 
+// Like SpeechSegment, but the samples are not copied out of the internal
+// buffer of the detector. The samples stay valid as long as the view or
+// any copy of it is alive, even after Pop(), Reset() or further calls to
+// AcceptWaveform(). Please release it once it is processed since it
+// keeps the buffer from reusing its memory.
+struct SpeechSegmentView {
+  int32_t start = -1;  // in samples
+  CircularBufferView samples;
+};
+
 class VoiceActivityDetector {
  public:
   explicit VoiceActivityDetector(const VadModelConfig &config,
@@ -40,11 +51,18 @@ class VoiceActivityDetector {
   // methods of VoiceActivityDetector.
   const SpeechSegment &Front() const;
 
+  // Like Front(), but without copying the samples. It is an error to
+  // call it if Empty() returns true.
+  const SpeechSegmentView &FrontView() const;
+
   bool IsSpeechDetected() const;
 
   // It is empty if IsSpeechDetected() returns false
   SpeechSegment CurrentSpeechSegment() const;
 
+  // Like CurrentSpeechSegment(), but without copying the samples.
+  SpeechSegmentView CurrentSpeechSegmentView() const;
+
   void Reset() const;
 
   // At the end of the utterance, you can invoke this method so that
@@ -190,10 +190,10 @@ JNIEXPORT jobject JNICALL Java_com_k2fsa_sherpa_onnx_Vad_front(JNIEnv *env,
     return nullptr;
   }
 
-  const auto &front = vad->Front();
+  const auto &front = vad->FrontView();
 
   jfloatArray samples_arr =
-      env->NewFloatArray(static_cast<jsize>(front.samples.size()));
+      env->NewFloatArray(static_cast<jsize>(front.samples.Size()));
 
   if (!samples_arr) {
     SHERPA_ONNX_LOGE("Failed to allocate");
@@ -201,8 +201,8 @@ JNIEXPORT jobject JNICALL Java_com_k2fsa_sherpa_onnx_Vad_front(JNIEnv *env,
   }
 
   env->SetFloatArrayRegion(samples_arr, 0,
-                           static_cast<jsize>(front.samples.size()),
-                           front.samples.data());
+                           static_cast<jsize>(front.samples.Size()),
+                           front.samples.Data());
 
   jclass cls = env->FindClass("com/k2fsa/sherpa/onnx/SpeechSegment");
   if (!cls) {
@@ -229,6 +229,7 @@ type
     Encoder: AnsiString;
     Decoder: AnsiString;
     Joiner: AnsiString;
+    NativeJoiner: Boolean;
     function ToString: AnsiString;
   end;
 
@@ -356,6 +357,7 @@ type
     Encoder: AnsiString;
     Decoder: AnsiString;
     Joiner: AnsiString;
+    NativeJoiner: Boolean;
     function ToString: AnsiString;
   end;
 
@@ -877,6 +879,7 @@ type
     Encoder: PAnsiChar;
     Decoder: PAnsiChar;
     Joiner: PAnsiChar;
+    NativeJoiner: cint32;
   end;
   SherpaOnnxOnlineParaformerModelConfig = record
     Encoder: PAnsiChar;
@@ -951,6 +954,7 @@ type
     Encoder: PAnsiChar;
     Decoder: PAnsiChar;
     Joiner: PAnsiChar;
+    NativeJoiner: cint32;
   end;
   SherpaOnnxOfflineParaformerModelConfig = record
     Model: PAnsiChar;
@@ -1653,8 +1657,8 @@ end;
 
 function TSherpaOnnxOnlineTransducerModelConfig.ToString: AnsiString;
 begin
-  Result := Format('TSherpaOnnxOnlineTransducerModelConfig(Encoder := %s, Decoder := %s, Joiner := %s)',
-  [Self.Encoder, Self.Decoder, Self.Joiner]);
+  Result := Format('TSherpaOnnxOnlineTransducerModelConfig(Encoder := %s, Decoder := %s, Joiner := %s, NativeJoiner := %s)',
+  [Self.Encoder, Self.Decoder, Self.Joiner, Self.NativeJoiner.ToString]);
 end;
 
 function TSherpaOnnxOnlineParaformerModelConfig.ToString: AnsiString;
@@ -1793,6 +1797,7 @@ begin
   C.ModelConfig.Transducer.Encoder := PAnsiChar(Config.ModelConfig.Transducer.Encoder);
   C.ModelConfig.Transducer.Decoder := PAnsiChar(Config.ModelConfig.Transducer.Decoder);
   C.ModelConfig.Transducer.Joiner := PAnsiChar(Config.ModelConfig.Transducer.Joiner);
+  C.ModelConfig.Transducer.NativeJoiner := Ord(Config.ModelConfig.Transducer.NativeJoiner);
 
   C.ModelConfig.Paraformer.Encoder := PAnsiChar(Config.ModelConfig.Paraformer.Encoder);
   C.ModelConfig.Paraformer.Decoder := PAnsiChar(Config.ModelConfig.Paraformer.Decoder);
@@ -1942,9 +1947,10 @@ begin
   Result := Format('TSherpaOnnxOfflineTransducerModelConfig(' +
     'Encoder := %s, ' +
     'Decoder := %s, ' +
-    'Joiner := %s' +
+    'Joiner := %s, ' +
+    'NativeJoiner := %s' +
     ')',
-    [Self.Encoder, Self.Decoder, Self.Joiner]);
+    [Self.Encoder, Self.Decoder, Self.Joiner, Self.NativeJoiner.ToString]);
 end;
 
 function TSherpaOnnxOfflineParaformerModelConfig.ToString: AnsiString;
@@ -2199,6 +2205,7 @@ begin
   C.ModelConfig.Transducer.Encoder := PAnsiChar(Config.ModelConfig.Transducer.Encoder);
   C.ModelConfig.Transducer.Decoder := PAnsiChar(Config.ModelConfig.Transducer.Decoder);
   C.ModelConfig.Transducer.Joiner := PAnsiChar(Config.ModelConfig.Transducer.Joiner);
+  C.ModelConfig.Transducer.NativeJoiner := Ord(Config.ModelConfig.Transducer.NativeJoiner);
 
   C.ModelConfig.Paraformer.Model := PAnsiChar(Config.ModelConfig.Paraformer.Model);
   C.ModelConfig.NeMoCtc.Model := PAnsiChar(Config.ModelConfig.NeMoCtc.Model);
@@ -2544,6 +2551,7 @@ begin
   Dest.NumThreads := 1;
   Dest.Provider := 'cpu';
   Dest.Debug := False;
+  Dest.Transducer.NativeJoiner := False;
 end;
 
 class operator TSherpaOnnxOfflineWhisperModelConfig.Initialize({$IFDEF FPC}var{$ELSE}out{$ENDIF} Dest: TSherpaOnnxOfflineWhisperModelConfig);
@@ -2583,6 +2591,7 @@ begin
   Dest.NumThreads := 1;
   Dest.Debug := False;
   Dest.Provider := 'cpu';
+  Dest.Transducer.NativeJoiner := False;
 end;
 
 class operator TSherpaOnnxOfflineRecognizerConfig.Initialize({$IFDEF FPC}var{$ELSE}out{$ENDIF} Dest: TSherpaOnnxOfflineRecognizerConfig);
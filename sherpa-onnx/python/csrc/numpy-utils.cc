@@ -0,0 +1,46 @@
+// sherpa-onnx/python/csrc/numpy-utils.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/python/csrc/numpy-utils.h"
+
+#include <utility>
+#include <vector>
+
+namespace sherpa_onnx {
+
+std::vector<float> Int16ToFloat(const int16_t *samples, int32_t n) {
+  std::vector<float> ans(n);
+  for (int32_t i = 0; i != n; ++i) {
+    ans[i] = samples[i] / 32768.0f;
+  }
+
+  return ans;
+}
+
+PyContiguousInt16Array ToContiguous(const PyInt16Array &samples) {
+  return PyContiguousInt16Array::ensure(samples);
+}
+
+py::array_t<float> ToNumpy(std::vector<float> v) {
+  auto p = new std::vector<float>(std::move(v));
+
+  py::capsule owner(
+      p, [](void *q) { delete reinterpret_cast<std::vector<float> *>(q); });
+
+  return py::array_t<float>(p->size(), p->data(), owner);
+}
+
+py::array_t<float> ToNumpy(const CircularBufferView &v) {
+  auto p = new CircularBufferView(v);
+
+  py::capsule owner(
+      p, [](void *q) { delete reinterpret_cast<CircularBufferView *>(q); });
+
+  py::array_t<float> ans(p->Size(), p->Data(), owner);
+  ans.attr("setflags")(py::arg("write") = false);
+
+  return ans;
+}
+
+}  // namespace sherpa_onnx
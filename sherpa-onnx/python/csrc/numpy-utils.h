@@ -0,0 +1,51 @@
+// sherpa-onnx/python/csrc/numpy-utils.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_PYTHON_CSRC_NUMPY_UTILS_H_
+#define SHERPA_ONNX_PYTHON_CSRC_NUMPY_UTILS_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "sherpa-onnx/csrc/circular-buffer.h"
+#include "sherpa-onnx/python/csrc/sherpa-onnx.h"
+
+namespace sherpa_onnx {
+
+// Audio samples from Python. A C-contiguous float32 NumPy array is used
+// as it is, without a copy. Other inputs, e.g., a list or a float64 array,
+// are converted to float32.
+using PyFloatArray =
+    py::array_t<float, py::array::c_style | py::array::forcecast>;
+
+// 16-bit PCM samples from Python. It accepts int16 NumPy arrays of any
+// layout, e.g., stereo[:, 0]. Please declare the argument with
+// py::arg().noconvert() so that other dtypes are never cast to int16, and
+// an int16 array never goes to the unscaled PyFloatArray overload.
+// Use ToContiguous() to access the samples.
+using PyInt16Array = py::array_t<int16_t>;
+
+using PyContiguousInt16Array =
+    py::array_t<int16_t, py::array::c_style | py::array::forcecast>;
+
+// Return a C-contiguous version of samples. No samples are copied if it is
+// already contiguous. The GIL must be held.
+PyContiguousInt16Array ToContiguous(const PyInt16Array &samples);
+
+// Convert 16-bit PCM samples to floats in the range [-1, 1).
+// It does not use any Python API, so the GIL needs not to be held.
+std::vector<float> Int16ToFloat(const int16_t *samples, int32_t n);
+
+// Return a 1-D float32 NumPy array that takes the ownership of the
+// buffer of v. No samples are copied. The GIL must be held.
+py::array_t<float> ToNumpy(std::vector<float> v);
+
+// Return a read-only 1-D float32 NumPy array that refers to the samples
+// of the view. No samples are copied; the array keeps the view alive.
+// The GIL must be held.
+py::array_t<float> ToNumpy(const CircularBufferView &v);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_PYTHON_CSRC_NUMPY_UTILS_H_
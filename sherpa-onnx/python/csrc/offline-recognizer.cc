@@ -40,6 +40,8 @@ static void PybindOfflineRecognizerConfig(py::module *m) {
       .def_readwrite("rule_fsts", &PyClass::rule_fsts)
       .def_readwrite("rule_fars", &PyClass::rule_fars)
       .def_readwrite("hr", &PyClass::hr)
+      .def_readwrite("max_padding_ratio", &PyClass::max_padding_ratio)
+      .def_readwrite("num_bucket_threads", &PyClass::num_bucket_threads)
       .def("__str__", &PyClass::ToString);
 }
 
@@ -64,6 +66,8 @@ void PybindOfflineRecognizer(py::module *m) {
            py::call_guard<py::gil_scoped_release>())
       .def("set_config", &PyClass::SetConfig, py::arg("config"),
            py::call_guard<py::gil_scoped_release>())
+      .def_property_readonly("padding_efficiency",
+                             &PyClass::PaddingEfficiency)
       .def(
           "decode_streams",
           [](const PyClass &self, std::vector<OfflineStream *> ss) {
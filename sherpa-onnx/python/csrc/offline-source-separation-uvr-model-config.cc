@@ -13,8 +13,10 @@ namespace sherpa_onnx {
 void PybindOfflineSourceSeparationUvrModelConfig(py::module *m) {
   using PyClass = OfflineSourceSeparationUvrModelConfig;
   py::class_<PyClass>(*m, "OfflineSourceSeparationUvrModelConfig")
-      .def(py::init<const std::string &>(), py::arg("model") = "")
+      .def(py::init<const std::string &, int32_t>(), py::arg("model") = "",
+           py::arg("batch_size") = 1)
       .def_readwrite("model", &PyClass::model)
+      .def_readwrite("batch_size", &PyClass::batch_size)
       .def("validate", &PyClass::Validate)
       .def("__str__", &PyClass::ToString);
 }
@@ -18,9 +18,15 @@ void PybindOfflineSpeechDenoiserConfig(py::module *m) {
 
   py::class_<PyClass>(*m, "OfflineSpeechDenoiserConfig")
       .def(py::init<>())
-      .def(py::init<const OfflineSpeechDenoiserModelConfig &>(),
-           py::arg("model") = OfflineSpeechDenoiserModelConfig{})
+      .def(py::init<const OfflineSpeechDenoiserModelConfig &, float, float,
+                    int32_t>(),
+           py::arg("model") = OfflineSpeechDenoiserModelConfig{},
+           py::arg("segment_duration") = 0, py::arg("segment_overlap") = 0.5,
+           py::arg("segment_num_threads") = 1)
       .def_readwrite("model", &PyClass::model)
+      .def_readwrite("segment_duration", &PyClass::segment_duration)
+      .def_readwrite("segment_overlap", &PyClass::segment_overlap)
+      .def_readwrite("segment_num_threads", &PyClass::segment_num_threads)
       .def("validate", &PyClass::Validate)
       .def("__str__", &PyClass::ToString);
 }
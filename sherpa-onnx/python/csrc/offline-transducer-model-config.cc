@@ -21,6 +21,9 @@ void PybindOfflineTransducerModelConfig(py::module *m) {
       .def_readwrite("encoder_filename", &PyClass::encoder_filename)
       .def_readwrite("decoder_filename", &PyClass::decoder_filename)
       .def_readwrite("joiner_filename", &PyClass::joiner_filename)
+      .def_readwrite("native_joiner", &PyClass::native_joiner)
+      .def_readwrite("decoder_output_cache_size",
+                     &PyClass::decoder_output_cache_size)
       .def("__str__", &PyClass::ToString);
 }
 
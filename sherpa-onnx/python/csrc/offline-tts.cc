@@ -4,10 +4,12 @@
 #include "sherpa-onnx/python/csrc/offline-tts.h"
 
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "sherpa-onnx/csrc/offline-tts.h"
+#include "sherpa-onnx/python/csrc/numpy-utils.h"
 #include "sherpa-onnx/python/csrc/offline-tts-model-config.h"
 
 namespace sherpa_onnx {
@@ -16,7 +18,25 @@ static void PybindGeneratedAudio(py::module *m) {
   using PyClass = GeneratedAudio;
   py::class_<PyClass>(*m, "GeneratedAudio")
       .def(py::init<>())
-      .def_readwrite("samples", &PyClass::samples)
+      .def(py::init([](const PyFloatArray &samples, int32_t sample_rate) {
+             auto ans = std::make_unique<PyClass>();
+             ans->samples.assign(samples.data(),
+                                 samples.data() + samples.size());
+             ans->sample_rate = sample_rate;
+             return ans;
+           }),
+           py::arg("samples"), py::arg("sample_rate"))
+      .def_property_readonly(
+          "samples",
+          [](py::object self) {
+            // A view of the samples without a copy. It keeps the
+            // GeneratedAudio object alive. The property is read-only
+            // since assigning to it would free the buffer of the views
+            // returned earlier; please create a new object instead.
+            auto &audio = self.cast<PyClass &>();
+            return py::array_t<float>(audio.samples.size(),
+                                      audio.samples.data(), self);
+          })
       .def_readwrite("sample_rate", &PyClass::sample_rate)
       .def("__str__", [](PyClass &self) {
         std::ostringstream os;
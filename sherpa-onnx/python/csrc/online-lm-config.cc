@@ -28,6 +28,7 @@ void PybindOnlineLMConfig(py::module *m) {
       .def_readwrite("lodr_fst", &PyClass::lodr_fst)
       .def_readwrite("lodr_scale", &PyClass::lodr_scale)
       .def_readwrite("lodr_backoff_id", &PyClass::lodr_backoff_id)
+      .def_readwrite("lm_cache_size", &PyClass::lm_cache_size)
 
       .def("__str__", &PyClass::ToString);
 }
@@ -7,6 +7,8 @@
 #include <vector>
 
 #include "sherpa-onnx/csrc/online-stream.h"
+#include "sherpa-onnx/csrc/sample-format.h"
+#include "sherpa-onnx/python/csrc/numpy-utils.h"
 
 namespace sherpa_onnx {
 
@@ -19,7 +21,10 @@ Args:
     expected by the model, we will do resampling inside.
   waveform:
     A 1-D float32 tensor containing audio samples. It must be normalized
-    to the range [-1, 1].
+    to the range [-1, 1]. A contiguous float32 numpy array is used without
+    a copy. A 1-D int16 numpy array with 16-bit PCM samples is also
+    accepted, e.g., a column of a 2-D stereo array; it is converted to
+    float32 in C++.
 )";
 
 
@@ -44,12 +49,21 @@ void PybindOnlineStream(py::module *m) {
   py::class_<PyClass>(*m, "OnlineStream")
       .def(
           "accept_waveform",
-          [](PyClass &self, float sample_rate,
-             const std::vector<float> &waveform) {
+          [](PyClass &self, float sample_rate, const PyFloatArray &waveform) {
             self.AcceptWaveform(sample_rate, waveform.data(), waveform.size());
           },
           py::arg("sample_rate"), py::arg("waveform"), kAcceptWaveformUsage,
           py::call_guard<py::gil_scoped_release>())
+      .def(
+          "accept_waveform",
+          [](PyClass &self, float sample_rate, const PyInt16Array &waveform) {
+            auto samples = ToContiguous(waveform);
+            py::gil_scoped_release release;
+            self.AcceptWaveform(sample_rate, samples.data(), samples.size(),
+                                SampleFormat::kInt16);
+          },
+          py::arg("sample_rate"), py::arg("waveform").noconvert(),
+          kAcceptWaveformUsage)
       .def("input_finished", &PyClass::InputFinished,
            py::call_guard<py::gil_scoped_release>())
       .def("set_option", &PyClass::SetOption, py::arg("key"),
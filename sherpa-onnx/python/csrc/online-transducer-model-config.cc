@@ -19,6 +19,9 @@ void PybindOnlineTransducerModelConfig(py::module *m) {
       .def_readwrite("encoder", &PyClass::encoder)
       .def_readwrite("decoder", &PyClass::decoder)
       .def_readwrite("joiner", &PyClass::joiner)
+      .def_readwrite("native_joiner", &PyClass::native_joiner)
+      .def_readwrite("decoder_output_cache_size",
+                     &PyClass::decoder_output_cache_size)
       .def("__str__", &PyClass::ToString);
 }
 
@@ -0,0 +1,61 @@
+// sherpa-onnx/python/csrc/ort-thread-pool-config.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/python/csrc/ort-thread-pool-config.h"
+
+#include <stdexcept>
+#include <string>
+
+#include "sherpa-onnx/csrc/ort-thread-pool-config.h"
+#include "sherpa-onnx/csrc/session.h"
+
+namespace sherpa_onnx {
+
+void PybindOrtThreadPoolConfig(py::module *m) {
+  using PyClass = OrtThreadPoolConfig;
+  py::class_<PyClass>(*m, "OrtThreadPoolConfig")
+      .def(py::init([](int32_t intra_op_num_threads,
+                       int32_t inter_op_num_threads, bool allow_spinning,
+                       const std::string &intra_op_thread_affinity) {
+             PyClass config;
+             config.enabled = true;
+             config.intra_op_num_threads = intra_op_num_threads;
+             config.inter_op_num_threads = inter_op_num_threads;
+             config.allow_spinning = allow_spinning;
+             config.intra_op_thread_affinity = intra_op_thread_affinity;
+             return config;
+           }),
+           py::arg("intra_op_num_threads") = 0,
+           py::arg("inter_op_num_threads") = 1,
+           py::arg("allow_spinning") = true,
+           py::arg("intra_op_thread_affinity") = "")
+      .def_readwrite("enabled", &PyClass::enabled)
+      .def_readwrite("intra_op_num_threads", &PyClass::intra_op_num_threads)
+      .def_readwrite("inter_op_num_threads", &PyClass::inter_op_num_threads)
+      .def_readwrite("allow_spinning", &PyClass::allow_spinning)
+      .def_readwrite("intra_op_thread_affinity",
+                     &PyClass::intra_op_thread_affinity)
+      .def("validate", &PyClass::Validate)
+      .def("__str__", &PyClass::ToString);
+
+  m->def(
+      "init_global_thread_pool",
+      [](const PyClass &config) {
+        if (!config.Validate()) {
+          throw std::invalid_argument("Invalid OrtThreadPoolConfig");
+        }
+
+        if (HasGlobalThreadPool()) {
+          throw std::runtime_error(
+              "The global thread pool can be initialized only once");
+        }
+
+        InitGlobalThreadPool(config);
+      },
+      py::arg("config"),
+      "Let all models of this process share one set of onnxruntime thread "
+      "pools. Call it once, before creating any model.");
+}
+
+}  // namespace sherpa_onnx
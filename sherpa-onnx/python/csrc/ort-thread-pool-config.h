@@ -0,0 +1,16 @@
+// sherpa-onnx/python/csrc/ort-thread-pool-config.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_PYTHON_CSRC_ORT_THREAD_POOL_CONFIG_H_
+#define SHERPA_ONNX_PYTHON_CSRC_ORT_THREAD_POOL_CONFIG_H_
+
+#include "sherpa-onnx/python/csrc/sherpa-onnx.h"
+
+namespace sherpa_onnx {
+
+void PybindOrtThreadPoolConfig(py::module *m);
+
+}
+
+#endif  // SHERPA_ONNX_PYTHON_CSRC_ORT_THREAD_POOL_CONFIG_H_
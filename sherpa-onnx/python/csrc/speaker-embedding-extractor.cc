@@ -5,8 +5,11 @@
 #include "sherpa-onnx/python/csrc/speaker-embedding-extractor.h"
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "sherpa-onnx/csrc/speaker-embedding-extractor.h"
+#include "sherpa-onnx/python/csrc/numpy-utils.h"
 
 namespace sherpa_onnx {
 
@@ -35,8 +38,17 @@ void PybindSpeakerEmbeddingExtractor(py::module *m) {
       .def_property_readonly("dim", &PyClass::Dim)
       .def("create_stream", &PyClass::CreateStream,
            py::call_guard<py::gil_scoped_release>())
-      .def("compute", &PyClass::Compute,
-           py::call_guard<py::gil_scoped_release>())
+      .def(
+          "compute",
+          [](const PyClass &self, OnlineStream *s) {
+            std::vector<float> embedding;
+            {
+              py::gil_scoped_release release;
+              embedding = self.Compute(s);
+            }
+            return ToNumpy(std::move(embedding));
+          },
+          py::arg("s"))
       .def("is_ready", &PyClass::IsReady,
            py::call_guard<py::gil_scoped_release>());
 }
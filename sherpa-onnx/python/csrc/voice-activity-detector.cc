@@ -7,16 +7,20 @@
 #include <vector>
 
 #include "sherpa-onnx/csrc/voice-activity-detector.h"
+#include "sherpa-onnx/python/csrc/numpy-utils.h"
 
 namespace sherpa_onnx {
 
 void PybindSpeechSegment(py::module *m) {
-  using PyClass = SpeechSegment;
+  // Segments are exposed to Python as views so that no samples are
+  // copied. The returned array stays valid after pop().
+  using PyClass = SpeechSegmentView;
   py::class_<PyClass>(*m, "SpeechSegment")
       .def_property_readonly("start",
                              [](const PyClass &self) { return self.start; })
-      .def_property_readonly("samples",
-                             [](const PyClass &self) { return self.samples; });
+      .def_property_readonly("samples", [](const PyClass &self) {
+        return ToNumpy(self.samples);
+      });
 }
 
 void PybindVoiceActivityDetector(py::module *m) {
@@ -25,8 +29,8 @@ void PybindVoiceActivityDetector(py::module *m) {
   py::class_<PyClass>(*m, "VoiceActivityDetector",
                       R"(
 1. It is an error to call the front property when the method empty() returns True
-2. The property front returns a reference, which is valid until the next call of any
-   methods of this class
+2. The property front returns a view of the internal buffer. Its samples are
+   not copied and stay valid after pop()
 3. When speech is detected, the method is_speech_detected() return True, you can
    use the property current_segment to get the speech samples since
    is_speech_detected() returns true
@@ -38,10 +42,20 @@ void PybindVoiceActivityDetector(py::module *m) {
            py::call_guard<py::gil_scoped_release>())
       .def(
           "accept_waveform",
-          [](PyClass &self, const std::vector<float> &samples) {
+          [](PyClass &self, const PyFloatArray &samples) {
             self.AcceptWaveform(samples.data(), samples.size());
           },
           py::arg("samples"), py::call_guard<py::gil_scoped_release>())
+      .def(
+          "accept_waveform",
+          [](PyClass &self, const PyInt16Array &samples) {
+            auto contiguous = ToContiguous(samples);
+            py::gil_scoped_release release;
+            std::vector<float> s =
+                Int16ToFloat(contiguous.data(), contiguous.size());
+            self.AcceptWaveform(s.data(), s.size());
+          },
+          py::arg("samples").noconvert())
       .def_property_readonly("config", &PyClass::GetConfig)
       .def("empty", &PyClass::Empty, py::call_guard<py::gil_scoped_release>())
       .def("pop", &PyClass::Pop, py::call_guard<py::gil_scoped_release>())
@@ -49,8 +63,16 @@ void PybindVoiceActivityDetector(py::module *m) {
            py::call_guard<py::gil_scoped_release>())
       .def("reset", &PyClass::Reset, py::call_guard<py::gil_scoped_release>())
       .def("flush", &PyClass::Flush, py::call_guard<py::gil_scoped_release>())
-      .def_property_readonly("front", &PyClass::Front)
-      .def_property_readonly("current_segment", &PyClass::CurrentSpeechSegment);
+      .def_property_readonly(
+          "front",
+          [](const PyClass &self) -> SpeechSegmentView {
+            // Return a copy of the view. A reference to the front of the
+            // queue would be invalidated by pop(). The copy shares the
+            // samples, so no samples are copied.
+            return self.FrontView();
+          })
+      .def_property_readonly("current_segment",
+                             &PyClass::CurrentSpeechSegmentView);
 }
 
 }  // namespace sherpa_onnx
@@ -67,6 +67,7 @@ from sherpa_onnx.lib._sherpa_onnx import (
     OnlineSpeechDenoiser,
     OnlineSpeechDenoiserConfig,
     OnlineStream,
+    OrtThreadPoolConfig,
     SentencePieceTokenizer,
     SileroVadModelConfig,
     SpeakerEmbeddingExtractor,
@@ -82,6 +83,7 @@ from sherpa_onnx.lib._sherpa_onnx import (
     VoiceActivityDetector,
     git_date,
     git_sha1,
+    init_global_thread_pool,
     version,
     write_wave,
 )
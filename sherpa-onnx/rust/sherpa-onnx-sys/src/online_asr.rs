@@ -10,6 +10,7 @@ pub struct OnlineTransducerModelConfig {
     pub encoder: *const c_char,
     pub decoder: *const c_char,
     pub joiner: *const c_char,
+    pub native_joiner: i32,
 }
 
 #[repr(C)]
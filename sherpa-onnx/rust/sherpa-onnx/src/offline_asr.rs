@@ -50,6 +50,7 @@ pub struct OfflineTransducerModelConfig {
     pub encoder: Option<String>,
     pub decoder: Option<String>,
     pub joiner: Option<String>,
+    pub native_joiner: bool,
 }
 
 impl OfflineTransducerModelConfig {
@@ -58,6 +59,7 @@ impl OfflineTransducerModelConfig {
             encoder: to_c_ptr(&self.encoder, cstrings),
             decoder: to_c_ptr(&self.decoder, cstrings),
             joiner: to_c_ptr(&self.joiner, cstrings),
+            native_joiner: self.native_joiner as i32,
         }
     }
 }
@@ -636,6 +638,7 @@ pub struct OfflineRecognizerResult {
 ///     encoder: Some("./sherpa-onnx-nemo-parakeet-tdt-0.6b-v3-int8/encoder.int8.onnx".into()),
 ///     decoder: Some("./sherpa-onnx-nemo-parakeet-tdt-0.6b-v3-int8/decoder.int8.onnx".into()),
 ///     joiner: Some("./sherpa-onnx-nemo-parakeet-tdt-0.6b-v3-int8/joiner.int8.onnx".into()),
+///     ..Default::default()
 /// };
 /// config.model_config.tokens =
 ///     Some("./sherpa-onnx-nemo-parakeet-tdt-0.6b-v3-int8/tokens.txt".into());
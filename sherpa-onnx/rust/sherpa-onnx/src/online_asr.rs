@@ -51,6 +51,7 @@ pub struct OnlineTransducerModelConfig {
     pub encoder: Option<String>,
     pub decoder: Option<String>,
     pub joiner: Option<String>,
+    pub native_joiner: bool,
 }
 
 impl OnlineTransducerModelConfig {
@@ -59,6 +60,7 @@ impl OnlineTransducerModelConfig {
             encoder: to_c_ptr(&self.encoder, cstrings),
             decoder: to_c_ptr(&self.decoder, cstrings),
             joiner: to_c_ptr(&self.joiner, cstrings),
+            native_joiner: self.native_joiner as i32,
         }
     }
 }
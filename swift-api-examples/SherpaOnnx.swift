@@ -25,17 +25,20 @@ func toCPointer(_ s: String) -> UnsafePointer<Int8>! {
 ///   - encoder: Path to encoder.onnx
 ///   - decoder: Path to decoder.onnx
 ///   - joiner: Path to joiner.onnx
+///   - nativeJoiner: Run the joiner in C++ if the joiner model is supported
 ///
 /// - Returns: Return an instance of SherpaOnnxOnlineTransducerModelConfig
 func sherpaOnnxOnlineTransducerModelConfig(
   encoder: String = "",
   decoder: String = "",
-  joiner: String = ""
+  joiner: String = "",
+  nativeJoiner: Bool = false
 ) -> SherpaOnnxOnlineTransducerModelConfig {
   return SherpaOnnxOnlineTransducerModelConfig(
     encoder: toCPointer(encoder),
     decoder: toCPointer(decoder),
-    joiner: toCPointer(joiner)
+    joiner: toCPointer(joiner),
+    native_joiner: nativeJoiner ? 1 : 0
   )
 }
 
@@ -335,12 +338,14 @@ class SherpaOnnxRecognizer {
 func sherpaOnnxOfflineTransducerModelConfig(
   encoder: String = "",
   decoder: String = "",
-  joiner: String = ""
+  joiner: String = "",
+  nativeJoiner: Bool = false
 ) -> SherpaOnnxOfflineTransducerModelConfig {
   return SherpaOnnxOfflineTransducerModelConfig(
     encoder: toCPointer(encoder),
     decoder: toCPointer(decoder),
-    joiner: toCPointer(joiner)
+    joiner: toCPointer(joiner),
+    native_joiner: nativeJoiner ? 1 : 0
   )
 }
 
@@ -120,7 +120,7 @@ function initSherpaOnnxOnlineTransducerModelConfig(config, Module) {
 
   const buffer = Module._malloc(n);
 
-  const len = 3 * 4;  // 3 pointers
+  const len = 4 * 4;  // 3 pointers + 1 int32
   const ptr = Module._malloc(len);
 
   let offset = 0;
@@ -141,6 +141,8 @@ function initSherpaOnnxOnlineTransducerModelConfig(config, Module) {
 
   Module.setValue(ptr + 8, buffer + offset, 'i8*');
 
+  Module.setValue(ptr + 12, config.nativeJoiner ? 1 : 0, 'i32');
+
   return {
     buffer: buffer,
     ptr: ptr,
@@ -688,7 +690,7 @@ function initSherpaOnnxOfflineTransducerModelConfig(config, Module) {
 
   const buffer = Module._malloc(n);
 
-  const len = 3 * 4;  // 3 pointers
+  const len = 4 * 4;  // 3 pointers + 1 int32
   const ptr = Module._malloc(len);
 
   let offset = 0;
@@ -709,6 +711,8 @@ function initSherpaOnnxOfflineTransducerModelConfig(config, Module) {
 
   Module.setValue(ptr + 8, buffer + offset, 'i8*');
 
+  Module.setValue(ptr + 12, config.nativeJoiner ? 1 : 0, 'i32');
+
   return {
     buffer: buffer,
     ptr: ptr,
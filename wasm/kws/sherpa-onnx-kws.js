@@ -34,7 +34,7 @@ function initSherpaOnnxOnlineTransducerModelConfig(config, Module) {
 
   const buffer = Module._malloc(n);
 
-  const len = 3 * 4;  // 3 pointers
+  const len = 4 * 4;  // 3 pointers + 1 int32
   const ptr = Module._malloc(len);
 
   let offset = 0;
@@ -55,6 +55,8 @@ function initSherpaOnnxOnlineTransducerModelConfig(config, Module) {
 
   Module.setValue(ptr + 8, buffer + offset, 'i8*');
 
+  Module.setValue(ptr + 12, config.nativeJoiner ? 1 : 0, 'i32');
+
   return {
     buffer: buffer,
     ptr: ptr,
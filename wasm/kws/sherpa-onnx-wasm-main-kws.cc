@@ -13,7 +13,7 @@
 
 extern "C" {
 
-static_assert(sizeof(SherpaOnnxOnlineTransducerModelConfig) == 3 * 4, "");
+static_assert(sizeof(SherpaOnnxOnlineTransducerModelConfig) == 4 * 4, "");
 static_assert(sizeof(SherpaOnnxOnlineParaformerModelConfig) == 2 * 4, "");
 static_assert(sizeof(SherpaOnnxOnlineZipformer2CtcModelConfig) == 1 * 4, "");
 static_assert(sizeof(SherpaOnnxOnlineModelConfig) ==
@@ -10,7 +10,7 @@
 
 extern "C" {
 
-static_assert(sizeof(SherpaOnnxOfflineTransducerModelConfig) == 3 * 4, "");
+static_assert(sizeof(SherpaOnnxOfflineTransducerModelConfig) == 4 * 4, "");
 static_assert(sizeof(SherpaOnnxOfflineParaformerModelConfig) == 4, "");
 
 static_assert(sizeof(SherpaOnnxOfflineZipformerCtcModelConfig) == 4, "");